@@ -5,15 +5,23 @@ HEADERS += \
     $$PWD/asyncfilestorage.h \
     $$PWD/bittorrent/abstractfilestorage.h \
     $$PWD/bittorrent/addtorrentparams.h \
+    $$PWD/bittorrent/addtorrentpipeline.h \
     $$PWD/bittorrent/bandwidthscheduler.h \
     $$PWD/bittorrent/bencoderesumedatastorage.h \
     $$PWD/bittorrent/cachestatus.h \
     $$PWD/bittorrent/categoryoptions.h \
+    $$PWD/bittorrent/checkingdevicestatus.h \
+    $$PWD/bittorrent/checkingslots.h \
     $$PWD/bittorrent/common.h \
+    $$PWD/bittorrent/contentremovalstatus.h \
+    $$PWD/bittorrent/contentreuse.h \
     $$PWD/bittorrent/customstorage.h \
+    $$PWD/bittorrent/diskiostatistics.h \
+    $$PWD/bittorrent/diskreadcache.h \
     $$PWD/bittorrent/downloadpriority.h \
     $$PWD/bittorrent/dbresumedatastorage.h \
     $$PWD/bittorrent/extensiondata.h \
+    $$PWD/bittorrent/filefingerprint.h \
     $$PWD/bittorrent/filesearcher.h \
     $$PWD/bittorrent/filterparserthread.h \
     $$PWD/bittorrent/infohash.h \
@@ -22,11 +30,16 @@ HEADERS += \
     $$PWD/bittorrent/ltqhash.h \
     $$PWD/bittorrent/lttypecast.h \
     $$PWD/bittorrent/magneturi.h \
+    $$PWD/bittorrent/metadatacache.h \
+    $$PWD/bittorrent/movestoragelanestatus.h \
     $$PWD/bittorrent/nativesessionextension.h \
     $$PWD/bittorrent/nativetorrentextension.h \
     $$PWD/bittorrent/peeraddress.h \
     $$PWD/bittorrent/peerinfo.h \
+    $$PWD/bittorrent/piecechecker.h \
+    $$PWD/bittorrent/piecestates.h \
     $$PWD/bittorrent/portforwarderimpl.h \
+    $$PWD/bittorrent/queueorder.h \
     $$PWD/bittorrent/resumedatastorage.h \
     $$PWD/bittorrent/session.h \
     $$PWD/bittorrent/sessionstatus.h \
@@ -34,6 +47,7 @@ HEADERS += \
     $$PWD/bittorrent/statistics.h \
     $$PWD/bittorrent/torrent.h \
     $$PWD/bittorrent/torrentcontentlayout.h \
+    $$PWD/bittorrent/torrentcontentremover.h \
     $$PWD/bittorrent/torrentcreatorthread.h \
     $$PWD/bittorrent/torrentimpl.h \
     $$PWD/bittorrent/torrentinfo.h \
@@ -43,6 +57,7 @@ HEADERS += \
     $$PWD/exceptions.h \
     $$PWD/global.h \
     $$PWD/http/connection.h \
+    $$PWD/http/eventstream.h \
     $$PWD/http/httperror.h \
     $$PWD/http/irequesthandler.h \
     $$PWD/http/requestparser.h \
@@ -54,6 +69,7 @@ HEADERS += \
     $$PWD/indexrange.h \
     $$PWD/interfaces/iapplication.h \
     $$PWD/interfaces/istringable.h \
+    $$PWD/latencyhistogram.h \
     $$PWD/logger.h \
     $$PWD/net/dnsupdater.h \
     $$PWD/net/downloadhandlerimpl.h \
@@ -108,27 +124,38 @@ SOURCES += \
     $$PWD/applicationcomponent.cpp \
     $$PWD/asyncfilestorage.cpp \
     $$PWD/bittorrent/abstractfilestorage.cpp \
+    $$PWD/bittorrent/addtorrentpipeline.cpp \
     $$PWD/bittorrent/bandwidthscheduler.cpp \
     $$PWD/bittorrent/bencoderesumedatastorage.cpp \
     $$PWD/bittorrent/categoryoptions.cpp \
+    $$PWD/bittorrent/checkingslots.cpp \
+    $$PWD/bittorrent/contentreuse.cpp \
     $$PWD/bittorrent/customstorage.cpp \
+    $$PWD/bittorrent/diskiostatistics.cpp \
+    $$PWD/bittorrent/diskreadcache.cpp \
     $$PWD/bittorrent/dbresumedatastorage.cpp \
     $$PWD/bittorrent/downloadpriority.cpp \
+    $$PWD/bittorrent/filefingerprint.cpp \
     $$PWD/bittorrent/filesearcher.cpp \
     $$PWD/bittorrent/filterparserthread.cpp \
     $$PWD/bittorrent/infohash.cpp \
     $$PWD/bittorrent/ltqbitarray.cpp \
     $$PWD/bittorrent/magneturi.cpp \
+    $$PWD/bittorrent/metadatacache.cpp \
     $$PWD/bittorrent/nativesessionextension.cpp \
     $$PWD/bittorrent/nativetorrentextension.cpp \
     $$PWD/bittorrent/peeraddress.cpp \
     $$PWD/bittorrent/peerinfo.cpp \
+    $$PWD/bittorrent/piecechecker.cpp \
+    $$PWD/bittorrent/piecestates.cpp \
     $$PWD/bittorrent/portforwarderimpl.cpp \
+    $$PWD/bittorrent/queueorder.cpp \
     $$PWD/bittorrent/resumedatastorage.cpp \
     $$PWD/bittorrent/session.cpp \
     $$PWD/bittorrent/speedmonitor.cpp \
     $$PWD/bittorrent/statistics.cpp \
     $$PWD/bittorrent/torrent.cpp \
+    $$PWD/bittorrent/torrentcontentremover.cpp \
     $$PWD/bittorrent/torrentcreatorthread.cpp \
     $$PWD/bittorrent/torrentimpl.cpp \
     $$PWD/bittorrent/torrentinfo.cpp \
@@ -136,12 +163,14 @@ SOURCES += \
     $$PWD/bittorrent/trackerentry.cpp \
     $$PWD/exceptions.cpp \
     $$PWD/http/connection.cpp \
+    $$PWD/http/eventstream.cpp \
     $$PWD/http/httperror.cpp \
     $$PWD/http/requestparser.cpp \
     $$PWD/http/responsebuilder.cpp \
     $$PWD/http/responsegenerator.cpp \
     $$PWD/http/server.cpp \
     $$PWD/iconprovider.cpp \
+    $$PWD/latencyhistogram.cpp \
     $$PWD/logger.cpp \
     $$PWD/net/dnsupdater.cpp \
     $$PWD/net/downloadhandlerimpl.cpp \
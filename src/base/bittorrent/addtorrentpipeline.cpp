@@ -0,0 +1,214 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "addtorrentpipeline.h"
+
+#include <algorithm>
+
+#include "base/global.h"
+#include "downloadpriority.h"
+
+namespace
+{
+    // Limits the number of torrents which are loaded but not yet handed over,
+    // so that adding thousands of torrents doesn't keep all of them in memory
+    const int MAX_PROCESSED_TORRENTS = 64;
+    // The owner thread handles other events between the batches
+    const int COMMIT_BATCH_SIZE = 16;
+
+    BitTorrent::PreparedTorrent prepareTorrent(const std::variant<Path, BitTorrent::TorrentInfo> &source
+            , const BitTorrent::AddTorrentParams &params, const QVector<QRegularExpression> &excludedFileNames)
+    {
+        BitTorrent::PreparedTorrent torrent;
+        if (const auto *torrentFilePath = std::get_if<Path>(&source))
+        {
+            torrent.sourcePath = *torrentFilePath;
+            const nonstd::expected<BitTorrent::TorrentInfo, QString> loadResult = BitTorrent::TorrentInfo::loadFromFile(*torrentFilePath);
+            if (!loadResult)
+            {
+                torrent.error = loadResult.error();
+                return torrent;
+            }
+
+            torrent.torrentInfo = loadResult.value();
+        }
+        else
+        {
+            torrent.torrentInfo = std::get<BitTorrent::TorrentInfo>(source);
+        }
+
+        const nonstd::expected<BitTorrent::AddTorrentParams, QString> prepareResult
+                = BitTorrent::prepareAddTorrentParams(torrent.torrentInfo, params, excludedFileNames);
+        if (prepareResult)
+            torrent.params = prepareResult.value();
+        else
+            torrent.error = prepareResult.error();
+
+        return torrent;
+    }
+}
+
+nonstd::expected<BitTorrent::AddTorrentParams, QString> BitTorrent::prepareAddTorrentParams(const TorrentInfo &torrentInfo
+        , AddTorrentParams params, const QVector<QRegularExpression> &excludedFileNames)
+{
+    const int filesCount = torrentInfo.filesCount();
+
+    if (params.filePaths.isEmpty())
+    {
+        params.filePaths = torrentInfo.filePaths();
+
+        const TorrentContentLayout contentLayout = params.contentLayout.value_or(TorrentContentLayout::Original);
+        if (contentLayout != TorrentContentLayout::Original)
+        {
+            const Path originalRootFolder = Path::findRootFolder(params.filePaths);
+            const auto originalContentLayout = (originalRootFolder.isEmpty()
+                                                ? TorrentContentLayout::NoSubfolder
+                                                : TorrentContentLayout::Subfolder);
+            if (contentLayout != originalContentLayout)
+            {
+                if (contentLayout == TorrentContentLayout::NoSubfolder)
+                    Path::stripRootFolder(params.filePaths);
+                else
+                    Path::addRootFolder(params.filePaths, params.filePaths.at(0).removedExtension());
+            }
+        }
+    }
+    else if (params.filePaths.size() != filesCount)
+    {
+        return nonstd::make_unexpected(AddTorrentPipeline::tr("Number of file paths doesn't match the number of files in the torrent"));
+    }
+
+    if (params.filePriorities.isEmpty())
+    {
+        // Check file name blacklist when priorities are not explicitly set
+        for (int i = 0; (i < filesCount) && !excludedFileNames.isEmpty(); ++i)
+        {
+            const QString fileName = params.filePaths.at(i).filename();
+            const bool isExcluded = std::any_of(excludedFileNames.cbegin(), excludedFileNames.cend()
+                                                , [&fileName](const QRegularExpression &re) { return re.match(fileName).hasMatch(); });
+            if (!isExcluded)
+                continue;
+
+            if (params.filePriorities.isEmpty())
+                params.filePriorities.fill(DownloadPriority::Normal, filesCount);
+            params.filePriorities[i] = DownloadPriority::Ignored;
+        }
+    }
+    else if (params.filePriorities.size() != filesCount)
+    {
+        return nonstd::make_unexpected(AddTorrentPipeline::tr("Number of file priorities doesn't match the number of files in the torrent"));
+    }
+
+    return params;
+}
+
+BitTorrent::AddTorrentPipeline::AddTorrentPipeline(QObject *parent)
+    : QObject(parent)
+{
+}
+
+BitTorrent::AddTorrentPipeline::~AddTorrentPipeline()
+{
+    m_threadPool.clear();
+    m_threadPool.waitForDone();
+}
+
+void BitTorrent::AddTorrentPipeline::add(const Path &torrentFilePath, const AddTorrentParams &params
+        , const QVector<QRegularExpression> &excludedFileNames)
+{
+    m_waitingRequests.enqueue({torrentFilePath, params, excludedFileNames});
+    startJobs();
+}
+
+void BitTorrent::AddTorrentPipeline::add(const TorrentInfo &torrentInfo, const AddTorrentParams &params
+        , const QVector<QRegularExpression> &excludedFileNames)
+{
+    m_waitingRequests.enqueue({torrentInfo, params, excludedFileNames});
+    startJobs();
+}
+
+int BitTorrent::AddTorrentPipeline::pendingCount() const
+{
+    return m_waitingRequests.size() + m_runningJobsCount + m_preparedTorrents.size();
+}
+
+void BitTorrent::AddTorrentPipeline::startJobs()
+{
+    while (!m_waitingRequests.isEmpty()
+           && ((m_runningJobsCount + m_preparedTorrents.size()) < MAX_PROCESSED_TORRENTS))
+    {
+        const quint64 sequenceNumber = m_nextSequenceNumber++;
+        ++m_runningJobsCount;
+        m_threadPool.start([this, sequenceNumber, request = m_waitingRequests.dequeue()]()
+        {
+            const PreparedTorrent torrent = prepareTorrent(request.source, request.params, request.excludedFileNames);
+            QMetaObject::invokeMethod(this, [this, sequenceNumber, torrent]()
+            {
+                handleJobFinished(sequenceNumber, torrent);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void BitTorrent::AddTorrentPipeline::handleJobFinished(const quint64 sequenceNumber, const PreparedTorrent &torrent)
+{
+    --m_runningJobsCount;
+    m_preparedTorrents.insert(sequenceNumber, torrent);
+
+    if ((sequenceNumber == m_nextCommitSequenceNumber) && !m_isCommitScheduled)
+    {
+        m_isCommitScheduled = true;
+        QMetaObject::invokeMethod(this, &AddTorrentPipeline::commitPreparedTorrents, Qt::QueuedConnection);
+    }
+}
+
+void BitTorrent::AddTorrentPipeline::commitPreparedTorrents()
+{
+    m_isCommitScheduled = false;
+
+    // Torrents are handed over in the order they were requested
+    QVector<PreparedTorrent> torrents;
+    torrents.reserve(COMMIT_BATCH_SIZE);
+    while ((torrents.size() < COMMIT_BATCH_SIZE) && !m_preparedTorrents.isEmpty()
+           && (m_preparedTorrents.firstKey() == m_nextCommitSequenceNumber))
+    {
+        torrents.append(m_preparedTorrents.take(m_nextCommitSequenceNumber));
+        ++m_nextCommitSequenceNumber;
+    }
+
+    if (!torrents.isEmpty())
+        emit torrentsPrepared(torrents);
+
+    startJobs();
+
+    if (!m_preparedTorrents.isEmpty() && (m_preparedTorrents.firstKey() == m_nextCommitSequenceNumber))
+    {
+        m_isCommitScheduled = true;
+        QMetaObject::invokeMethod(this, &AddTorrentPipeline::commitPreparedTorrents, Qt::QueuedConnection);
+    }
+}
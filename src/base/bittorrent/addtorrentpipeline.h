@@ -0,0 +1,104 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <variant>
+
+#include <QMap>
+#include <QObject>
+#include <QQueue>
+#include <QRegularExpression>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include "base/3rdparty/expected.hpp"
+#include "base/path.h"
+#include "addtorrentparams.h"
+#include "torrentinfo.h"
+
+namespace BitTorrent
+{
+    struct PreparedTorrent
+    {
+        Path sourcePath; // empty unless the torrent is loaded from file
+        TorrentInfo torrentInfo;
+        AddTorrentParams params;
+        QString error;
+    };
+
+    // Resolves the file paths (according to the content layout) and the file priorities
+    // (according to the excluded file names) of a torrent to be added.
+    // `params.contentLayout` is expected to be resolved by the caller.
+    nonstd::expected<AddTorrentParams, QString> prepareAddTorrentParams(const TorrentInfo &torrentInfo
+            , AddTorrentParams params, const QVector<QRegularExpression> &excludedFileNames);
+
+    // Loads and prepares the torrents to be added on worker threads and hands them over
+    // to the owner thread in batches. Only a limited number of torrents is processed
+    // at the same time, the remaining requests wait in the queue.
+    class AddTorrentPipeline final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(AddTorrentPipeline)
+
+    public:
+        explicit AddTorrentPipeline(QObject *parent = nullptr);
+        ~AddTorrentPipeline() override;
+
+        void add(const Path &torrentFilePath, const AddTorrentParams &params
+                 , const QVector<QRegularExpression> &excludedFileNames = {});
+        void add(const TorrentInfo &torrentInfo, const AddTorrentParams &params
+                 , const QVector<QRegularExpression> &excludedFileNames = {});
+
+        int pendingCount() const;
+
+    signals:
+        void torrentsPrepared(const QVector<BitTorrent::PreparedTorrent> &torrents);
+
+    private:
+        struct Request
+        {
+            std::variant<Path, TorrentInfo> source;
+            AddTorrentParams params;
+            QVector<QRegularExpression> excludedFileNames;
+        };
+
+        void startJobs();
+        void handleJobFinished(quint64 sequenceNumber, const PreparedTorrent &torrent);
+        void commitPreparedTorrents();
+
+        QThreadPool m_threadPool;
+        QQueue<Request> m_waitingRequests;
+        QMap<quint64, PreparedTorrent> m_preparedTorrents;
+        int m_runningJobsCount = 0;
+        quint64 m_nextSequenceNumber = 0;
+        quint64 m_nextCommitSequenceNumber = 0;
+        bool m_isCommitScheduled = false;
+    };
+}
@@ -48,6 +48,7 @@
 #include "base/utils/fs.h"
 #include "base/utils/io.h"
 #include "base/utils/string.h"
+#include "filefingerprint.h"
 #include "infohash.h"
 #include "loadtorrentparams.h"
 
@@ -264,6 +265,8 @@ BitTorrent::LoadResumeDataResult BitTorrent::BencodeResumeDataStorage::loadTorre
         }
     }
 
+    torrentParams.fileFingerprints = fileFingerprintsFromNode(root.dict_find_list("qBt-fileFingerprints"));
+
     lt::add_torrent_params &p = torrentParams.ltAddTorrentParams;
 
     p = lt::read_resume_data(root, ec);
@@ -379,6 +382,7 @@ void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, co
     data["qBt-seedStatus"] = resumeData.hasSeedStatus;
     data["qBt-contentLayout"] = Utils::String::fromEnum(resumeData.contentLayout).toStdString();
     data["qBt-firstLastPiecePriority"] = resumeData.firstLastPiecePriority;
+    data["qBt-fileFingerprints"] = fileFingerprintsToEntry(resumeData.fileFingerprints);
 
     if (!resumeData.useAutoTMM)
     {
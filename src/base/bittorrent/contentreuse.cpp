@@ -0,0 +1,140 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "contentreuse.h"
+
+#include <algorithm>
+
+#include <QCryptographicHash>
+#include <QFile>
+
+#include "base/utils/fs.h"
+#include "torrentinfo.h"
+
+std::optional<BitTorrent::ContentReuseCandidate> BitTorrent::makeContentReuseCandidate(const TorrentInfo &torrentInfo
+        , const QVector<QByteArray> &pieceHashes, const int fileIndex)
+{
+    const qint64 fileSize = torrentInfo.fileSize(fileIndex);
+    const int pieceLength = torrentInfo.pieceLength();
+    if ((fileSize <= 0) || (pieceLength <= 0))
+        return std::nullopt;
+
+    const qint64 fileOffset = torrentInfo.fileOffset(fileIndex);
+    const qint64 fileEnd = fileOffset + fileSize;
+    int pieceIndex = static_cast<int>((fileOffset + pieceLength - 1) / pieceLength);
+
+    ContentReuseCandidate candidate;
+    candidate.fileIndex = fileIndex;
+    candidate.fileSize = fileSize;
+    candidate.firstPieceOffset = (static_cast<qint64>(pieceIndex) * pieceLength) - fileOffset;
+    candidate.pieceLength = pieceLength;
+    for (; pieceIndex < pieceHashes.size(); ++pieceIndex)
+    {
+        const qint64 pieceEnd = (static_cast<qint64>(pieceIndex) * pieceLength) + torrentInfo.pieceLength(pieceIndex);
+        if (pieceEnd > fileEnd)
+            break;
+
+        candidate.pieceHashes.append(pieceHashes[pieceIndex]);
+    }
+
+    if (candidate.pieceHashes.isEmpty())
+        return std::nullopt;
+
+    return candidate;
+}
+
+bool BitTorrent::verifyFileContent(const Path &filePath, const ContentReuseCandidate &candidate)
+{
+    QFile file {filePath.data()};
+    if (!file.open(QIODevice::ReadOnly) || (file.size() != candidate.fileSize))
+        return false;
+
+    if (!file.seek(candidate.firstPieceOffset))
+        return false;
+
+    // the last piece of a torrent can be shorter, it always ends at the end of the file
+    QByteArray buffer;
+    for (const QByteArray &pieceHash : candidate.pieceHashes)
+    {
+        buffer = file.read(candidate.pieceLength);
+        if (buffer.isEmpty() || (QCryptographicHash::hash(buffer, QCryptographicHash::Sha1) != pieceHash))
+            return false;
+    }
+
+    return true;
+}
+
+qint64 BitTorrent::reuseFileContent(const ContentReuseCandidate &candidate, const Path &targetPath)
+{
+    for (const Path &existingFilePath : candidate.existingFilePaths)
+    {
+        if (!verifyFileContent(existingFilePath, candidate))
+            continue;
+
+        // The file is never hard linked. The data at its edges isn't verified and can be rewritten
+        // by the added torrent which would corrupt the data of the existing one.
+        // Copying is cheap anyway where the file system supports cloning.
+        if (!Utils::Fs::mkpath(targetPath.parentPath()) || !Utils::Fs::copyFile(existingFilePath, targetPath))
+            return 0;
+
+        return candidate.fileSize;
+    }
+
+    return 0;
+}
+
+void BitTorrent::ContentReuseIndex::addTorrent(const TorrentID &id, const TorrentInfo &torrentInfo)
+{
+    for (int i = 0; i < torrentInfo.filesCount(); ++i)
+    {
+        const qint64 fileSize = torrentInfo.fileSize(i);
+        if (fileSize > 0)
+            m_files[fileSize].append({id, i});
+    }
+}
+
+void BitTorrent::ContentReuseIndex::removeTorrent(const TorrentID &id, const TorrentInfo &torrentInfo)
+{
+    for (int i = 0; i < torrentInfo.filesCount(); ++i)
+    {
+        const auto iter = m_files.find(torrentInfo.fileSize(i));
+        if (iter == m_files.end())
+            continue;
+
+        QVector<FileRef> &refs = iter.value();
+        refs.erase(std::remove_if(refs.begin(), refs.end(), [&id](const FileRef &ref) { return ref.torrentID == id; })
+                , refs.end());
+        if (refs.isEmpty())
+            m_files.erase(iter);
+    }
+}
+
+QVector<BitTorrent::ContentReuseIndex::FileRef> BitTorrent::ContentReuseIndex::find(const qint64 fileSize) const
+{
+    return m_files.value(fileSize);
+}
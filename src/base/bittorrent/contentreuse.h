@@ -0,0 +1,83 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+#include "base/path.h"
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    class TorrentInfo;
+
+    // Describes a file of a torrent being added which could be taken
+    // from the files of existing torrents instead of being downloaded.
+    // Only the pieces that lie entirely within the file can be verified
+    // without the data of the neighbouring files.
+    struct ContentReuseCandidate
+    {
+        int fileIndex = -1;
+        qint64 fileSize = 0;
+        qint64 firstPieceOffset = 0; // offset of the first verified piece within the file
+        int pieceLength = 0;
+        QVector<QByteArray> pieceHashes;
+        PathList existingFilePaths;
+    };
+
+    std::optional<ContentReuseCandidate> makeContentReuseCandidate(const TorrentInfo &torrentInfo
+            , const QVector<QByteArray> &pieceHashes, int fileIndex);
+    bool verifyFileContent(const Path &filePath, const ContentReuseCandidate &candidate);
+    // Copies (or clones) the first existing file whose content matches to `targetPath`.
+    // Returns the number of reused bytes.
+    qint64 reuseFileContent(const ContentReuseCandidate &candidate, const Path &targetPath);
+
+    // Maps file sizes to the files of loaded torrents so that
+    // files with possibly the same content can be found quickly
+    class ContentReuseIndex
+    {
+    public:
+        struct FileRef
+        {
+            TorrentID torrentID;
+            int fileIndex = -1;
+        };
+
+        void addTorrent(const TorrentID &id, const TorrentInfo &torrentInfo);
+        void removeTorrent(const TorrentID &id, const TorrentInfo &torrentInfo);
+        QVector<FileRef> find(qint64 fileSize) const;
+
+    private:
+        QHash<qint64, QVector<FileRef>> m_files;
+    };
+}
@@ -30,34 +30,84 @@
 
 #include <libtorrent/download_priority.hpp>
 
+#include <QPair>
+#include <QVector>
+
 #include "base/utils/fs.h"
 #include "common.h"
 
 #ifdef QBT_USES_LIBTORRENT2
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <boost/asio/post.hpp>
+
 #include <libtorrent/mmap_disk_io.hpp>
 #include <libtorrent/posix_disk_io.hpp>
 #include <libtorrent/session.hpp>
 
 std::unique_ptr<lt::disk_interface> customDiskIOConstructor(
-        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters
+        , BitTorrent::DiskIOStatistics *statistics, BitTorrent::DiskReadCache *readCache)
 {
-    return std::make_unique<CustomDiskIOThread>(lt::default_disk_io_constructor(ioContext, settings, counters));
+    return std::make_unique<CustomDiskIOThread>(ioContext, lt::default_disk_io_constructor(ioContext, settings, counters), statistics, readCache);
 }
 
 std::unique_ptr<lt::disk_interface> customPosixDiskIOConstructor(
-        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters
+        , BitTorrent::DiskIOStatistics *statistics, BitTorrent::DiskReadCache *readCache)
 {
-    return std::make_unique<CustomDiskIOThread>(lt::posix_disk_io_constructor(ioContext, settings, counters));
+    return std::make_unique<CustomDiskIOThread>(ioContext, lt::posix_disk_io_constructor(ioContext, settings, counters), statistics, readCache);
 }
 
 std::unique_ptr<lt::disk_interface> customMMapDiskIOConstructor(
-        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters
+        , BitTorrent::DiskIOStatistics *statistics, BitTorrent::DiskReadCache *readCache)
 {
-    return std::make_unique<CustomDiskIOThread>(lt::mmap_disk_io_constructor(ioContext, settings, counters));
+    return std::make_unique<CustomDiskIOThread>(ioContext, lt::mmap_disk_io_constructor(ioContext, settings, counters), statistics, readCache);
 }
 
-CustomDiskIOThread::CustomDiskIOThread(std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread)
-    : m_nativeDiskIO {std::move(nativeDiskIOThread)}
+// Measures the time between submitting a disk job and running its completion handler
+// so it includes the time the job spent in the queue of the native disk I/O thread
+class CustomDiskIOThread::JobTimer
+{
+public:
+    JobTimer(BitTorrent::DiskIOStatistics *statistics, const BitTorrent::TorrentID &id, const QString &device
+             , const BitTorrent::DiskIOOperation operation, const qint64 bytes)
+        : m_statistics {statistics}
+        , m_id {id}
+        , m_device {device}
+        , m_operation {operation}
+        , m_bytes {bytes}
+        , m_startTime {std::chrono::steady_clock::now()}
+    {
+    }
+
+    void finish(const lt::storage_error &error) const
+    {
+        if (!m_statistics || error)
+            return;
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_startTime);
+        m_statistics->record(m_id, m_device, m_operation, elapsed.count(), m_bytes);
+    }
+
+private:
+    BitTorrent::DiskIOStatistics *m_statistics = nullptr;
+    BitTorrent::TorrentID m_id;
+    QString m_device;
+    BitTorrent::DiskIOOperation m_operation;
+    qint64 m_bytes = 0;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+CustomDiskIOThread::CustomDiskIOThread(lt::io_context &ioContext, std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread
+                                       , BitTorrent::DiskIOStatistics *statistics, BitTorrent::DiskReadCache *readCache)
+    : m_ioContext {ioContext}
+    , m_nativeDiskIO {std::move(nativeDiskIOThread)}
+    , m_statistics {statistics}
+    , m_readCache {readCache}
 {
 }
 
@@ -70,7 +120,9 @@ lt::storage_holder CustomDiskIOThread::new_torrent(const lt::storage_params &sto
     {
         savePath,
         storageParams.mapped_files ? *storageParams.mapped_files : storageParams.files,
-        storageParams.priorities
+        storageParams.priorities,
+        BitTorrent::TorrentID(storageParams.info_hash),
+        deviceName(savePath)
     };
 
     return storageHolder;
@@ -79,34 +131,107 @@ lt::storage_holder CustomDiskIOThread::new_torrent(const lt::storage_params &sto
 void CustomDiskIOThread::remove_torrent(lt::storage_index_t storage)
 {
     m_nativeDiskIO->remove_torrent(storage);
+
+    if (m_readCache)
+        m_readCache->removeStorage(static_cast<int>(storage));
+
+    const auto storageIter = m_storageData.constFind(storage);
+    if (storageIter == m_storageData.cend())
+        return;
+
+    if (m_statistics)
+        m_statistics->removeTorrent(storageIter->id);
+    m_storageData.erase(storageIter);
 }
 
 void CustomDiskIOThread::async_read(lt::storage_index_t storage, const lt::peer_request &peerRequest
                                     , std::function<void (lt::disk_buffer_holder, const lt::storage_error &)> handler
                                     , lt::disk_job_flags_t flags)
 {
-    m_nativeDiskIO->async_read(storage, peerRequest, std::move(handler), flags);
+    if (m_readCache)
+    {
+        const QByteArray cachedData = m_readCache->read(static_cast<int>(storage), static_cast<int>(peerRequest.piece)
+                                                        , peerRequest.start, peerRequest.length);
+        if (!cachedData.isNull())
+        {
+            // the buffer is released by `free_disk_buffer()` once libtorrent is done with it
+            char *buffer = new char[peerRequest.length];
+            std::memcpy(buffer, cachedData.constData(), peerRequest.length);
+            boost::asio::post(m_ioContext, [this, buffer, length = peerRequest.length, handler = std::move(handler)]()
+            {
+                handler(lt::disk_buffer_holder(*this, buffer, length), {});
+            });
+            return;
+        }
+    }
+
+    const JobTimer jobTimer = startJob(storage, BitTorrent::DiskIOOperation::Read, peerRequest.length);
+    const bool useCache = (m_readCache && !(flags & lt::disk_interface::volatile_read));
+    const quint64 cacheGeneration = useCache ? m_readCache->generation(static_cast<int>(storage)) : 0;
+    m_nativeDiskIO->async_read(storage, peerRequest
+                               , [=, handler = std::move(handler)](lt::disk_buffer_holder buffer, const lt::storage_error &error)
+    {
+        jobTimer.finish(error);
+        if (useCache && !error && buffer)
+        {
+            m_readCache->insert(static_cast<int>(storage), static_cast<int>(peerRequest.piece)
+                                , peerRequest.start, buffer.data(), peerRequest.length, cacheGeneration);
+        }
+        handler(std::move(buffer), error);
+    }, flags);
 }
 
 bool CustomDiskIOThread::async_write(lt::storage_index_t storage, const lt::peer_request &peerRequest
                                      , const char *buf, std::shared_ptr<lt::disk_observer> diskObserver
                                      , std::function<void (const lt::storage_error &)> handler, lt::disk_job_flags_t flags)
 {
-    return m_nativeDiskIO->async_write(storage, peerRequest, buf, diskObserver, std::move(handler), flags);
+    // invalidate the piece when the write completes as well since the read jobs
+    // issued before this write can be completed after it
+    if (m_readCache)
+        m_readCache->removePiece(static_cast<int>(storage), static_cast<int>(peerRequest.piece));
+
+    const JobTimer jobTimer = startJob(storage, BitTorrent::DiskIOOperation::Write, peerRequest.length);
+    return m_nativeDiskIO->async_write(storage, peerRequest, buf, diskObserver
+                                       , [=, handler = std::move(handler)](const lt::storage_error &error)
+    {
+        jobTimer.finish(error);
+        if (m_readCache)
+            m_readCache->removePiece(static_cast<int>(storage), static_cast<int>(peerRequest.piece));
+        handler(error);
+    }, flags);
 }
 
 void CustomDiskIOThread::async_hash(lt::storage_index_t storage, lt::piece_index_t piece
                                     , lt::span<lt::sha256_hash> hash, lt::disk_job_flags_t flags
                                     , std::function<void (lt::piece_index_t, const lt::sha1_hash &, const lt::storage_error &)> handler)
 {
-    m_nativeDiskIO->async_hash(storage, piece, hash, flags, std::move(handler));
+    const auto storageIter = m_storageData.constFind(storage);
+    const qint64 pieceSize = (storageIter != m_storageData.cend()) ? storageIter->files.piece_size(piece) : 0;
+
+    const JobTimer jobTimer = startJob(storage, BitTorrent::DiskIOOperation::Hash, pieceSize);
+    m_nativeDiskIO->async_hash(storage, piece, hash, flags
+                               , [jobTimer, handler = std::move(handler)](lt::piece_index_t piece, const lt::sha1_hash &hash, const lt::storage_error &error)
+    {
+        jobTimer.finish(error);
+        handler(piece, hash, error);
+    });
 }
 
 void CustomDiskIOThread::async_hash2(lt::storage_index_t storage, lt::piece_index_t piece
                                      , int offset, lt::disk_job_flags_t flags
                                      , std::function<void (lt::piece_index_t, const lt::sha256_hash &, const lt::storage_error &)> handler)
 {
-    m_nativeDiskIO->async_hash2(storage, piece, offset, flags, std::move(handler));
+    const auto storageIter = m_storageData.constFind(storage);
+    const qint64 pieceSize = (storageIter != m_storageData.cend()) ? storageIter->files.piece_size(piece) : 0;
+    const qint64 blockSize = std::clamp<qint64>((pieceSize - offset), 0, lt::default_block_size);
+
+    const JobTimer jobTimer = startJob(storage, BitTorrent::DiskIOOperation::Hash, blockSize);
+    m_nativeDiskIO->async_hash2(storage, piece, offset, flags
+                                , [jobTimer, handler = std::move(handler)](lt::piece_index_t piece, const lt::sha256_hash &hash, const lt::storage_error &error)
+    {
+        jobTimer.finish(error);
+        handler(piece, hash, error);
+    });
 }
 
 void CustomDiskIOThread::async_move_storage(lt::storage_index_t storage, std::string path, lt::move_flags_t flags
@@ -117,11 +242,24 @@ void CustomDiskIOThread::async_move_storage(lt::storage_index_t storage, std::st
     if (flags == lt::move_flags_t::dont_replace)
         handleCompleteFiles(storage, newSavePath);
 
+    if (m_readCache)
+        m_readCache->removeStorage(static_cast<int>(storage));
+
+    const auto storageIter = m_storageData.constFind(storage);
+    const qint64 totalSize = (storageIter != m_storageData.cend()) ? storageIter->files.total_size() : 0;
+    const JobTimer jobTimer = startJob(storage, BitTorrent::DiskIOOperation::Move, totalSize);
+
     m_nativeDiskIO->async_move_storage(storage, path, flags
                                        , [=, handler = std::move(handler)](lt::status_t status, const std::string &path, const lt::storage_error &error)
     {
         if (status != lt::status_t::fatal_disk_error)
-            m_storageData[storage].savePath = newSavePath;
+        {
+            jobTimer.finish(error);
+
+            StorageData &storageData = m_storageData[storage];
+            storageData.savePath = newSavePath;
+            storageData.device = deviceName(newSavePath);
+        }
 
         handler(status, path, error);
     });
@@ -129,6 +267,9 @@ void CustomDiskIOThread::async_move_storage(lt::storage_index_t storage, std::st
 
 void CustomDiskIOThread::async_release_files(lt::storage_index_t storage, std::function<void ()> handler)
 {
+    if (m_readCache)
+        m_readCache->removeStorage(static_cast<int>(storage));
+
     m_nativeDiskIO->async_release_files(storage, std::move(handler));
 }
 
@@ -137,11 +278,18 @@ void CustomDiskIOThread::async_check_files(lt::storage_index_t storage, const lt
                                            , std::function<void (lt::status_t, const lt::storage_error &)> handler)
 {
     handleCompleteFiles(storage, m_storageData[storage].savePath);
+
+    if (m_readCache)
+        m_readCache->removeStorage(static_cast<int>(storage));
+
     m_nativeDiskIO->async_check_files(storage, resume_data, links, std::move(handler));
 }
 
 void CustomDiskIOThread::async_stop_torrent(lt::storage_index_t storage, std::function<void ()> handler)
 {
+    if (m_readCache)
+        m_readCache->removeStorage(static_cast<int>(storage));
+
     m_nativeDiskIO->async_stop_torrent(storage, std::move(handler));
 }
 
@@ -160,6 +308,9 @@ void CustomDiskIOThread::async_rename_file(lt::storage_index_t storage, lt::file
 void CustomDiskIOThread::async_delete_files(lt::storage_index_t storage, lt::remove_flags_t options
                                             , std::function<void (const lt::storage_error &)> handler)
 {
+    if (m_readCache)
+        m_readCache->removeStorage(static_cast<int>(storage));
+
     m_nativeDiskIO->async_delete_files(storage, options, std::move(handler));
 }
 
@@ -177,6 +328,9 @@ void CustomDiskIOThread::async_set_file_priority(lt::storage_index_t storage, lt
 void CustomDiskIOThread::async_clear_piece(lt::storage_index_t storage, lt::piece_index_t index
                                            , std::function<void (lt::piece_index_t)> handler)
 {
+    if (m_readCache)
+        m_readCache->removePiece(static_cast<int>(storage), static_cast<int>(index));
+
     m_nativeDiskIO->async_clear_piece(storage, index, std::move(handler));
 }
 
@@ -205,6 +359,34 @@ void CustomDiskIOThread::settings_updated()
     m_nativeDiskIO->settings_updated();
 }
 
+void CustomDiskIOThread::free_disk_buffer(char *buffer)
+{
+    // only the buffers served from read cache are allocated here
+    delete[] buffer;
+}
+
+CustomDiskIOThread::JobTimer CustomDiskIOThread::startJob(const lt::storage_index_t storage
+        , const BitTorrent::DiskIOOperation operation, const qint64 bytes) const
+{
+    const auto storageIter = m_storageData.constFind(storage);
+    if (storageIter == m_storageData.cend())
+        return {nullptr, {}, {}, operation, bytes};
+
+    return {m_statistics, storageIter->id, storageIter->device, operation, bytes};
+}
+
+QString CustomDiskIOThread::deviceName(const Path &savePath)
+{
+    // Looking up the device is rather expensive and most torrents share a few save paths
+    const auto deviceIter = m_deviceNames.constFind(savePath);
+    if (deviceIter != m_deviceNames.cend())
+        return deviceIter.value();
+
+    const QString device = Utils::Fs::storageDeviceName(savePath);
+    m_deviceNames.insert(savePath, device);
+    return device;
+}
+
 void CustomDiskIOThread::handleCompleteFiles(lt::storage_index_t storage, const Path &savePath)
 {
     const StorageData storageData = m_storageData[storage];
@@ -241,6 +423,7 @@ lt::storage_interface *customStorageConstructor(const lt::storage_params &params
 
 CustomStorage::CustomStorage(const lt::storage_params &params, lt::file_pool &filePool)
     : lt::default_storage {params, filePool}
+    , m_filePool {filePool}
     , m_savePath {params.path}
 {
 }
@@ -264,13 +447,78 @@ lt::status_t CustomStorage::move_storage(const std::string &savePath, lt::move_f
     if (flags == lt::move_flags_t::dont_replace)
         handleCompleteFiles(newSavePath);
 
-    const lt::status_t ret = lt::default_storage::move_storage(savePath, flags, ec);
+    const bool hasExistingFiles = moveFiles(newSavePath, flags);
+
+    lt::status_t ret = lt::default_storage::move_storage(savePath, flags, ec);
+    // With "dont_replace" libtorrent requests full check when it finds the files at the destination.
+    // If they all were moved there by us they are the same files, so there is nothing to check.
+    if ((ret == lt::status_t::need_full_check) && !hasExistingFiles)
+    {
+        ret = lt::status_t::no_error;
+        ec.ec.clear();
+    }
+
     if (ret != lt::status_t::fatal_disk_error)
         m_savePath = newSavePath;
 
     return ret;
 }
 
+// Moves the files ahead of libtorrent which then only has to move the rest (e.g. the part file)
+// and to remove the old directories. It's done to copy the files between devices using
+// `Utils::Fs::moveFile()` which lets the kernel clone or copy them instead of reading them in.
+// The files that already exist at the destination are left to libtorrent to handle them according to `flags`.
+// Returns true if there are such files.
+bool CustomStorage::moveFiles(const Path &newSavePath, const lt::move_flags_t flags)
+{
+    QVector<QPair<Path, Path>> moves;
+    bool hasExistingFiles = false;
+
+    const lt::file_storage &fileStorage = files();
+    for (const lt::file_index_t fileIndex : fileStorage.file_range())
+    {
+        if (fileStorage.pad_file_at(fileIndex) || fileStorage.file_absolute_path(fileIndex))
+            continue;
+
+        const Path filePath {fileStorage.file_path(fileIndex)};
+        const Path destinationPath = newSavePath / filePath;
+        if (destinationPath.exists())
+        {
+            // libtorrent won't move anything in this case
+            if (flags == lt::move_flags_t::fail_if_exist)
+                return true;
+
+            hasExistingFiles = true;
+            continue;
+        }
+
+        const Path sourcePath = m_savePath / filePath;
+        if (!sourcePath.exists())
+            continue;
+
+        moves.append({sourcePath, destinationPath});
+    }
+
+    if (moves.isEmpty())
+        return hasExistingFiles;
+
+    m_filePool.release(storage_index());
+
+    for (auto iter = moves.cbegin(); iter != moves.cend(); ++iter)
+    {
+        Utils::Fs::mkpath(iter->second.parentPath());
+        if (!Utils::Fs::moveFile(iter->first, iter->second))
+        {
+            // put the files back so libtorrent finds them where it expects them and reports the error itself
+            for (auto movedIter = moves.cbegin(); movedIter != iter; ++movedIter)
+                Utils::Fs::moveFile(movedIter->second, movedIter->first);
+            break;
+        }
+    }
+
+    return hasExistingFiles;
+}
+
 void CustomStorage::handleCompleteFiles(const Path &savePath)
 {
     const lt::file_storage &fileStorage = files();
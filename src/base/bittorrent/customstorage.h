@@ -36,29 +36,38 @@
 #include "base/path.h"
 
 #ifdef QBT_USES_LIBTORRENT2
+#include <libtorrent/disk_buffer_holder.hpp>
 #include <libtorrent/disk_interface.hpp>
 #include <libtorrent/file_storage.hpp>
 #include <libtorrent/io_context.hpp>
 
 #include <QHash>
 
+#include "diskiostatistics.h"
+#include "diskreadcache.h"
+#include "infohash.h"
 #include "ltqhash.h"
 #else
+#include <libtorrent/file_pool.hpp>
 #include <libtorrent/storage.hpp>
 #endif
 
 #ifdef QBT_USES_LIBTORRENT2
 std::unique_ptr<lt::disk_interface> customDiskIOConstructor(
-        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters);
+        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters
+        , BitTorrent::DiskIOStatistics *statistics, BitTorrent::DiskReadCache *readCache);
 std::unique_ptr<lt::disk_interface> customPosixDiskIOConstructor(
-        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters);
+        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters
+        , BitTorrent::DiskIOStatistics *statistics, BitTorrent::DiskReadCache *readCache);
 std::unique_ptr<lt::disk_interface> customMMapDiskIOConstructor(
-        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters);
+        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters
+        , BitTorrent::DiskIOStatistics *statistics, BitTorrent::DiskReadCache *readCache);
 
-class CustomDiskIOThread final : public lt::disk_interface
+class CustomDiskIOThread final : public lt::disk_interface, public lt::buffer_allocator_interface
 {
 public:
-    explicit CustomDiskIOThread(std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread);
+    CustomDiskIOThread(lt::io_context &ioContext, std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread
+                       , BitTorrent::DiskIOStatistics *statistics, BitTorrent::DiskReadCache *readCache);
 
     lt::storage_holder new_torrent(const lt::storage_params &storageParams, const std::shared_ptr<void> &torrent) override;
     void remove_torrent(lt::storage_index_t storageIndex) override;
@@ -91,18 +100,30 @@ public:
     void submit_jobs() override;
     void settings_updated() override;
 
+    void free_disk_buffer(char *buffer) override;
+
 private:
+    class JobTimer;
+
     void handleCompleteFiles(libtorrent::storage_index_t storage, const Path &savePath);
+    JobTimer startJob(lt::storage_index_t storage, BitTorrent::DiskIOOperation operation, qint64 bytes) const;
+    QString deviceName(const Path &savePath);
 
+    lt::io_context &m_ioContext;
     std::unique_ptr<lt::disk_interface> m_nativeDiskIO;
+    BitTorrent::DiskIOStatistics *m_statistics = nullptr;
+    BitTorrent::DiskReadCache *m_readCache = nullptr;
 
     struct StorageData
     {
         Path savePath;
         lt::file_storage files;
         lt::aux::vector<lt::download_priority_t, lt::file_index_t> filePriorities;
+        BitTorrent::TorrentID id;
+        QString device;
     };
     QHash<lt::storage_index_t, StorageData> m_storageData;
+    QHash<Path, QString> m_deviceNames;
 };
 
 #else
@@ -120,7 +141,9 @@ public:
 
 private:
     void handleCompleteFiles(const Path &savePath);
+    bool moveFiles(const Path &newSavePath, lt::move_flags_t flags);
 
+    lt::file_pool &m_filePool;
     lt::aux::vector<lt::download_priority_t, lt::file_index_t> m_filePriorities;
     Path m_savePath;
 };
@@ -54,6 +54,7 @@
 #include "base/profile.h"
 #include "base/utils/fs.h"
 #include "base/utils/string.h"
+#include "filefingerprint.h"
 #include "infohash.h"
 #include "loadtorrentparams.h"
 
@@ -238,6 +239,9 @@ namespace BitTorrent
             p.save_path = Profile::instance()->fromPortablePath(Path(fromLTString(p.save_path)))
                     .toString().toStdString();
 
+            // qBittorrent specific data which doesn't need a separate column
+            resumeData.fileFingerprints = fileFingerprintsFromNode(root.dict_find_list("qBt-fileFingerprints"));
+
             return resumeData;
         }
     }
@@ -605,6 +609,7 @@ void BitTorrent::DBResumeDataStorage::Worker::store(const TorrentID &id, const L
     };
 
     lt::entry data = lt::write_resume_data(p);
+    data["qBt-fileFingerprints"] = fileFingerprintsToEntry(resumeData.fileFingerprints);
 
     // metadata is stored in separate column
     QByteArray bencodedMetadata;
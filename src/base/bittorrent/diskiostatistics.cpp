@@ -0,0 +1,86 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "diskiostatistics.h"
+
+#include <QMutexLocker>
+
+using namespace BitTorrent;
+
+DiskIOOperationStatus &DiskIOStatus::operator[](const DiskIOOperation operation)
+{
+    switch (operation)
+    {
+    case DiskIOOperation::Read:
+        return read;
+    case DiskIOOperation::Write:
+        return write;
+    case DiskIOOperation::Hash:
+        return hash;
+    case DiskIOOperation::Move:
+        return move;
+    }
+
+    Q_ASSERT(false);
+    return read;
+}
+
+void DiskIOStatistics::record(const TorrentID &id, const QString &device
+        , const DiskIOOperation operation, const qint64 latency, const qint64 bytes)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    DiskIOOperationStatus &torrentStatus = m_torrentStatus[id][operation];
+    torrentStatus.latency.record(latency);
+    torrentStatus.bytes += bytes;
+
+    if (!device.isEmpty())
+    {
+        DiskIOOperationStatus &deviceStatus = m_deviceStatus[device][operation];
+        deviceStatus.latency.record(latency);
+        deviceStatus.bytes += bytes;
+    }
+}
+
+void DiskIOStatistics::removeTorrent(const TorrentID &id)
+{
+    const QMutexLocker locker {&m_mutex};
+    m_torrentStatus.remove(id);
+}
+
+DiskIOStatus DiskIOStatistics::torrentStatus(const TorrentID &id) const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_torrentStatus.value(id);
+}
+
+QHash<QString, DiskIOStatus> DiskIOStatistics::deviceStatus() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_deviceStatus;
+}
@@ -0,0 +1,85 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include "base/latencyhistogram.h"
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    enum class DiskIOOperation
+    {
+        Read,
+        Write,
+        Hash,
+        Move
+    };
+
+    struct DiskIOOperationStatus
+    {
+        LatencyHistogram latency;  // in microseconds
+        qint64 bytes = 0;
+    };
+
+    struct DiskIOStatus
+    {
+        DiskIOOperationStatus read;
+        DiskIOOperationStatus write;
+        DiskIOOperationStatus hash;
+        DiskIOOperationStatus move;
+
+        DiskIOOperationStatus &operator[](DiskIOOperation operation);
+    };
+
+    // Collects latencies of the disk jobs issued by libtorrent.
+    // Jobs are recorded from the libtorrent network thread while the snapshots
+    // are taken from the main thread, so all access is serialized.
+    class DiskIOStatistics
+    {
+        Q_DISABLE_COPY_MOVE(DiskIOStatistics)
+
+    public:
+        DiskIOStatistics() = default;
+
+        void record(const TorrentID &id, const QString &device, DiskIOOperation operation, qint64 latency, qint64 bytes);
+        void removeTorrent(const TorrentID &id);
+
+        DiskIOStatus torrentStatus(const TorrentID &id) const;
+        QHash<QString, DiskIOStatus> deviceStatus() const;
+
+    private:
+        mutable QMutex m_mutex;
+        QHash<TorrentID, DiskIOStatus> m_torrentStatus;
+        QHash<QString, DiskIOStatus> m_deviceStatus;
+    };
+}
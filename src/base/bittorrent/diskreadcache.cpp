@@ -0,0 +1,254 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "diskreadcache.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <QMutexLocker>
+
+#include "base/global.h"
+
+using namespace BitTorrent;
+
+namespace
+{
+    // the rest is left for the blocks which were requested only once
+    const int PROTECTED_SEGMENT_PERCENT = 80;
+
+    quint64 makePieceKey(const int storage, const int piece)
+    {
+        return (static_cast<quint64>(static_cast<quint32>(storage)) << 32) | static_cast<quint32>(piece);
+    }
+
+    int storageFromPieceKey(const quint64 pieceKey)
+    {
+        return static_cast<int>(pieceKey >> 32);
+    }
+}
+
+qint64 DiskReadCache::capacity() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_capacity;
+}
+
+void DiskReadCache::setCapacity(const qint64 capacity)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    m_capacity = std::max<qint64>(0, capacity);
+    evict();
+}
+
+QByteArray DiskReadCache::read(const int storage, const int piece, const int offset, const int length)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    if (m_capacity <= 0)
+        return {};
+
+    const auto pieceIter = m_index.constFind(makePieceKey(storage, piece));
+    if (pieceIter != m_index.cend())
+    {
+        const auto blockIter = pieceIter->constFind(offset);
+        if ((blockIter != pieceIter->cend()) && (blockIter.value()->data.size() >= length))
+        {
+            const BlockList::iterator block = blockIter.value();
+            promote(block);
+            ++m_hits;
+            return block->data;
+        }
+    }
+
+    ++m_misses;
+    return {};
+}
+
+void DiskReadCache::insert(const int storage, const int piece, const int offset, const char *data, const int length)
+{
+    const QMutexLocker locker {&m_mutex};
+    insertBlock(makePieceKey(storage, piece), offset, data, length);
+}
+
+quint64 DiskReadCache::generation(const int storage) const
+{
+    const QMutexLocker locker {&m_mutex};
+    return currentGeneration(storage);
+}
+
+void DiskReadCache::insert(const int storage, const int piece, const int offset, const char *data, const int length
+        , const quint64 readGeneration)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    // the data could be read before it was overwritten
+    if (readGeneration != currentGeneration(storage))
+        return;
+
+    insertBlock(makePieceKey(storage, piece), offset, data, length);
+}
+
+void DiskReadCache::removePiece(const int storage, const int piece)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    invalidate(storage);
+
+    const QHash<int, BlockList::iterator> pieceBlocks = m_index.take(makePieceKey(storage, piece));
+    for (const BlockList::iterator &block : pieceBlocks)
+        eraseBlock(block);
+}
+
+void DiskReadCache::removeStorage(const int storage)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    invalidate(storage);
+
+    for (auto pieceIter = m_index.begin(); pieceIter != m_index.end();)
+    {
+        if (storageFromPieceKey(pieceIter.key()) != storage)
+        {
+            ++pieceIter;
+            continue;
+        }
+
+        for (const BlockList::iterator &block : asConst(pieceIter.value()))
+            eraseBlock(block);
+        pieceIter = m_index.erase(pieceIter);
+    }
+}
+
+void DiskReadCache::clear()
+{
+    const QMutexLocker locker {&m_mutex};
+
+    m_storageGenerations.clear();
+    m_clearGeneration = ++m_lastGeneration;
+
+    m_index.clear();
+    m_probationBlocks.clear();
+    m_protectedBlocks.clear();
+    m_size = 0;
+    m_protectedSize = 0;
+}
+
+DiskReadCacheStatus DiskReadCache::status() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return {m_hits, m_misses, m_size, m_capacity};
+}
+
+quint64 DiskReadCache::currentGeneration(const int storage) const
+{
+    return std::max(m_storageGenerations.value(storage, 0), m_clearGeneration);
+}
+
+void DiskReadCache::invalidate(const int storage)
+{
+    m_storageGenerations[storage] = ++m_lastGeneration;
+}
+
+void DiskReadCache::insertBlock(const quint64 pieceKey, const int offset, const char *data, const int length)
+{
+    if ((length <= 0) || (length > m_capacity))
+        return;
+
+    QHash<int, BlockList::iterator> &pieceBlocks = m_index[pieceKey];
+    if (pieceBlocks.contains(offset))
+        return;
+
+    m_probationBlocks.push_front({pieceKey, offset, QByteArray(data, length)});
+    pieceBlocks.insert(offset, m_probationBlocks.begin());
+    m_size += length;
+
+    evict();
+}
+
+void DiskReadCache::promote(const BlockList::iterator blockIter)
+{
+    if (blockIter->isProtected)
+    {
+        m_protectedBlocks.splice(m_protectedBlocks.begin(), m_protectedBlocks, blockIter);
+        return;
+    }
+
+    blockIter->isProtected = true;
+    m_protectedSize += blockIter->data.size();
+    m_protectedBlocks.splice(m_protectedBlocks.begin(), m_probationBlocks, blockIter);
+
+    // demote least recently used protected blocks so they get another chance before eviction
+    const qint64 maxProtectedSize = m_capacity * PROTECTED_SEGMENT_PERCENT / 100;
+    while ((m_protectedSize > maxProtectedSize) && (m_protectedBlocks.size() > 1))
+    {
+        const BlockList::iterator demotedBlock = std::prev(m_protectedBlocks.end());
+        demotedBlock->isProtected = false;
+        m_protectedSize -= demotedBlock->data.size();
+        m_probationBlocks.splice(m_probationBlocks.begin(), m_protectedBlocks, demotedBlock);
+    }
+}
+
+void DiskReadCache::removeBlock(const BlockList::iterator blockIter)
+{
+    const auto pieceIter = m_index.find(blockIter->pieceKey);
+    if (pieceIter != m_index.end())
+    {
+        pieceIter->remove(blockIter->offset);
+        if (pieceIter->isEmpty())
+            m_index.erase(pieceIter);
+    }
+
+    eraseBlock(blockIter);
+}
+
+void DiskReadCache::eraseBlock(const BlockList::iterator blockIter)
+{
+    m_size -= blockIter->data.size();
+    if (blockIter->isProtected)
+    {
+        m_protectedSize -= blockIter->data.size();
+        m_protectedBlocks.erase(blockIter);
+    }
+    else
+    {
+        m_probationBlocks.erase(blockIter);
+    }
+}
+
+void DiskReadCache::evict()
+{
+    while (m_size > m_capacity)
+    {
+        if (!m_probationBlocks.empty())
+            removeBlock(std::prev(m_probationBlocks.end()));
+        else
+            removeBlock(std::prev(m_protectedBlocks.end()));
+    }
+}
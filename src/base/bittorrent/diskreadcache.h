@@ -0,0 +1,114 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <list>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QtGlobal>
+
+namespace BitTorrent
+{
+    struct DiskReadCacheStatus
+    {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 size = 0;
+        qint64 capacity = 0;
+    };
+
+    // Size bounded cache of blocks read from disk.
+    // It uses segmented LRU eviction: blocks are inserted into "probationary" segment
+    // and promoted to "protected" one when they are requested again, so the blocks
+    // of popular pieces survive sequential reads of the rarely requested ones.
+    // It is accessed by libtorrent network thread and configured from the main thread.
+    class DiskReadCache
+    {
+        Q_DISABLE_COPY_MOVE(DiskReadCache)
+
+    public:
+        DiskReadCache() = default;
+
+        qint64 capacity() const;
+        void setCapacity(qint64 capacity);
+
+        // returns null array on cache miss, the returned data can be larger than `length`
+        QByteArray read(int storage, int piece, int offset, int length);
+        void insert(int storage, int piece, int offset, const char *data, int length);
+        // The storage generation changes each time its data is invalidated. The data read from disk
+        // is inserted with the generation taken before the read was issued, so it is dropped
+        // if a write invalidated the storage while the read was in flight.
+        quint64 generation(int storage) const;
+        void insert(int storage, int piece, int offset, const char *data, int length, quint64 readGeneration);
+
+        void removePiece(int storage, int piece);
+        void removeStorage(int storage);
+        void clear();
+
+        DiskReadCacheStatus status() const;
+
+    private:
+        struct Block
+        {
+            quint64 pieceKey;
+            int offset;
+            QByteArray data;
+            bool isProtected = false;
+        };
+
+        using BlockList = std::list<Block>;
+
+        quint64 currentGeneration(int storage) const;
+        void invalidate(int storage);
+        void insertBlock(quint64 pieceKey, int offset, const char *data, int length);
+        void promote(BlockList::iterator blockIter);
+        void removeBlock(BlockList::iterator blockIter);
+        void eraseBlock(BlockList::iterator blockIter);
+        void evict();
+
+        mutable QMutex m_mutex;
+
+        // most recently used blocks are at the front
+        BlockList m_probationBlocks;
+        BlockList m_protectedBlocks;
+        QHash<quint64, QHash<int, BlockList::iterator>> m_index;
+
+        QHash<int, quint64> m_storageGenerations;
+        quint64 m_clearGeneration = 0;
+        quint64 m_lastGeneration = 0;
+
+        qint64 m_capacity = 0;
+        qint64 m_size = 0;
+        qint64 m_protectedSize = 0;
+        qint64 m_hits = 0;
+        qint64 m_misses = 0;
+    };
+}
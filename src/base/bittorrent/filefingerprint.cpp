@@ -0,0 +1,98 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "filefingerprint.h"
+
+#include <utility>
+
+#include <libtorrent/bdecode.hpp>
+#include <libtorrent/entry.hpp>
+
+#include <QDateTime>
+#include <QFileInfo>
+
+bool BitTorrent::FileFingerprint::isValid() const
+{
+    return (size >= 0);
+}
+
+BitTorrent::FileFingerprint BitTorrent::FileFingerprint::fromFile(const Path &path)
+{
+    const QFileInfo fileInfo {path.data()};
+    if (!fileInfo.isFile())
+        return {};
+
+    return {fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch()};
+}
+
+bool BitTorrent::operator==(const FileFingerprint &left, const FileFingerprint &right)
+{
+    return (left.size == right.size) && (left.lastModified == right.lastModified);
+}
+
+bool BitTorrent::operator!=(const FileFingerprint &left, const FileFingerprint &right)
+{
+    return !(left == right);
+}
+
+lt::entry BitTorrent::fileFingerprintsToEntry(const QVector<FileFingerprint> &fingerprints)
+{
+    lt::entry::list_type fingerprintList;
+    fingerprintList.reserve(fingerprints.size());
+    for (const FileFingerprint &fingerprint : fingerprints)
+    {
+        lt::entry::list_type item;
+        if (fingerprint.isValid())
+        {
+            item.emplace_back(static_cast<lt::entry::integer_type>(fingerprint.size));
+            item.emplace_back(static_cast<lt::entry::integer_type>(fingerprint.lastModified));
+        }
+        fingerprintList.emplace_back(std::move(item));
+    }
+
+    return fingerprintList;
+}
+
+QVector<BitTorrent::FileFingerprint> BitTorrent::fileFingerprintsFromNode(const lt::bdecode_node &node)
+{
+    if (node.type() != lt::bdecode_node::list_t)
+        return {};
+
+    QVector<FileFingerprint> fingerprints;
+    fingerprints.reserve(node.list_size());
+    for (int i = 0; i < node.list_size(); ++i)
+    {
+        const lt::bdecode_node item = node.list_at(i);
+        if ((item.type() == lt::bdecode_node::list_t) && (item.list_size() == 2))
+            fingerprints.append({item.list_int_value_at(0), item.list_int_value_at(1)});
+        else
+            fingerprints.append({});
+    }
+
+    return fingerprints;
+}
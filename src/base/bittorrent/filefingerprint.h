@@ -0,0 +1,59 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <libtorrent/fwd.hpp>
+
+#include <QtGlobal>
+#include <QVector>
+
+#include "base/path.h"
+
+namespace BitTorrent
+{
+    // Size and modification time of a file at the moment its content was known to be valid.
+    // A file whose fingerprint hasn't changed since then is assumed to be unmodified.
+    struct FileFingerprint
+    {
+        qint64 size = -1;
+        qint64 lastModified = 0;  // milliseconds since epoch
+
+        bool isValid() const;
+
+        static FileFingerprint fromFile(const Path &path);
+    };
+
+    bool operator==(const FileFingerprint &left, const FileFingerprint &right);
+    bool operator!=(const FileFingerprint &left, const FileFingerprint &right);
+
+    // Fingerprints are stored in resume data as a list of [size, mtime] lists,
+    // an empty list stands for a file with unknown fingerprint
+    lt::entry fileFingerprintsToEntry(const QVector<FileFingerprint> &fingerprints);
+    QVector<FileFingerprint> fileFingerprintsFromNode(const lt::bdecode_node &node);
+}
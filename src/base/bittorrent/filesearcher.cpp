@@ -27,22 +27,85 @@
  */
 
 #include "filesearcher.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include <QDir>
+#include <QHash>
+#include <QSet>
+#include <QThreadPool>
+
 #include "base/bittorrent/common.h"
-#include "base/bittorrent/infohash.h"
 
-void FileSearcher::search(const BitTorrent::TorrentID &id, const PathList &originalFileNames
-                          , const Path &savePath, const Path &downloadPath)
+namespace
 {
-    const auto findInDir = [](const Path &dirPath, PathList &fileNames) -> bool
+    // Network file systems benefit from several outstanding requests
+    // but too many of them can overload local disks
+    const int MAX_LISTING_THREADS = 4;
+
+    // Names are matched the same way the file system matches them
+    QString matchingKey(const QString &fileName)
+    {
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+        return fileName.toLower();
+#else
+        return fileName;
+#endif
+    }
+
+    using DirectoryListing = QSet<QString>;
+    using DirectoryListings = QHash<Path, DirectoryListing>;
+
+    // Lists every directory only once instead of querying each file separately
+    DirectoryListings listDirectories(const QSet<Path> &dirPaths)
+    {
+        DirectoryListings listings;
+        for (const Path &dirPath : dirPaths)
+            listings.insert(dirPath, {});
+
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(MAX_LISTING_THREADS);
+        for (auto iter = listings.begin(); iter != listings.end(); ++iter)
+        {
+            // every task fills in its own preallocated item so no locking is required
+            const Path dirPath = iter.key();
+            DirectoryListing *listing = &iter.value();
+            threadPool.start([dirPath, listing]()
+            {
+                const QStringList fileNames = QDir(dirPath.data()).entryList((QDir::Files | QDir::Hidden | QDir::System));
+                listing->reserve(fileNames.size());
+                for (const QString &fileName : fileNames)
+                    listing->insert(matchingKey(fileName));
+            });
+        }
+        threadPool.waitForDone();
+
+        return listings;
+    }
+
+    bool existsInDir(const DirectoryListings &listings, const Path &dirPath, const Path &fileName)
+    {
+        const Path filePath = dirPath / fileName;
+        const DirectoryListing listing = listings.value(filePath.parentPath());
+        const QString key = matchingKey(filePath.filename());
+        return listing.contains(key) || listing.contains(key + matchingKey(QB_EXT));
+    }
+
+    bool findInDir(const DirectoryListings &listings, const Path &dirPath, PathList &fileNames)
     {
         bool found = false;
         for (Path &fileName : fileNames)
         {
-            if ((dirPath / fileName).exists())
+            const Path filePath = dirPath / fileName;
+            const DirectoryListing listing = listings.value(filePath.parentPath());
+            const QString key = matchingKey(filePath.filename());
+            if (listing.contains(key))
             {
                 found = true;
             }
-            else if ((dirPath / fileName + QB_EXT).exists())
+            else if (listing.contains(key + matchingKey(QB_EXT)))
             {
                 found = true;
                 fileName = fileName + QB_EXT;
@@ -50,16 +113,100 @@ void FileSearcher::search(const BitTorrent::TorrentID &id, const PathList &origi
         }
 
         return found;
-    };
+    }
+}
 
-    Path usedPath = savePath;
-    PathList adjustedFileNames = originalFileNames;
-    const bool found = findInDir(usedPath, adjustedFileNames);
-    if (!found && !downloadPath.isEmpty())
+FileSearcher::FileSearcher()
+{
+    m_reuseThreadPool.setMaxThreadCount(MAX_LISTING_THREADS);
+}
+
+void FileSearcher::search(const BitTorrent::TorrentID &id, const PathList &originalFileNames
+                          , const Path &savePath, const Path &downloadPath
+                          , const QVector<BitTorrent::ContentReuseCandidate> &reuseCandidates)
+{
+    // Requests which come while the searcher is busy are processed together
+    // so that directories shared by several torrents are listed only once
+    if (m_pendingRequests.isEmpty())
+        QMetaObject::invokeMethod(this, &FileSearcher::processPendingRequests, Qt::QueuedConnection);
+
+    m_pendingRequests.append({id, originalFileNames, savePath, downloadPath, reuseCandidates});
+}
+
+void FileSearcher::processPendingRequests()
+{
+    const QVector<SearchRequest> requests = std::exchange(m_pendingRequests, {});
+
+    // Candidate roots are listed at the same time, so the download path
+    // doesn't have to wait until the save path is searched
+    QSet<Path> dirPaths;
+    for (const SearchRequest &request : requests)
     {
-        usedPath = downloadPath;
-        findInDir(usedPath, adjustedFileNames);
+        for (const Path &fileName : request.originalFileNames)
+        {
+            dirPaths.insert((request.savePath / fileName).parentPath());
+            if (!request.downloadPath.isEmpty())
+                dirPaths.insert((request.downloadPath / fileName).parentPath());
+        }
     }
 
-    emit searchFinished(id, usedPath, adjustedFileNames);
+    const DirectoryListings listings = listDirectories(dirPaths);
+
+    for (const SearchRequest &request : requests)
+    {
+        Path usedPath = request.savePath;
+        PathList adjustedFileNames = request.originalFileNames;
+        const bool found = findInDir(listings, usedPath, adjustedFileNames);
+        if (!found && !request.downloadPath.isEmpty())
+        {
+            usedPath = request.downloadPath;
+            findInDir(listings, usedPath, adjustedFileNames);
+        }
+
+        QVector<ReuseJob> reuseJobs;
+        for (const BitTorrent::ContentReuseCandidate &candidate : request.reuseCandidates)
+        {
+            const Path fileName = request.originalFileNames.at(candidate.fileIndex);
+            if (!existsInDir(listings, usedPath, fileName))
+                reuseJobs.append({candidate, (usedPath / fileName)});
+        }
+
+        // copying of the files takes a while so the other torrents don't wait for it
+        if (reuseJobs.isEmpty())
+            emit searchFinished(request.id, usedPath, adjustedFileNames);
+        else
+            reuseContent(request.id, usedPath, adjustedFileNames, reuseJobs);
+    }
+}
+
+// Missing files are taken from existing torrents before the torrent is checked.
+// Every file has to be hashed so the files are verified in parallel
+// and the search is finished when the last of them is done.
+void FileSearcher::reuseContent(const BitTorrent::TorrentID &id, const Path &savePath, const PathList &fileNames
+                                , const QVector<ReuseJob> &reuseJobs)
+{
+    struct ReuseState
+    {
+        std::atomic_int remainingJobs {0};
+        std::atomic<qint64> reusedBytes {0};
+    };
+
+    const auto state = std::make_shared<ReuseState>();
+    state->remainingJobs = reuseJobs.size();
+    for (const ReuseJob &job : reuseJobs)
+    {
+        m_reuseThreadPool.start([this, job, state, id, savePath, fileNames]()
+        {
+            state->reusedBytes += BitTorrent::reuseFileContent(job.candidate, job.targetPath);
+            if (--state->remainingJobs > 0)
+                return;
+
+            QMetaObject::invokeMethod(this, [this, id, savePath, fileNames, reusedBytes = state->reusedBytes.load()]()
+            {
+                if (reusedBytes > 0)
+                    emit contentReused(id, reusedBytes);
+                emit searchFinished(id, savePath, fileNames);
+            }, Qt::QueuedConnection);
+        });
+    }
 }
@@ -29,26 +29,51 @@
 #pragma once
 
 #include <QObject>
+#include <QThreadPool>
+#include <QVector>
 
+#include "base/bittorrent/contentreuse.h"
+#include "base/bittorrent/infohash.h"
 #include "base/path.h"
 
-namespace BitTorrent
-{
-    class TorrentID;
-}
-
 class FileSearcher final : public QObject
 {
     Q_OBJECT
     Q_DISABLE_COPY_MOVE(FileSearcher)
 
 public:
-    FileSearcher() = default;
+    FileSearcher();
 
 public slots:
     void search(const BitTorrent::TorrentID &id, const PathList &originalFileNames
-                , const Path &savePath, const Path &downloadPath);
+                , const Path &savePath, const Path &downloadPath
+                , const QVector<BitTorrent::ContentReuseCandidate> &reuseCandidates = {});
 
 signals:
     void searchFinished(const BitTorrent::TorrentID &id, const Path &savePath, const PathList &fileNames);
+    void contentReused(const BitTorrent::TorrentID &id, qint64 reusedBytes);
+
+private:
+    struct SearchRequest
+    {
+        BitTorrent::TorrentID id;
+        PathList originalFileNames;
+        Path savePath;
+        Path downloadPath;
+        QVector<BitTorrent::ContentReuseCandidate> reuseCandidates;
+    };
+
+    struct ReuseJob
+    {
+        BitTorrent::ContentReuseCandidate candidate;
+        Path targetPath;
+    };
+
+    void processPendingRequests();
+    void reuseContent(const BitTorrent::TorrentID &id, const Path &savePath, const PathList &fileNames
+                      , const QVector<ReuseJob> &reuseJobs);
+
+    QVector<SearchRequest> m_pendingRequests;
+    // it waits for the running jobs when destroyed, so the searcher outlives them
+    QThreadPool m_reuseThreadPool;
 };
@@ -31,9 +31,11 @@
 #include <libtorrent/add_torrent_params.hpp>
 
 #include <QString>
+#include <QVector>
 
 #include "base/path.h"
 #include "base/tagset.h"
+#include "filefingerprint.h"
 #include "torrent.h"
 #include "torrentcontentlayout.h"
 
@@ -58,6 +60,8 @@ namespace BitTorrent
         qreal ratioLimit = Torrent::USE_GLOBAL_RATIO;
         int seedingTimeLimit = Torrent::USE_GLOBAL_SEEDING_TIME;
 
+        QVector<FileFingerprint> fileFingerprints;
+
         bool restored = false;  // is existing torrent job?
     };
 }
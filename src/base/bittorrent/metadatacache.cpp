@@ -0,0 +1,200 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "metadatacache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QVector>
+
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/utils/fs.h"
+#include "base/utils/io.h"
+
+namespace
+{
+    // v1 info hash is preferred for hybrid torrents
+    QStringList cacheKeys(const BitTorrent::InfoHash &infoHash)
+    {
+        QStringList keys;
+        if (const SHA1Hash v1 = infoHash.v1(); v1.isValid())
+            keys.append(v1.toString());
+        if (const SHA256Hash v2 = infoHash.v2(); v2.isValid())
+            keys.append(v2.toString());
+        return keys;
+    }
+}
+
+BitTorrent::MetadataCache::MetadataCache(const Path &dirPath, const qint64 maxSize)
+    : m_dirPath {dirPath}
+    , m_maxSize {maxSize}
+{
+    Utils::Fs::mkpath(m_dirPath);
+
+    const QFileInfoList fileInfos = QDir(m_dirPath.data()).entryInfoList({u"*.torrent"_qs}, QDir::Files);
+    for (const QFileInfo &fileInfo : fileInfos)
+        insertEntry(fileInfo.completeBaseName(), {fileInfo.size(), fileInfo.lastModified()});
+
+    evict();
+}
+
+std::optional<BitTorrent::TorrentInfo> BitTorrent::MetadataCache::find(const InfoHash &infoHash)
+{
+    if (m_maxSize <= 0)
+        return std::nullopt;
+
+    for (const QString &key : asConst(cacheKeys(infoHash)))
+    {
+        if (!m_entries.contains(key))
+            continue;
+
+        const Path path = filePath(key);
+        const nonstd::expected<TorrentInfo, QString> loadResult = TorrentInfo::loadFromFile(path);
+        if (!loadResult || !cacheKeys(loadResult.value().infoHash()).contains(key))
+        {
+            LogMsg(tr("Removed invalid torrent metadata from cache. File: \"%1\"").arg(path.toString()), Log::WARNING);
+            Utils::Fs::removeFile(path);
+            removeEntry(key);
+            continue;
+        }
+
+        touch(key);
+        return loadResult.value();
+    }
+
+    return std::nullopt;
+}
+
+void BitTorrent::MetadataCache::store(const TorrentInfo &metadata)
+{
+    if ((m_maxSize <= 0) || !metadata.isValid())
+        return;
+
+    const QStringList keys = cacheKeys(metadata.infoHash());
+    if (keys.isEmpty())
+        return;
+
+    const QString key = keys.first();
+    if (m_entries.contains(key))
+    {
+        touch(key);
+        return;
+    }
+
+    // Only the info dictionary is stored since it is all that peers provide
+    const QByteArray data = "d4:info" + metadata.metadata() + 'e';
+    if (data.size() > m_maxSize)
+        return;
+
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(filePath(key), data);
+    if (!result)
+    {
+        LogMsg(tr("Failed to store torrent metadata in cache. Torrent: \"%1\". Reason: \"%2\"")
+               .arg(metadata.name(), result.error()), Log::WARNING);
+        return;
+    }
+
+    insertEntry(key, {data.size(), QDateTime::currentDateTime()});
+    evict();
+}
+
+qint64 BitTorrent::MetadataCache::maxSize() const
+{
+    return m_maxSize;
+}
+
+void BitTorrent::MetadataCache::setMaxSize(const qint64 maxSize)
+{
+    m_maxSize = maxSize;
+    evict();
+}
+
+qint64 BitTorrent::MetadataCache::size() const
+{
+    return m_size;
+}
+
+Path BitTorrent::MetadataCache::filePath(const QString &key) const
+{
+    return m_dirPath / Path(key + u".torrent"_qs);
+}
+
+void BitTorrent::MetadataCache::insertEntry(const QString &key, const Entry &entry)
+{
+    removeEntry(key);
+    m_entries.insert(key, entry);
+    m_size += entry.size;
+}
+
+void BitTorrent::MetadataCache::removeEntry(const QString &key)
+{
+    const auto iter = m_entries.find(key);
+    if (iter == m_entries.end())
+        return;
+
+    m_size -= iter->size;
+    m_entries.erase(iter);
+}
+
+void BitTorrent::MetadataCache::touch(const QString &key)
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    m_entries[key].lastUsed = now;
+
+    // The modification time keeps the order of use after restart
+    QFile file {filePath(key).data()};
+    if (file.open(QIODevice::Append))
+        file.setFileTime(now, QFileDevice::FileModificationTime);
+}
+
+void BitTorrent::MetadataCache::evict()
+{
+    if (m_size <= m_maxSize)
+        return;
+
+    QVector<std::pair<QDateTime, QString>> entries;
+    entries.reserve(m_entries.size());
+    for (auto iter = m_entries.cbegin(); iter != m_entries.cend(); ++iter)
+        entries.append({iter->lastUsed, iter.key()});
+    std::sort(entries.begin(), entries.end());
+
+    for (const auto &entry : asConst(entries))
+    {
+        if (m_size <= m_maxSize)
+            break;
+
+        Utils::Fs::removeFile(filePath(entry.second));
+        removeEntry(entry.second);
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+
+#include "base/path.h"
+#include "infohash.h"
+#include "torrentinfo.h"
+
+namespace BitTorrent
+{
+    // Keeps the metadata of torrents on disk so that magnet links which were added
+    // earlier don't have to wait for the metadata to be received from peers.
+    // Every file is named after the info hash (v1 if available, v2 otherwise) and
+    // verified when it is loaded. The least recently used files are removed once
+    // the size limit is exceeded.
+    class MetadataCache
+    {
+        Q_DISABLE_COPY_MOVE(MetadataCache)
+        Q_DECLARE_TR_FUNCTIONS(MetadataCache)
+
+    public:
+        MetadataCache(const Path &dirPath, qint64 maxSize);
+
+        std::optional<TorrentInfo> find(const InfoHash &infoHash);
+        void store(const TorrentInfo &metadata);
+
+        qint64 maxSize() const;
+        void setMaxSize(qint64 maxSize);
+        qint64 size() const;
+
+    private:
+        struct Entry
+        {
+            qint64 size = 0;
+            QDateTime lastUsed;
+        };
+
+        Path filePath(const QString &key) const;
+        void insertEntry(const QString &key, const Entry &entry);
+        void removeEntry(const QString &key);
+        void touch(const QString &key);
+        void evict();
+
+        Path m_dirPath;
+        qint64 m_maxSize = 0;
+        qint64 m_size = 0;
+        QHash<QString, Entry> m_entries;
+    };
+}
@@ -0,0 +1,245 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "piecechecker.h"
+
+#include <memory>
+#include <vector>
+
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/torrent_info.hpp>
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QFile>
+
+#include "lttypecast.h"
+
+namespace
+{
+    // Reads the data of pieces from the files of a torrent,
+    // the file which was read last is kept open
+    class PieceReader
+    {
+    public:
+        PieceReader(const BitTorrent::TorrentInfo &torrentInfo, const PathList &filePaths)
+            : m_torrentInfo {torrentInfo}
+            , m_nativeInfo {torrentInfo.nativeInfo()}
+            , m_filePaths {filePaths}
+        {
+            // pad files have no index
+            m_fileIndexes.fill(-1, m_nativeInfo->orig_files().num_files());
+            const QVector<lt::file_index_t> nativeIndexes = torrentInfo.nativeIndexes();
+            for (int i = 0; i < nativeIndexes.size(); ++i)
+                m_fileIndexes[static_cast<int>(BitTorrent::LT::toUnderlyingType(nativeIndexes[i]))] = i;
+        }
+
+        // Returns empty array if the piece can't be read completely
+        QByteArray read(const int pieceIndex)
+        {
+            const int pieceLength = m_torrentInfo.pieceLength(pieceIndex);
+            const std::vector<lt::file_slice> slices = m_nativeInfo->orig_files().map_block(lt::piece_index_t {pieceIndex}, 0, pieceLength);
+
+            QByteArray data;
+            data.reserve(pieceLength);
+            for (const lt::file_slice &slice : slices)
+            {
+                const int fileIndex = m_fileIndexes.at(static_cast<int>(BitTorrent::LT::toUnderlyingType(slice.file_index)));
+                if (fileIndex < 0)
+                {
+                    data.append(static_cast<int>(slice.size), '\0');
+                    continue;
+                }
+
+                if (!openFile(fileIndex) || !m_file.seek(slice.offset))
+                    return {};
+
+                const QByteArray chunk = m_file.read(slice.size);
+                if (chunk.size() != slice.size)
+                    return {};
+
+                data.append(chunk);
+            }
+
+            return data;
+        }
+
+    private:
+        bool openFile(const int fileIndex)
+        {
+            if (fileIndex == m_openFileIndex)
+                return true;
+
+            m_file.close();
+            m_file.setFileName(m_filePaths.at(fileIndex).data());
+            m_openFileIndex = (m_file.open(QIODevice::ReadOnly) ? fileIndex : -1);
+            return (m_openFileIndex >= 0);
+        }
+
+        const BitTorrent::TorrentInfo &m_torrentInfo;
+        const std::shared_ptr<lt::torrent_info> m_nativeInfo;
+        const PathList &m_filePaths;
+        QVector<int> m_fileIndexes;
+        QFile m_file;
+        int m_openFileIndex = -1;
+    };
+}
+
+QBitArray BitTorrent::piecesOverlappingFiles(const TorrentInfo &torrentInfo, const QVector<int> &fileIndexes)
+{
+    QBitArray pieces {torrentInfo.piecesCount()};
+    for (const int fileIndex : fileIndexes)
+    {
+        for (const int pieceIndex : torrentInfo.filePieces(fileIndex))
+            pieces.setBit(pieceIndex);
+    }
+
+    return pieces;
+}
+
+BitTorrent::PieceCheckResult BitTorrent::checkPieces(const PieceCheckParams &params)
+{
+    const TorrentInfo &torrentInfo = params.torrentInfo;
+    const int filesCount = torrentInfo.filesCount();
+    const int piecesCount = torrentInfo.piecesCount();
+
+    PieceCheckResult result;
+    result.havePieces = params.havePieces;
+    result.havePieces.resize(piecesCount);
+    result.checkedPieces = params.piecesToCheck;
+    result.checkedPieces.resize(piecesCount);
+
+    QVector<FileFingerprint> currentFingerprints;
+    currentFingerprints.reserve(filesCount);
+    for (const Path &filePath : params.filePaths)
+        currentFingerprints.append(FileFingerprint::fromFile(filePath));
+
+    QBitArray unwantedFiles = params.unwantedFiles;
+    unwantedFiles.resize(filesCount);
+    QVector<int> unwantedFileIndexes;
+    for (int i = 0; i < filesCount; ++i)
+    {
+        if (unwantedFiles.testBit(i))
+            unwantedFileIndexes.append(i);
+    }
+    const QBitArray unreadablePieces = piecesOverlappingFiles(torrentInfo, unwantedFileIndexes);
+
+    if (params.checkModifiedFiles)
+    {
+        for (int i = 0; i < filesCount; ++i)
+        {
+            if (unwantedFiles.testBit(i))
+                continue;
+
+            const FileFingerprint storedFingerprint = params.fileFingerprints.value(i);
+            if (storedFingerprint.isValid() && (storedFingerprint == currentFingerprints.at(i)))
+                continue;
+
+            for (const int pieceIndex : torrentInfo.filePieces(i))
+            {
+                if (result.havePieces.testBit(pieceIndex))
+                    result.checkedPieces.setBit(pieceIndex);
+            }
+        }
+    }
+
+    result.checkedPieces &= ~unreadablePieces;
+
+    const QVector<QByteArray> pieceHashes = torrentInfo.pieceHashes();
+    PieceReader reader {torrentInfo, params.filePaths};
+    for (int i = 0; i < piecesCount; ++i)
+    {
+        if (!result.checkedPieces.testBit(i))
+        {
+            if (result.havePieces.testBit(i))
+                result.skippedBytes += torrentInfo.pieceLength(i);
+            continue;
+        }
+
+        const QByteArray data = reader.read(i);
+        result.hashedBytes += data.size();
+        const bool isValid = !data.isEmpty()
+                && (QCryptographicHash::hash(data, QCryptographicHash::Sha1) == pieceHashes.at(i));
+        result.havePieces.setBit(i, isValid);
+    }
+
+    // Files which weren't touched by the check keep their stored fingerprints
+    result.fileFingerprints.reserve(filesCount);
+    for (int i = 0; i < filesCount; ++i)
+    {
+        bool isComplete = true;
+        bool isChecked = false;
+        for (const int pieceIndex : torrentInfo.filePieces(i))
+        {
+            isComplete = isComplete && result.havePieces.testBit(pieceIndex);
+            isChecked = isChecked || result.checkedPieces.testBit(pieceIndex);
+        }
+
+        if (!isComplete || unwantedFiles.testBit(i))
+            result.fileFingerprints.append(FileFingerprint());
+        else if (isChecked)
+            result.fileFingerprints.append(currentFingerprints.at(i));
+        else
+            result.fileFingerprints.append(params.fileFingerprints.value(i));
+    }
+
+    return result;
+}
+
+BitTorrent::PieceChecker::PieceChecker(QObject *parent)
+    : QObject(parent)
+{
+    m_threadPool.setMaxThreadCount(1);
+}
+
+BitTorrent::PieceChecker::~PieceChecker()
+{
+    m_threadPool.clear();
+    m_threadPool.waitForDone();
+}
+
+void BitTorrent::PieceChecker::check(const TorrentID &id, const PieceCheckParams &params)
+{
+    ++m_statistics.pendingCount;
+    m_threadPool.start([this, id, params]()
+    {
+        const PieceCheckResult result = checkPieces(params);
+        QMetaObject::invokeMethod(this, [this, id, result]()
+        {
+            --m_statistics.pendingCount;
+            m_statistics.hashedBytes += result.hashedBytes;
+            m_statistics.skippedBytes += result.skippedBytes;
+            emit checkFinished(id, result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+BitTorrent::PieceCheckStatistics BitTorrent::PieceChecker::statistics() const
+{
+    return m_statistics;
+}
@@ -0,0 +1,99 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QBitArray>
+#include <QObject>
+#include <QThreadPool>
+#include <QVector>
+
+#include "base/path.h"
+#include "filefingerprint.h"
+#include "infohash.h"
+#include "torrentinfo.h"
+
+namespace BitTorrent
+{
+    struct PieceCheckParams
+    {
+        TorrentInfo torrentInfo;
+        PathList filePaths;  // actual paths of the files
+        QBitArray havePieces;
+        QBitArray piecesToCheck;
+        QVector<FileFingerprint> fileFingerprints;  // stored ones
+        // The data of the files which aren't downloaded is kept in the part file
+        // so the pieces overlapping them can't be hashed and keep their state
+        QBitArray unwantedFiles;
+        // The pieces the torrent has are hashed as well if they overlap
+        // the files whose stored fingerprints differ from the current ones
+        bool checkModifiedFiles = false;
+    };
+
+    struct PieceCheckResult
+    {
+        QBitArray havePieces;
+        QBitArray checkedPieces;
+        QVector<FileFingerprint> fileFingerprints;  // valid for complete files only
+        qint64 hashedBytes = 0;
+        qint64 skippedBytes = 0;
+    };
+
+    struct PieceCheckStatistics
+    {
+        int pendingCount = 0;
+        qint64 hashedBytes = 0;
+        qint64 skippedBytes = 0;
+    };
+
+    QBitArray piecesOverlappingFiles(const TorrentInfo &torrentInfo, const QVector<int> &fileIndexes);
+    // Hashes the requested pieces (v1 hashes are required), the other pieces keep their state
+    PieceCheckResult checkPieces(const PieceCheckParams &params);
+
+    // Checks the pieces on a worker thread. Torrents are checked one at a time
+    // so that they don't compete for the same disk.
+    class PieceChecker final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(PieceChecker)
+
+    public:
+        explicit PieceChecker(QObject *parent = nullptr);
+        ~PieceChecker() override;
+
+        void check(const TorrentID &id, const PieceCheckParams &params);
+        PieceCheckStatistics statistics() const;
+
+    signals:
+        void checkFinished(const BitTorrent::TorrentID &id, const BitTorrent::PieceCheckResult &result);
+
+    private:
+        QThreadPool m_threadPool;
+        PieceCheckStatistics m_statistics;
+    };
+}
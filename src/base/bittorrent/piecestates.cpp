@@ -0,0 +1,131 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "piecestates.h"
+
+#include <QBitArray>
+
+namespace
+{
+    const int STATES_PER_BYTE = 4;
+
+    int packedSize(const int size)
+    {
+        return (size + STATES_PER_BYTE - 1) / STATES_PER_BYTE;
+    }
+}
+
+BitTorrent::PieceStates::PieceStates(const int size)
+    : m_data(packedSize(size), 0)
+    , m_size {size}
+{
+}
+
+BitTorrent::PieceStates::PieceStates(const QBitArray &pieces, const QBitArray &downloadingPieces)
+    : PieceStates(pieces.size())
+{
+    Q_ASSERT(downloadingPieces.isEmpty() || (downloadingPieces.size() == pieces.size()));
+
+    const bool hasDownloadingPieces = !downloadingPieces.isEmpty();
+    for (int i = 0; i < m_size; ++i)
+    {
+        // the piece which is being downloaded again (e.g. rechecked) is considered downloading
+        if (hasDownloadingPieces && downloadingPieces.testBit(i))
+            setState(i, PieceState::Downloading);
+        else if (pieces.testBit(i))
+            setState(i, PieceState::Downloaded);
+    }
+}
+
+BitTorrent::PieceStates BitTorrent::PieceStates::fromPackedData(const QByteArray &data, const int size)
+{
+    if ((size < 0) || (data.size() != packedSize(size)))
+        return {};
+
+    PieceStates states;
+    states.m_data = data;
+    states.m_size = size;
+    return states;
+}
+
+bool BitTorrent::PieceStates::isEmpty() const
+{
+    return (m_size == 0);
+}
+
+int BitTorrent::PieceStates::size() const
+{
+    return m_size;
+}
+
+BitTorrent::PieceState BitTorrent::PieceStates::state(const int index) const
+{
+    Q_ASSERT((index >= 0) && (index < m_size));
+
+    const auto byte = static_cast<uchar>(m_data[index / STATES_PER_BYTE]);
+    return static_cast<PieceState>((byte >> ((index % STATES_PER_BYTE) * 2)) & 0b11);
+}
+
+void BitTorrent::PieceStates::setState(const int index, const PieceState state)
+{
+    Q_ASSERT((index >= 0) && (index < m_size));
+
+    const int shift = (index % STATES_PER_BYTE) * 2;
+    char &byte = m_data[index / STATES_PER_BYTE];
+    byte = static_cast<char>((static_cast<uchar>(byte) & ~(0b11 << shift)) | (static_cast<int>(state) << shift));
+}
+
+BitTorrent::PieceStates BitTorrent::PieceStates::mid(const int first, const int count) const
+{
+    Q_ASSERT((first >= 0) && (count >= 0) && ((first + count) <= m_size));
+
+    if ((first % STATES_PER_BYTE) == 0)
+    {
+        PieceStates result;
+        result.m_data = m_data.mid((first / STATES_PER_BYTE), packedSize(count));
+        result.m_size = count;
+        // clear the states following the range in the last byte
+        const int tailSize = count % STATES_PER_BYTE;
+        if (tailSize > 0)
+        {
+            char &lastByte = result.m_data[result.m_data.size() - 1];
+            lastByte = static_cast<char>(static_cast<uchar>(lastByte) & ((1 << (tailSize * 2)) - 1));
+        }
+        return result;
+    }
+
+    PieceStates result {count};
+    for (int i = 0; i < count; ++i)
+        result.setState(i, state(first + i));
+    return result;
+}
+
+const QByteArray &BitTorrent::PieceStates::packedData() const
+{
+    return m_data;
+}
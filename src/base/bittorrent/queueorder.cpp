@@ -0,0 +1,125 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "queueorder.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Fenwick tree for counting the items that are still to be moved
+    class CountingTree
+    {
+    public:
+        explicit CountingTree(const int size)
+            : m_tree(size + 1, 0)
+        {
+        }
+
+        void add(const int index, const int value)
+        {
+            for (int i = index + 1; i < static_cast<int>(m_tree.size()); i += (i & -i))
+                m_tree[i] += value;
+        }
+
+        // Returns the sum of values in [0, index)
+        int prefixSum(const int index) const
+        {
+            int sum = 0;
+            for (int i = index; i > 0; i -= (i & -i))
+                sum += m_tree[i];
+            return sum;
+        }
+
+    private:
+        QVector<int> m_tree;
+    };
+
+    // Marks the items that form the longest subsequence of `order` which is already sorted,
+    // i.e. the largest set of items that don't need to be moved
+    QVector<bool> findLongestSortedSubsequence(const QVector<int> &order)
+    {
+        const int size = static_cast<int>(order.size());
+        QVector<int> tails; // position (in `order`) of the smallest tail of every subsequence length
+        QVector<int> predecessors(size, -1);
+        for (int i = 0; i < size; ++i)
+        {
+            const auto iter = std::lower_bound(tails.begin(), tails.end(), order[i]
+                                               , [&order](const int position, const int value) { return order[position] < value; });
+            const int length = static_cast<int>(iter - tails.begin());
+            if (length > 0)
+                predecessors[i] = tails[length - 1];
+
+            if (iter == tails.end())
+                tails.push_back(i);
+            else
+                *iter = i;
+        }
+
+        QVector<bool> result(size, false);
+        for (int i = (tails.empty() ? -1 : tails.back()); i >= 0; i = predecessors[i])
+            result[order[i]] = true;
+        return result;
+    }
+}
+
+QVector<BitTorrent::QueueMove> BitTorrent::computeQueueMoves(const QVector<int> &order)
+{
+    const int size = static_cast<int>(order.size());
+    const QVector<bool> isFixed = findLongestSortedSubsequence(order);
+
+    CountingTree notMoved {size};
+    for (int i = 0; i < size; ++i)
+    {
+        if (!isFixed[i])
+            notMoved.add(i, 1);
+    }
+
+    // Every item is placed right after the one that precedes it in the new order.
+    // All the items preceding it are in place at that moment, so its new position is
+    // its position in the new order plus the number of items that are still to be moved
+    // and are located before it. These are the ones located before the last fixed item
+    // since the moved items are placed in blocks following the fixed ones.
+    QVector<QueueMove> moves;
+    int lastFixedItem = -1;
+    for (int position = 0; position < size; ++position)
+    {
+        const int item = order[position];
+        if (isFixed[item])
+        {
+            lastFixedItem = item;
+            continue;
+        }
+
+        notMoved.add(item, -1);
+        const int offset = (lastFixedItem >= 0) ? notMoved.prefixSum(lastFixedItem) : 0;
+        moves.push_back({item, (position + offset)});
+    }
+
+    return moves;
+}
@@ -33,6 +33,7 @@
 #include <chrono>
 #include <cstdint>
 #include <ctime>
+#include <optional>
 #include <queue>
 #include <string>
 #include <utility>
@@ -55,6 +56,7 @@
 #include <libtorrent/session_status.hpp>
 #include <libtorrent/torrent_info.hpp>
 
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
@@ -90,11 +92,14 @@
 #include "base/utils/net.h"
 #include "base/utils/random.h"
 #include "base/version.h"
+#include "addtorrentpipeline.h"
 #include "bandwidthscheduler.h"
 #include "bencoderesumedatastorage.h"
+#include "checkingslots.h"
 #include "common.h"
 #include "customstorage.h"
 #include "dbresumedatastorage.h"
+#include "diskreadcache.h"
 #include "downloadpriority.h"
 #include "extensiondata.h"
 #include "filesearcher.h"
@@ -102,10 +107,14 @@
 #include "loadtorrentparams.h"
 #include "lttypecast.h"
 #include "magneturi.h"
+#include "metadatacache.h"
 #include "nativesessionextension.h"
+#include "piecechecker.h"
 #include "portforwarderimpl.h"
+#include "queueorder.h"
 #include "resumedatastorage.h"
 #include "statistics.h"
+#include "torrentcontentremover.h"
 #include "torrentimpl.h"
 #include "tracker.h"
 
@@ -113,6 +122,8 @@ using namespace std::chrono_literals;
 using namespace BitTorrent;
 
 const Path CATEGORIES_FILE_NAME {u"categories.json"_qs};
+const Path CONTENT_REMOVAL_QUEUE_DIR_NAME {u"content_removal_queue"_qs};
+const Path METADATA_CACHE_FOLDER_NAME {u"metadata"_qs};
 const int MAX_PROCESSING_RESUMEDATA_COUNT = 50;
 
 namespace
@@ -120,6 +131,19 @@ namespace
     const char PEER_ID[] = "qB";
     const auto USER_AGENT = QStringLiteral("qBittorrent/" QBT_VERSION_2);
 
+    // Cached metadata contains only the info dictionary,
+    // so trackers and web seeds are taken from the magnet link
+    TorrentInfo addMagnetSources(const TorrentInfo &metadata, const MagnetUri &magnetUri)
+    {
+        lt::torrent_info nativeInfo {*metadata.nativeInfo()};
+        for (const TrackerEntry &tracker : asConst(magnetUri.trackers()))
+            nativeInfo.add_tracker(tracker.url.toStdString(), tracker.tier);
+        for (const QUrl &urlSeed : asConst(magnetUri.urlSeeds()))
+            nativeInfo.add_url_seed(urlSeed.toString().toStdString());
+
+        return TorrentInfo {nativeInfo};
+    }
+
     void torrentQueuePositionUp(const lt::torrent_handle &handle)
     {
         try
@@ -168,6 +192,49 @@ namespace
         }
     }
 
+    void torrentQueuePositionSet(const lt::torrent_handle &handle, const int position)
+    {
+        try
+        {
+            handle.queue_position_set(lt::queue_position_t {position});
+        }
+        catch (const std::exception &exc)
+        {
+            qDebug() << Q_FUNC_INFO << " fails: " << exc.what();
+        }
+    }
+
+    struct QueuedTorrent
+    {
+        lt::torrent_handle handle;
+        TorrentID id;
+    };
+
+    // Returns the actual (non-cached) queue using a single call to libtorrent
+    // rather than querying the queue position of every torrent one by one
+    QVector<QueuedTorrent> loadTorrentsQueue(const lt::session &session)
+    {
+        const std::vector<lt::torrent_status> statuses = session.get_torrent_status([](const lt::torrent_status &status)
+        {
+            return (status.queue_position >= lt::queue_position_t {});
+        }, {});
+
+        QVector<QueuedTorrent> queue;
+        for (const lt::torrent_status &status : statuses)
+        {
+            const int queuePos = LT::toUnderlyingType(status.queue_position);
+            if (queuePos >= queue.size())
+                queue.resize(queuePos + 1);
+#ifdef QBT_USES_LIBTORRENT2
+            queue[queuePos] = {status.handle, TorrentID::fromInfoHash(status.info_hashes)};
+#else
+            queue[queuePos] = {status.handle, TorrentID::fromInfoHash(status.info_hash)};
+#endif
+        }
+
+        return queue;
+    }
+
     QMap<QString, CategoryOptions> expandCategories(const QMap<QString, CategoryOptions> &categories)
     {
         QMap<QString, CategoryOptions> expanded = categories;
@@ -342,6 +409,7 @@ Session::Session(QObject *parent)
     , m_filePoolSize(BITTORRENT_SESSION_KEY(u"FilePoolSize"_qs), 5000)
     , m_checkingMemUsage(BITTORRENT_SESSION_KEY(u"CheckingMemUsageSize"_qs), 32)
     , m_diskCacheSize(BITTORRENT_SESSION_KEY(u"DiskCacheSize"_qs), -1)
+    , m_diskReadCacheSize(BITTORRENT_SESSION_KEY(u"DiskReadCacheSize"_qs), 0)
     , m_diskCacheTTL(BITTORRENT_SESSION_KEY(u"DiskCacheTTL"_qs), 60)
     , m_diskQueueSize(BITTORRENT_SESSION_KEY(u"DiskQueueSize"_qs), (1024 * 1024))
     , m_diskIOType(BITTORRENT_SESSION_KEY(u"DiskIOType"_qs), DiskIOType::Default)
@@ -417,6 +485,13 @@ Session::Session(QObject *parent)
     , m_networkInterfaceAddress(BITTORRENT_SESSION_KEY(u"InterfaceAddress"_qs))
     , m_encryption(BITTORRENT_SESSION_KEY(u"Encryption"_qs), 0)
     , m_maxActiveCheckingTorrents(BITTORRENT_SESSION_KEY(u"MaxActiveCheckingTorrents"_qs), 1)
+    , m_isDiskAwareCheckingEnabled(BITTORRENT_SESSION_KEY(u"DiskAwareCheckingEnabled"_qs), false)
+    , m_maxActiveCheckingTorrentsPerHDD(BITTORRENT_SESSION_KEY(u"MaxActiveCheckingTorrentsPerHDD"_qs), 1, lowerLimited(1))
+    , m_maxActiveCheckingTorrentsPerSSD(BITTORRENT_SESSION_KEY(u"MaxActiveCheckingTorrentsPerSSD"_qs), 4, lowerLimited(1))
+    , m_maxActiveMovesPerLane(BITTORRENT_SESSION_KEY(u"MaxActiveMovesPerLane"_qs), 1, lowerLimited(1))
+    , m_contentRemovalRateLimit(BITTORRENT_SESSION_KEY(u"ContentRemovalRateLimit"_qs), 0, lowerLimited(0))
+    , m_metadataCacheSize(BITTORRENT_SESSION_KEY(u"MetadataCacheSize"_qs), 32, lowerLimited(0))
+    , m_isContentReuseEnabled(BITTORRENT_SESSION_KEY(u"ContentReuseEnabled"_qs), false)
     , m_isProxyPeerConnectionsEnabled(BITTORRENT_SESSION_KEY(u"ProxyPeerConnections"_qs), false)
     , m_chokingAlgorithm(BITTORRENT_SESSION_KEY(u"ChokingAlgorithm"_qs), ChokingAlgorithm::FixedSlots
         , clampValue(ChokingAlgorithm::FixedSlots, ChokingAlgorithm::RateBased))
@@ -453,7 +528,10 @@ Session::Session(QObject *parent)
     , m_seedingLimitTimer {new QTimer {this}}
     , m_resumeDataTimer {new QTimer {this}}
     , m_statistics {new Statistics {this}}
+    , m_diskIOStatistics {new DiskIOStatistics}
+    , m_diskReadCache {new DiskReadCache}
     , m_ioThread {new QThread {this}}
+    , m_contentRemoverThread {new QThread {this}}
     , m_recentErroredTorrentsTimer {new QTimer {this}}
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
     , m_networkManager {new QNetworkConfigurationManager {this}}
@@ -505,13 +583,31 @@ Session::Session(QObject *parent)
     connect(m_networkManager, &QNetworkConfigurationManager::configurationChanged, this, &Session::networkConfigurationChange);
 #endif
 
+    m_addTorrentPipeline = new AddTorrentPipeline(this);
+    connect(m_addTorrentPipeline, &AddTorrentPipeline::torrentsPrepared, this, &Session::handleTorrentsPrepared);
+
+    m_pieceChecker = new PieceChecker(this);
+    connect(m_pieceChecker, &PieceChecker::checkFinished, this, &Session::handlePieceCheckFinished);
+
     m_fileSearcher = new FileSearcher;
     m_fileSearcher->moveToThread(m_ioThread);
     connect(m_ioThread, &QThread::finished, m_fileSearcher, &QObject::deleteLater);
     connect(m_fileSearcher, &FileSearcher::searchFinished, this, &Session::fileSearchFinished);
+    connect(m_fileSearcher, &FileSearcher::contentReused, this, &Session::handleContentReused);
 
     m_ioThread->start();
 
+    m_metadataCache = new MetadataCache((specialFolderLocation(SpecialFolder::Cache) / METADATA_CACHE_FOLDER_NAME)
+                                        , (static_cast<qint64>(metadataCacheSize()) * 1024 * 1024));
+
+    m_contentRemover = new TorrentContentRemover(specialFolderLocation(SpecialFolder::Data) / CONTENT_REMOVAL_QUEUE_DIR_NAME);
+    m_contentRemover->setRateLimit(contentRemovalRateLimit());
+    m_contentRemover->moveToThread(m_contentRemoverThread);
+    connect(m_contentRemoverThread, &QThread::finished, m_contentRemover, &QObject::deleteLater);
+    connect(m_contentRemover, &TorrentContentRemover::jobFinished, this, &Session::handleContentRemovalJobFinished);
+    m_contentRemoverThread->start();
+    QMetaObject::invokeMethod(m_contentRemover, &TorrentContentRemover::load);
+
     // initialize PortForwarder instance
     new PortForwarderImpl(m_nativeSession);
 
@@ -1002,8 +1098,18 @@ Session::~Session()
     qDebug("Deleting the session");
     delete m_nativeSession;
 
+    // must outlive the disk I/O thread of lt::session
+    delete m_diskIOStatistics;
+    delete m_diskReadCache;
+
     m_ioThread->quit();
     m_ioThread->wait();
+
+    // the remaining content removal jobs are resumed on the next start
+    m_contentRemoverThread->quit();
+    m_contentRemoverThread->wait();
+
+    delete m_metadataCache;
 }
 
 void Session::initInstance()
@@ -1404,16 +1510,27 @@ void Session::initializeNativeSession()
     loadLTSettings(pack);
     lt::session_params sessionParams {pack, {}};
 #ifdef QBT_USES_LIBTORRENT2
+    DiskIOStatistics *diskIOStatistics = m_diskIOStatistics;
+    DiskReadCache *diskReadCache = m_diskReadCache;
     switch (diskIOType())
     {
     case DiskIOType::Posix:
-        sessionParams.disk_io_constructor = customPosixDiskIOConstructor;
+        sessionParams.disk_io_constructor = [diskIOStatistics, diskReadCache](lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+        {
+            return customPosixDiskIOConstructor(ioContext, settings, counters, diskIOStatistics, diskReadCache);
+        };
         break;
     case DiskIOType::MMap:
-        sessionParams.disk_io_constructor = customMMapDiskIOConstructor;
+        sessionParams.disk_io_constructor = [diskIOStatistics, diskReadCache](lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+        {
+            return customMMapDiskIOConstructor(ioContext, settings, counters, diskIOStatistics, diskReadCache);
+        };
         break;
     default:
-        sessionParams.disk_io_constructor = customDiskIOConstructor;
+        sessionParams.disk_io_constructor = [diskIOStatistics, diskReadCache](lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+        {
+            return customDiskIOConstructor(ioContext, settings, counters, diskIOStatistics, diskReadCache);
+        };
         break;
     }
 #endif
@@ -1560,7 +1677,8 @@ void Session::loadLTSettings(lt::settings_pack &settingsPack)
         settingsPack.set_int(lt::settings_pack::in_enc_policy, lt::settings_pack::pe_disabled);
     }
 
-    settingsPack.set_int(lt::settings_pack::active_checking, maxActiveCheckingTorrents());
+    // Disk-aware scheduler starts the checks itself, so libtorrent should keep all the queued ones waiting
+    settingsPack.set_int(lt::settings_pack::active_checking, (isDiskAwareCheckingEnabled() ? 0 : maxActiveCheckingTorrents()));
 
     // proxy
     const auto proxyManager = Net::ProxyConfigurationManager::instance();
@@ -1620,7 +1738,9 @@ void Session::loadLTSettings(lt::settings_pack &settingsPack)
     const int checkingMemUsageSize = checkingMemUsage() * 64;
     settingsPack.set_int(lt::settings_pack::checking_mem_usage, checkingMemUsageSize);
 
-#ifndef QBT_USES_LIBTORRENT2
+#ifdef QBT_USES_LIBTORRENT2
+    m_diskReadCache->setCapacity(static_cast<qint64>(diskReadCacheSize()) * 1024 * 1024);
+#else
     const int cacheSize = (diskCacheSize() > -1) ? (diskCacheSize() * 64) : -1;
     settingsPack.set_int(lt::settings_pack::cache_size, cacheSize);
     settingsPack.set_int(lt::settings_pack::cache_expiry, diskCacheTTL());
@@ -2091,6 +2211,18 @@ void Session::handleDownloadFinished(const Net::DownloadResult &result)
     }
 }
 
+void Session::handleContentReused(const TorrentID &id, const qint64 reusedBytes)
+{
+    QString name;
+    if (const TorrentImpl *torrent = m_torrents.value(id))
+        name = torrent->name();
+    else if (const auto loadingTorrentsIter = m_loadingTorrents.constFind(id); loadingTorrentsIter != m_loadingTorrents.cend())
+        name = loadingTorrentsIter->name;
+
+    LogMsg(tr("Reused data of existing torrents. Torrent: \"%1\". Size: %2")
+           .arg((name.isEmpty() ? id.toString() : name), Utils::Misc::friendlyUnit(reusedBytes)));
+}
+
 void Session::fileSearchFinished(const TorrentID &id, const Path &savePath, const PathList &fileNames)
 {
     TorrentImpl *torrent = m_torrents.value(id);
@@ -2175,18 +2307,18 @@ bool Session::deleteTorrent(const TorrentID &id, const DeleteOption deleteOption
     qDebug("Deleting torrent with ID: %s", qUtf8Printable(torrent->id().toString()));
     emit torrentAboutToBeRemoved(torrent);
 
+    m_checkingJobs.remove(id);
+    m_batchUpdatedTorrents.remove(torrent);
+    if (torrent->hasMetadata())
+        m_contentReuseIndex.removeTorrent(id, torrent->info());
+
     // Remove it from session
     if (deleteOption == DeleteTorrent)
     {
         m_removingTorrents[torrent->id()] = {torrent->name(), {}, deleteOption};
 
         const lt::torrent_handle nativeHandle {torrent->nativeHandle()};
-        const auto iter = std::find_if(m_moveStorageQueue.begin(), m_moveStorageQueue.end()
-                                 , [&nativeHandle](const MoveStorageJob &job)
-        {
-            return job.torrentHandle == nativeHandle;
-        });
-        if (iter != m_moveStorageQueue.end())
+        if (m_moveStorageJobs.contains(id))
         {
             // We shouldn't actually remove torrent until existing "move storage jobs" are done
             torrentQueuePositionBottom(nativeHandle);
@@ -2200,22 +2332,50 @@ bool Session::deleteTorrent(const TorrentID &id, const DeleteOption deleteOption
     }
     else
     {
-        m_removingTorrents[torrent->id()] = {torrent->name(), torrent->rootPath(), deleteOption};
+        Path storageLocation = torrent->actualStorageLocation();
 
-        if (m_moveStorageQueue.size() > 1)
+        const auto jobsIter = m_moveStorageJobs.find(id);
+        if (jobsIter != m_moveStorageJobs.end())
         {
             // Delete "move storage job" for the deleted torrent
             // (note: we shouldn't delete active job)
-            const auto iter = std::find_if(m_moveStorageQueue.begin() + 1, m_moveStorageQueue.end()
-                                     , [torrent](const MoveStorageJob &job)
+            if (jobsIter->last().startTime == 0)
             {
-                return job.torrentHandle == torrent->nativeHandle();
+                const MoveStorageJob canceledJob = jobsIter->takeLast();
+                if (canceledJob.ticket > 0)
+                    --m_moveStorageLanes[canceledJob.lane].queuedCount;
+            }
+
+            if (jobsIter->isEmpty())
+                m_moveStorageJobs.erase(jobsIter);
+            else
+                storageLocation = jobsIter->first().path; // the content is deleted once it is moved
+        }
+
+        // The files are deleted by the content remover rather than by libtorrent so that
+        // deleting lots of files doesn't stall libtorrent and is resumed after restart.
+        // libtorrent only deletes the part file and releases the files.
+        ContentRemovalJob contentRemovalJob;
+        if (torrent->hasMetadata())
+        {
+            contentRemovalJob = {id, torrent->name(), storageLocation, {}, {}};
+            contentRemovalJob.files.reserve(torrent->filesCount());
+            for (int i = 0; i < torrent->filesCount(); ++i)
+                contentRemovalJob.files.append(torrent->actualFilePath(i));
+
+            const Path relativeRootPath = Path::findRootFolder(torrent->filePaths());
+            if (!relativeRootPath.isEmpty())
+                contentRemovalJob.pathToRemove = storageLocation / relativeRootPath;
+
+            QMetaObject::invokeMethod(m_contentRemover, [this, contentRemovalJob]()
+            {
+                m_contentRemover->enqueue(contentRemovalJob);
             });
-            if (iter != m_moveStorageQueue.end())
-                m_moveStorageQueue.erase(iter);
         }
 
-        m_nativeSession->remove_torrent(torrent->nativeHandle(), lt::session::delete_files);
+        m_removingTorrents[torrent->id()] = {torrent->name(), contentRemovalJob.pathToRemove, deleteOption, torrent->hasMetadata()};
+
+        m_nativeSession->remove_torrent(torrent->nativeHandle(), lt::session::delete_partfile);
     }
 
     // Remove it from torrent resume directory
@@ -2347,6 +2507,65 @@ void Session::bottomTorrentsQueuePos(const QVector<TorrentID> &ids)
     saveTorrentsQueue();
 }
 
+// The given torrents swap their queue positions so that they follow each other in the given order,
+// the rest of the queue is left intact. The new order is applied with the least number
+// of libtorrent calls, e.g. moving a single torrent takes a single call regardless of the distance.
+void Session::setTorrentsQueueOrder(const QVector<TorrentID> &ids)
+{
+    const QVector<QueuedTorrent> queue = loadTorrentsQueue(*m_nativeSession);
+
+    QHash<TorrentID, int> queuePositions;
+    queuePositions.reserve(queue.size());
+    for (int i = 0; i < queue.size(); ++i)
+        queuePositions.insert(queue[i].id, i);
+
+    QVector<int> positions;
+    QVector<int> reorderedPositions;
+    QSet<TorrentID> processedIDs;
+    for (const TorrentID &id : ids)
+    {
+        if (!m_torrents.contains(id) || processedIDs.contains(id))
+            continue;
+
+        const auto positionIter = queuePositions.constFind(id);
+        if (positionIter == queuePositions.cend())
+            continue;
+
+        processedIDs.insert(id);
+        positions.append(positionIter.value());
+        reorderedPositions.append(positionIter.value());
+    }
+
+    if (positions.size() < 2)
+        return;
+
+    std::sort(positions.begin(), positions.end());
+
+    QVector<int> order;
+    order.reserve(queue.size());
+    for (int i = 0; i < queue.size(); ++i)
+        order.append(i);
+    for (int i = 0; i < positions.size(); ++i)
+        order[positions[i]] = reorderedPositions[i];
+
+    const QVector<QueueMove> moves = computeQueueMoves(order);
+    if (moves.isEmpty())
+        return;
+
+    for (const QueueMove &move : moves)
+        torrentQueuePositionSet(queue[move.item].handle, move.position);
+
+    QVector<TorrentID> newQueue;
+    newQueue.reserve(order.size());
+    for (const int item : asConst(order))
+    {
+        const TorrentID &id = queue[item].id;
+        newQueue.append(m_torrents.contains(id) ? id : TorrentID());
+    }
+
+    m_resumeDataStorage->storeQueue(newQueue);
+}
+
 void Session::handleTorrentNeedSaveResumeData(const TorrentImpl *torrent)
 {
     if (m_needSaveResumeDataTorrents.empty())
@@ -2372,6 +2591,37 @@ void Session::handleTorrentSaveResumeDataRequested(const TorrentImpl *torrent)
     ++m_numResumeData;
 }
 
+void Session::applyToTorrents(const QVector<Torrent *> &torrents, const std::function<void (Torrent *)> &func)
+{
+    ++m_torrentsBatchLevel;
+    for (Torrent *const torrent : torrents)
+        func(torrent);
+    --m_torrentsBatchLevel;
+
+    if (m_torrentsBatchLevel == 0)
+        finishTorrentsBatch();
+}
+
+void Session::finishTorrentsBatch()
+{
+    if (m_batchShareLimitChanged)
+    {
+        m_batchShareLimitChanged = false;
+        updateSeedingLimitTimer();
+    }
+
+    if (!m_batchUpdatedTorrents.isEmpty())
+    {
+        QVector<Torrent *> updatedTorrents;
+        updatedTorrents.reserve(m_batchUpdatedTorrents.size());
+        for (TorrentImpl *const torrent : asConst(m_batchUpdatedTorrents))
+            updatedTorrents.append(torrent);
+        m_batchUpdatedTorrents.clear();
+
+        emit torrentsUpdated(updatedTorrents);
+    }
+}
+
 QVector<Torrent *> Session::torrents() const
 {
     QVector<Torrent *> result;
@@ -2408,17 +2658,29 @@ bool Session::addTorrent(const QString &source, const AddTorrentParams &params)
     if (magnetUri.isValid())
         return addTorrent(magnetUri, params);
 
-    const Path path {source};
-    TorrentFileGuard guard {path};
-    const nonstd::expected<TorrentInfo, QString> loadResult = TorrentInfo::loadFromFile(path);
-    if (!loadResult)
+    // The file is loaded on a worker thread, the torrent is added once it is prepared.
+    // Report right away at least the errors that can be found without parsing it.
+    const Path torrentFilePath {source};
+    QFile torrentFile {torrentFilePath.data()};
+    if (!torrentFile.open(QIODevice::ReadOnly))
+    {
+        LogMsg(tr("Failed to load torrent. Source: \"%1\". Reason: \"%2\"").arg(source, torrentFile.errorString()), Log::WARNING);
+        return false;
+    }
+
+    // bencoded dictionary is expected
+    char firstChar = 0;
+    if ((torrentFile.size() > MAX_TORRENT_SIZE) || !torrentFile.getChar(&firstChar) || (firstChar != 'd'))
     {
-       LogMsg(tr("Failed to load torrent. Source: \"%1\". Reason: \"%2\"").arg(source, loadResult.error()), Log::WARNING);
-       return false;
+        LogMsg(tr("Failed to load torrent. Source: \"%1\". Reason: \"%2\"").arg(source, tr("Invalid torrent file")), Log::WARNING);
+        return false;
     }
+    torrentFile.close();
 
-    guard.markAsAddedToSession();
-    return addTorrent(loadResult.value(), params);
+    AddTorrentParams preparedParams = params;
+    preparedParams.contentLayout = params.contentLayout.value_or(torrentContentLayout());
+    m_addTorrentPipeline->add(torrentFilePath, preparedParams, m_excludedFileNamesRegExpList);
+    return true;
 }
 
 bool Session::addTorrent(const MagnetUri &magnetUri, const AddTorrentParams &params)
@@ -2429,6 +2691,10 @@ bool Session::addTorrent(const MagnetUri &magnetUri, const AddTorrentParams &par
     if (!magnetUri.isValid())
         return false;
 
+    // The torrent doesn't have to wait for peers if its metadata was received before
+    if (const std::optional<TorrentInfo> metadata = m_metadataCache->find(magnetUri.infoHash()))
+        return addTorrent(addMagnetSources(*metadata, magnetUri), params);
+
     return addTorrent_impl(magnetUri, params);
 }
 
@@ -2437,7 +2703,45 @@ bool Session::addTorrent(const TorrentInfo &torrentInfo, const AddTorrentParams
     if (!isRestored())
         return false;
 
-    return addTorrent_impl(torrentInfo, params);
+    AddTorrentParams preparedParams = params;
+    preparedParams.contentLayout = params.contentLayout.value_or(torrentContentLayout());
+    const nonstd::expected<AddTorrentParams, QString> prepareResult
+            = prepareAddTorrentParams(torrentInfo, preparedParams, m_excludedFileNamesRegExpList);
+    if (!prepareResult)
+    {
+        LogMsg(tr("Failed to load torrent. Source: \"%1\". Reason: \"%2\"").arg(torrentInfo.name(), prepareResult.error())
+               , Log::WARNING);
+        return false;
+    }
+
+    return addTorrent_impl(torrentInfo, prepareResult.value());
+}
+
+void Session::addTorrentAsync(const TorrentInfo &torrentInfo, const AddTorrentParams &params)
+{
+    if (!isRestored())
+        return;
+
+    AddTorrentParams preparedParams = params;
+    preparedParams.contentLayout = params.contentLayout.value_or(torrentContentLayout());
+    m_addTorrentPipeline->add(torrentInfo, preparedParams, m_excludedFileNamesRegExpList);
+}
+
+void Session::handleTorrentsPrepared(const QVector<PreparedTorrent> &torrents)
+{
+    for (const PreparedTorrent &torrent : torrents)
+    {
+        TorrentFileGuard guard {torrent.sourcePath};
+        if (!torrent.error.isEmpty())
+        {
+            const QString source = torrent.sourcePath.isEmpty() ? torrent.torrentInfo.name() : torrent.sourcePath.toString();
+            LogMsg(tr("Failed to load torrent. Source: \"%1\". Reason: \"%2\"").arg(source, torrent.error), Log::WARNING);
+            continue;
+        }
+
+        guard.markAsAddedToSession();
+        addTorrent_impl(torrent.torrentInfo, torrent.params);
+    }
 }
 
 LoadTorrentParams Session::initLoadTorrentParams(const AddTorrentParams &addTorrentParams)
@@ -2535,31 +2839,34 @@ bool Session::addTorrent_impl(const std::variant<MagnetUri, TorrentInfo> &source
     const bool useAutoTMM = loadTorrentParams.useAutoTMM;
     const Path actualSavePath = useAutoTMM ? categorySavePath(loadTorrentParams.category) : loadTorrentParams.savePath;
 
+    // The content of the torrent removed recently can still be queued for deletion
+    // but now it belongs to the added torrent
+    PathList contentPaths;
+    if (hasMetadata)
+    {
+        const Path actualDownloadPath = useAutoTMM
+                ? categoryDownloadPath(loadTorrentParams.category) : loadTorrentParams.downloadPath;
+        contentPaths.reserve(addTorrentParams.filePaths.size() * 2);
+        for (const Path &filePath : addTorrentParams.filePaths)
+        {
+            contentPaths.append(actualSavePath / filePath);
+            if (!actualDownloadPath.isEmpty())
+                contentPaths.append(actualDownloadPath / filePath);
+        }
+    }
+    QMetaObject::invokeMethod(m_contentRemover, [this, id, contentPaths]()
+    {
+        m_contentRemover->excludeContent(id, contentPaths);
+    });
+
     if (hasMetadata)
     {
         const TorrentInfo &torrentInfo = std::get<TorrentInfo>(source);
 
-        Q_ASSERT(addTorrentParams.filePaths.isEmpty() || (addTorrentParams.filePaths.size() == torrentInfo.filesCount()));
+        // file paths and priorities are resolved by prepareAddTorrentParams()
+        Q_ASSERT(addTorrentParams.filePaths.size() == torrentInfo.filesCount());
 
-        PathList filePaths = addTorrentParams.filePaths;
-        if (filePaths.isEmpty())
-        {
-            filePaths = torrentInfo.filePaths();
-            if (loadTorrentParams.contentLayout != TorrentContentLayout::Original)
-            {
-                const Path originalRootFolder = Path::findRootFolder(filePaths);
-                const auto originalContentLayout = (originalRootFolder.isEmpty()
-                                                    ? TorrentContentLayout::NoSubfolder
-                                                    : TorrentContentLayout::Subfolder);
-                if (loadTorrentParams.contentLayout != originalContentLayout)
-                {
-                    if (loadTorrentParams.contentLayout == TorrentContentLayout::NoSubfolder)
-                        Path::stripRootFolder(filePaths);
-                    else
-                        Path::addRootFolder(filePaths, filePaths.at(0).removedExtension());
-                }
-            }
-        }
+        const PathList &filePaths = addTorrentParams.filePaths;
 
         // if torrent name wasn't explicitly set we handle the case of
         // initial renaming of torrent content and rename torrent accordingly
@@ -2577,7 +2884,7 @@ bool Session::addTorrent_impl(const std::variant<MagnetUri, TorrentInfo> &source
         {
             const Path actualDownloadPath = useAutoTMM
                     ? categoryDownloadPath(loadTorrentParams.category) : loadTorrentParams.downloadPath;
-            findIncompleteFiles(torrentInfo, actualSavePath, actualDownloadPath, filePaths);
+            findIncompleteFiles(torrentInfo, actualSavePath, actualDownloadPath, filePaths, addTorrentParams.filePriorities);
             isFindingIncompleteFiles = true;
         }
 
@@ -2592,23 +2899,8 @@ bool Session::addTorrent_impl(const std::variant<MagnetUri, TorrentInfo> &source
         // Use qBittorrent default priority rather than libtorrent's (4)
         p.file_priorities = std::vector(internalFilesCount, LT::toNative(DownloadPriority::Normal));
 
-        if (addTorrentParams.filePriorities.isEmpty())
-        {
-            if (isExcludedFileNamesEnabled())
-            {
-                // Check file name blacklist when priorities are not explicitly set
-                for (int i = 0; i < filePaths.size(); ++i)
-                {
-                    if (isFilenameExcluded(filePaths.at(i).filename()))
-                        p.file_priorities[LT::toUnderlyingType(nativeIndexes[i])] = lt::dont_download;
-                }
-            }
-        }
-        else
-        {
-            for (int i = 0; i < addTorrentParams.filePriorities.size(); ++i)
-                p.file_priorities[LT::toUnderlyingType(nativeIndexes[i])] = LT::toNative(addTorrentParams.filePriorities[i]);
-        }
+        for (int i = 0; i < addTorrentParams.filePriorities.size(); ++i)
+            p.file_priorities[LT::toUnderlyingType(nativeIndexes[i])] = LT::toNative(addTorrentParams.filePriorities[i]);
 
         p.ti = torrentInfo.nativeInfo();
     }
@@ -2681,18 +2973,67 @@ bool Session::addTorrent_impl(const std::variant<MagnetUri, TorrentInfo> &source
 }
 
 void Session::findIncompleteFiles(const TorrentInfo &torrentInfo, const Path &savePath
-                                  , const Path &downloadPath, const PathList &filePaths) const
+                                  , const Path &downloadPath, const PathList &filePaths
+                                  , const QVector<DownloadPriority> &filePriorities) const
 {
     Q_ASSERT(filePaths.isEmpty() || (filePaths.size() == torrentInfo.filesCount()));
 
     const auto searchId = TorrentID::fromInfoHash(torrentInfo.infoHash());
     const PathList originalFileNames = (filePaths.isEmpty() ? torrentInfo.filePaths() : filePaths);
+    const QVector<ContentReuseCandidate> reuseCandidates = contentReuseCandidates(torrentInfo, filePriorities);
     QMetaObject::invokeMethod(m_fileSearcher, [=]()
     {
-        m_fileSearcher->search(searchId, originalFileNames, savePath, downloadPath);
+        m_fileSearcher->search(searchId, originalFileNames, savePath, downloadPath, reuseCandidates);
     });
 }
 
+QVector<ContentReuseCandidate> Session::contentReuseCandidates(const TorrentInfo &torrentInfo
+                                                               , const QVector<DownloadPriority> &filePriorities) const
+{
+    // Files are verified using v1 piece hashes which v2-only torrents don't have
+    if (!isContentReuseEnabled() || !torrentInfo.infoHash().v1().isValid())
+        return {};
+
+    const auto id = TorrentID::fromInfoHash(torrentInfo.infoHash());
+    QVector<QByteArray> pieceHashes;
+    QVector<ContentReuseCandidate> candidates;
+    for (int i = 0; i < torrentInfo.filesCount(); ++i)
+    {
+        // the files which aren't going to be downloaded shouldn't appear on disk
+        if (filePriorities.value(i, DownloadPriority::Normal) == DownloadPriority::Ignored)
+            continue;
+
+        PathList existingFilePaths;
+        for (const ContentReuseIndex::FileRef &fileRef : asConst(m_contentReuseIndex.find(torrentInfo.fileSize(i))))
+        {
+            if (fileRef.torrentID == id)
+                continue;
+
+            // Only the files which are completely downloaded can be reused
+            const TorrentImpl *torrent = m_torrents.value(fileRef.torrentID);
+            if (!torrent || !torrent->isSeed() || (torrent->filePriorities().at(fileRef.fileIndex) == DownloadPriority::Ignored))
+                continue;
+
+            existingFilePaths.append(torrent->actualStorageLocation() / torrent->actualFilePath(fileRef.fileIndex));
+        }
+
+        if (existingFilePaths.isEmpty())
+            continue;
+
+        if (pieceHashes.isEmpty())
+            pieceHashes = torrentInfo.pieceHashes();
+
+        std::optional<ContentReuseCandidate> candidate = makeContentReuseCandidate(torrentInfo, pieceHashes, i);
+        if (!candidate)
+            continue;
+
+        candidate->existingFilePaths = existingFilePaths;
+        candidates.append(std::move(*candidate));
+    }
+
+    return candidates;
+}
+
 // Add a torrent to libtorrent session in hidden mode
 // and force it to download its metadata
 bool Session::downloadMetadata(const MagnetUri &magnetUri)
@@ -2708,6 +3049,16 @@ bool Session::downloadMetadata(const MagnetUri &magnetUri)
     if (m_loadingTorrents.contains(id)) return false;
     if (m_downloadedMetadata.contains(id)) return false;
 
+    if (const std::optional<TorrentInfo> metadata = m_metadataCache->find(magnetUri.infoHash()))
+    {
+        // delivered asynchronously just like the metadata received from peers
+        QMetaObject::invokeMethod(this, [this, torrentInfo = addMagnetSources(*metadata, magnetUri)]()
+        {
+            emit metadataDownloaded(torrentInfo);
+        }, Qt::QueuedConnection);
+        return true;
+    }
+
     qDebug("Adding torrent to preload metadata...");
     qDebug(" -> Torrent ID: %s", qUtf8Printable(id.toString()));
     qDebug(" -> Name: %s", qUtf8Printable(name));
@@ -2825,18 +3176,13 @@ void Session::saveResumeData()
 
 void Session::saveTorrentsQueue() const
 {
+    // We require actual (non-cached) queue position here!
+    const QVector<QueuedTorrent> nativeQueue = loadTorrentsQueue(*m_nativeSession);
+
     QVector<TorrentID> queue;
-    for (const TorrentImpl *torrent : asConst(m_torrents))
-    {
-        // We require actual (non-cached) queue position here!
-        const int queuePos = LT::toUnderlyingType(torrent->nativeHandle().queue_position());
-        if (queuePos >= 0)
-        {
-            if (queuePos >= queue.size())
-                queue.resize(queuePos + 1);
-            queue[queuePos] = torrent->id();
-        }
-    }
+    queue.reserve(nativeQueue.size());
+    for (const QueuedTorrent &queuedTorrent : nativeQueue)
+        queue.append(m_torrents.contains(queuedTorrent.id) ? queuedTorrent.id : TorrentID());
 
     m_resumeDataStorage->storeQueue(queue);
 }
@@ -3318,6 +3664,98 @@ void Session::setMaxActiveCheckingTorrents(const int val)
     configureDeferred();
 }
 
+bool Session::isDiskAwareCheckingEnabled() const
+{
+    return m_isDiskAwareCheckingEnabled;
+}
+
+void Session::setDiskAwareCheckingEnabled(const bool enabled)
+{
+    if (enabled == m_isDiskAwareCheckingEnabled)
+        return;
+
+    m_isDiskAwareCheckingEnabled = enabled;
+    if (!enabled)
+        m_checkingJobs.clear();
+    configureDeferred();
+}
+
+int Session::maxActiveCheckingTorrentsPerHDD() const
+{
+    return m_maxActiveCheckingTorrentsPerHDD;
+}
+
+void Session::setMaxActiveCheckingTorrentsPerHDD(const int val)
+{
+    m_maxActiveCheckingTorrentsPerHDD = std::max(1, val);
+}
+
+int Session::maxActiveCheckingTorrentsPerSSD() const
+{
+    return m_maxActiveCheckingTorrentsPerSSD;
+}
+
+void Session::setMaxActiveCheckingTorrentsPerSSD(const int val)
+{
+    m_maxActiveCheckingTorrentsPerSSD = std::max(1, val);
+}
+
+int Session::maxActiveMovesPerLane() const
+{
+    return m_maxActiveMovesPerLane;
+}
+
+void Session::setMaxActiveMovesPerLane(const int val)
+{
+    if (val == m_maxActiveMovesPerLane)
+        return;
+
+    m_maxActiveMovesPerLane = std::max(1, val);
+    for (auto laneIter = m_moveStorageLanes.cbegin(); laneIter != m_moveStorageLanes.cend(); ++laneIter)
+        startMoveStorageJobs(laneIter.key());
+}
+
+int Session::metadataCacheSize() const
+{
+    return m_metadataCacheSize;
+}
+
+void Session::setMetadataCacheSize(const int size)
+{
+    if (size == m_metadataCacheSize)
+        return;
+
+    m_metadataCacheSize = std::max(0, size);
+    m_metadataCache->setMaxSize(static_cast<qint64>(metadataCacheSize()) * 1024 * 1024);
+}
+
+bool Session::isContentReuseEnabled() const
+{
+    return m_isContentReuseEnabled;
+}
+
+void Session::setContentReuseEnabled(const bool enabled)
+{
+    m_isContentReuseEnabled = enabled;
+}
+
+int Session::contentRemovalRateLimit() const
+{
+    return m_contentRemovalRateLimit;
+}
+
+void Session::setContentRemovalRateLimit(const int limit)
+{
+    if (limit == m_contentRemovalRateLimit)
+        return;
+
+    m_contentRemovalRateLimit = std::max(0, limit);
+    QMetaObject::invokeMethod(m_contentRemover, [this, limit = contentRemovalRateLimit()]()
+    {
+        m_contentRemover->setRateLimit(limit);
+    });
+}
+
 bool Session::isProxyPeerConnectionsEnabled() const
 {
     return m_isProxyPeerConnectionsEnabled;
@@ -3755,6 +4193,31 @@ void Session::setDiskCacheSize(int size)
     }
 }
 
+int Session::diskReadCacheSize() const
+{
+#ifdef QBT_APP_64BIT
+    return std::clamp(m_diskReadCacheSize.get(), 0, 33554431);  // 32768GiB
+#else
+    // allocate 1536MiB and leave 512MiB to the rest of program data in RAM
+    return std::clamp(m_diskReadCacheSize.get(), 0, 1536);
+#endif
+}
+
+void Session::setDiskReadCacheSize(int size)
+{
+#ifdef QBT_APP_64BIT
+    size = std::clamp(size, 0, 33554431);  // 32768GiB
+#else
+    // allocate 1536MiB and leave 512MiB to the rest of program data in RAM
+    size = std::clamp(size, 0, 1536);
+#endif
+    if (size != m_diskReadCacheSize)
+    {
+        m_diskReadCacheSize = size;
+        configureDeferred();
+    }
+}
+
 int Session::diskCacheTTL() const
 {
     return m_diskCacheTTL;
@@ -4386,9 +4849,140 @@ void Session::updateSeedingLimitTimer()
     }
 }
 
+void Session::processCheckingQueue()
+{
+    struct DeviceQueue
+    {
+        QVector<TorrentImpl *> waitingTorrents;
+        int activeCount = 0;
+    };
+
+    QHash<QString, DeviceQueue> deviceQueues;
+    QSet<TorrentID> activeTorrents;
+    int totalActiveCount = 0;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    for (CheckingDeviceStatus &deviceStatus : m_checkingDeviceStatus)
+    {
+        deviceStatus.activeCount = 0;
+        deviceStatus.queuedCount = 0;
+        deviceStatus.rate = 0;
+    }
+
+    for (TorrentImpl *const torrent : asConst(m_torrents))
+    {
+        if (torrent->isCheckingFiles())
+        {
+            // also take into account the checks which weren't started by us, e.g. of forced torrents
+            auto jobIter = m_checkingJobs.find(torrent->id());
+            if (jobIter == m_checkingJobs.end())
+                jobIter = m_checkingJobs.insert(torrent->id(), {storageDevice(torrent->actualStorageLocation()), now});
+
+            const qint64 elapsed = now - jobIter->startTime;
+            CheckingDeviceStatus &deviceStatus = m_checkingDeviceStatus[jobIter->device];
+            ++deviceStatus.activeCount;
+            if (elapsed > 0)
+                deviceStatus.rate += static_cast<qint64>(torrent->totalSize() * torrent->progress() * 1000 / elapsed);
+
+            ++deviceQueues[jobIter->device].activeCount;
+            ++totalActiveCount;
+            activeTorrents.insert(torrent->id());
+        }
+        else if (torrent->isWaitingForChecking())
+        {
+            const QString device = storageDevice(torrent->actualStorageLocation());
+            ++m_checkingDeviceStatus[device].queuedCount;
+            deviceQueues[device].waitingTorrents.append(torrent);
+        }
+    }
+
+    // forget the checks which were interrupted, e.g. by pausing torrent
+    for (auto jobIter = m_checkingJobs.begin(); jobIter != m_checkingJobs.end();)
+    {
+        if (activeTorrents.contains(jobIter.key()))
+            ++jobIter;
+        else
+            jobIter = m_checkingJobs.erase(jobIter);
+    }
+
+    for (auto queueIter = deviceQueues.begin(); queueIter != deviceQueues.end(); ++queueIter)
+    {
+        CheckingDeviceStatus &deviceStatus = m_checkingDeviceStatus[queueIter.key()];
+        deviceStatus.isSolidState = isSolidStateDevice(queueIter.key());
+        deviceStatus.limit = (deviceStatus.isSolidState
+            ? maxActiveCheckingTorrentsPerSSD() : maxActiveCheckingTorrentsPerHDD());
+
+        // Keep the checks of the same directory close to each other to reduce disk seeking
+        QVector<TorrentImpl *> &waitingTorrents = queueIter->waitingTorrents;
+        std::sort(waitingTorrents.begin(), waitingTorrents.end()
+            , [](const TorrentImpl *left, const TorrentImpl *right)
+        {
+            return (left->actualStorageLocation().data() < right->actualStorageLocation().data());
+        });
+    }
+
+    QHash<QString, CheckingDeviceQueue> checkingQueues;
+    for (auto queueIter = deviceQueues.cbegin(); queueIter != deviceQueues.cend(); ++queueIter)
+    {
+        const int limit = m_checkingDeviceStatus[queueIter.key()].limit;
+        checkingQueues.insert(queueIter.key(), {queueIter->activeCount, static_cast<int>(queueIter->waitingTorrents.size()), limit});
+    }
+
+    const QHash<QString, int> grantedSlots = distributeCheckingSlots(checkingQueues, maxActiveCheckingTorrents(), totalActiveCount);
+    for (auto slotsIter = grantedSlots.cbegin(); slotsIter != grantedSlots.cend(); ++slotsIter)
+    {
+        const QString &device = slotsIter.key();
+        const QVector<TorrentImpl *> &waitingTorrents = deviceQueues[device].waitingTorrents;
+        CheckingDeviceStatus &deviceStatus = m_checkingDeviceStatus[device];
+        for (int i = 0; i < slotsIter.value(); ++i)
+        {
+            TorrentImpl *const torrent = waitingTorrents[i];
+            torrent->startScheduledChecking();
+            m_checkingJobs.insert(torrent->id(), {device, now});
+
+            ++deviceStatus.activeCount;
+            --deviceStatus.queuedCount;
+        }
+    }
+}
+
+void Session::enqueueCheckingQueueProcessing()
+{
+    if (!isDiskAwareCheckingEnabled() || m_checkingQueueProcessingEnqueued)
+        return;
+
+    m_checkingQueueProcessingEnqueued = true;
+    QMetaObject::invokeMethod(this, [this]()
+    {
+        m_checkingQueueProcessingEnqueued = false;
+        if (isDiskAwareCheckingEnabled())
+            processCheckingQueue();
+    }, Qt::QueuedConnection);
+}
+
+QString Session::storageDevice(const Path &path)
+{
+    auto iter = m_storageDevices.find(path);
+    if (iter == m_storageDevices.end())
+        iter = m_storageDevices.insert(path, Utils::Fs::storageDeviceName(path));
+    return iter.value();
+}
+
+bool Session::isSolidStateDevice(const QString &device)
+{
+    auto iter = m_solidStateDevices.find(device);
+    if (iter == m_solidStateDevices.end())
+        iter = m_solidStateDevices.insert(device, Utils::Fs::isSolidStateDevice(device));
+    return iter.value();
+}
+
 void Session::handleTorrentShareLimitChanged(TorrentImpl *const)
 {
-    updateSeedingLimitTimer();
+    // checking per-torrent limits iterates all the torrents so it's done once per batch
+    if (m_torrentsBatchLevel > 0)
+        m_batchShareLimitChanged = true;
+    else
+        updateSeedingLimitTimer();
 }
 
 void Session::handleTorrentNameChanged(TorrentImpl *const)
@@ -4459,6 +5053,8 @@ void Session::handleTorrentUrlSeedsRemoved(TorrentImpl *const torrent, const QVe
 
 void Session::handleTorrentMetadataReceived(TorrentImpl *const torrent)
 {
+    m_contentReuseIndex.addTorrent(torrent->id(), torrent->info());
+
     if (!torrentExportDirectory().isEmpty())
         exportTorrentFile(torrent, torrentExportDirectory());
 
@@ -4468,17 +5064,42 @@ void Session::handleTorrentMetadataReceived(TorrentImpl *const torrent)
 void Session::handleTorrentPaused(TorrentImpl *const torrent)
 {
     LogMsg(tr("Torrent paused. Torrent: \"%1\"").arg(torrent->name()));
-    emit torrentPaused(torrent);
+    if (m_torrentsBatchLevel > 0)
+        m_batchUpdatedTorrents.insert(torrent);
+    else
+        emit torrentPaused(torrent);
 }
 
 void Session::handleTorrentResumed(TorrentImpl *const torrent)
 {
     LogMsg(tr("Torrent resumed. Torrent: \"%1\"").arg(torrent->name()));
-    emit torrentResumed(torrent);
+    if (m_torrentsBatchLevel > 0)
+        m_batchUpdatedTorrents.insert(torrent);
+    else
+        emit torrentResumed(torrent);
 }
 
 void Session::handleTorrentChecked(TorrentImpl *const torrent)
 {
+    const auto jobIter = m_checkingJobs.constFind(torrent->id());
+    if (jobIter != m_checkingJobs.cend())
+    {
+        const qint64 elapsed = std::max<qint64>(1, (QDateTime::currentMSecsSinceEpoch() - jobIter->startTime));
+        const qint64 checkedBytes = torrent->totalSize();
+
+        CheckingDeviceStatus &deviceStatus = m_checkingDeviceStatus[jobIter->device];
+        deviceStatus.checkedBytes += checkedBytes;
+        deviceStatus.checkingTime += elapsed;
+
+        LogMsg(tr("Torrent checked. Torrent: \"%1\". Device: \"%2\". Speed: %3")
+            .arg(torrent->name(), jobIter->device, Utils::Misc::friendlyUnit(((checkedBytes * 1000) / elapsed), true)));
+        m_checkingJobs.erase(jobIter);
+
+        // the freed slot is given to the torrents waiting for checking since they
+        // don't change their state and so don't trigger processing of the queue themselves
+        enqueueCheckingQueueProcessing();
+    }
+
     emit torrentFinishedChecking(torrent);
 }
 
@@ -4524,42 +5145,54 @@ void Session::handleTorrentResumeDataReady(TorrentImpl *const torrent, const Loa
     m_resumeDataStorage->store(torrent->id(), data);
 }
 
+void Session::checkTorrentPieces(TorrentImpl *torrent, const PieceCheckParams &params)
+{
+    LogMsg(tr("Checking pieces of torrent. Torrent: \"%1\"").arg(torrent->name()));
+    m_pieceChecker->check(torrent->id(), params);
+}
+
+void Session::handlePieceCheckFinished(const TorrentID &id, const PieceCheckResult &result)
+{
+    TorrentImpl *torrent = m_torrents.value(id);
+    if (!torrent)
+        return;
+
+    LogMsg(tr("Finished checking modified files of torrent. Torrent: \"%1\". Hashed: %2. Skipped: %3")
+           .arg(torrent->name(), Utils::Misc::friendlyUnit(result.hashedBytes), Utils::Misc::friendlyUnit(result.skippedBytes)));
+    torrent->handlePieceCheckFinished(result);
+}
+
 bool Session::addMoveTorrentStorageJob(TorrentImpl *torrent, const Path &newPath, const MoveStorageMode mode)
 {
     Q_ASSERT(torrent);
 
-    const lt::torrent_handle torrentHandle = torrent->nativeHandle();
+    const TorrentID id = torrent->id();
     const Path currentLocation = torrent->actualStorageLocation();
 
-    if (m_moveStorageQueue.size() > 1)
+    auto jobsIter = m_moveStorageJobs.find(id);
+    if ((jobsIter != m_moveStorageJobs.end()) && (jobsIter->last().startTime == 0))
     {
-        auto iter = std::find_if(m_moveStorageQueue.begin() + 1, m_moveStorageQueue.end()
-                                 , [&torrentHandle](const MoveStorageJob &job)
-        {
-            return job.torrentHandle == torrentHandle;
-        });
+        // remove existing inactive job
+        const MoveStorageJob canceledJob = jobsIter->takeLast();
+        LogMsg(tr("Torrent move canceled. Torrent: \"%1\". Source: \"%2\". Destination: \"%3\"").arg(torrent->name(), currentLocation.toString(), canceledJob.path.toString()));
+        if (canceledJob.ticket > 0)
+            --m_moveStorageLanes[canceledJob.lane].queuedCount;
 
-        if (iter != m_moveStorageQueue.end())
+        if (jobsIter->isEmpty())
         {
-            // remove existing inactive job
-            LogMsg(tr("Torrent move canceled. Torrent: \"%1\". Source: \"%2\". Destination: \"%3\"").arg(torrent->name(), currentLocation.toString(), iter->path.toString()));
-            iter = m_moveStorageQueue.erase(iter);
-
-            iter = std::find_if(iter, m_moveStorageQueue.end(), [&torrentHandle](const MoveStorageJob &job)
-            {
-                return job.torrentHandle == torrentHandle;
-            });
-
-            const bool torrentHasOutstandingJob = (iter != m_moveStorageQueue.end());
-            torrent->handleMoveStorageJobFinished(currentLocation, torrentHasOutstandingJob);
+            m_moveStorageJobs.erase(jobsIter);
+            jobsIter = m_moveStorageJobs.end();
         }
+
+        const bool torrentHasOutstandingJob = (jobsIter != m_moveStorageJobs.end());
+        torrent->handleMoveStorageJobFinished(currentLocation, torrentHasOutstandingJob);
     }
 
-    if (!m_moveStorageQueue.isEmpty() && (m_moveStorageQueue.first().torrentHandle == torrentHandle))
+    if (jobsIter != m_moveStorageJobs.end())
     {
         // if there is active job for this torrent prevent creating meaningless
         // job that will move torrent to the same location as current one
-        if (m_moveStorageQueue.first().path == newPath)
+        if (jobsIter->first().path == newPath)
         {
             LogMsg(tr("Failed to enqueue torrent move. Torrent: \"%1\". Source: \"%2\". Destination: \"%3\". Reason: torrent is currently moving to the destination")
                    .arg(torrent->name(), currentLocation.toString(), newPath.toString()));
@@ -4576,16 +5209,56 @@ bool Session::addMoveTorrentStorageJob(TorrentImpl *torrent, const Path &newPath
         }
     }
 
-    const MoveStorageJob moveStorageJob {torrentHandle, newPath, mode};
-    m_moveStorageQueue << moveStorageJob;
+    // the job starts when the active one is finished so it moves the data from its destination
+    const Path sourcePath = ((jobsIter != m_moveStorageJobs.end()) ? jobsIter->first().path : currentLocation);
+    const MoveStorageJob moveStorageJob {torrent->nativeHandle(), newPath, mode, {storageDevice(sourcePath), storageDevice(newPath)}};
+    QList<MoveStorageJob> &torrentJobs = m_moveStorageJobs[id];
+    torrentJobs.append(moveStorageJob);
     LogMsg(tr("Enqueued torrent move. Torrent: \"%1\". Source: \"%2\". Destination: \"%3\"").arg(torrent->name(), currentLocation.toString(), newPath.toString()));
 
-    if (m_moveStorageQueue.size() == 1)
-        moveTorrentStorage(moveStorageJob);
+    if (torrentJobs.size() == 1)
+        enqueueMoveStorageJob(id);
 
     return true;
 }
 
+void Session::enqueueMoveStorageJob(const TorrentID &id)
+{
+    MoveStorageJob &job = m_moveStorageJobs[id].first();
+    job.ticket = ++m_lastMoveStorageTicket;
+
+    MoveStorageLane &lane = m_moveStorageLanes[job.lane];
+    lane.queue.append({id, job.ticket});
+    ++lane.queuedCount;
+
+    startMoveStorageJobs(job.lane);
+}
+
+void Session::startMoveStorageJobs(const MoveStorageLaneKey &laneKey)
+{
+    MoveStorageLane &lane = m_moveStorageLanes[laneKey];
+    while ((lane.activeCount < maxActiveMovesPerLane()) && !lane.queue.isEmpty())
+    {
+        const auto [id, ticket] = lane.queue.takeFirst();
+
+        const auto jobsIter = m_moveStorageJobs.find(id);
+        if (jobsIter == m_moveStorageJobs.end())
+            continue;
+
+        MoveStorageJob &job = jobsIter->first();
+        if ((job.ticket != ticket) || (job.startTime > 0))
+            continue;
+
+        const TorrentImpl *torrent = m_torrents.value(id);
+        job.size = (torrent ? torrent->completedSize() : 0);
+        job.startTime = QDateTime::currentMSecsSinceEpoch();
+        --lane.queuedCount;
+        ++lane.activeCount;
+
+        moveTorrentStorage(job);
+    }
+}
+
 void Session::moveTorrentStorage(const MoveStorageJob &job) const
 {
 #ifdef QBT_USES_LIBTORRENT2
@@ -4602,21 +5275,34 @@ void Session::moveTorrentStorage(const MoveStorageJob &job) const
                             ? lt::move_flags_t::always_replace_files : lt::move_flags_t::dont_replace));
 }
 
-void Session::handleMoveTorrentStorageJobFinished(const Path &newPath)
+void Session::handleMoveTorrentStorageJobFinished(const TorrentID &id, const Path &newPath)
 {
-    const MoveStorageJob finishedJob = m_moveStorageQueue.takeFirst();
-    if (!m_moveStorageQueue.isEmpty())
-        moveTorrentStorage(m_moveStorageQueue.first());
+    const auto jobsIter = m_moveStorageJobs.find(id);
+    Q_ASSERT(jobsIter != m_moveStorageJobs.end());
+    if (jobsIter == m_moveStorageJobs.end())
+        return;
+
+    const MoveStorageJob finishedJob = jobsIter->takeFirst();
+    Q_ASSERT(finishedJob.startTime > 0);
 
-    const auto iter = std::find_if(m_moveStorageQueue.cbegin(), m_moveStorageQueue.cend()
-                                   , [&finishedJob](const MoveStorageJob &job)
+    MoveStorageLane &lane = m_moveStorageLanes[finishedJob.lane];
+    --lane.activeCount;
+    if (newPath == finishedJob.path)
     {
-        return job.torrentHandle == finishedJob.torrentHandle;
-    });
+        ++lane.finishedCount;
+        lane.movedBytes += finishedJob.size;
+        lane.movingTime += (QDateTime::currentMSecsSinceEpoch() - finishedJob.startTime);
+    }
 
-    const bool torrentHasOutstandingJob = (iter != m_moveStorageQueue.cend());
+    const bool torrentHasOutstandingJob = !jobsIter->isEmpty();
+    if (torrentHasOutstandingJob)
+        enqueueMoveStorageJob(id);
+    else
+        m_moveStorageJobs.erase(jobsIter);
 
-    TorrentImpl *torrent = m_torrents.value(finishedJob.torrentHandle.info_hash());
+    startMoveStorageJobs(finishedJob.lane);
+
+    TorrentImpl *torrent = m_torrents.value(id);
     if (torrent)
     {
         torrent->handleMoveStorageJobFinished(newPath, torrentHasOutstandingJob);
@@ -4625,7 +5311,7 @@ void Session::handleMoveTorrentStorageJobFinished(const Path &newPath)
     {
         // Last job is completed for torrent that being removing, so actually remove it
         const lt::torrent_handle nativeHandle {finishedJob.torrentHandle};
-        const RemovingTorrentData &removingTorrentData = m_removingTorrents[nativeHandle.info_hash()];
+        const RemovingTorrentData &removingTorrentData = m_removingTorrents[id];
         if (removingTorrentData.deleteOption == DeleteTorrent)
             m_nativeSession->remove_torrent(nativeHandle, lt::session::delete_partfile);
     }
@@ -4809,6 +5495,45 @@ const CacheStatus &Session::cacheStatus() const
     return m_cacheStatus;
 }
 
+DiskIOStatus Session::torrentDiskIOStatus(const TorrentID &id) const
+{
+    return m_diskIOStatistics->torrentStatus(id);
+}
+
+QHash<QString, DiskIOStatus> Session::deviceDiskIOStatus() const
+{
+    return m_diskIOStatistics->deviceStatus();
+}
+
+QHash<QString, CheckingDeviceStatus> Session::checkingDeviceStatus() const
+{
+    return m_checkingDeviceStatus;
+}
+
+ContentRemovalStatus Session::contentRemovalStatus() const
+{
+    return m_contentRemover->status();
+}
+
+PieceCheckStatistics Session::pieceCheckStatistics() const
+{
+    return m_pieceChecker->statistics();
+}
+
+QVector<MoveStorageLaneStatus> Session::moveStorageLaneStatus() const
+{
+    QVector<MoveStorageLaneStatus> result;
+    result.reserve(m_moveStorageLanes.size());
+    for (auto laneIter = m_moveStorageLanes.cbegin(); laneIter != m_moveStorageLanes.cend(); ++laneIter)
+    {
+        const MoveStorageLane &lane = laneIter.value();
+        result.append({laneIter.key().first, laneIter.key().second, maxActiveMovesPerLane()
+            , lane.activeCount, lane.queuedCount, lane.finishedCount, lane.movedBytes, lane.movingTime});
+    }
+
+    return result;
+}
+
 qint64 Session::getAlltimeDL() const
 {
     return m_statistics->getAlltimeDL();
@@ -5056,6 +5781,8 @@ TorrentImpl *Session::createTorrent(const lt::torrent_handle &nativeHandle, cons
 
     auto *const torrent = new TorrentImpl(this, m_nativeSession, nativeHandle, params);
     m_torrents.insert(torrent->id(), torrent);
+    if (torrent->hasMetadata())
+        m_contentReuseIndex.addTorrent(torrent->id(), torrent->info());
 
     if (!params.restored)
     {
@@ -5089,6 +5816,10 @@ TorrentImpl *Session::createTorrent(const lt::torrent_handle &nativeHandle, cons
     if (torrent->hasError())
         LogMsg(tr("Torrent errored. Torrent: \"%1\". Error: \"%2\"").arg(torrent->name(), torrent->error()), Log::WARNING);
 
+    // Torrent can be enqueued for checking just after adding to libtorrent
+    if (torrent->isChecking())
+        enqueueCheckingQueueProcessing();
+
     return torrent;
 }
 
@@ -5124,8 +5855,15 @@ void Session::handleTorrentDeletedAlert(const lt::torrent_deleted_alert *p)
     if (removingTorrentDataIter == m_removingTorrents.end())
         return;
 
-    Utils::Fs::smartRemoveEmptyFolderTree(removingTorrentDataIter->pathToRemove);
-    LogMsg(tr("Removed torrent and deleted its content. Torrent: \"%1\"").arg(removingTorrentDataIter->name));
+    if (removingTorrentDataIter->hasContentRemovalJob)
+    {
+        // libtorrent has released the files so they can be deleted now
+        QMetaObject::invokeMethod(m_contentRemover, [this, id]() { m_contentRemover->start(id); });
+    }
+    else
+    {
+        LogMsg(tr("Removed torrent. Torrent: \"%1\"").arg(removingTorrentDataIter->name));
+    }
     m_removingTorrents.erase(removingTorrentDataIter);
 }
 
@@ -5142,23 +5880,41 @@ void Session::handleTorrentDeleteFailedAlert(const lt::torrent_delete_failed_ale
     if (removingTorrentDataIter == m_removingTorrents.end())
         return;
 
-    if (p->error)
+    if (removingTorrentDataIter->hasContentRemovalJob)
     {
-        // libtorrent won't delete the directory if it contains files not listed in the torrent,
-        // so we remove the directory ourselves
-        Utils::Fs::smartRemoveEmptyFolderTree(removingTorrentDataIter->pathToRemove);
-
-        LogMsg(tr("Removed torrent but failed to delete its content. Torrent: \"%1\". Error: \"%2\"")
-                .arg(removingTorrentDataIter->name, QString::fromLocal8Bit(p->error.message().c_str()))
-            , Log::WARNING);
+        // only the part file failed to be deleted, the files are released anyway
+        if (p->error)
+        {
+            LogMsg(tr("Failed to delete the part file of removed torrent. Torrent: \"%1\". Error: \"%2\"")
+                    .arg(removingTorrentDataIter->name, QString::fromLocal8Bit(p->error.message().c_str()))
+                , Log::WARNING);
+        }
+        QMetaObject::invokeMethod(m_contentRemover, [this, id]() { m_contentRemover->start(id); });
     }
     else // torrent without metadata, hence no files on disk
     {
         LogMsg(tr("Removed torrent. Torrent: \"%1\"").arg(removingTorrentDataIter->name));
     }
+
     m_removingTorrents.erase(removingTorrentDataIter);
 }
 
+void Session::handleContentRemovalJobFinished(const TorrentID &id, const QString &name, const int failedCount)
+{
+    Q_UNUSED(id);
+
+    if (failedCount > 0)
+    {
+        LogMsg(tr("Removed torrent but failed to delete its content. Torrent: \"%1\". Error: \"%2\"")
+                .arg(name, tr("%1 file(s) could not be deleted").arg(failedCount))
+            , Log::WARNING);
+    }
+    else
+    {
+        LogMsg(tr("Removed torrent and deleted its content. Torrent: \"%1\"").arg(name));
+    }
+}
+
 void Session::handleMetadataReceivedAlert(const lt::metadata_received_alert *p)
 {
 #ifdef QBT_USES_LIBTORRENT2
@@ -5167,12 +5923,13 @@ void Session::handleMetadataReceivedAlert(const lt::metadata_received_alert *p)
     const auto id = TorrentID::fromInfoHash(p->handle.info_hash());
 #endif
 
+    const TorrentInfo metadata {*p->handle.torrent_file()};
+    m_metadataCache->store(metadata);
+
     const auto downloadedMetadataIter = m_downloadedMetadata.find(id);
 
     if (downloadedMetadataIter != m_downloadedMetadata.end())
     {
-        const TorrentInfo metadata {*p->handle.torrent_file()};
-
         m_downloadedMetadata.erase(downloadedMetadataIter);
         --m_extraLimit;
         adjustLimits();
@@ -5368,7 +6125,10 @@ void Session::handleSessionStatsAlert(const lt::session_stats_alert *p)
     m_cacheStatus.totalUsedBuffers = stats[m_metricIndices.disk.diskBlocksInUse];
     m_cacheStatus.jobQueueLength = stats[m_metricIndices.disk.queuedDiskJobs];
 
-#ifndef QBT_USES_LIBTORRENT2
+#ifdef QBT_USES_LIBTORRENT2
+    const DiskReadCacheStatus readCacheStatus = m_diskReadCache->status();
+    m_cacheStatus.readRatio = static_cast<qreal>(readCacheStatus.hits) / std::max<qint64>((readCacheStatus.hits + readCacheStatus.misses), 1);
+#else
     const int64_t numBlocksRead = stats[m_metricIndices.disk.numBlocksRead];
     const int64_t numBlocksCacheHits = stats[m_metricIndices.disk.numBlocksCacheHits];
     m_cacheStatus.readRatio = static_cast<qreal>(numBlocksCacheHits) / std::max<int64_t>((numBlocksCacheHits + numBlocksRead), 1);
@@ -5390,40 +6150,39 @@ void Session::handleAlertsDroppedAlert(const lt::alerts_dropped_alert *p) const
 
 void Session::handleStorageMovedAlert(const lt::storage_moved_alert *p)
 {
-    Q_ASSERT(!m_moveStorageQueue.isEmpty());
-
-    const MoveStorageJob &currentJob = m_moveStorageQueue.first();
-    Q_ASSERT(currentJob.torrentHandle == p->handle);
-
-    const Path newPath {QString::fromUtf8(p->storage_path())};
-    Q_ASSERT(newPath == currentJob.path);
-
 #ifdef QBT_USES_LIBTORRENT2
-    const auto id = TorrentID::fromInfoHash(currentJob.torrentHandle.info_hashes());
+    const auto id = TorrentID::fromInfoHash(p->handle.info_hashes());
 #else
-    const auto id = TorrentID::fromInfoHash(currentJob.torrentHandle.info_hash());
+    const auto id = TorrentID::fromInfoHash(p->handle.info_hash());
 #endif
 
+    Q_ASSERT(m_moveStorageJobs.contains(id));
+
+    const Path newPath {QString::fromUtf8(p->storage_path())};
+    Q_ASSERT(newPath == m_moveStorageJobs.value(id).first().path);
+
     TorrentImpl *torrent = m_torrents.value(id);
     const QString torrentName = (torrent ? torrent->name() : id.toString());
     LogMsg(tr("Moved torrent successfully. Torrent: \"%1\". Destination: \"%2\"").arg(torrentName, newPath.toString()));
 
-    handleMoveTorrentStorageJobFinished(newPath);
+    handleMoveTorrentStorageJobFinished(id, newPath);
 }
 
 void Session::handleStorageMovedFailedAlert(const lt::storage_moved_failed_alert *p)
 {
-    Q_ASSERT(!m_moveStorageQueue.isEmpty());
-
-    const MoveStorageJob &currentJob = m_moveStorageQueue.first();
-    Q_ASSERT(currentJob.torrentHandle == p->handle);
-
 #ifdef QBT_USES_LIBTORRENT2
-    const auto id = TorrentID::fromInfoHash(currentJob.torrentHandle.info_hashes());
+    const auto id = TorrentID::fromInfoHash(p->handle.info_hashes());
 #else
-    const auto id = TorrentID::fromInfoHash(currentJob.torrentHandle.info_hash());
+    const auto id = TorrentID::fromInfoHash(p->handle.info_hash());
 #endif
 
+    const auto jobsIter = m_moveStorageJobs.constFind(id);
+    Q_ASSERT(jobsIter != m_moveStorageJobs.cend());
+    if (jobsIter == m_moveStorageJobs.cend())
+        return;
+
+    const MoveStorageJob &currentJob = jobsIter->first();
+
     TorrentImpl *torrent = m_torrents.value(id);
     const QString torrentName = (torrent ? torrent->name() : id.toString());
     const Path currentLocation = (torrent ? torrent->actualStorageLocation()
@@ -5432,13 +6191,15 @@ void Session::handleStorageMovedFailedAlert(const lt::storage_moved_failed_alert
     LogMsg(tr("Failed to move torrent. Torrent: \"%1\". Source: \"%2\". Destination: \"%3\". Reason: \"%4\"")
            .arg(torrentName, currentLocation.toString(), currentJob.path.toString(), errorMessage), Log::WARNING);
 
-    handleMoveTorrentStorageJobFinished(currentLocation);
+    handleMoveTorrentStorageJobFinished(id, currentLocation);
 }
 
 void Session::handleStateUpdateAlert(const lt::state_update_alert *p)
 {
     QVector<Torrent *> updatedTorrents;
     updatedTorrents.reserve(static_cast<decltype(updatedTorrents)::size_type>(p->status.size()));
+    // finished or interrupted checks free their slots
+    bool needProcessCheckingQueue = !m_checkingJobs.isEmpty();
 
     for (const lt::torrent_status &status : p->status)
     {
@@ -5453,11 +6214,15 @@ void Session::handleStateUpdateAlert(const lt::state_update_alert *p)
 
         torrent->handleStateUpdate(status);
         updatedTorrents.push_back(torrent);
+        needProcessCheckingQueue = needProcessCheckingQueue || torrent->isChecking();
     }
 
     if (!updatedTorrents.isEmpty())
         emit torrentsUpdated(updatedTorrents);
 
+    if (needProcessCheckingQueue && isDiskAwareCheckingEnabled())
+        processCheckingQueue();
+
     if (m_refreshEnqueued)
         m_refreshEnqueued = false;
     else
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <functional>
 #include <variant>
 #include <vector>
 
@@ -37,6 +38,7 @@
 #include <libtorrent/torrent_handle.hpp>
 
 #include <QHash>
+#include <QPair>
 #include <QPointer>
 #include <QSet>
 #include <QtContainerFwd>
@@ -48,6 +50,11 @@
 #include "addtorrentparams.h"
 #include "cachestatus.h"
 #include "categoryoptions.h"
+#include "checkingdevicestatus.h"
+#include "contentremovalstatus.h"
+#include "contentreuse.h"
+#include "diskiostatistics.h"
+#include "movestoragelanestatus.h"
 #include "sessionstatus.h"
 #include "torrentinfo.h"
 #include "trackerentry.h"
@@ -89,13 +96,22 @@ namespace Net
 
 namespace BitTorrent
 {
+    class AddTorrentPipeline;
+    class DiskReadCache;
     class InfoHash;
     class MagnetUri;
+    class MetadataCache;
+    class PieceChecker;
     class ResumeDataStorage;
     class Torrent;
+    class TorrentContentRemover;
     class TorrentImpl;
     class Tracker;
     struct LoadTorrentParams;
+    struct PieceCheckParams;
+    struct PieceCheckResult;
+    struct PieceCheckStatistics;
+    struct PreparedTorrent;
 
     enum class MoveStorageMode;
 
@@ -334,6 +350,20 @@ namespace BitTorrent
         void setEncryption(int state);
         int maxActiveCheckingTorrents() const;
         void setMaxActiveCheckingTorrents(int val);
+        bool isDiskAwareCheckingEnabled() const;
+        void setDiskAwareCheckingEnabled(bool enabled);
+        int maxActiveCheckingTorrentsPerHDD() const;
+        void setMaxActiveCheckingTorrentsPerHDD(int val);
+        int maxActiveCheckingTorrentsPerSSD() const;
+        void setMaxActiveCheckingTorrentsPerSSD(int val);
+        int maxActiveMovesPerLane() const;
+        void setMaxActiveMovesPerLane(int val);
+        int metadataCacheSize() const;
+        void setMetadataCacheSize(int size);
+        bool isContentReuseEnabled() const;
+        void setContentReuseEnabled(bool enabled);
+        int contentRemovalRateLimit() const;
+        void setContentRemovalRateLimit(int limit);
         bool isProxyPeerConnectionsEnabled() const;
         void setProxyPeerConnectionsEnabled(bool enabled);
         ChokingAlgorithm chokingAlgorithm() const;
@@ -370,6 +400,8 @@ namespace BitTorrent
         void setCheckingMemUsage(int size);
         int diskCacheSize() const;
         void setDiskCacheSize(int size);
+        int diskReadCacheSize() const;
+        void setDiskReadCacheSize(int size);
         int diskCacheTTL() const;
         void setDiskCacheTTL(int ttl);
         qint64 diskQueueSize() const;
@@ -481,6 +513,12 @@ namespace BitTorrent
         bool hasRunningSeed() const;
         const SessionStatus &status() const;
         const CacheStatus &cacheStatus() const;
+        DiskIOStatus torrentDiskIOStatus(const TorrentID &id) const;
+        QHash<QString, DiskIOStatus> deviceDiskIOStatus() const;
+        QHash<QString, CheckingDeviceStatus> checkingDeviceStatus() const;
+        QVector<MoveStorageLaneStatus> moveStorageLaneStatus() const;
+        ContentRemovalStatus contentRemovalStatus() const;
+        PieceCheckStatistics pieceCheckStatistics() const;
         qint64 getAlltimeDL() const;
         qint64 getAlltimeUL() const;
         bool isListening() const;
@@ -494,7 +532,12 @@ namespace BitTorrent
         bool addTorrent(const QString &source, const AddTorrentParams &params = AddTorrentParams());
         bool addTorrent(const MagnetUri &magnetUri, const AddTorrentParams &params = AddTorrentParams());
         bool addTorrent(const TorrentInfo &torrentInfo, const AddTorrentParams &params = AddTorrentParams());
+        void addTorrentAsync(const TorrentInfo &torrentInfo, const AddTorrentParams &params = AddTorrentParams());
         bool deleteTorrent(const TorrentID &id, DeleteOption deleteOption = DeleteTorrent);
+        // Applies `func` to each of the torrents as a single operation:
+        // the state changes are reported by a single `torrentsUpdated()` signal once it is done
+        // instead of the per-torrent signals, and the session-wide updates are performed once
+        void applyToTorrents(const QVector<Torrent *> &torrents, const std::function<void (Torrent *)> &func);
         bool downloadMetadata(const MagnetUri &magnetUri);
         bool cancelDownloadMetadata(const TorrentID &id);
 
@@ -503,6 +546,7 @@ namespace BitTorrent
         void decreaseTorrentsQueuePos(const QVector<TorrentID> &ids);
         void topTorrentsQueuePos(const QVector<TorrentID> &ids);
         void bottomTorrentsQueuePos(const QVector<TorrentID> &ids);
+        void setTorrentsQueueOrder(const QVector<TorrentID> &ids);
 
         // Torrent interface
         void handleTorrentNeedSaveResumeData(const TorrentImpl *torrent);
@@ -525,11 +569,13 @@ namespace BitTorrent
         void handleTorrentUrlSeedsAdded(TorrentImpl *const torrent, const QVector<QUrl> &newUrlSeeds);
         void handleTorrentUrlSeedsRemoved(TorrentImpl *const torrent, const QVector<QUrl> &urlSeeds);
         void handleTorrentResumeDataReady(TorrentImpl *const torrent, const LoadTorrentParams &data);
+        void checkTorrentPieces(TorrentImpl *torrent, const PieceCheckParams &params);
 
         bool addMoveTorrentStorageJob(TorrentImpl *torrent, const Path &newPath, MoveStorageMode mode);
 
         void findIncompleteFiles(const TorrentInfo &torrentInfo, const Path &savePath
-                                 , const Path &downloadPath, const PathList &filePaths = {}) const;
+                                 , const Path &downloadPath, const PathList &filePaths = {}
+                                 , const QVector<DownloadPriority> &filePriorities = {}) const;
 
     signals:
         void startupProgressUpdated(int progress);
@@ -582,6 +628,7 @@ namespace BitTorrent
         void handleIPFilterError();
         void handleDownloadFinished(const Net::DownloadResult &result);
         void fileSearchFinished(const TorrentID &id, const Path &savePath, const PathList &fileNames);
+        void handleContentReused(const TorrentID &id, qint64 reusedBytes);
 
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
         // Session reconfiguration triggers
@@ -592,11 +639,29 @@ namespace BitTorrent
     private:
         struct ResumeSessionContext;
 
+        // Jobs moving data between the same pair of devices share a lane
+        using MoveStorageLaneKey = QPair<QString, QString>;
+
         struct MoveStorageJob
         {
             lt::torrent_handle torrentHandle;
             Path path;
             MoveStorageMode mode;
+            MoveStorageLaneKey lane;
+            quint64 ticket = 0;  // identifies the entry in lane queue, 0 if job isn't queued yet
+            qint64 size = 0;
+            qint64 startTime = 0;  // 0 if job isn't started yet
+        };
+
+        struct MoveStorageLane
+        {
+            // the entries of canceled jobs become stale and are skipped
+            QList<QPair<TorrentID, quint64>> queue;
+            int activeCount = 0;
+            int queuedCount = 0;
+            int finishedCount = 0;
+            qint64 movedBytes = 0;
+            qint64 movingTime = 0;
         };
 
         struct RemovingTorrentData
@@ -604,6 +669,13 @@ namespace BitTorrent
             QString name;
             Path pathToRemove;
             DeleteOption deleteOption;
+            bool hasContentRemovalJob = false;
+        };
+
+        struct CheckingJob
+        {
+            QString device;
+            qint64 startTime = 0;
         };
 
         explicit Session(QObject *parent = nullptr);
@@ -641,8 +713,17 @@ namespace BitTorrent
 
         LoadTorrentParams initLoadTorrentParams(const AddTorrentParams &addTorrentParams);
         bool addTorrent_impl(const std::variant<MagnetUri, TorrentInfo> &source, const AddTorrentParams &addTorrentParams);
+        void handleTorrentsPrepared(const QVector<PreparedTorrent> &torrents);
+        void handlePieceCheckFinished(const TorrentID &id, const PieceCheckResult &result);
+        QVector<ContentReuseCandidate> contentReuseCandidates(const TorrentInfo &torrentInfo
+                                                              , const QVector<DownloadPriority> &filePriorities) const;
 
         void updateSeedingLimitTimer();
+        void finishTorrentsBatch();
+        void processCheckingQueue();
+        void enqueueCheckingQueueProcessing();
+        QString storageDevice(const Path &path);
+        bool isSolidStateDevice(const QString &device);
         void exportTorrentFile(const Torrent *torrent, const Path &folderPath);
 
         void handleAlert(const lt::alert *a);
@@ -654,6 +735,7 @@ namespace BitTorrent
         void handleTorrentRemovedAlert(const lt::torrent_removed_alert *p);
         void handleTorrentDeletedAlert(const lt::torrent_deleted_alert *p);
         void handleTorrentDeleteFailedAlert(const lt::torrent_delete_failed_alert *p);
+        void handleContentRemovalJobFinished(const TorrentID &id, const QString &name, int failedCount);
         void handlePortmapWarningAlert(const lt::portmap_error_alert *p);
         void handlePortmapAlert(const lt::portmap_alert *p);
         void handlePeerBlockedAlert(const lt::peer_blocked_alert *p);
@@ -677,8 +759,10 @@ namespace BitTorrent
 
         std::vector<lt::alert *> getPendingAlerts(lt::time_duration time = lt::time_duration::zero()) const;
 
+        void enqueueMoveStorageJob(const TorrentID &id);
+        void startMoveStorageJobs(const MoveStorageLaneKey &laneKey);
         void moveTorrentStorage(const MoveStorageJob &job) const;
-        void handleMoveTorrentStorageJobFinished(const Path &newPath);
+        void handleMoveTorrentStorageJobFinished(const TorrentID &id, const Path &newPath);
 
         void loadCategories();
         void storeCategories() const;
@@ -704,6 +788,7 @@ namespace BitTorrent
         CachedSettingValue<int> m_filePoolSize;
         CachedSettingValue<int> m_checkingMemUsage;
         CachedSettingValue<int> m_diskCacheSize;
+        CachedSettingValue<int> m_diskReadCacheSize;
         CachedSettingValue<int> m_diskCacheTTL;
         CachedSettingValue<qint64> m_diskQueueSize;
         CachedSettingValue<DiskIOType> m_diskIOType;
@@ -773,6 +858,13 @@ namespace BitTorrent
         CachedSettingValue<QString> m_networkInterfaceAddress;
         CachedSettingValue<int> m_encryption;
         CachedSettingValue<int> m_maxActiveCheckingTorrents;
+        CachedSettingValue<bool> m_isDiskAwareCheckingEnabled;
+        CachedSettingValue<int> m_maxActiveCheckingTorrentsPerHDD;
+        CachedSettingValue<int> m_maxActiveCheckingTorrentsPerSSD;
+        CachedSettingValue<int> m_maxActiveMovesPerLane;
+        CachedSettingValue<int> m_contentRemovalRateLimit;
+        CachedSettingValue<int> m_metadataCacheSize;
+        CachedSettingValue<bool> m_isContentReuseEnabled;
         CachedSettingValue<bool> m_isProxyPeerConnectionsEnabled;
         CachedSettingValue<ChokingAlgorithm> m_chokingAlgorithm;
         CachedSettingValue<SeedChokingAlgorithm> m_seedChokingAlgorithm;
@@ -813,6 +905,10 @@ namespace BitTorrent
         QTimer *m_seedingLimitTimer = nullptr;
         QTimer *m_resumeDataTimer = nullptr;
         Statistics *m_statistics = nullptr;
+        DiskIOStatistics *m_diskIOStatistics = nullptr;
+        DiskReadCache *m_diskReadCache = nullptr;
+        MetadataCache *m_metadataCache = nullptr;
+        ContentReuseIndex m_contentReuseIndex;
         // IP filtering
         QPointer<FilterParserThread> m_filterParser;
         QPointer<BandwidthScheduler> m_bwScheduler;
@@ -820,8 +916,12 @@ namespace BitTorrent
         QPointer<Tracker> m_tracker;
 
         QThread *m_ioThread = nullptr;
+        QThread *m_contentRemoverThread = nullptr;
+        TorrentContentRemover *m_contentRemover = nullptr;
         ResumeDataStorage *m_resumeDataStorage = nullptr;
+        AddTorrentPipeline *m_addTorrentPipeline = nullptr;
         FileSearcher *m_fileSearcher = nullptr;
+        PieceChecker *m_pieceChecker = nullptr;
 
         QSet<TorrentID> m_downloadedMetadata;
 
@@ -830,6 +930,9 @@ namespace BitTorrent
         QHash<QString, AddTorrentParams> m_downloadedTorrents;
         QHash<TorrentID, RemovingTorrentData> m_removingTorrents;
         QSet<TorrentID> m_needSaveResumeDataTorrents;
+        int m_torrentsBatchLevel = 0;
+        QSet<TorrentImpl *> m_batchUpdatedTorrents;
+        bool m_batchShareLimitChanged = false;
         QMap<QString, CategoryOptions> m_categories;
         QSet<QString> m_tags;
 
@@ -848,7 +951,16 @@ namespace BitTorrent
         QNetworkConfigurationManager *m_networkManager = nullptr;
 #endif
 
-        QList<MoveStorageJob> m_moveStorageQueue;
+        // jobs of every torrent in order of execution, only the first one can be active
+        QHash<TorrentID, QList<MoveStorageJob>> m_moveStorageJobs;
+        QHash<MoveStorageLaneKey, MoveStorageLane> m_moveStorageLanes;
+        quint64 m_lastMoveStorageTicket = 0;
+
+        QHash<TorrentID, CheckingJob> m_checkingJobs;
+        bool m_checkingQueueProcessingEnqueued = false;
+        QHash<QString, CheckingDeviceStatus> m_checkingDeviceStatus;
+        QHash<Path, QString> m_storageDevices;
+        QHash<QString, bool> m_solidStateDevices;
 
         QString m_lastExternalIP;
 
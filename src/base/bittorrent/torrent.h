@@ -281,6 +281,11 @@ namespace BitTorrent
         virtual void forceReannounce(int index = -1) = 0;
         virtual void forceDHTAnnounce() = 0;
         virtual void forceRecheck() = 0;
+        // Hashes only the pieces of the files which were modified since they were
+        // known to be complete, falls back to full recheck if it isn't possible
+        virtual void quickRecheck() = 0;
+        // Hashes only the pieces overlapping the given files
+        virtual void recheckFiles(const QVector<int> &fileIndexes) = 0;
         virtual void prioritizeFiles(const QVector<DownloadPriority> &priorities) = 0;
         virtual void setRatioLimit(qreal limit) = 0;
         virtual void setSeedingTimeLimit(int limit) = 0;
@@ -0,0 +1,349 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentcontentremover.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QMutexLocker>
+#include <QTimer>
+
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/utils/fs.h"
+#include "base/utils/io.h"
+#include "common.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    const auto TICK_INTERVAL = 100ms;
+    // max number of files removed at once if the rate isn't limited,
+    // the thread has to process new jobs meanwhile
+    const int UNLIMITED_CHUNK_SIZE = 1000;
+
+    const QString KEY_ID = u"id"_qs;
+    const QString KEY_NAME = u"name"_qs;
+    const QString KEY_SAVE_PATH = u"save_path"_qs;
+    const QString KEY_FILES = u"files"_qs;
+    const QString KEY_PATH_TO_REMOVE = u"path_to_remove"_qs;
+    const QString KEY_QUEUED_ON = u"queued_on"_qs;
+
+    QJsonObject serializeJob(const BitTorrent::ContentRemovalJob &job)
+    {
+        QJsonArray files;
+        for (const Path &filePath : job.files)
+            files.append(filePath.data());
+
+        return {
+            {KEY_ID, job.id.toString()},
+            {KEY_NAME, job.name},
+            {KEY_SAVE_PATH, job.savePath.data()},
+            {KEY_FILES, files},
+            {KEY_PATH_TO_REMOVE, job.pathToRemove.data()},
+            {KEY_QUEUED_ON, job.queuedOn}
+        };
+    }
+
+    BitTorrent::ContentRemovalJob parseJob(const QJsonObject &jsonObj)
+    {
+        BitTorrent::ContentRemovalJob job;
+        job.id = BitTorrent::TorrentID::fromString(jsonObj.value(KEY_ID).toString());
+        job.name = jsonObj.value(KEY_NAME).toString();
+        job.savePath = Path(jsonObj.value(KEY_SAVE_PATH).toString());
+        job.pathToRemove = Path(jsonObj.value(KEY_PATH_TO_REMOVE).toString());
+        job.queuedOn = jsonObj.value(KEY_QUEUED_ON).toVariant().toLongLong();
+
+        const QJsonArray files = jsonObj.value(KEY_FILES).toArray();
+        job.files.reserve(files.size());
+        for (const QJsonValue &filePath : files)
+            job.files.append(Path(filePath.toString()));
+
+        return job;
+    }
+}
+
+BitTorrent::TorrentContentRemover::TorrentContentRemover(const Path &queueDirPath, QObject *parent)
+    : QObject(parent)
+    , m_queueDirPath {queueDirPath}
+    , m_timer {new QTimer(this)}
+{
+    connect(m_timer, &QTimer::timeout, this, &TorrentContentRemover::processFiles);
+}
+
+BitTorrent::ContentRemovalStatus BitTorrent::TorrentContentRemover::status() const
+{
+    const QMutexLocker locker {&m_statusMutex};
+    return m_status;
+}
+
+void BitTorrent::TorrentContentRemover::load()
+{
+    Utils::Fs::mkpath(m_queueDirPath);
+
+    const QStringList jobFileNames = QDir(m_queueDirPath.data()).entryList({u"*.json"_qs}, QDir::Files);
+    qint64 remainingFiles = 0;
+    for (const QString &jobFileName : jobFileNames)
+    {
+        const Path jobFilePath = m_queueDirPath / Path(jobFileName);
+        QFile file {jobFilePath.data()};
+        if (!file.open(QFile::ReadOnly))
+        {
+            LogMsg(tr("Failed to load the torrent content deletion job. File: \"%1\". Error: \"%2\"")
+                   .arg(file.fileName(), file.errorString()), Log::WARNING);
+            continue;
+        }
+
+        QJsonParseError jsonError;
+        const QJsonDocument jsonDoc = QJsonDocument::fromJson(file.readAll(), &jsonError);
+        if ((jsonError.error != QJsonParseError::NoError) || !jsonDoc.isObject())
+        {
+            LogMsg(tr("Failed to parse the torrent content deletion job. File: \"%1\"")
+                   .arg(file.fileName()), Log::WARNING);
+            continue;
+        }
+
+        const ContentRemovalJob job = parseJob(jsonDoc.object());
+        if (job.savePath.isEmpty())
+            continue;
+
+        remainingFiles += job.files.size();
+        m_jobs.append(job);
+    }
+
+    if (m_jobs.isEmpty())
+        return;
+
+    std::stable_sort(m_jobs.begin(), m_jobs.end(), [](const ContentRemovalJob &left, const ContentRemovalJob &right)
+    {
+        return (left.queuedOn < right.queuedOn);
+    });
+
+    LogMsg(tr("Resuming deletion of torrent content. Torrents: %1. Files: %2").arg(m_jobs.size()).arg(remainingFiles));
+
+    {
+        const QMutexLocker locker {&m_statusMutex};
+        m_status.queuedTorrents = m_jobs.size();
+        m_status.remainingFiles = remainingFiles;
+    }
+
+    scheduleProcessing();
+}
+
+void BitTorrent::TorrentContentRemover::enqueue(const ContentRemovalJob &job)
+{
+    // the torrent was removed again, the previous job doesn't matter anymore
+    excludeContent(job.id, {});
+
+    m_jobs.append(job);
+    m_jobs.last().queuedOn = QDateTime::currentMSecsSinceEpoch();
+    m_waitingIDs.insert(job.id);
+    storeJob(m_jobs.last());
+
+    const QMutexLocker locker {&m_statusMutex};
+    ++m_status.queuedTorrents;
+    m_status.remainingFiles += job.files.size();
+}
+
+void BitTorrent::TorrentContentRemover::start(const TorrentID &id)
+{
+    if (m_waitingIDs.remove(id))
+        scheduleProcessing();
+}
+
+void BitTorrent::TorrentContentRemover::excludeContent(const TorrentID &id, const PathList &filePaths)
+{
+    const QSet<Path> excludedPaths {filePaths.cbegin(), filePaths.cend()};
+    int excludedJobs = 0;
+    qint64 excludedFiles = 0;
+
+    for (int i = (m_jobs.size() - 1); i >= 0; --i)
+    {
+        ContentRemovalJob &job = m_jobs[i];
+        // the files of the current job that are already deleted are kept in the list
+        const int firstFileIndex = (i == m_currentJobIndex) ? m_nextFileIndex : 0;
+
+        if (job.id == id)
+        {
+            excludedFiles += (job.files.size() - firstFileIndex);
+            ++excludedJobs;
+            m_waitingIDs.remove(id);
+            removeJob(i);
+            continue;
+        }
+
+        if (excludedPaths.isEmpty())
+            continue;
+
+        const auto newEnd = std::remove_if((job.files.begin() + firstFileIndex), job.files.end()
+                                           , [&excludedPaths, &job](const Path &filePath)
+        {
+            return excludedPaths.contains((job.savePath / filePath).removedExtension(QB_EXT));
+        });
+        const auto count = static_cast<int>(job.files.end() - newEnd);
+        if (count == 0)
+            continue;
+
+        job.files.erase(newEnd, job.files.end());
+        excludedFiles += count;
+        storeJob(job);
+    }
+
+    if ((excludedJobs == 0) && (excludedFiles == 0))
+        return;
+
+    const QMutexLocker locker {&m_statusMutex};
+    m_status.queuedTorrents -= excludedJobs;
+    m_status.remainingFiles -= excludedFiles;
+}
+
+void BitTorrent::TorrentContentRemover::setRateLimit(const int filesPerSecond)
+{
+    m_rateLimit = std::max(0, filesPerSecond);
+
+    {
+        const QMutexLocker locker {&m_statusMutex};
+        m_status.rateLimit = m_rateLimit;
+    }
+
+    if (m_timer->isActive())
+    {
+        m_timer->stop();
+        scheduleProcessing();
+    }
+}
+
+void BitTorrent::TorrentContentRemover::processFiles()
+{
+    const auto ticksPerSecond = static_cast<int>(1s / TICK_INTERVAL);
+    int budget = (m_rateLimit > 0) ? std::max(1, (m_rateLimit / ticksPerSecond)) : UNLIMITED_CHUNK_SIZE;
+    qint64 removedFiles = 0;
+
+    while (budget > 0)
+    {
+        if (m_currentJobIndex < 0)
+        {
+            const auto jobIter = std::find_if(m_jobs.cbegin(), m_jobs.cend()
+                                              , [this](const ContentRemovalJob &job) { return !m_waitingIDs.contains(job.id); });
+            if (jobIter == m_jobs.cend())
+                break;
+
+            m_currentJobIndex = static_cast<int>(jobIter - m_jobs.cbegin());
+            m_nextFileIndex = 0;
+            m_failedCount = 0;
+        }
+
+        const ContentRemovalJob &job = m_jobs.at(m_currentJobIndex);
+        if (m_nextFileIndex < job.files.size())
+        {
+            if (!Utils::Fs::removeFile(job.savePath / job.files.at(m_nextFileIndex)))
+                ++m_failedCount;
+
+            ++m_nextFileIndex;
+            ++removedFiles;
+            --budget;
+            continue;
+        }
+
+        if (!job.pathToRemove.isEmpty())
+            Utils::Fs::smartRemoveEmptyFolderTree(job.pathToRemove);
+
+        emit jobFinished(job.id, job.name, m_failedCount);
+
+        removeJob(m_currentJobIndex);
+
+        const QMutexLocker locker {&m_statusMutex};
+        --m_status.queuedTorrents;
+    }
+
+    updateStatus(removedFiles);
+
+    if (m_currentJobIndex < 0)
+    {
+        const bool hasReadyJobs = std::any_of(m_jobs.cbegin(), m_jobs.cend()
+                                              , [this](const ContentRemovalJob &job) { return !m_waitingIDs.contains(job.id); });
+        if (!hasReadyJobs)
+            m_timer->stop();
+    }
+}
+
+void BitTorrent::TorrentContentRemover::scheduleProcessing()
+{
+    if (m_timer->isActive())
+        return;
+
+    // process the files as fast as possible but let the thread handle other events in between
+    m_timer->start((m_rateLimit > 0) ? TICK_INTERVAL : 0ms);
+}
+
+Path BitTorrent::TorrentContentRemover::jobFilePath(const TorrentID &id) const
+{
+    return m_queueDirPath / Path(id.toString() + u".json");
+}
+
+void BitTorrent::TorrentContentRemover::storeJob(const ContentRemovalJob &job) const
+{
+    const Path filePath = jobFilePath(job.id);
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(filePath, QJsonDocument(serializeJob(job)).toJson(QJsonDocument::Compact));
+    if (!result)
+    {
+        LogMsg(tr("Failed to save the torrent content deletion job. File: \"%1\". Error: \"%2\"")
+               .arg(filePath.toString(), result.error()), Log::WARNING);
+    }
+}
+
+// Only the job file is removed here, the rest of the queue is stored as is
+void BitTorrent::TorrentContentRemover::removeJob(const int index)
+{
+    Utils::Fs::removeFile(jobFilePath(m_jobs.at(index).id));
+    m_jobs.removeAt(index);
+
+    if (index == m_currentJobIndex)
+        m_currentJobIndex = -1;
+    else if (index < m_currentJobIndex)
+        --m_currentJobIndex;
+}
+
+void BitTorrent::TorrentContentRemover::updateStatus(const qint64 removedFiles)
+{
+    if (removedFiles == 0)
+        return;
+
+    const QMutexLocker locker {&m_statusMutex};
+    m_status.remainingFiles -= removedFiles;
+    m_status.removedFiles += removedFiles;
+}
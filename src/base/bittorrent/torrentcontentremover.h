@@ -0,0 +1,105 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+#include "base/path.h"
+#include "contentremovalstatus.h"
+#include "infohash.h"
+
+class QTimer;
+
+namespace BitTorrent
+{
+    struct ContentRemovalJob
+    {
+        TorrentID id;
+        QString name;
+        Path savePath;
+        PathList files;
+        // removed once it is empty, i.e. the root folder of the torrent
+        Path pathToRemove;
+        // keeps the order of the jobs after restart
+        qint64 queuedOn = 0;
+    };
+
+    // Deletes the content of removed torrents file by file on its own thread.
+    // The queue is stored on disk (a file per job) so the deletion continues after restart.
+    // The job is queued as soon as the torrent is removed but it is started only once
+    // libtorrent has released the files of the torrent.
+    class TorrentContentRemover final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(TorrentContentRemover)
+
+    public:
+        explicit TorrentContentRemover(const Path &queueDirPath, QObject *parent = nullptr);
+
+        // can be called from any thread
+        ContentRemovalStatus status() const;
+
+    public slots:
+        void load();
+        void enqueue(const BitTorrent::ContentRemovalJob &job);
+        void start(const BitTorrent::TorrentID &id);
+        // Drops the job of the torrent and stops deleting the given files (absolute paths)
+        // since they belong to the torrent that is added again
+        void excludeContent(const BitTorrent::TorrentID &id, const PathList &filePaths);
+        // 0 means unlimited
+        void setRateLimit(int filesPerSecond);
+
+    signals:
+        void jobFinished(const BitTorrent::TorrentID &id, const QString &name, int failedCount);
+
+    private:
+        void processFiles();
+        void scheduleProcessing();
+        Path jobFilePath(const TorrentID &id) const;
+        void storeJob(const ContentRemovalJob &job) const;
+        void removeJob(int index);
+        void updateStatus(qint64 removedFiles);
+
+        Path m_queueDirPath;
+        QList<ContentRemovalJob> m_jobs;
+        QSet<TorrentID> m_waitingIDs;
+        int m_currentJobIndex = -1;
+        int m_nextFileIndex = 0;
+        int m_failedCount = 0;
+        int m_rateLimit = 0;
+        QTimer *m_timer = nullptr;
+
+        mutable QMutex m_statusMutex;
+        ContentRemovalStatus m_status;
+    };
+}
@@ -28,15 +28,23 @@
 
 #include "torrentcreatorthread.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <functional>
+#include <vector>
 
 #include <libtorrent/create_torrent.hpp>
 #include <libtorrent/file_storage.hpp>
+#include <libtorrent/hasher.hpp>
 #include <libtorrent/torrent_info.hpp>
 
 #include <QDirIterator>
+#include <QFile>
 #include <QFileInfo>
 #include <QHash>
+#include <QSemaphore>
+#include <QThreadPool>
 
 #include "base/exceptions.h"
 #include "base/global.h"
@@ -48,6 +56,15 @@
 
 namespace
 {
+    // Content is read sequentially in chunks of whole pieces of (at least) this size
+    // which are then hashed by the worker threads
+    const qint64 CHUNK_SIZE = 4 * 1024 * 1024;
+    // Limit of the memory used by the chunks which are read but not hashed yet
+    const qint64 MAX_CHUNKS_MEMORY = 64 * 1024 * 1024;
+#ifdef QBT_USES_LIBTORRENT2
+    const int BLOCK_SIZE = 16 * 1024;  // leaf size of v2 merkle trees
+#endif
+
     // do not include files and folders whose
     // name starts with a .
     bool fileFilter(const std::string &f)
@@ -55,6 +72,213 @@ namespace
         return !Path(f).filename().startsWith(u'.');
     }
 
+    class ContentReader
+    {
+    public:
+        ContentReader(const lt::file_storage &fs, const Path &basePath)
+            : m_fs {fs}
+            , m_basePath {basePath}
+        {
+        }
+
+        // Reads next `size` bytes of the content, pad files are read as zeros
+        QByteArray read(const qint64 size)
+        {
+            QByteArray buffer {static_cast<int>(size), Qt::Uninitialized};
+            qint64 bufferPos = 0;
+            while (bufferPos < size)
+            {
+                if (m_fileIndex >= m_fs.end_file())
+                    throw RuntimeError(BitTorrent::TorrentCreatorThread::tr("Unexpected end of content"));
+
+                const qint64 fileSize = m_fs.file_size(m_fileIndex);
+                const qint64 bytesToRead = std::min((size - bufferPos), (fileSize - m_filePos));
+                if (bytesToRead > 0)
+                {
+                    if (m_fs.pad_file_at(m_fileIndex))
+                        std::fill_n((buffer.data() + bufferPos), bytesToRead, 0);
+                    else
+                        readFile((buffer.data() + bufferPos), bytesToRead);
+
+                    bufferPos += bytesToRead;
+                    m_filePos += bytesToRead;
+                }
+
+                if (m_filePos >= fileSize)
+                {
+                    m_file.close();
+                    ++m_fileIndex;
+                    m_filePos = 0;
+                }
+            }
+
+            return buffer;
+        }
+
+    private:
+        void readFile(char *data, const qint64 size)
+        {
+            if (!m_file.isOpen())
+            {
+                const Path filePath = m_basePath / Path(m_fs.file_path(m_fileIndex));
+                m_file.setFileName(filePath.data());
+                if (!m_file.open(QIODevice::ReadOnly))
+                {
+                    throw RuntimeError(BitTorrent::TorrentCreatorThread::tr("Cannot read file. File: \"%1\". Error: \"%2\"")
+                        .arg(filePath.toString(), m_file.errorString()));
+                }
+            }
+
+            if (m_file.read(data, size) != size)
+            {
+                throw RuntimeError(BitTorrent::TorrentCreatorThread::tr("Cannot read file. File: \"%1\". Error: \"%2\"")
+                    .arg(Path(m_file.fileName()).toString(), m_file.errorString()));
+            }
+        }
+
+        const lt::file_storage &m_fs;
+        const Path m_basePath;
+        lt::file_index_t m_fileIndex {0};
+        qint64 m_filePos = 0;
+        QFile m_file;
+    };
+
+#ifdef QBT_USES_LIBTORRENT2
+    int ceilPowerOfTwo(const int value)
+    {
+        int result = 1;
+        while (result < value)
+            result *= 2;
+        return result;
+    }
+
+    // Piece layer hash is the root of the merkle subtree of the piece blocks.
+    // As BEP 52 requires, leaves beyond the end of file are zero hashes and
+    // the tree of the file not larger than one piece isn't padded up to the piece size.
+    lt::sha256_hash pieceLayerHash(const lt::file_storage &fs, const lt::piece_index_t piece, const char *pieceData)
+    {
+        const lt::file_index_t fileIndex = fs.file_index_at_piece(piece);
+        const qint64 pieceOffset = static_cast<qint64>(LT::toUnderlyingType(piece)) * fs.piece_length();
+        const qint64 fileSize = fs.file_size(fileIndex);
+        const int dataSize = static_cast<int>(std::min<qint64>(fs.piece_size(piece), (fs.file_offset(fileIndex) + fileSize - pieceOffset)));
+        if (fs.pad_file_at(fileIndex) || (dataSize <= 0))
+            return {};
+
+        const int blocksPerPiece = fs.piece_length() / BLOCK_SIZE;
+        const int blockCount = (dataSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const int leafCount = (fileSize > fs.piece_length()) ? blocksPerPiece : ceilPowerOfTwo(blockCount);
+
+        std::vector<lt::sha256_hash> nodes;
+        nodes.reserve(leafCount);
+        for (int offset = 0; offset < dataSize; offset += BLOCK_SIZE)
+            nodes.push_back(lt::hasher256((pieceData + offset), std::min(BLOCK_SIZE, (dataSize - offset))).final());
+        nodes.resize(leafCount);
+
+        for (std::size_t levelSize = nodes.size(); levelSize > 1; levelSize /= 2)
+        {
+            for (std::size_t i = 0; i < (levelSize / 2); ++i)
+            {
+                lt::hasher256 hasher;
+                hasher.update(nodes[2 * i].data(), static_cast<int>(nodes[2 * i].size()));
+                hasher.update(nodes[(2 * i) + 1].data(), static_cast<int>(nodes[(2 * i) + 1].size()));
+                nodes[i] = hasher.final();
+            }
+        }
+
+        return nodes.front();
+    }
+#endif
+
+    // Replacement of lt::set_piece_hashes() which hashes the pieces on a thread pool
+    // while the content is being read sequentially by the calling thread
+    void setPieceHashes(lt::create_torrent &newTorrent, const Path &basePath, const bool hashV1, const bool hashV2
+        , const std::function<void (int hashedPieces)> &progressHandler)
+    {
+#ifndef QBT_USES_LIBTORRENT2
+        Q_UNUSED(hashV2);
+#endif
+        const lt::file_storage &fs = newTorrent.files();
+        const int numPieces = newTorrent.num_pieces();
+        const int pieceLength = newTorrent.piece_length();
+        const int piecesPerChunk = std::max(1, static_cast<int>(CHUNK_SIZE / pieceLength));
+        const qint64 chunkMemory = static_cast<qint64>(piecesPerChunk) * pieceLength;
+        // large pieces allow fewer chunks in memory, there is no use in more threads than chunks
+        const int maxChunks = static_cast<int>(std::max<qint64>(1, (MAX_CHUNKS_MEMORY / chunkMemory)));
+        const int threadCount = std::clamp(QThread::idealThreadCount(), 1, maxChunks);
+
+        std::vector<lt::sha1_hash> v1Hashes(hashV1 ? numPieces : 0);
+#ifdef QBT_USES_LIBTORRENT2
+        std::vector<lt::sha256_hash> v2Hashes(hashV2 ? numPieces : 0);
+#endif
+        std::atomic_int hashedPieces {0};
+        // limits the memory used by the chunks waiting to be hashed
+        QSemaphore freeChunks {std::min((threadCount * 2), maxChunks)};
+
+        // it waits for the running tasks when destroyed so it should go after the data they use
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(threadCount);
+
+        try
+        {
+            ContentReader reader {fs, basePath};
+            for (int firstPiece = 0; firstPiece < numPieces; firstPiece += piecesPerChunk)
+            {
+                while (!freeChunks.tryAcquire(1, 100))
+                    progressHandler(hashedPieces);
+                progressHandler(hashedPieces);
+
+                const int lastPiece = std::min((firstPiece + piecesPerChunk), numPieces) - 1;
+                const qint64 chunkSize = static_cast<qint64>(lastPiece - firstPiece) * pieceLength
+                    + fs.piece_size(lt::piece_index_t {lastPiece});
+
+                const QByteArray chunk = reader.read(chunkSize);
+                threadPool.start([&, chunk, firstPiece, lastPiece]()
+                {
+                    for (int piece = firstPiece; piece <= lastPiece; ++piece)
+                    {
+                        const lt::piece_index_t pieceIndex {piece};
+                        const char *pieceData = chunk.constData() + (static_cast<qint64>(piece - firstPiece) * pieceLength);
+                        if (hashV1)
+                            v1Hashes[piece] = lt::hasher(pieceData, fs.piece_size(pieceIndex)).final();
+#ifdef QBT_USES_LIBTORRENT2
+                        if (hashV2)
+                            v2Hashes[piece] = pieceLayerHash(fs, pieceIndex, pieceData);
+#endif
+                        ++hashedPieces;
+                    }
+
+                    freeChunks.release();
+                });
+            }
+
+            while (!threadPool.waitForDone(100))
+                progressHandler(hashedPieces);
+        }
+        catch (...)
+        {
+            threadPool.clear();
+            throw;
+        }
+
+        for (int piece = 0; piece < numPieces; ++piece)
+        {
+            const lt::piece_index_t pieceIndex {piece};
+            if (hashV1)
+                newTorrent.set_hash(pieceIndex, v1Hashes[piece]);
+#ifdef QBT_USES_LIBTORRENT2
+            if (hashV2)
+            {
+                const lt::file_index_t fileIndex = fs.file_index_at_piece(pieceIndex);
+                if (fs.pad_file_at(fileIndex) || (fs.file_size(fileIndex) == 0))
+                    continue;
+
+                const int firstFilePiece = static_cast<int>(fs.file_offset(fileIndex) / pieceLength);
+                newTorrent.set_hash2(fileIndex, (piece - firstFilePiece), v2Hashes[piece]);
+            }
+#endif
+        }
+    }
+
 #ifdef QBT_USES_LIBTORRENT2
     lt::create_flags_t toNativeTorrentFormatFlag(const BitTorrent::TorrentFormat torrentFormat)
     {
@@ -181,12 +405,20 @@ void TorrentCreatorThread::run()
                 newTorrent.add_tracker(tracker.trimmed().toStdString(), tier);
         }
 
+#ifdef QBT_USES_LIBTORRENT2
+        const bool hashV1 = (m_params.torrentFormat != TorrentFormat::V2);
+        const bool hashV2 = (m_params.torrentFormat != TorrentFormat::V1);
+#else
+        const bool hashV1 = true;
+        const bool hashV2 = false;
+#endif
+
         // calculate the hash for all pieces
-        lt::set_piece_hashes(newTorrent, parentPath.toString().toStdString()
-            , [this, &newTorrent](const lt::piece_index_t n)
+        setPieceHashes(newTorrent, parentPath, hashV1, hashV2
+            , [this, &newTorrent](const int hashedPieces)
         {
             checkInterruptionRequested();
-            sendProgressSignal(LT::toUnderlyingType(n), newTorrent.num_pieces());
+            sendProgressSignal(hashedPieces, newTorrent.num_pieces());
         });
 
         // Set qBittorrent as creator and add user comment to
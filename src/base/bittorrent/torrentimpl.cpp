@@ -284,6 +284,9 @@ TorrentImpl::TorrentImpl(Session *session, lt::session *nativeSession
             const auto priority = LT::fromNative(filePriorities[LT::toUnderlyingType(nativeIndex)]);
             m_filePriorities.append(priority);
         }
+
+        m_fileFingerprints = params.fileFingerprints;
+        m_fileFingerprints.resize(filesCount);
     }
 
     const auto *extensionData = static_cast<ExtensionData *>(m_ltAddTorrentParams.userdata);
@@ -833,7 +836,8 @@ bool TorrentImpl::isQueued() const
 bool TorrentImpl::isChecking() const
 {
     return ((m_nativeStatus.state == lt::torrent_status::checking_files)
-            || (m_nativeStatus.state == lt::torrent_status::checking_resume_data));
+            || (m_nativeStatus.state == lt::torrent_status::checking_resume_data)
+            || (m_maintenanceJob == MaintenanceJob::CheckPieces));
 }
 
 bool TorrentImpl::isDownloading() const
@@ -957,6 +961,10 @@ void TorrentImpl::updateState()
     {
         m_state = TorrentState::CheckingResumeData;
     }
+    else if (m_maintenanceJob == MaintenanceJob::CheckPieces)
+    {
+        m_state = m_hasSeedStatus ? TorrentState::CheckingUploading : TorrentState::CheckingDownloading;
+    }
     else if (isMoveInProgress())
     {
         m_state = TorrentState::Moving;
@@ -1398,12 +1406,14 @@ void TorrentImpl::forceDHTAnnounce()
 
 void TorrentImpl::forceRecheck()
 {
-    if (!hasMetadata()) return;
+    if (!hasMetadata() || (m_maintenanceJob == MaintenanceJob::CheckPieces)) return;
 
     m_nativeHandle.force_recheck();
     m_hasMissingFiles = false;
     m_unchecked = false;
     m_completedFiles.fill(false);
+    // Files are fingerprinted again once they are verified
+    m_fileFingerprints.fill(FileFingerprint());
 
     if (isPaused())
     {
@@ -1413,6 +1423,112 @@ void TorrentImpl::forceRecheck()
     }
 }
 
+void TorrentImpl::quickRecheck()
+{
+    if (!hasMetadata() || (m_maintenanceJob != MaintenanceJob::None)) return;
+
+    // Pieces are verified using v1 hashes. Without fingerprints
+    // there is nothing to skip so libtorrent checks the files itself.
+    const bool hasFingerprints = std::any_of(m_fileFingerprints.cbegin(), m_fileFingerprints.cend()
+            , [](const FileFingerprint &fingerprint) { return fingerprint.isValid(); });
+    if (!hasFingerprints || !infoHash().v1().isValid())
+    {
+        forceRecheck();
+        return;
+    }
+
+    startPieceChecking({}, true);
+}
+
+void TorrentImpl::recheckFiles(const QVector<int> &fileIndexes)
+{
+    if (!hasMetadata() || (m_maintenanceJob != MaintenanceJob::None)) return;
+
+    if (!infoHash().v1().isValid())
+    {
+        forceRecheck();
+        return;
+    }
+
+    const QBitArray pieces = piecesOverlappingFiles(m_torrentInfo, fileIndexes);
+    if (pieces.count(true) == 0)
+        return;
+
+    startPieceChecking(pieces, false);
+}
+
+void TorrentImpl::startPieceChecking(const QBitArray &piecesToCheck, const bool checkModifiedFiles)
+{
+    PieceCheckParams params;
+    params.torrentInfo = m_torrentInfo;
+    params.filePaths.reserve(filesCount());
+    for (int i = 0; i < filesCount(); ++i)
+        params.filePaths.append(actualStorageLocation() / actualFilePath(i));
+    // Progress of the torrent with missing files is preserved in resume data only
+    params.havePieces = (m_hasMissingFiles ? LT::toQBitArray(m_ltAddTorrentParams.have_pieces) : pieces());
+    params.piecesToCheck = piecesToCheck;
+    params.fileFingerprints = m_fileFingerprints;
+    params.checkModifiedFiles = checkModifiedFiles;
+    params.unwantedFiles.resize(filesCount());
+    const QVector<DownloadPriority> priorities = filePriorities();
+    for (int i = 0; i < priorities.size(); ++i)
+        params.unwantedFiles.setBit(i, (priorities[i] == DownloadPriority::Ignored));
+
+    // libtorrent must not write to the files while they are being checked
+    m_maintenanceJob = MaintenanceJob::CheckPieces;
+    setAutoManaged(false);
+    m_nativeHandle.pause();
+    updateState();
+
+    m_session->checkTorrentPieces(this, params);
+}
+
+void TorrentImpl::handlePieceCheckFinished(const PieceCheckResult &result)
+{
+    if (m_maintenanceJob != MaintenanceJob::CheckPieces)
+        return;
+
+    m_maintenanceJob = MaintenanceJob::None;
+
+    // The torrent is added again with the verified pieces as if it was
+    // restored from resume data so libtorrent doesn't check the files itself
+    lt::add_torrent_params &p = m_ltAddTorrentParams;
+    p.ti = std::const_pointer_cast<lt::torrent_info>(nativeTorrentInfo());
+    p.file_priorities = m_nativeHandle.get_file_priorities();
+    p.have_pieces.resize(result.havePieces.size());
+    for (int i = 0; i < result.havePieces.size(); ++i)
+    {
+        const lt::piece_index_t pieceIndex {i};
+        if (result.havePieces.testBit(i))
+            p.have_pieces.set_bit(pieceIndex);
+        else
+            p.have_pieces.clear_bit(pieceIndex);
+
+        if (result.checkedPieces.testBit(i))
+            p.unfinished_pieces.erase(pieceIndex);
+    }
+    p.verified_pieces.clear();
+    p.flags &= ~lt::torrent_flags::seed_mode;
+
+    m_fileFingerprints = result.fileFingerprints;
+    m_hasMissingFiles = false;
+    m_unchecked = false;
+
+    // the part file holds the data of the pieces overlapping unwanted files
+    reload(true);
+    m_session->handleTorrentNeedSaveResumeData(this);
+}
+
+void TorrentImpl::updateFileFingerprints()
+{
+    const QVector<qreal> fp = filesProgress();
+    for (int i = 0; i < fp.size(); ++i)
+    {
+        if ((fp[i] == 1) && !m_fileFingerprints.at(i).isValid())
+            m_fileFingerprints[i] = FileFingerprint::fromFile(actualStorageLocation() / actualFilePath(i));
+    }
+}
+
 void TorrentImpl::setSequentialDownload(const bool enable)
 {
     if (enable)
@@ -1546,6 +1662,7 @@ void TorrentImpl::endReceivedMetadataHandling(const Path &savePath, const PathLi
                                 , LT::toNative(p.file_priorities.empty() ? DownloadPriority::Normal : DownloadPriority::Ignored));
 
     m_completedFiles.fill(static_cast<bool>(p.flags & lt::torrent_flags::seed_mode), filesCount());
+    m_fileFingerprints.fill(FileFingerprint(), filesCount());
 
     for (int i = 0; i < fileNames.size(); ++i)
     {
@@ -1579,14 +1696,17 @@ void TorrentImpl::endReceivedMetadataHandling(const Path &savePath, const PathLi
     m_session->handleTorrentMetadataReceived(this);
 }
 
-void TorrentImpl::reload()
+void TorrentImpl::reload(const bool keepPartFile)
 {
     m_completedFiles.fill(false);
     m_pieces.clear();
 
     const auto queuePos = m_nativeHandle.queue_position();
 
-    m_nativeSession->remove_torrent(m_nativeHandle, lt::session::delete_partfile);
+    if (keepPartFile)
+        m_nativeSession->remove_torrent(m_nativeHandle);
+    else
+        m_nativeSession->remove_torrent(m_nativeHandle, lt::session::delete_partfile);
 
     lt::add_torrent_params p = m_ltAddTorrentParams;
     p.flags |= lt::torrent_flags::update_subscribe
@@ -1728,6 +1848,14 @@ void TorrentImpl::handleTorrentCheckedAlert(const lt::torrent_checked_alert *p)
 {
     Q_UNUSED(p);
 
+    if (m_isCheckingScheduled)
+    {
+        m_isCheckingScheduled = false;
+        // Stopped torrent is paused by libtorrent itself due to "stop_when_ready" flag
+        if (!m_isStopped && (m_maintenanceJob == MaintenanceJob::None))
+            setAutoManaged(m_operatingMode == TorrentOperatingMode::AutoManaged);
+    }
+
     if (!hasMetadata())
     {
         // The torrent is checked due to metadata received, but we should not process
@@ -1751,6 +1879,7 @@ void TorrentImpl::handleTorrentCheckedAlert(const lt::torrent_checked_alert *p)
 
             adjustStorageLocation();
             manageIncompleteFiles();
+            updateFileFingerprints();
         }
 
         m_session->handleTorrentChecked(this);
@@ -1834,6 +1963,9 @@ void TorrentImpl::handleSaveResumeDataAlert(const lt::save_resume_data_alert *p)
         }
 
         const auto nativeIndexes = metadata.nativeIndexes();
+        const std::vector<lt::download_priority_t> &nativePriorities = m_ltAddTorrentParams.file_priorities;
+        QVector<DownloadPriority> filePriorities;
+        filePriorities.reserve(filePaths.size());
         m_indexMap.reserve(filePaths.size());
         for (int i = 0; i < filePaths.size(); ++i)
         {
@@ -1842,9 +1974,13 @@ void TorrentImpl::handleSaveResumeDataAlert(const lt::save_resume_data_alert *p)
 
             if (const auto it = renamedFiles.find(nativeIndex); it != renamedFiles.cend())
                 filePaths[i] = Path(it->second);
+
+            const auto nativeIndexValue = static_cast<std::size_t>(LT::toUnderlyingType(nativeIndex));
+            filePriorities.append((nativeIndexValue < nativePriorities.size())
+                                  ? LT::fromNative(nativePriorities[nativeIndexValue]) : DownloadPriority::Normal);
         }
 
-        m_session->findIncompleteFiles(metadata, savePath(), downloadPath(), filePaths);
+        m_session->findIncompleteFiles(metadata, savePath(), downloadPath(), filePaths, filePriorities);
     }
     else
     {
@@ -1887,6 +2023,7 @@ void TorrentImpl::prepareResumeData(const lt::add_torrent_params &params)
     resumeData.seedingTimeLimit = m_seedingTimeLimit;
     resumeData.firstLastPiecePriority = m_hasFirstLastPiecePriority;
     resumeData.hasSeedStatus = m_hasSeedStatus;
+    resumeData.fileFingerprints = m_fileFingerprints;
     resumeData.stopped = m_isStopped;
     resumeData.operatingMode = m_operatingMode;
     resumeData.ltAddTorrentParams = m_ltAddTorrentParams;
@@ -1973,6 +2110,7 @@ void TorrentImpl::handleFileCompletedAlert(const lt::file_completed_alert *p)
     Q_ASSERT(fileIndex >= 0);
 
     m_completedFiles[fileIndex] = true;
+    m_fileFingerprints[fileIndex] = FileFingerprint::fromFile(actualStorageLocation() / actualFilePath(fileIndex));
 
     if (m_session->isAppendExtensionEnabled())
     {
@@ -2126,6 +2264,30 @@ lt::torrent_handle TorrentImpl::nativeHandle() const
     return m_nativeHandle;
 }
 
+bool TorrentImpl::isWaitingForChecking() const
+{
+    // libtorrent keeps auto managed torrents paused until they get a checking slot
+    return ((m_nativeStatus.state == lt::torrent_status::checking_files)
+            && (m_nativeStatus.flags & lt::torrent_flags::auto_managed)
+            && (m_nativeStatus.flags & lt::torrent_flags::paused));
+}
+
+bool TorrentImpl::isCheckingFiles() const
+{
+    return ((m_nativeStatus.state == lt::torrent_status::checking_files)
+            && !(m_nativeStatus.flags & lt::torrent_flags::paused));
+}
+
+void TorrentImpl::startScheduledChecking()
+{
+    // Take the torrent out of libtorrent checking queue and let it check right now.
+    // Auto management is restored when checking is done.
+    m_isCheckingScheduled = true;
+    setAutoManaged(false);
+    m_nativeHandle.resume();
+    m_nativeStatus.flags &= ~(lt::torrent_flags::auto_managed | lt::torrent_flags::paused);  // prevent return cached value
+}
+
 bool TorrentImpl::setMetadata(const TorrentInfo &torrentInfo)
 {
     if (hasMetadata())
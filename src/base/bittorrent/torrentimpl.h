@@ -49,7 +49,9 @@
 
 #include "base/path.h"
 #include "base/tagset.h"
+#include "filefingerprint.h"
 #include "infohash.h"
+#include "piecechecker.h"
 #include "speedmonitor.h"
 #include "torrent.h"
 #include "torrentcontentlayout.h"
@@ -70,7 +72,8 @@ namespace BitTorrent
     enum class MaintenanceJob
     {
         None,
-        HandleMetadata
+        HandleMetadata,
+        CheckPieces
     };
 
     struct FileErrorInfo
@@ -207,6 +210,8 @@ namespace BitTorrent
         void forceReannounce(int index = -1) override;
         void forceDHTAnnounce() override;
         void forceRecheck() override;
+        void quickRecheck() override;
+        void recheckFiles(const QVector<int> &fileIndexes) override;
         void renameFile(int index, const Path &path) override;
         void prioritizeFiles(const QVector<DownloadPriority> &priorities) override;
         void setRatioLimit(qreal limit) override;
@@ -235,6 +240,9 @@ namespace BitTorrent
 
         // Session interface
         lt::torrent_handle nativeHandle() const;
+        bool isWaitingForChecking() const;
+        bool isCheckingFiles() const;
+        void startScheduledChecking();
 
         void handleAlert(const lt::alert *a);
         void handleStateUpdate(const lt::torrent_status &nativeStatus);
@@ -243,6 +251,7 @@ namespace BitTorrent
         void saveResumeData();
         void handleMoveStorageJobFinished(const Path &path, bool hasOutstandingJob);
         void fileSearchFinished(const Path &savePath, const PathList &fileNames);
+        void handlePieceCheckFinished(const PieceCheckResult &result);
         void updatePeerCount(const QString &trackerURL, const TrackerEntry::Endpoint &endpoint, int count);
         void invalidateTrackerEntry(const QString &trackerURL);
 
@@ -280,10 +289,12 @@ namespace BitTorrent
         void moveStorage(const Path &newPath, MoveStorageMode mode);
         void manageIncompleteFiles();
         void applyFirstLastPiecePriority(bool enabled);
+        void startPieceChecking(const QBitArray &piecesToCheck, bool checkModifiedFiles);
+        void updateFileFingerprints();
 
         void prepareResumeData(const lt::add_torrent_params &params);
         void endReceivedMetadataHandling(const Path &savePath, const PathList &fileNames);
-        void reload();
+        void reload(bool keepPartFile = false);
 
         nonstd::expected<lt::entry, QString> exportTorrent() const;
 
@@ -332,9 +343,12 @@ namespace BitTorrent
         bool m_hasFirstLastPiecePriority = false;
         bool m_useAutoTMM;
         bool m_isStopped;
+        bool m_isCheckingScheduled = false;
 
         bool m_unchecked = false;
 
+        QVector<FileFingerprint> m_fileFingerprints;
+
         lt::add_torrent_params m_ltAddTorrentParams;
 
         mutable QBitArray m_pieces;
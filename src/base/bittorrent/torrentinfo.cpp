@@ -357,6 +357,19 @@ QVector<QByteArray> TorrentInfo::pieceHashes() const
     return hashes;
 }
 
+QByteArray TorrentInfo::pieceHashesData(const PieceRange &pieces) const
+{
+    if (!isValid() || (pieces.first() < 0) || (pieces.last() >= piecesCount()))
+        return {};
+
+    QByteArray data;
+    data.reserve(pieces.size() * SHA1Hash::length());
+    for (const int index : pieces)
+        data.append(m_nativeInfo->hash_for_piece_ptr(lt::piece_index_t {index}), SHA1Hash::length());
+
+    return data;
+}
+
 TorrentInfo::PieceRange TorrentInfo::filePieces(const Path &filePath) const
 {
     if (!isValid()) // if we do not check here the debug message will be printed, which would be not correct
@@ -88,6 +88,8 @@ namespace BitTorrent
         QVector<QByteArray> pieceHashes() const;
 
         using PieceRange = IndexRange<int>;
+        // returns the hashes of the pieces one after another (SHA1Hash::length() bytes each)
+        QByteArray pieceHashesData(const PieceRange &pieces) const;
         // returns pair of the first and the last pieces into which
         // the given file extends (maybe partially).
         PieceRange filePieces(const Path &filePath) const;
@@ -33,16 +33,19 @@
 #include <QTcpSocket>
 
 #include "base/logger.h"
-#include "irequesthandler.h"
-#include "requestparser.h"
+#include "eventstream.h"
 #include "responsegenerator.h"
 
 using namespace Http;
 
-Connection::Connection(QTcpSocket *socket, IRequestHandler *requestHandler, QObject *parent)
+namespace
+{
+    const long BUFFER_LIMIT = RequestParser::MAX_CONTENT_SIZE * 1.1;  // some margin for headers
+}
+
+Connection::Connection(QTcpSocket *socket, QObject *parent)
     : QObject(parent)
     , m_socket(socket)
-    , m_requestHandler(requestHandler)
 {
     m_socket->setParent(this);
 
@@ -62,25 +65,51 @@ Connection::Connection(QTcpSocket *socket, IRequestHandler *requestHandler, QObj
 Connection::~Connection()
 {
     m_socket->close();
+
+    // the stream lives in the thread of the request handler
+    if (m_eventStream)
+        m_eventStream->deleteLater();
 }
 
 void Connection::read()
 {
-    m_receivedData.append(m_socket->readAll());
+    const QByteArray data = m_socket->readAll();
 
-    while (!m_receivedData.isEmpty())
+    // nothing is expected from the client once the stream is opened
+    if (m_eventStream)
+        return;
+
+    m_requestParser.append(data);
+
+    // the pipelined requests aren't parsed until the current one is responded
+    // but the received data is limited meanwhile as well
+    if (m_isProcessingRequest)
     {
-        const RequestParser::ParseResult result = RequestParser::parse(m_receivedData);
+        if (m_requestParser.bufferedSize() > BUFFER_LIMIT)
+        {
+            // nothing can be sent before the response which is awaited
+            LogMsg(tr("Http request size exceeds limitation, closing socket. Limit: %1, IP: %2")
+                .arg(BUFFER_LIMIT).arg(m_socket->peerAddress().toString()), Log::WARNING);
+            m_socket->close();
+        }
+        return;
+    }
+
+    processReceivedData();
+}
 
-        switch (result.status)
+void Connection::processReceivedData()
+{
+    while (!m_isProcessingRequest)
+    {
+        switch (m_requestParser.parse())
         {
         case RequestParser::ParseStatus::Incomplete:
             {
-                const long bufferLimit = RequestParser::MAX_CONTENT_SIZE * 1.1;  // some margin for headers
-                if (m_receivedData.size() > bufferLimit)
+                if (m_requestParser.bufferedSize() > BUFFER_LIMIT)
                 {
                     LogMsg(tr("Http request size exceeds limitation, closing socket. Limit: %1, IP: %2")
-                        .arg(bufferLimit).arg(m_socket->peerAddress().toString()), Log::WARNING);
+                        .arg(BUFFER_LIMIT).arg(m_socket->peerAddress().toString()), Log::WARNING);
 
                     Response resp(413, u"Payload Too Large"_qs);
                     resp.headers[HEADER_CONNECTION] = u"close"_qs;
@@ -107,16 +136,12 @@ void Connection::read()
         case RequestParser::ParseStatus::OK:
             {
                 const Environment env {m_socket->localAddress(), m_socket->localPort(), m_socket->peerAddress(), m_socket->peerPort()};
+                const Request request = m_requestParser.takeRequest();
 
-                Response resp = m_requestHandler->processRequest(result.request, env);
-
-                if (acceptsGzipEncoding(result.request.headers[u"accept-encoding"_qs]))
-                    resp.headers[HEADER_CONTENT_ENCODING] = u"gzip"_qs;
-
-                resp.headers[HEADER_CONNECTION] = u"keep-alive"_qs;
+                m_isProcessingRequest = true;
+                m_acceptsGzipEncoding = acceptsGzipEncoding(request.headers[u"accept-encoding"_qs]);
 
-                sendResponse(resp);
-                m_receivedData = m_receivedData.mid(result.frameSize);
+                emit requestReceived(request, env);
             }
             break;
 
@@ -127,62 +152,68 @@ void Connection::read()
     }
 }
 
-void Connection::sendResponse(const Response &response) const
+void Connection::respond(Response response)
 {
-    m_socket->write(toByteArray(response));
-}
+    Q_ASSERT(m_isProcessingRequest);
 
-bool Connection::hasExpired(const qint64 timeout) const
-{
-    return (m_socket->bytesAvailable() == 0)
-        && (m_socket->bytesToWrite() == 0)
-        && m_idleTimer.hasExpired(timeout);
+    m_isProcessingRequest = false;
+
+    if (response.eventStream)
+    {
+        openEventStream(response);
+        return;
+    }
+
+    if (m_acceptsGzipEncoding)
+        response.headers[HEADER_CONTENT_ENCODING] = u"gzip"_qs;
+
+    response.headers[HEADER_CONNECTION] = u"keep-alive"_qs;
+
+    sendResponse(response);
+
+    // pipelined requests
+    processReceivedData();
 }
 
-bool Connection::isClosed() const
+void Connection::sendResponse(const Response &response) const
 {
-    return (m_socket->state() == QAbstractSocket::UnconnectedState);
+    m_socket->write(toByteArray(response));
 }
 
-bool Connection::acceptsGzipEncoding(QString codings)
+void Connection::openEventStream(const Response &response)
 {
-    // [rfc7231] 5.3.4. Accept-Encoding
+    m_eventStream = response.eventStream;
 
-    const auto isCodingAvailable = [](const QList<QStringView> &list, const QStringView encoding) -> bool
+    connect(m_eventStream, &EventStream::dataAvailable, this, [this](const QByteArray &data)
     {
-        for (const QStringView &str : list)
-        {
-            if (!str.startsWith(encoding))
-                continue;
-
-            // without quality values
-            if (str == encoding)
-                return true;
-
-            // [rfc7231] 5.3.1. Quality Values
-            const QStringView substr = str.mid(encoding.size() + 3);  // ex. skip over "gzip;q="
-
-            bool ok = false;
-            const double qvalue = substr.toDouble(&ok);
-            if (!ok || (qvalue <= 0))
-                return false;
+        m_socket->write(data);
+        m_eventStream->setPendingSize(m_socket->bytesToWrite());
+    });
+    connect(m_eventStream, &EventStream::closeRequested, this, [this]()
+    {
+        m_socket->close();
+    });
+    connect(m_socket, &QIODevice::bytesWritten, this, [this]()
+    {
+        m_eventStream->setPendingSize(m_socket->bytesToWrite());
+    });
 
-            return true;
-        }
-        return false;
-    };
+    m_socket->write(toStreamHeader(response));
+    QMetaObject::invokeMethod(m_eventStream, [eventStream = m_eventStream]() { eventStream->open(); });
+}
 
-    const QList<QStringView> list = QStringView(codings.remove(u' ').remove(u'\t')).split(u',', Qt::SkipEmptyParts);
-    if (list.isEmpty())
+bool Connection::hasExpired(const qint64 timeout) const
+{
+    // the response is awaited, streams are kept alive by their heartbeats
+    if (m_isProcessingRequest || m_eventStream)
         return false;
 
-    const bool canGzip = isCodingAvailable(list, u"gzip"_qs);
-    if (canGzip)
-        return true;
-
-    const bool canAny = isCodingAvailable(list, u"*"_qs);
-    if (canAny)
-        return true;
+    return (m_socket->bytesAvailable() == 0)
+        && (m_socket->bytesToWrite() == 0)
+        && m_idleTimer.hasExpired(timeout);
+}
 
-    return false;
+bool Connection::isClosed() const
+{
+    return (m_socket->state() == QAbstractSocket::UnconnectedState);
 }
@@ -33,33 +33,45 @@
 #include <QElapsedTimer>
 #include <QObject>
 
+#include "requestparser.h"
+#include "types.h"
+
 class QTcpSocket;
 
 namespace Http
 {
-    class IRequestHandler;
-    struct Response;
 
+    // Receives the requests and sends the responses over the socket.
+    // Requests are processed one at a time: the next one isn't parsed
+    // until the response to the previous one is passed to respond().
     class Connection : public QObject
     {
         Q_OBJECT
         Q_DISABLE_COPY_MOVE(Connection)
 
     public:
-        Connection(QTcpSocket *socket, IRequestHandler *requestHandler, QObject *parent = nullptr);
+        explicit Connection(QTcpSocket *socket, QObject *parent = nullptr);
         ~Connection();
 
         bool hasExpired(qint64 timeout) const;
         bool isClosed() const;
 
+        void respond(Response response);
+
+    signals:
+        void requestReceived(const Request &request, const Environment &env);
+
     private:
-        static bool acceptsGzipEncoding(QString codings);
         void read();
+        void processReceivedData();
         void sendResponse(const Response &response) const;
+        void openEventStream(const Response &response);
 
         QTcpSocket *m_socket = nullptr;
-        IRequestHandler *m_requestHandler = nullptr;
-        QByteArray m_receivedData;
+        RequestParser m_requestParser;
         QElapsedTimer m_idleTimer;
+        bool m_isProcessingRequest = false;
+        bool m_acceptsGzipEncoding = false;
+        EventStream *m_eventStream = nullptr;
     };
 }
@@ -0,0 +1,107 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "eventstream.h"
+
+#include <chrono>
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+namespace
+{
+    // Comments are sent periodically so that the connection isn't closed by proxies
+    // and the clients which are gone are detected
+    const std::chrono::seconds HEARTBEAT_INTERVAL {15};
+    const qint64 MAX_PENDING_SIZE = 4 * 1024 * 1024;
+}
+
+using namespace Http;
+
+EventStream::EventStream(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_heartbeatTimer, &QTimer::timeout, this, [this]() { write(QByteArrayLiteral(":\n\n")); });
+}
+
+bool EventStream::isOpen() const
+{
+    return m_isOpen;
+}
+
+bool EventStream::isBackedUp() const
+{
+    return (m_pendingSize.loadRelaxed() > MAX_PENDING_SIZE);
+}
+
+void EventStream::send(const QString &event, const QByteArray &data, const QString &id)
+{
+    // [HTML] 9.2.6 Interpreting an event stream
+    QByteArray buf;
+    buf.reserve(data.size() + 64);
+    buf.append("event: ").append(event.toUtf8()).append('\n');
+    if (!id.isEmpty())
+        buf.append("id: ").append(id.toUtf8()).append('\n');
+    for (const QByteArray &line : data.split('\n'))
+        buf.append("data: ").append(line).append('\n');
+    buf.append('\n');
+
+    write(buf);
+}
+
+void EventStream::close()
+{
+    m_heartbeatTimer.stop();
+    if (!m_isOpen)
+        return;
+
+    m_isOpen = false;
+    emit closeRequested();
+}
+
+void EventStream::open()
+{
+    Q_ASSERT(!m_isOpen);
+
+    m_isOpen = true;
+    m_heartbeatTimer.start(HEARTBEAT_INTERVAL);
+    emit opened();
+}
+
+// It is called from the thread of the connection
+void EventStream::setPendingSize(const qint64 size)
+{
+    m_pendingSize.storeRelaxed(size);
+}
+
+void EventStream::write(const QByteArray &data)
+{
+    if (m_isOpen)
+        emit dataAvailable(data);
+}
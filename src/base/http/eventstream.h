@@ -0,0 +1,75 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QAtomicInteger>
+#include <QObject>
+#include <QTimer>
+
+class QByteArray;
+class QString;
+
+namespace Http
+{
+    // Stream of server-sent events. It is created by the request handler, passed along
+    // with the response and opened by the connection once the response header is sent.
+    // The connection may live in another thread so the data is passed to it by signals.
+    class EventStream final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(EventStream)
+
+    public:
+        explicit EventStream(QObject *parent = nullptr);
+
+        bool isOpen() const;
+        // The client doesn't read the events as fast as they are sent
+        bool isBackedUp() const;
+
+        // The client sends the ID of the last event it has received when it reconnects
+        void send(const QString &event, const QByteArray &data, const QString &id = {});
+        void close();
+
+        // Used by the connection
+        void open();
+        void setPendingSize(qint64 size);
+
+    signals:
+        void opened();
+        void dataAvailable(const QByteArray &data);
+        void closeRequested();
+
+    private:
+        void write(const QByteArray &data);
+
+        bool m_isOpen = false;
+        QAtomicInteger<qint64> m_pendingSize = 0;
+        QTimer m_heartbeatTimer;
+    };
+}
@@ -28,16 +28,26 @@
 
 #pragma once
 
+#include <optional>
+
+#include "types.h"
+
 namespace Http
 {
-    struct Environment;
-    struct Request;
-    struct Response;
-
     class IRequestHandler
     {
     public:
         virtual ~IRequestHandler() {}
         virtual Response processRequest(const Request &request, const Environment &env) = 0;
+
+        // It is called in the I/O threads before the request is passed to processRequest()
+        // in the thread of the server. The requests which don't need the state owned by that thread
+        // (e.g. static files) can be served right away, so it should be thread-safe.
+        virtual std::optional<Response> processRequestConcurrently(const Request &request, const Environment &env)
+        {
+            Q_UNUSED(request);
+            Q_UNUSED(env);
+            return std::nullopt;
+        }
     };
 }
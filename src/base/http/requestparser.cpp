@@ -31,10 +31,12 @@
 #include "requestparser.h"
 
 #include <algorithm>
+#include <utility>
 
 #include <QDebug>
 #include <QRegularExpression>
 #include <QStringList>
+#include <QTemporaryFile>
 #include <QUrl>
 #include <QUrlQuery>
 
@@ -49,6 +51,8 @@ using QStringPair = QPair<QString, QString>;
 namespace
 {
     const QByteArray EOH = QByteArray(CRLF).repeated(2);
+    // larger message bodies are written to a temporary file as they are received
+    const int BODY_FILE_THRESHOLD = 1024 * 1024;
 
     const QByteArray viewWithoutEndingWith(const QByteArray &in, const QByteArray &str)
     {
@@ -75,38 +79,89 @@ namespace
     }
 }
 
-RequestParser::RequestParser()
+RequestParser::RequestParser() = default;
+
+RequestParser::~RequestParser() = default;
+
+void RequestParser::append(const QByteArray &data)
 {
+    // Drop the parsed data lazily so that the pipelined requests received at once
+    // don't make the rest of the data to be moved after each of them
+    if (m_offset == m_buffer.size())
+    {
+        m_buffer.clear();
+        m_scanOffset -= m_offset;
+        m_offset = 0;
+    }
+    else if (m_offset > (m_buffer.size() / 2))
+    {
+        m_buffer.remove(0, m_offset);
+        m_scanOffset -= m_offset;
+        m_offset = 0;
+    }
+
+    m_buffer.append(data);
 }
 
-RequestParser::ParseResult RequestParser::parse(const QByteArray &data)
+RequestParser::ParseStatus RequestParser::parse()
 {
-    // Warning! Header names are converted to lowercase
-    return RequestParser().doParse(data);
+    Q_ASSERT(m_state != State::Completed);
+
+    if (m_state == State::Header)
+    {
+        const ParseStatus status = parseHeader();
+        if (status != ParseStatus::OK)
+            return status;
+    }
+
+    if (m_state == State::Body)
+        return parseBody();
+
+    return ParseStatus::OK;
+}
+
+Request RequestParser::takeRequest()
+{
+    Q_ASSERT(m_state == State::Completed);
+
+    m_state = State::Header;
+    m_contentLength = 0;
+    m_scanOffset = m_offset;
+    return std::exchange(m_request, {});
+}
+
+qint64 RequestParser::bufferedSize() const
+{
+    return (m_buffer.size() - m_offset);
 }
 
-RequestParser::ParseResult RequestParser::doParse(const QByteArray &data)
+RequestParser::ParseStatus RequestParser::parseHeader()
 {
     // we don't handle malformed requests which use double `LF` as delimiter
-    const int headerEnd = data.indexOf(EOH);
+    // the end of header could be received partially last time
+    const int headerEnd = m_buffer.indexOf(EOH, std::max<int>(m_offset, (m_scanOffset - EOH.size() + 1)));
     if (headerEnd < 0)
     {
-        qDebug() << Q_FUNC_INFO << "incomplete request";
-        return {ParseStatus::Incomplete, Request(), 0};
+        m_scanOffset = m_buffer.size();
+        return ParseStatus::Incomplete;
     }
 
-    const QString httpHeaders = QString::fromLatin1(data.constData(), headerEnd);
+    // Warning! Header names are converted to lowercase
+    const QString httpHeaders = QString::fromLatin1((m_buffer.constData() + m_offset), (headerEnd - m_offset));
     if (!parseStartLines(httpHeaders))
     {
         qWarning() << Q_FUNC_INFO << "header parsing error";
-        return {ParseStatus::BadRequest, Request(), 0};
+        return fail();
     }
 
-    const int headerLength = headerEnd + EOH.length();
+    consume(headerEnd + EOH.length() - m_offset);
 
     // handle supported methods
     if ((m_request.method == HEADER_REQUEST_METHOD_GET) || (m_request.method == HEADER_REQUEST_METHOD_HEAD))
-        return {ParseStatus::OK, m_request, headerLength};
+    {
+        m_state = State::Completed;
+        return ParseStatus::OK;
+    }
     if (m_request.method == HEADER_REQUEST_METHOD_POST)
     {
         const auto parseContentLength = [this]() -> int
@@ -119,39 +174,110 @@ RequestParser::ParseResult RequestParser::doParse(const QByteArray &data)
             return Utils::String::parseInt(rawValue).value_or(-1);
         };
 
-        const int contentLength = parseContentLength();
-        if (contentLength < 0)
+        m_contentLength = parseContentLength();
+        if (m_contentLength < 0)
         {
             qWarning() << Q_FUNC_INFO << "bad request: content-length invalid";
-            return {ParseStatus::BadRequest, Request(), 0};
+            return fail();
         }
-        if (contentLength > MAX_CONTENT_SIZE)
+        if (m_contentLength > MAX_CONTENT_SIZE)
         {
             qWarning() << Q_FUNC_INFO << "bad request: message too long";
-            return {ParseStatus::BadRequest, Request(), 0};
+            return fail();
         }
 
-        if (contentLength > 0)
+        m_state = State::Body;
+        if (m_contentLength > BODY_FILE_THRESHOLD)
         {
-            const QByteArray httpBodyView = midView(data, headerLength, contentLength);
-            if (httpBodyView.length() < contentLength)
+            m_bodyFile = std::make_unique<QTemporaryFile>();
+            if (!m_bodyFile->open())
             {
-                qDebug() << Q_FUNC_INFO << "incomplete request";
-                return {ParseStatus::Incomplete, Request(), 0};
-            }
-
-            if (!parsePostMessage(httpBodyView))
-            {
-                qWarning() << Q_FUNC_INFO << "message body parsing error";
-                return {ParseStatus::BadRequest, Request(), 0};
+                qWarning() << Q_FUNC_INFO << "couldn't create temporary file for message body:" << m_bodyFile->errorString();
+                m_bodyFile.reset();
             }
         }
 
-        return {ParseStatus::OK, m_request, (headerLength + contentLength)};
+        return ParseStatus::OK;
     }
 
     qWarning() << Q_FUNC_INFO << "unsupported request method: " << m_request.method;
-    return {ParseStatus::BadRequest, Request(), 0};  // TODO: SHOULD respond "501 Not Implemented"
+    return fail();  // TODO: SHOULD respond "501 Not Implemented"
+}
+
+RequestParser::ParseStatus RequestParser::parseBody()
+{
+    if (m_bodyFile)
+    {
+        if (!writeBodyToFile())
+        {
+            qWarning() << Q_FUNC_INFO << "couldn't write message body to temporary file:" << m_bodyFile->errorString();
+            return fail();
+        }
+        if (m_bodyFile->pos() < m_contentLength)
+            return ParseStatus::Incomplete;
+
+        m_bodyFile->flush();
+        const uchar *body = m_bodyFile->map(0, m_contentLength);
+        if (!body)
+        {
+            qWarning() << Q_FUNC_INFO << "couldn't map temporary file of message body:" << m_bodyFile->errorString();
+            return fail();
+        }
+
+        // the file stays mapped while the request exists so the uploaded files don't need to be copied
+        m_request.bodyFile = std::move(m_bodyFile);
+        if (!parsePostMessage(QByteArray::fromRawData(reinterpret_cast<const char *>(body), m_contentLength)))
+        {
+            qWarning() << Q_FUNC_INFO << "message body parsing error";
+            return fail();
+        }
+    }
+    else if (m_contentLength > 0)
+    {
+        if (bufferedSize() < m_contentLength)
+            return ParseStatus::Incomplete;
+
+        if (!parsePostMessage(midView(m_buffer, m_offset, m_contentLength)))
+        {
+            qWarning() << Q_FUNC_INFO << "message body parsing error";
+            return fail();
+        }
+        consume(m_contentLength);
+    }
+
+    m_state = State::Completed;
+    return ParseStatus::OK;
+}
+
+RequestParser::ParseStatus RequestParser::fail()
+{
+    // the connection is closed anyway
+    m_buffer.clear();
+    m_offset = 0;
+    m_scanOffset = 0;
+    m_state = State::Header;
+    m_request = {};
+    m_bodyFile.reset();
+    return ParseStatus::BadRequest;
+}
+
+void RequestParser::consume(const int size)
+{
+    m_offset += size;
+    m_scanOffset = m_offset;
+}
+
+bool RequestParser::writeBodyToFile()
+{
+    const int size = std::min<qint64>(bufferedSize(), (m_contentLength - m_bodyFile->pos()));
+    if (size <= 0)
+        return true;
+
+    if (m_bodyFile->write((m_buffer.constData() + m_offset), size) != size)
+        return false;
+
+    consume(size);
+    return true;
 }
 
 bool RequestParser::parseStartLines(const QStringView data)
@@ -352,7 +478,10 @@ bool RequestParser::parseFormData(const QByteArray &data)
 
     if (headersMap.contains(filename))
     {
-        m_request.files.append({headersMap[filename], headersMap[HEADER_CONTENT_TYPE], payload});
+        // the payload is a view of either the body file kept by the request
+        // or the receive buffer which doesn't outlive the parsing
+        const QByteArray fileData = m_request.bodyFile ? payload : QByteArray(payload.constData(), payload.size());
+        m_request.files.append({headersMap[filename], headersMap[HEADER_CONTENT_TYPE], fileData});
     }
     else if (headersMap.contains(name))
     {
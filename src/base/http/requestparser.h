@@ -30,12 +30,23 @@
 
 #pragma once
 
+#include <memory>
+
+#include <QByteArray>
+
 #include "types.h"
 
+class QTemporaryFile;
+
 namespace Http
 {
+    // Parses the requests received over a connection. The parsing resumes where it
+    // stopped when more data arrives, and large message bodies are written to
+    // a temporary file instead of being kept in memory.
     class RequestParser
     {
+        Q_DISABLE_COPY_MOVE(RequestParser)
+
     public:
         enum class ParseStatus
         {
@@ -44,28 +55,47 @@ namespace Http
             BadRequest
         };
 
-        struct ParseResult
-        {
-            // when `status != ParseStatus::OK`, `request` & `frameSize` are undefined
-            ParseStatus status;
-            Request request;
-            long frameSize;  // http request frame size (bytes)
-        };
+        RequestParser();
+        ~RequestParser();
 
-        static ParseResult parse(const QByteArray &data);
+        void append(const QByteArray &data);
+        // When it returns `ParseStatus::OK`, the request is taken by `takeRequest()`
+        // and the next one can be parsed
+        ParseStatus parse();
+        Request takeRequest();
+
+        // The size of received data which is kept in memory
+        qint64 bufferedSize() const;
 
         static const long MAX_CONTENT_SIZE = 64 * 1024 * 1024;  // 64 MB
 
     private:
-        RequestParser();
+        enum class State
+        {
+            Header,
+            Body,
+            Completed
+        };
+
+        ParseStatus parseHeader();
+        ParseStatus parseBody();
+        ParseStatus fail();
+        void consume(int size);
+        bool writeBodyToFile();
 
-        ParseResult doParse(const QByteArray &data);
         bool parseStartLines(QStringView data);
         bool parseRequestLine(const QString &line);
 
         bool parsePostMessage(const QByteArray &data);
         bool parseFormData(const QByteArray &data);
 
+        QByteArray m_buffer;
+        int m_offset = 0;  // beginning of the data which isn't parsed yet
+        int m_scanOffset = 0;  // position to resume searching for the end of header from
+
+        State m_state = State::Header;
         Request m_request;
+        int m_contentLength = 0;
+        std::unique_ptr<QTemporaryFile> m_bodyFile;
     };
 }
@@ -50,6 +50,20 @@ void ResponseBuilder::print(const QByteArray &data, const QString &type)
     print_impl(data, type);
 }
 
+void ResponseBuilder::setCompressedContent(const QByteArray &data)
+{
+    m_response.compressedContent = data;
+    m_response.isPrecompressed = true;
+}
+
+void ResponseBuilder::stream(EventStream *eventStream)
+{
+    m_response.headers[HEADER_CONTENT_TYPE] = CONTENT_TYPE_EVENT_STREAM;
+    m_response.headers[HEADER_CACHE_CONTROL] = u"no-cache"_qs;
+    m_response.content.clear();
+    m_response.eventStream = eventStream;
+}
+
 void ResponseBuilder::clear()
 {
     m_response = Response();
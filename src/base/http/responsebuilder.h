@@ -42,6 +42,9 @@ namespace Http
         void setHeader(const Header &header);
         void print(const QString &text, const QString &type = CONTENT_TYPE_HTML);
         void print(const QByteArray &data, const QString &type = CONTENT_TYPE_HTML);
+        // Empty data means that the content isn't worth compressing
+        void setCompressedContent(const QByteArray &data);
+        void stream(EventStream *eventStream);
         void clear();
 
         Response response() const;
@@ -29,11 +29,41 @@
 
 #include "responsegenerator.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include <QDateTime>
 
 #include "base/http/types.h"
 #include "base/utils/gzip.h"
 
+namespace
+{
+    void appendHeader(QByteArray &buf, const Http::Response &response)
+    {
+        using namespace Http;
+
+        // Status Line
+        buf.append("HTTP/1.1 ")  // TODO: depends on request
+            .append(QByteArray::number(response.status.code))
+            .append(' ')
+            .append(response.status.text.toLatin1())
+            .append(CRLF);
+
+        // Header Fields
+        for (auto i = response.headers.constBegin(); i != response.headers.constEnd(); ++i)
+        {
+            buf.append(i.key().toLatin1())
+                .append(": ")
+                .append(i.value().toLatin1())
+                .append(CRLF);
+        }
+
+        // the first empty line
+        buf += CRLF;
+    }
+}
+
 QByteArray Http::toByteArray(Response response)
 {
     compressContent(response);
@@ -43,25 +73,7 @@ QByteArray Http::toByteArray(Response response)
 
     QByteArray buf;
     buf.reserve(1024 + response.content.length());
-
-    // Status Line
-    buf.append("HTTP/1.1 ")  // TODO: depends on request
-        .append(QByteArray::number(response.status.code))
-        .append(' ')
-        .append(response.status.text.toLatin1())
-        .append(CRLF);
-
-    // Header Fields
-    for (auto i = response.headers.constBegin(); i != response.headers.constEnd(); ++i)
-    {
-        buf.append(i.key().toLatin1())
-            .append(": ")
-            .append(i.value().toLatin1())
-            .append(CRLF);
-    }
-
-    // the first empty line
-    buf += CRLF;
+    appendHeader(buf, response);
 
     // message body  // TODO: support HEAD request
     buf += response.content;
@@ -69,6 +81,20 @@ QByteArray Http::toByteArray(Response response)
     return buf;
 }
 
+QByteArray Http::toStreamHeader(Response response)
+{
+    // the content length is unknown so the stream lasts until the connection is closed
+    response.headers.remove(HEADER_CONTENT_LENGTH);
+    response.headers.remove(HEADER_CONTENT_ENCODING);
+    response.headers[HEADER_CONNECTION] = u"close"_qs;
+    response.headers[HEADER_DATE] = httpDate();
+
+    QByteArray buf;
+    buf.reserve(1024);
+    appendHeader(buf, response);
+    return buf;
+}
+
 QString Http::httpDate()
 {
     // [RFC 7231] 7.1.1.1. Date/Time Formats
@@ -85,14 +111,19 @@ void Http::compressContent(Response &response)
 
     response.headers.remove(HEADER_CONTENT_ENCODING);
 
-    // for very small files, compressing them only wastes cpu cycles
-    const int contentSize = response.content.size();
-    if (contentSize <= 1024)  // 1 kb
+    // the content is compressed beforehand if it is worth it
+    if (response.isPrecompressed)
+    {
+        if (!response.compressedContent.isEmpty())
+        {
+            response.content = response.compressedContent;
+            response.headers[HEADER_CONTENT_ENCODING] = u"gzip"_qs;
+        }
         return;
+    }
 
-    // filter out known hard-to-compress types
-    const QString contentType = response.headers[HEADER_CONTENT_TYPE];
-    if ((contentType == CONTENT_TYPE_GIF) || (contentType == CONTENT_TYPE_PNG))
+    const int contentSize = response.content.size();
+    if (!isCompressible(response.headers[HEADER_CONTENT_TYPE], contentSize))
         return;
 
     // try compressing
@@ -108,3 +139,70 @@ void Http::compressContent(Response &response)
     response.content = compressedData;
     response.headers[HEADER_CONTENT_ENCODING] = u"gzip"_qs;
 }
+
+bool Http::isCompressible(const QString &contentType, const qint64 contentSize)
+{
+    // for very small files, compressing them only wastes cpu cycles
+    if (contentSize <= 1024)  // 1 kb
+        return false;
+
+    const QString mimeType = contentType.section(u';', 0, 0).trimmed().toLower();
+    if (mimeType.startsWith(u"image/"))
+        return (mimeType == u"image/svg+xml") || (mimeType == u"image/bmp") || (mimeType == u"image/x-icon")
+            || (mimeType == u"image/vnd.microsoft.icon");
+
+    const QString incompressibleTypes[] =
+    {
+        u"application/gzip"_qs,
+        u"application/x-bittorrent"_qs,
+        u"application/zip"_qs,
+        u"application/font-woff"_qs,
+        u"font/woff"_qs,
+        u"font/woff2"_qs
+    };
+    return !mimeType.startsWith(u"audio/") && !mimeType.startsWith(u"video/")
+        && (std::find(std::cbegin(incompressibleTypes), std::cend(incompressibleTypes), mimeType) == std::cend(incompressibleTypes));
+}
+
+bool Http::acceptsGzipEncoding(QString codings)
+{
+    // [rfc7231] 5.3.4. Accept-Encoding
+
+    const auto isCodingAvailable = [](const QList<QStringView> &list, const QStringView encoding) -> bool
+    {
+        for (const QStringView &str : list)
+        {
+            if (!str.startsWith(encoding))
+                continue;
+
+            // without quality values
+            if (str == encoding)
+                return true;
+
+            // [rfc7231] 5.3.1. Quality Values
+            const QStringView substr = str.mid(encoding.size() + 3);  // ex. skip over "gzip;q="
+
+            bool ok = false;
+            const double qvalue = substr.toDouble(&ok);
+            if (!ok || (qvalue <= 0))
+                return false;
+
+            return true;
+        }
+        return false;
+    };
+
+    const QList<QStringView> list = QStringView(codings.remove(u' ').remove(u'\t')).split(u',', Qt::SkipEmptyParts);
+    if (list.isEmpty())
+        return false;
+
+    const bool canGzip = isCodingAvailable(list, u"gzip"_qs);
+    if (canGzip)
+        return true;
+
+    const bool canAny = isCodingAvailable(list, u"*"_qs);
+    if (canAny)
+        return true;
+
+    return false;
+}
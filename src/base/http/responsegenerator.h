@@ -38,6 +38,11 @@ namespace Http
     struct Response;
 
     QByteArray toByteArray(Response response);
+    // Returns the header of the response which content is streamed
+    QByteArray toStreamHeader(Response response);
     QString httpDate();
     void compressContent(Response &response);
+    // Small and already compressed contents (images, fonts, archives) aren't worth compressing
+    bool isCompressible(const QString &contentType, qint64 contentSize);
+    bool acceptsGzipEncoding(QString codings);
 }
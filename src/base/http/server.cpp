@@ -32,18 +32,26 @@
 
 #include <algorithm>
 #include <chrono>
+#include <optional>
+#include <utility>
 
 #include <QNetworkProxy>
+#include <QAtomicInt>
+#include <QHash>
 #include <QSslCipher>
 #include <QSslConfiguration>
 #include <QSslSocket>
 #include <QStringList>
+#include <QThread>
 #include <QTimer>
 
 #include "base/algorithm.h"
 #include "base/global.h"
 #include "base/utils/net.h"
 #include "connection.h"
+#include "eventstream.h"
+#include "irequesthandler.h"
+#include "types.h"
 
 using namespace std::chrono_literals;
 
@@ -51,6 +59,7 @@ namespace
 {
     const int KEEP_ALIVE_DURATION = std::chrono::milliseconds(7s).count();
     const int CONNECTIONS_LIMIT = 500;
+    const int MAX_IO_THREADS = 4;
     const std::chrono::seconds CONNECTIONS_SCAN_INTERVAL {2};
 
     QList<QSslCipher> safeCipherList()
@@ -71,27 +80,61 @@ namespace
 
 using namespace Http;
 
-Server::Server(IRequestHandler *requestHandler, QObject *parent)
-    : QTcpServer(parent)
-    , m_requestHandler(requestHandler)
+// Serves the connections assigned to it in its I/O thread
+class Server::Worker final : public QObject
 {
-    setProxy(QNetworkProxy::NoProxy);
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(Worker)
 
-    QSslConfiguration sslConf {QSslConfiguration::defaultConfiguration()};
-    sslConf.setCiphers(safeCipherList());
-    QSslConfiguration::setDefaultConfiguration(sslConf);
+public:
+    explicit Worker(Server *server);
+
+    int connectionsCount() const;
+
+    // HTTPS is used if the certificates are provided
+    void assignConnection(qintptr socketDescriptor, const QList<QSslCertificate> &certificates, const QSslKey &key);
+    void sendResponse(quint64 connectionID, const Response &response);
 
+private:
+    void addConnection(qintptr socketDescriptor, const QList<QSslCertificate> &certificates, const QSslKey &key);
+    void removeConnection(quint64 connectionID);
+    void dropTimedOutConnections();
+
+    Server *m_server = nullptr;
+    QHash<quint64, Connection *> m_connections;  // for tracking persistent connections
+    quint64 m_lastConnectionID = 0;
+    QAtomicInt m_connectionsCount = 0;
+};
+
+Server::Worker::Worker(Server *server)
+    : m_server {server}
+{
     auto *dropConnectionTimer = new QTimer(this);
-    connect(dropConnectionTimer, &QTimer::timeout, this, &Server::dropTimedOutConnection);
+    connect(dropConnectionTimer, &QTimer::timeout, this, &Worker::dropTimedOutConnections);
     dropConnectionTimer->start(CONNECTIONS_SCAN_INTERVAL);
 }
 
-void Server::incomingConnection(const qintptr socketDescriptor)
+int Server::Worker::connectionsCount() const
+{
+    return m_connectionsCount.loadRelaxed();
+}
+
+// It is called from the thread of the server
+void Server::Worker::assignConnection(const qintptr socketDescriptor, const QList<QSslCertificate> &certificates, const QSslKey &key)
+{
+    m_connectionsCount.fetchAndAddRelaxed(1);
+    QMetaObject::invokeMethod(this, [this, socketDescriptor, certificates, key]()
+    {
+        addConnection(socketDescriptor, certificates, key);
+    });
+}
+
+void Server::Worker::addConnection(const qintptr socketDescriptor, const QList<QSslCertificate> &certificates, const QSslKey &key)
 {
-    if (m_connections.size() >= CONNECTIONS_LIMIT) return;
+    const bool isHttps = !certificates.isEmpty();
 
     QTcpSocket *serverSocket = nullptr;
-    if (m_https)
+    if (isHttps)
         serverSocket = new QSslSocket(this);
     else
         serverSocket = new QTcpSocket(this);
@@ -99,41 +142,135 @@ void Server::incomingConnection(const qintptr socketDescriptor)
     if (!serverSocket->setSocketDescriptor(socketDescriptor))
     {
         delete serverSocket;
+        m_connectionsCount.fetchAndSubRelaxed(1);
         return;
     }
 
-    if (m_https)
+    if (isHttps)
     {
         static_cast<QSslSocket *>(serverSocket)->setProtocol(QSsl::SecureProtocols);
-        static_cast<QSslSocket *>(serverSocket)->setPrivateKey(m_key);
-        static_cast<QSslSocket *>(serverSocket)->setLocalCertificateChain(m_certificates);
+        static_cast<QSslSocket *>(serverSocket)->setPrivateKey(key);
+        static_cast<QSslSocket *>(serverSocket)->setLocalCertificateChain(certificates);
         static_cast<QSslSocket *>(serverSocket)->setPeerVerifyMode(QSslSocket::VerifyNone);
         static_cast<QSslSocket *>(serverSocket)->startServerEncryption();
     }
 
-    auto *c = new Connection(serverSocket, m_requestHandler, this);
-    m_connections.insert(c);
-    connect(serverSocket, &QAbstractSocket::disconnected, this, [c, this]() { removeConnection(c); });
+    const quint64 connectionID = ++m_lastConnectionID;
+    auto *c = new Connection(serverSocket, this);
+    m_connections.insert(connectionID, c);
+    connect(serverSocket, &QAbstractSocket::disconnected, this, [this, connectionID]() { removeConnection(connectionID); });
+    connect(c, &Connection::requestReceived, this, [this, connectionID](const Request &request, const Environment &env)
+    {
+        if (std::optional<Response> response = m_server->m_requestHandler->processRequestConcurrently(request, env))
+        {
+            // the connection doesn't expect the response while it is still handling the request
+            QMetaObject::invokeMethod(this, [this, connectionID, response = std::move(*response)]()
+            {
+                sendResponse(connectionID, response);
+            }, Qt::QueuedConnection);
+            return;
+        }
+
+        QMetaObject::invokeMethod(m_server, [server = m_server, worker = this, connectionID, request, env]()
+        {
+            server->processRequest(worker, connectionID, request, env);
+        });
+    });
+}
+
+void Server::Worker::sendResponse(const quint64 connectionID, const Response &response)
+{
+    Connection *connection = m_connections.value(connectionID);
+    if (!connection)
+    {
+        // the client is gone meanwhile
+        if (response.eventStream)
+            response.eventStream->deleteLater();
+        return;
+    }
+
+    connection->respond(response);
 }
 
-void Server::removeConnection(Connection *connection)
+void Server::Worker::removeConnection(const quint64 connectionID)
 {
-    m_connections.remove(connection);
+    Connection *connection = m_connections.take(connectionID);
+    if (!connection)
+        return;
+
     connection->deleteLater();
+    m_connectionsCount.fetchAndSubRelaxed(1);
 }
 
-void Server::dropTimedOutConnection()
+void Server::Worker::dropTimedOutConnections()
 {
-    Algorithm::removeIf(m_connections, [](Connection *connection)
+    Algorithm::removeIf(m_connections, [this](const quint64, Connection *connection)
     {
         if (!connection->hasExpired(KEEP_ALIVE_DURATION))
             return false;
 
         connection->deleteLater();
+        m_connectionsCount.fetchAndSubRelaxed(1);
         return true;
     });
 }
 
+Server::Server(IRequestHandler *requestHandler, QObject *parent)
+    : QTcpServer(parent)
+    , m_requestHandler(requestHandler)
+{
+    setProxy(QNetworkProxy::NoProxy);
+
+    QSslConfiguration sslConf {QSslConfiguration::defaultConfiguration()};
+    sslConf.setCiphers(safeCipherList());
+    QSslConfiguration::setDefaultConfiguration(sslConf);
+
+    const int ioThreadsCount = std::clamp(QThread::idealThreadCount(), 1, MAX_IO_THREADS);
+    for (int i = 0; i < ioThreadsCount; ++i)
+    {
+        auto *ioThread = new QThread(this);
+        auto *worker = new Worker(this);
+        worker->moveToThread(ioThread);
+        connect(ioThread, &QThread::finished, worker, &QObject::deleteLater);
+        ioThread->start();
+
+        m_ioThreads.append(ioThread);
+        m_workers.append(worker);
+    }
+}
+
+Server::~Server()
+{
+    for (QThread *ioThread : asConst(m_ioThreads))
+        ioThread->quit();
+    for (QThread *ioThread : asConst(m_ioThreads))
+        ioThread->wait();
+}
+
+void Server::incomingConnection(const qintptr socketDescriptor)
+{
+    int connectionsCount = 0;
+    for (const Worker *worker : asConst(m_workers))
+        connectionsCount += worker->connectionsCount();
+    if (connectionsCount >= CONNECTIONS_LIMIT) return;
+
+    // the connections stay in the thread they are assigned to
+    Worker *worker = *std::min_element(m_workers.cbegin(), m_workers.cend(), [](const Worker *left, const Worker *right)
+    {
+        return left->connectionsCount() < right->connectionsCount();
+    });
+    worker->assignConnection(socketDescriptor, (m_https ? m_certificates : QList<QSslCertificate>()), m_key);
+}
+
+void Server::processRequest(Worker *worker, const quint64 connectionID, const Request &request, const Environment &env)
+{
+    const Response response = m_requestHandler->processRequest(request, env);
+    QMetaObject::invokeMethod(worker, [worker, connectionID, response]()
+    {
+        worker->sendResponse(connectionID, response);
+    });
+}
+
 bool Server::setupHttps(const QByteArray &certificates, const QByteArray &privateKey)
 {
     const QList<QSslCertificate> certs {Utils::Net::loadSSLCertificate(certificates)};
@@ -157,3 +294,5 @@ void Server::disableHttps()
     m_certificates.clear();
     m_key.clear();
 }
+
+#include "server.moc"
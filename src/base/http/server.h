@@ -30,16 +30,23 @@
 
 #pragma once
 
-#include <QSet>
 #include <QSslCertificate>
 #include <QSslKey>
 #include <QTcpServer>
+#include <QVector>
+
+class QThread;
 
 namespace Http
 {
     class IRequestHandler;
-    class Connection;
+    struct Environment;
+    struct Request;
 
+    // The connections are served (including TLS, request parsing and response
+    // compression) in a pool of I/O threads, only the requests are processed
+    // by the request handler in the thread of the server unless the handler
+    // serves them concurrently.
     class Server final : public QTcpServer
     {
         Q_OBJECT
@@ -47,19 +54,20 @@ namespace Http
 
     public:
         explicit Server(IRequestHandler *requestHandler, QObject *parent = nullptr);
+        ~Server() override;
 
         bool setupHttps(const QByteArray &certificates, const QByteArray &privateKey);
         void disableHttps();
 
-    private slots:
-        void dropTimedOutConnection();
-
     private:
+        class Worker;
+
         void incomingConnection(qintptr socketDescriptor) override;
-        void removeConnection(Connection *connection);
+        void processRequest(Worker *worker, quint64 connectionID, const Request &request, const Environment &env);
 
         IRequestHandler *m_requestHandler = nullptr;
-        QSet<Connection *> m_connections;  // for tracking persistent connections
+        QVector<QThread *> m_ioThreads;
+        QVector<Worker *> m_workers;
 
         bool m_https = false;
         QList<QSslCertificate> m_certificates;
@@ -29,17 +29,24 @@
 
 #pragma once
 
+#include <memory>
+
 #include <QHostAddress>
 #include <QString>
 #include <QVector>
 
 #include "base/global.h"
 
+class QTemporaryFile;
+
 namespace Http
 {
+    class EventStream;
+
     inline const QString METHOD_GET = u"GET"_qs;
     inline const QString METHOD_POST = u"POST"_qs;
 
+    inline const QString HEADER_ACCEPT = u"accept"_qs;
     inline const QString HEADER_CACHE_CONTROL = u"cache-control"_qs;
     inline const QString HEADER_CONNECTION = u"connection"_qs;
     inline const QString HEADER_CONTENT_DISPOSITION = u"content-disposition"_qs;
@@ -48,11 +55,15 @@ namespace Http
     inline const QString HEADER_CONTENT_SECURITY_POLICY = u"content-security-policy"_qs;
     inline const QString HEADER_CONTENT_TYPE = u"content-type"_qs;
     inline const QString HEADER_DATE = u"date"_qs;
+    inline const QString HEADER_ETAG = u"etag"_qs;
     inline const QString HEADER_HOST = u"host"_qs;
+    inline const QString HEADER_IF_NONE_MATCH = u"if-none-match"_qs;
+    inline const QString HEADER_LAST_EVENT_ID = u"last-event-id"_qs;
     inline const QString HEADER_ORIGIN = u"origin"_qs;
     inline const QString HEADER_REFERER = u"referer"_qs;
     inline const QString HEADER_REFERRER_POLICY = u"referrer-policy"_qs;
     inline const QString HEADER_SET_COOKIE = u"set-cookie"_qs;
+    inline const QString HEADER_VARY = u"vary"_qs;
     inline const QString HEADER_X_CONTENT_TYPE_OPTIONS = u"x-content-type-options"_qs;
     inline const QString HEADER_X_FORWARDED_FOR = u"x-forwarded-for"_qs;
     inline const QString HEADER_X_FORWARDED_HOST = u"x-forwarded-host"_qs;
@@ -68,10 +79,12 @@ namespace Http
     inline const QString CONTENT_TYPE_TXT = u"text/plain; charset=UTF-8"_qs;
     inline const QString CONTENT_TYPE_JS = u"application/javascript"_qs;
     inline const QString CONTENT_TYPE_JSON = u"application/json"_qs;
+    inline const QString CONTENT_TYPE_CBOR = u"application/cbor"_qs;
     inline const QString CONTENT_TYPE_GIF = u"image/gif"_qs;
     inline const QString CONTENT_TYPE_PNG = u"image/png"_qs;
     inline const QString CONTENT_TYPE_FORM_ENCODED = u"application/x-www-form-urlencoded"_qs;
     inline const QString CONTENT_TYPE_FORM_DATA = u"multipart/form-data"_qs;
+    inline const QString CONTENT_TYPE_EVENT_STREAM = u"text/event-stream"_qs;
 
     // portability: "\r\n" doesn't guarantee mapping to the correct symbol
     inline const char CRLF[] = {0x0D, 0x0A, '\0'};
@@ -109,6 +122,9 @@ namespace Http
         QHash<QString, QByteArray> query;
         QHash<QString, QString> posts;
         QVector<UploadedFile> files;
+        // The large message bodies are kept in a mapped temporary file.
+        // The data of uploaded files refers to it, so it's valid as long as the request is.
+        std::shared_ptr<QTemporaryFile> bodyFile;
     };
 
     struct ResponseStatus
@@ -122,6 +138,13 @@ namespace Http
         ResponseStatus status;
         HeaderMap headers;
         QByteArray content;
+        // The content compressed by gzip beforehand, it is sent instead if the client accepts it.
+        // The precompressed content isn't compressed on the fly even if there is no compressed one
+        // since it isn't worth it.
+        QByteArray compressedContent;
+        bool isPrecompressed = false;
+        // If set, the content is streamed instead, the connection takes ownership of it
+        EventStream *eventStream = nullptr;
 
         Response(uint code = 200, const QString &text = u"OK"_qs)
             : status {code, text}
@@ -0,0 +1,121 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "latencyhistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtAlgorithms>
+
+void LatencyHistogram::record(const qint64 value)
+{
+    const qint64 clampedValue = std::max<qint64>(value, 0);
+
+    ++m_buckets[bucketIndex(clampedValue)];
+    ++m_count;
+    m_total += clampedValue;
+    m_max = std::max(m_max, clampedValue);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+        m_buckets[i] += other.m_buckets[i];
+    m_count += other.m_count;
+    m_total += other.m_total;
+    m_max = std::max(m_max, other.m_max);
+}
+
+void LatencyHistogram::reset()
+{
+    *this = {};
+}
+
+qint64 LatencyHistogram::count() const
+{
+    return m_count;
+}
+
+qint64 LatencyHistogram::total() const
+{
+    return m_total;
+}
+
+qint64 LatencyHistogram::max() const
+{
+    return m_max;
+}
+
+qint64 LatencyHistogram::mean() const
+{
+    return (m_count > 0) ? (m_total / m_count) : 0;
+}
+
+qint64 LatencyHistogram::percentile(const qreal percent) const
+{
+    if (m_count == 0)
+        return 0;
+
+    const qreal clampedPercent = std::clamp<qreal>(percent, 0, 100);
+    const qint64 target = std::max<qint64>(1, static_cast<qint64>(std::ceil(m_count * clampedPercent / 100)));
+
+    qint64 accumulated = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        accumulated += m_buckets[i];
+        if (accumulated >= target)
+            return std::min(bucketUpperBound(i), m_max);
+    }
+
+    return m_max;
+}
+
+int LatencyHistogram::bucketIndex(const qint64 value)
+{
+    if (value < SUB_BUCKET_COUNT)
+        return static_cast<int>(value);
+
+    const int msb = 63 - qCountLeadingZeroBits(static_cast<quint64>(value));
+    if (msb >= MAX_VALUE_BITS)
+        return (BUCKET_COUNT - 1);
+
+    const int shift = msb - SUB_BUCKET_BITS;
+    const int subBucket = static_cast<int>(value >> shift) & (SUB_BUCKET_COUNT - 1);
+    return ((shift + 1) * SUB_BUCKET_COUNT) + subBucket;
+}
+
+qint64 LatencyHistogram::bucketUpperBound(const int index)
+{
+    if (index < SUB_BUCKET_COUNT)
+        return index;
+
+    const int shift = (index / SUB_BUCKET_COUNT) - 1;
+    const qint64 lowerBound = static_cast<qint64>(SUB_BUCKET_COUNT + (index % SUB_BUCKET_COUNT)) << shift;
+    return lowerBound + (qint64(1) << shift) - 1;
+}
@@ -0,0 +1,65 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+
+#include <QtGlobal>
+
+// Log-linear histogram of non-negative values (e.g. latencies in microseconds).
+// Every power of two is split into 4 sub-buckets, so reported percentiles
+// are within 25% of the real value while the whole histogram stays small.
+class LatencyHistogram
+{
+public:
+    void record(qint64 value);
+    void merge(const LatencyHistogram &other);
+    void reset();
+
+    qint64 count() const;
+    qint64 total() const;
+    qint64 max() const;
+    qint64 mean() const;
+    // `percent` is in range [0; 100]
+    qint64 percentile(qreal percent) const;
+
+private:
+    static const int SUB_BUCKET_BITS = 2;
+    static const int SUB_BUCKET_COUNT = (1 << SUB_BUCKET_BITS);
+    static const int MAX_VALUE_BITS = 36;
+    static const int BUCKET_COUNT = ((MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT);
+
+    static int bucketIndex(qint64 value);
+    static qint64 bucketUpperBound(int index);
+
+    std::array<quint32, BUCKET_COUNT> m_buckets {};
+    qint64 m_count = 0;
+    qint64 m_total = 0;
+    qint64 m_max = 0;
+};
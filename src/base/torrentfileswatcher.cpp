@@ -42,6 +42,7 @@
 #include <QJsonValue>
 #include <QSet>
 #include <QThread>
+#include <QThreadPool>
 #include <QTimer>
 #include <QVariant>
 
@@ -65,6 +66,8 @@ using namespace std::chrono_literals;
 
 const std::chrono::seconds WATCH_INTERVAL {10};
 const int MAX_FAILED_RETRIES = 5;
+// Limits the number of torrents loaded in memory at once
+const int LOAD_BATCH_SIZE = 64;
 const QString CONF_FILE_NAME = u"watched_folders.json"_qs;
 
 const QString OPTION_ADDTORRENTPARAMS = u"add_torrent_params"_qs;
@@ -87,6 +90,31 @@ const QString PARAM_RATIOLIMIT = u"ratio_limit"_qs;
 
 namespace
 {
+    using TorrentLoadResult = nonstd::expected<BitTorrent::TorrentInfo, QString>;
+
+    // Torrent files are often dropped into the watched folder in bulk
+    // so they are loaded in parallel
+    QVector<TorrentLoadResult> loadTorrentFiles(const PathList &filePaths)
+    {
+        QVector<TorrentLoadResult> results(filePaths.size());
+        TorrentLoadResult *resultsData = results.data();
+
+        QThreadPool threadPool;
+        for (int i = 0; i < filePaths.size(); ++i)
+        {
+            // every task fills in its own preallocated item so no locking is required
+            const Path filePath = filePaths.at(i);
+            TorrentLoadResult *result = resultsData + i;
+            threadPool.start([filePath, result]()
+            {
+                *result = BitTorrent::TorrentInfo::loadFromFile(filePath);
+            });
+        }
+        threadPool.waitForDone();
+
+        return results;
+    }
+
     TagSet parseTagSet(const QJsonArray &jsonArr)
     {
         TagSet tags;
@@ -457,7 +485,7 @@ void TorrentFilesWatcher::onMagnetFound(const BitTorrent::MagnetUri &magnetURI
 void TorrentFilesWatcher::onTorrentFound(const BitTorrent::TorrentInfo &torrentInfo
                                          , const BitTorrent::AddTorrentParams &addTorrentParams)
 {
-    BitTorrent::Session::instance()->addTorrent(torrentInfo, addTorrentParams);
+    BitTorrent::Session::instance()->addTorrentAsync(torrentInfo, addTorrentParams);
 }
 
 TorrentFilesWatcher::Worker::Worker()
@@ -522,26 +550,27 @@ void TorrentFilesWatcher::Worker::processWatchedFolder(const Path &path)
 void TorrentFilesWatcher::Worker::processFolder(const Path &path, const Path &watchedFolderPath
                                               , const TorrentFilesWatcher::WatchedFolderOptions &options)
 {
-    QDirIterator dirIter {path.data(), {u"*.torrent"_qs, u"*.magnet"_qs}, QDir::Files};
-    while (dirIter.hasNext())
+    BitTorrent::AddTorrentParams addTorrentParams = options.addTorrentParams;
+    if (path != watchedFolderPath)
     {
-        const Path filePath {dirIter.next()};
-        BitTorrent::AddTorrentParams addTorrentParams = options.addTorrentParams;
-        if (path != watchedFolderPath)
+        const Path subdirPath = watchedFolderPath.relativePathOf(path);
+        const bool useAutoTMM = addTorrentParams.useAutoTMM.value_or(!BitTorrent::Session::instance()->isAutoTMMDisabledByDefault());
+        if (useAutoTMM)
         {
-            const Path subdirPath = watchedFolderPath.relativePathOf(path);
-            const bool useAutoTMM = addTorrentParams.useAutoTMM.value_or(!BitTorrent::Session::instance()->isAutoTMMDisabledByDefault());
-            if (useAutoTMM)
-            {
-                addTorrentParams.category = addTorrentParams.category.isEmpty()
-                        ? subdirPath.data() : (addTorrentParams.category + u'/' + subdirPath.data());
-            }
-            else
-            {
-                addTorrentParams.savePath = addTorrentParams.savePath / subdirPath;
-            }
+            addTorrentParams.category = addTorrentParams.category.isEmpty()
+                    ? subdirPath.data() : (addTorrentParams.category + u'/' + subdirPath.data());
+        }
+        else
+        {
+            addTorrentParams.savePath = addTorrentParams.savePath / subdirPath;
         }
+    }
 
+    PathList torrentFilePaths;
+    QDirIterator dirIter {path.data(), {u"*.torrent"_qs, u"*.magnet"_qs}, QDir::Files};
+    while (dirIter.hasNext())
+    {
+        const Path filePath {dirIter.next()};
         if (filePath.hasExtension(u".magnet"_qs))
         {
             QFile file {filePath.data()};
@@ -563,7 +592,18 @@ void TorrentFilesWatcher::Worker::processFolder(const Path &path, const Path &wa
         }
         else
         {
-            const nonstd::expected<BitTorrent::TorrentInfo, QString> result = BitTorrent::TorrentInfo::loadFromFile(filePath);
+            torrentFilePaths.append(filePath);
+        }
+    }
+
+    for (int offset = 0; offset < torrentFilePaths.size(); offset += LOAD_BATCH_SIZE)
+    {
+        const PathList batchFilePaths = torrentFilePaths.mid(offset, LOAD_BATCH_SIZE);
+        const QVector<TorrentLoadResult> results = loadTorrentFiles(batchFilePaths);
+        for (int i = 0; i < batchFilePaths.size(); ++i)
+        {
+            const Path &filePath = batchFilePaths.at(i);
+            const TorrentLoadResult &result = results.at(i);
             if (result)
             {
                 emit torrentFound(result.value(), addTorrentParams);
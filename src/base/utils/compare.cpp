@@ -93,4 +93,20 @@ int Utils::Compare::naturalCompare(const QString &left, const QString &right, co
         }
     }
 }
+
+Utils::Compare::NaturalSortKey::NaturalSortKey(const QString &str, const Qt::CaseSensitivity caseSensitivity)
+    : m_string {str}
+{
+    // case fold it the same way naturalCompare() does
+    if (caseSensitivity == Qt::CaseInsensitive)
+    {
+        for (QChar &c : m_string)
+            c = c.toLower();
+    }
+}
+
+int Utils::Compare::NaturalSortKey::compare(const NaturalSortKey &other) const
+{
+    return naturalCompare(m_string, other.m_string, Qt::CaseSensitive);
+}
 #endif
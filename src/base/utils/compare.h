@@ -30,17 +30,19 @@
 
 #include <Qt>
 #include <QtGlobal>
+#include <QString>
 
 #if !defined(Q_OS_WIN) && (!defined(Q_OS_UNIX) || defined(Q_OS_MACOS) || defined(QT_FEATURE_icu))
 #define QBT_USE_QCOLLATOR
 #include <QCollator>
 #endif
 
-class QString;
-
 namespace Utils::Compare
 {
 #ifdef QBT_USE_QCOLLATOR
+    // The keys can only be compared with the ones made by the same comparator
+    using NaturalSortKey = QCollatorSortKey;
+
     template <Qt::CaseSensitivity caseSensitivity>
     class NaturalCompare
     {
@@ -56,12 +58,31 @@ namespace Utils::Compare
             return m_collator.compare(left, right);
         }
 
+        // Comparing the keys is cheaper than comparing the strings
+        // when each string takes part in many comparisons (e.g. in sorting)
+        NaturalSortKey sortKey(const QString &str) const
+        {
+            return m_collator.sortKey(str);
+        }
+
     private:
         QCollator m_collator;
     };
 #else
     int naturalCompare(const QString &left, const QString &right, Qt::CaseSensitivity caseSensitivity);
 
+    class NaturalSortKey
+    {
+    public:
+        NaturalSortKey(const QString &str, Qt::CaseSensitivity caseSensitivity);
+
+        int compare(const NaturalSortKey &other) const;
+
+    private:
+        // it's already case folded if comparison is case insensitive
+        QString m_string;
+    };
+
     template <Qt::CaseSensitivity caseSensitivity>
     class NaturalCompare
     {
@@ -70,6 +91,13 @@ namespace Utils::Compare
         {
             return naturalCompare(left, right, caseSensitivity);
         }
+
+        // Comparing the keys is cheaper than comparing the strings
+        // when each string takes part in many comparisons (e.g. in sorting)
+        NaturalSortKey sortKey(const QString &str) const
+        {
+            return {str, caseSensitivity};
+        }
     };
 #endif
 
@@ -29,13 +29,12 @@
 
 #include "fs.h"
 
+#include <atomic>
 #include <cerrno>
 #include <cstring>
 #include <filesystem>
-
-#if defined(Q_OS_WIN)
 #include <memory>
-#endif
+#include <utility>
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -52,6 +51,14 @@
 #include <unistd.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
+
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
@@ -64,6 +71,125 @@
 #include "base/global.h"
 #include "base/path.h"
 
+namespace
+{
+    std::atomic<qint64> clonedBytes {0};
+    std::atomic<qint64> copyFileRangeBytes {0};
+    std::atomic<qint64> sendFileBytes {0};
+    std::atomic<qint64> readWriteBytes {0};
+
+#if defined(Q_OS_LINUX)
+    class FileDescriptor
+    {
+    public:
+        explicit FileDescriptor(const int fd)
+            : m_fd {fd}
+        {
+        }
+
+        ~FileDescriptor()
+        {
+            if (m_fd >= 0)
+                ::close(m_fd);
+        }
+
+        FileDescriptor(const FileDescriptor &) = delete;
+        FileDescriptor &operator=(const FileDescriptor &) = delete;
+
+        int fd() const
+        {
+            return m_fd;
+        }
+
+        bool close()
+        {
+            const int fd = std::exchange(m_fd, -1);
+            return (::close(fd) == 0);
+        }
+
+    private:
+        int m_fd = -1;
+    };
+
+    // Tries the cheapest method first: sharing the extents (reflink) is instant on CoW file systems,
+    // `copy_file_range()` stays in the kernel and can be offloaded to the server on network file systems,
+    // `sendfile()` avoids the user space buffers at least. Every method continues from the file offsets
+    // left by the previous one so a method that stops in the middle doesn't waste what it has copied.
+    bool copyFileContents(const int source, const int destination, const qint64 size)
+    {
+#ifdef FICLONE
+        if (::ioctl(destination, FICLONE, source) == 0)
+        {
+            clonedBytes += size;
+            return true;
+        }
+#endif
+
+        qint64 copied = 0;
+
+#ifdef __NR_copy_file_range
+        while (copied < size)
+        {
+            const auto ret = ::syscall(__NR_copy_file_range, source, nullptr, destination, nullptr
+                                       , static_cast<size_t>(size - copied), 0u);
+            if (ret <= 0)
+                break;
+
+            copied += ret;
+            copyFileRangeBytes += ret;
+        }
+#endif
+
+        while (copied < size)
+        {
+            const ssize_t ret = ::sendfile(destination, source, nullptr, static_cast<size_t>(size - copied));
+            if (ret <= 0)
+                break;
+
+            copied += ret;
+            sendFileBytes += ret;
+        }
+
+        const int BUFFER_SIZE = 1024 * 1024;
+        std::unique_ptr<char[]> buffer;
+        while (copied < size)
+        {
+            if (!buffer)
+                buffer = std::make_unique<char[]>(BUFFER_SIZE);
+
+            const ssize_t readBytes = ::read(source, buffer.get(), BUFFER_SIZE);
+            if (readBytes < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            if (readBytes == 0)
+                return false; // the file was truncated meanwhile
+
+            ssize_t written = 0;
+            while (written < readBytes)
+            {
+                const ssize_t ret = ::write(destination, (buffer.get() + written), static_cast<size_t>(readBytes - written));
+                if (ret < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                }
+
+                written += ret;
+            }
+
+            copied += readBytes;
+            readWriteBytes += readBytes;
+        }
+
+        return true;
+    }
+#endif
+}
+
 /**
  * This function will first check if there are only system cache files, e.g. `Thumbs.db`,
  * `.DS_Store` and/or only temp files that end with '~', e.g. `filename~`.
@@ -214,6 +340,54 @@ qint64 Utils::Fs::freeDiskSpaceOnPath(const Path &path)
     return QStorageInfo(path.data()).bytesAvailable();
 }
 
+QString Utils::Fs::storageDeviceName(const Path &path)
+{
+    // `QStorageInfo` needs an existing path so fall back to the nearest existing parent,
+    // e.g. save path of a torrent which files aren't created yet
+    Path existingPath = path;
+    while (!existingPath.isEmpty() && !existingPath.exists())
+    {
+        const Path parentPath = existingPath.parentPath();
+        if (parentPath == existingPath)
+            return {};
+        existingPath = parentPath;
+    }
+    if (existingPath.isEmpty())
+        return {};
+
+    const QStorageInfo storageInfo {existingPath.data()};
+    if (!storageInfo.isValid())
+        return {};
+
+    return QString::fromLocal8Bit(storageInfo.device());
+}
+
+bool Utils::Fs::isSolidStateDevice(const QString &deviceName)
+{
+#if defined(Q_OS_LINUX)
+    // resolve symlinks such as "/dev/mapper/root" -> "/dev/dm-0"
+    const QString canonicalDevice = QFileInfo(deviceName).canonicalFilePath();
+    const QString blockName = QFileInfo(canonicalDevice.isEmpty() ? deviceName : canonicalDevice).fileName();
+    if (blockName.isEmpty())
+        return false;
+
+    const QString sysPath = QFileInfo(u"/sys/class/block/" + blockName).canonicalFilePath();
+    if (sysPath.isEmpty())
+        return false;
+
+    // partitions have no "queue" directory, it belongs to their parent device
+    for (const QString &blockPath : {sysPath, QFileInfo(sysPath).path()})
+    {
+        QFile rotationalFile {blockPath + u"/queue/rotational"};
+        if (rotationalFile.open(QIODevice::ReadOnly))
+            return (rotationalFile.readAll().trimmed() == "0");
+    }
+#else
+    Q_UNUSED(deviceName);
+#endif
+    return false;
+}
+
 Path Utils::Fs::tempPath()
 {
     static const Path path = Path(QDir::tempPath()) / Path(u".qBittorrent"_qs);
@@ -290,9 +464,42 @@ bool Utils::Fs::isNetworkFileSystem(const Path &path)
 #endif
 }
 
+/**
+ * Copies the file and its permissions, fails if the destination exists.
+ *
+ * On Linux the copying is done by the kernel whenever possible, see `copyFileContents()`.
+ */
 bool Utils::Fs::copyFile(const Path &from, const Path &to)
 {
-    return QFile::copy(from.data(), to.data());
+#if defined(Q_OS_LINUX)
+    FileDescriptor source {::open(QFile::encodeName(from.data()).constData(), (O_RDONLY | O_CLOEXEC))};
+    if (source.fd() < 0)
+        return false;
+
+    struct stat sourceStat {};
+    if ((::fstat(source.fd(), &sourceStat) != 0) || !S_ISREG(sourceStat.st_mode))
+        return false;
+
+    const QByteArray destinationPath = QFile::encodeName(to.data());
+    FileDescriptor destination {::open(destinationPath.constData(), (O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC)
+                                       , (sourceStat.st_mode & 0777))};
+    if (destination.fd() < 0)
+        return false;
+
+    const bool copied = copyFileContents(source.fd(), destination.fd(), sourceStat.st_size)
+            && (::fchmod(destination.fd(), (sourceStat.st_mode & 07777)) == 0)
+            && destination.close();
+    if (!copied)
+        ::unlink(destinationPath.constData());
+
+    return copied;
+#else
+    if (!QFile::copy(from.data(), to.data()))
+        return false;
+
+    readWriteBytes += QFileInfo(to.data()).size();
+    return true;
+#endif
 }
 
 bool Utils::Fs::renameFile(const Path &from, const Path &to)
@@ -300,6 +507,41 @@ bool Utils::Fs::renameFile(const Path &from, const Path &to)
     return QFile::rename(from.data(), to.data());
 }
 
+/**
+ * Renames the file or copies it to the new location and removes the original one
+ * if it is on another device, fails if the destination exists.
+ *
+ * Unlike `renameFile()` it copies the file using `copyFile()`.
+ */
+bool Utils::Fs::moveFile(const Path &from, const Path &to)
+{
+    if (to.exists())
+        return false;
+
+    std::error_code ec;
+    std::filesystem::rename(from.toStdFsPath(), to.toStdFsPath(), ec);
+    if (!ec)
+        return true;
+    if (ec != std::errc::cross_device_link)
+        return false;
+
+    if (!copyFile(from, to))
+        return false;
+
+    if (!removeFile(from))
+    {
+        removeFile(to);
+        return false;
+    }
+
+    return true;
+}
+
+Utils::Fs::CopyStatistics Utils::Fs::copyStatistics()
+{
+    return {clonedBytes, copyFileRangeBytes, sendFileBytes, readWriteBytes};
+}
+
 /**
  * Removes the file with the given filePath.
  *
@@ -42,8 +42,19 @@ class QDateTime;
 
 namespace Utils::Fs
 {
+    // Bytes copied by `copyFile()` grouped by the method that did the copying
+    struct CopyStatistics
+    {
+        qint64 clonedBytes = 0;
+        qint64 copyFileRangeBytes = 0;
+        qint64 sendFileBytes = 0;
+        qint64 readWriteBytes = 0;
+    };
+
     qint64 computePathSize(const Path &path);
     qint64 freeDiskSpaceOnPath(const Path &path);
+    QString storageDeviceName(const Path &path);
+    bool isSolidStateDevice(const QString &deviceName);
 
     bool isRegularFile(const Path &path);
     bool isDir(const Path &path);
@@ -59,6 +70,8 @@ namespace Utils::Fs
 
     bool copyFile(const Path &from, const Path &to);
     bool renameFile(const Path &from, const Path &to);
+    bool moveFile(const Path &from, const Path &to);
+    CopyStatistics copyStatistics();
     bool removeFile(const Path &path);
     bool mkdir(const Path &dirPath);
     bool mkpath(const Path &dirPath);
@@ -105,10 +105,19 @@ namespace
 #endif
         FILE_POOL_SIZE,
         CHECKING_MEM_USAGE,
+        DISK_AWARE_CHECKING,
+        CHECKING_PER_HDD,
+        CHECKING_PER_SSD,
+        MOVES_PER_LANE,
+        CONTENT_REMOVAL_RATE_LIMIT,
+        METADATA_CACHE_SIZE,
+        CONTENT_REUSE,
 #ifndef QBT_USES_LIBTORRENT2
         // cache
         DISK_CACHE,
         DISK_CACHE_TTL,
+#else
+        DISK_READ_CACHE,
 #endif
         DISK_QUEUE_SIZE,
 #ifdef QBT_USES_LIBTORRENT2
@@ -199,10 +208,25 @@ void AdvancedSettings::saveAdvancedSettings() const
     session->setFilePoolSize(m_spinBoxFilePoolSize.value());
     // Checking Memory Usage
     session->setCheckingMemUsage(m_spinBoxCheckingMemUsage.value());
+    // Disk-aware checking
+    session->setDiskAwareCheckingEnabled(m_checkBoxDiskAwareChecking.isChecked());
+    session->setMaxActiveCheckingTorrentsPerHDD(m_spinBoxCheckingPerHDD.value());
+    session->setMaxActiveCheckingTorrentsPerSSD(m_spinBoxCheckingPerSSD.value());
+    // Concurrent moves
+    session->setMaxActiveMovesPerLane(m_spinBoxMovesPerLane.value());
+    // Content removal
+    session->setContentRemovalRateLimit(m_spinBoxContentRemovalRateLimit.value());
+    // Metadata cache
+    session->setMetadataCacheSize(m_spinBoxMetadataCacheSize.value());
+    // Content reuse
+    session->setContentReuseEnabled(m_checkBoxContentReuse.isChecked());
 #ifndef QBT_USES_LIBTORRENT2
     // Disk write cache
     session->setDiskCacheSize(m_spinBoxCache.value());
     session->setDiskCacheTTL(m_spinBoxCacheTTL.value());
+#else
+    // Disk read cache
+    session->setDiskReadCacheSize(m_spinBoxDiskReadCache.value());
 #endif
     // Disk queue size
     session->setDiskQueueSize(m_spinBoxDiskQueueSize.value() * 1024);
@@ -471,6 +495,42 @@ void AdvancedSettings::loadAdvancedSettings()
     m_spinBoxCheckingMemUsage.setSuffix(tr(" MiB"));
     addRow(CHECKING_MEM_USAGE, (tr("Outstanding memory when checking torrents") + u' ' + makeLink(u"https://www.libtorrent.org/reference-Settings.html#checking_mem_usage", u"(?)"))
             , &m_spinBoxCheckingMemUsage);
+    // Disk-aware checking
+    m_checkBoxDiskAwareChecking.setChecked(session->isDiskAwareCheckingEnabled());
+    addRow(DISK_AWARE_CHECKING, tr("Schedule checking torrents per storage device"), &m_checkBoxDiskAwareChecking);
+    m_spinBoxCheckingPerHDD.setMinimum(1);
+    m_spinBoxCheckingPerHDD.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxCheckingPerHDD.setValue(session->maxActiveCheckingTorrentsPerHDD());
+    addRow(CHECKING_PER_HDD, tr("Max active checking torrents per HDD"), &m_spinBoxCheckingPerHDD);
+    m_spinBoxCheckingPerSSD.setMinimum(1);
+    m_spinBoxCheckingPerSSD.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxCheckingPerSSD.setValue(session->maxActiveCheckingTorrentsPerSSD());
+    addRow(CHECKING_PER_SSD, tr("Max active checking torrents per SSD"), &m_spinBoxCheckingPerSSD);
+    // Concurrent moves
+    m_spinBoxMovesPerLane.setMinimum(1);
+    m_spinBoxMovesPerLane.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxMovesPerLane.setValue(session->maxActiveMovesPerLane());
+    m_spinBoxMovesPerLane.setToolTip(tr("Torrents moved between the same pair of storage devices share a lane"));
+    addRow(MOVES_PER_LANE, tr("Max concurrent torrent moves per device pair"), &m_spinBoxMovesPerLane);
+    // Content removal
+    m_spinBoxContentRemovalRateLimit.setMinimum(0);
+    m_spinBoxContentRemovalRateLimit.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxContentRemovalRateLimit.setSuffix(tr(" files/s"));
+    m_spinBoxContentRemovalRateLimit.setSpecialValueText(tr("Unlimited"));
+    m_spinBoxContentRemovalRateLimit.setValue(session->contentRemovalRateLimit());
+    addRow(CONTENT_REMOVAL_RATE_LIMIT, tr("Torrent content removal rate limit"), &m_spinBoxContentRemovalRateLimit);
+    // Metadata cache
+    m_spinBoxMetadataCacheSize.setMinimum(0);
+    m_spinBoxMetadataCacheSize.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxMetadataCacheSize.setSuffix(tr(" MiB"));
+    m_spinBoxMetadataCacheSize.setSpecialValueText(tr("Disabled"));
+    m_spinBoxMetadataCacheSize.setValue(session->metadataCacheSize());
+    m_spinBoxMetadataCacheSize.setToolTip(tr("Metadata of torrents is kept so that magnet links added again start without waiting for peers"));
+    addRow(METADATA_CACHE_SIZE, tr("Magnet metadata cache size"), &m_spinBoxMetadataCacheSize);
+    // Content reuse
+    m_checkBoxContentReuse.setChecked(session->isContentReuseEnabled());
+    m_checkBoxContentReuse.setToolTip(tr("Missing files of added torrents are linked to verified files of completed torrents"));
+    addRow(CONTENT_REUSE, tr("Reuse data of existing torrents"), &m_checkBoxContentReuse);
 #ifndef QBT_USES_LIBTORRENT2
     // Disk write cache
     m_spinBoxCache.setMinimum(-1);
@@ -494,6 +554,20 @@ void AdvancedSettings::loadAdvancedSettings()
     m_spinBoxCacheTTL.setSuffix(tr(" s", " seconds"));
     addRow(DISK_CACHE_TTL, (tr("Disk cache expiry interval") + u' ' + makeLink(u"https://www.libtorrent.org/reference-Settings.html#cache_expiry", u"(?)"))
             , &m_spinBoxCacheTTL);
+#else
+    // Disk read cache
+    m_spinBoxDiskReadCache.setMinimum(0);
+    // When build as 32bit binary, set the maximum at less than 2GB to prevent crashes.
+#ifdef QBT_APP_64BIT
+    m_spinBoxDiskReadCache.setMaximum(33554431);  // 32768GiB
+#else
+    // allocate 1536MiB and leave 512MiB to the rest of program data in RAM
+    m_spinBoxDiskReadCache.setMaximum(1536);
+#endif
+    m_spinBoxDiskReadCache.setValue(session->diskReadCacheSize());
+    m_spinBoxDiskReadCache.setSuffix(tr(" MiB"));
+    m_spinBoxDiskReadCache.setSpecialValueText(tr("Disabled"));
+    addRow(DISK_READ_CACHE, tr("Disk read cache"), &m_spinBoxDiskReadCache);
 #endif
     // Disk queue size
     m_spinBoxDiskQueueSize.setMinimum(1);
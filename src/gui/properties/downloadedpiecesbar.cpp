@@ -51,12 +51,17 @@ DownloadedPiecesBar::DownloadedPiecesBar(QWidget *parent)
 {
 }
 
-QVector<float> DownloadedPiecesBar::bitfieldToFloatVector(const QBitArray &vecin, int reqSize)
+QVector<float> DownloadedPiecesBar::piecesToFloatVector(const BitTorrent::PieceState state, const int reqSize) const
 {
     QVector<float> result(reqSize, 0.0);
-    if (vecin.isEmpty()) return result;
+    if (m_pieceStates.isEmpty()) return result;
 
-    const float ratio = vecin.size() / static_cast<float>(reqSize);
+    const auto hasState = [this, state](const int index) -> bool
+    {
+        return (m_pieceStates.state(index) == state);
+    };
+
+    const float ratio = m_pieceStates.size() / static_cast<float>(reqSize);
 
     // simple linear transformation algorithm
     // for example:
@@ -72,7 +77,7 @@ QVector<float> DownloadedPiecesBar::bitfieldToFloatVector(const QBitArray &vecin
         // C - integer
         int fromC = fromR; // std::floor not needed
         int toC = std::ceil(toR);
-        if (toC > vecin.size())
+        if (toC > m_pieceStates.size())
             --toC;
 
         // position in pieces table
@@ -87,7 +92,7 @@ QVector<float> DownloadedPiecesBar::bitfieldToFloatVector(const QBitArray &vecin
         // case when calculated range is (15.2 >= x < 15.7)
         if (x2 == toCMinusOne)
         {
-            if (vecin[x2])
+            if (hasState(x2))
                 value += ratio;
             ++x2;
         }
@@ -97,20 +102,20 @@ QVector<float> DownloadedPiecesBar::bitfieldToFloatVector(const QBitArray &vecin
             // subcase (15.2 >= x < 16)
             if (x2 != fromR)
             {
-                if (vecin[x2])
+                if (hasState(x2))
                     value += 1.0 - (fromR - fromC);
                 ++x2;
             }
 
             // subcase (16 >= x < 17)
             for (; x2 < toCMinusOne; ++x2)
-                if (vecin[x2])
+                if (hasState(x2))
                     value += 1.0;
 
             // subcase (17 >= x < 17.8)
             if (x2 == toCMinusOne)
             {
-                if (vecin[x2])
+                if (hasState(x2))
                     value += 1.0 - (toC - toR);
                 ++x2;
             }
@@ -138,15 +143,15 @@ bool DownloadedPiecesBar::updateImage(QImage &image)
         return false;
     }
 
-    if (m_pieces.isEmpty())
+    if (m_pieceStates.isEmpty())
     {
         image2.fill(backgroundColor());
         image = image2;
         return true;
     }
 
-    QVector<float> scaledPieces = bitfieldToFloatVector(m_pieces, image2.width());
-    QVector<float> scaledPiecesDl = bitfieldToFloatVector(m_downloadedPieces, image2.width());
+    QVector<float> scaledPieces = piecesToFloatVector(BitTorrent::PieceState::Downloaded, image2.width());
+    QVector<float> scaledPiecesDl = piecesToFloatVector(BitTorrent::PieceState::Downloading, image2.width());
 
     // filling image
     for (int x = 0; x < scaledPieces.size(); ++x)
@@ -172,18 +177,16 @@ bool DownloadedPiecesBar::updateImage(QImage &image)
     return true;
 }
 
-void DownloadedPiecesBar::setProgress(const QBitArray &pieces, const QBitArray &downloadedPieces)
+void DownloadedPiecesBar::setProgress(const BitTorrent::PieceStates &pieceStates)
 {
-    m_pieces = pieces;
-    m_downloadedPieces = downloadedPieces;
+    m_pieceStates = pieceStates;
 
     requestImageUpdate();
 }
 
 void DownloadedPiecesBar::clear()
 {
-    m_pieces.clear();
-    m_downloadedPieces.clear();
+    m_pieceStates = {};
     base::clear();
 }
 
@@ -28,9 +28,9 @@
 
 #pragma once
 
-#include <QBitArray>
 #include <QtContainerFwd>
 
+#include "base/bittorrent/piecestates.h"
 #include "piecesbar.h"
 
 class QWidget;
@@ -44,21 +44,20 @@ class DownloadedPiecesBar final : public PiecesBar
 public:
     DownloadedPiecesBar(QWidget *parent);
 
-    void setProgress(const QBitArray &pieces, const QBitArray &downloadedPieces);
+    void setProgress(const BitTorrent::PieceStates &pieceStates);
 
     // PiecesBar interface
     void clear() override;
 
 private:
-    // scale bitfield vector to float vector
-    QVector<float> bitfieldToFloatVector(const QBitArray &vecin, int reqSize);
+    // scale the pieces having the state to float vector
+    QVector<float> piecesToFloatVector(BitTorrent::PieceState state, int reqSize) const;
     virtual bool updateImage(QImage &image) override;
     QString simpleToolTipText() const override;
 
     // incomplete piece color
     const QColor m_dlPieceColor;
-    // last used bitfields, uses to better resize redraw
+    // last used piece states, uses to better resize redraw
     // TODO: make a diff pieces to new pieces and update only changed pixels, speedup when update > 20x faster
-    QBitArray m_pieces;
-    QBitArray m_downloadedPieces;
+    BitTorrent::PieceStates m_pieceStates;
 };
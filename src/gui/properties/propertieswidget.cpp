@@ -512,7 +512,7 @@ void PropertiesWidget::loadDynamicData()
                 // Progress
                 qreal progress = m_torrent->progress() * 100.;
                 m_ui->labelProgressVal->setText(Utils::String::fromDouble(progress, 1) + u'%');
-                m_downloadedPieces->setProgress(m_torrent->pieces(), m_torrent->downloadingPieces());
+                m_downloadedPieces->setProgress({m_torrent->pieces(), m_torrent->downloadingPieces()});
             }
             else
             {
@@ -666,6 +666,10 @@ void PropertiesWidget::displayFilesListMenu()
         this->applyPriorities();
     };
 
+    menu->addAction(UIThemeManager::instance()->getIcon(u"force-recheck"_qs), tr("Recheck")
+        , this, &PropertiesWidget::recheckSelectedFiles);
+    menu->addSeparator();
+
     QMenu *subMenu = menu->addMenu(tr("Priority"));
 
     subMenu->addAction(tr("Do not download"), subMenu, [applyPriorities]()
@@ -885,6 +889,29 @@ void PropertiesWidget::applyPriorities()
     m_torrent->prioritizeFiles(m_propListModel->model()->getFilePriorities());
 }
 
+void PropertiesWidget::recheckSelectedFiles()
+{
+    if (!m_torrent) return;
+
+    QVector<int> fileIndexes;
+    QModelIndexList indexes = m_ui->filesList->selectionModel()->selectedRows(0);
+    while (!indexes.isEmpty())
+    {
+        const QModelIndex index = indexes.takeLast();
+        if (m_propListModel->itemType(index) == TorrentContentModelItem::FileType)
+        {
+            fileIndexes.append(m_propListModel->getFileIndex(index));
+            continue;
+        }
+
+        // folder type
+        for (int row = 0; row < m_propListModel->rowCount(index); ++row)
+            indexes.append(m_propListModel->index(row, 0, index));
+    }
+
+    m_torrent->recheckFiles(fileIndexes);
+}
+
 void PropertiesWidget::filteredFilesChanged()
 {
     if (m_torrent)
@@ -109,6 +109,7 @@ private slots:
 private:
     QPushButton *getButtonFromIndex(int index);
     void applyPriorities();
+    void recheckSelectedFiles();
     void openParentFolder(const QModelIndex &index) const;
     Path getFullPath(const QModelIndex &index) const;
 
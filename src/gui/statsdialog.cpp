@@ -29,8 +29,16 @@
 #include "statsdialog.h"
 
 #include <algorithm>
+#include <tuple>
+
+#include <QHash>
+#include <QStringList>
+#include <QTreeWidgetItem>
+#include <QVector>
 
 #include "base/bittorrent/cachestatus.h"
+#include "base/bittorrent/diskiostatistics.h"
+#include "base/bittorrent/movestoragelanestatus.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
 #include "base/bittorrent/torrent.h"
@@ -42,6 +50,30 @@
 
 #define SETTINGS_KEY(name) u"StatisticsDialog/" name
 
+namespace
+{
+    enum DiskIOColumn
+    {
+        DISKIO_DEVICE,
+        DISKIO_READ_LATENCY,
+        DISKIO_WRITE_LATENCY,
+        DISKIO_HASH_LATENCY,
+        DISKIO_READ_BYTES,
+        DISKIO_WRITE_BYTES
+    };
+
+    enum MoveStorageColumn
+    {
+        MOVE_SOURCE,
+        MOVE_DESTINATION,
+        MOVE_ACTIVE,
+        MOVE_QUEUED,
+        MOVE_FINISHED,
+        MOVE_BYTES,
+        MOVE_SPEED
+    };
+}
+
 StatsDialog::StatsDialog(QWidget *parent)
     : QDialog(parent)
     , m_ui(new Ui::StatsDialog)
@@ -55,9 +87,9 @@ StatsDialog::StatsDialog(QWidget *parent)
     connect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated
             , this, &StatsDialog::update);
 
-#ifdef QBT_USES_LIBTORRENT2
-    m_ui->labelCacheHitsText->hide();
-    m_ui->labelCacheHits->hide();
+#ifndef QBT_USES_LIBTORRENT2
+    // disk jobs can be measured with libtorrent 2.x custom disk I/O only
+    m_ui->groupDiskIO->hide();
 #endif
 
     if (const QSize dialogSize = m_storeDialogSize; dialogSize.isValid())
@@ -87,13 +119,11 @@ void StatsDialog::update()
                 ((atd > 0) && (atu > 0))
                 ? Utils::String::fromDouble(static_cast<qreal>(atu) / atd, 2)
                 : u"-"_qs);
-#ifndef QBT_USES_LIBTORRENT2
     // Cache hits
     const qreal readRatio = cs.readRatio;
     m_ui->labelCacheHits->setText(u"%1%"_qs.arg((readRatio > 0)
         ? Utils::String::fromDouble((100 * readRatio), 2)
         : u"0"_qs));
-#endif
     // Buffers size
     m_ui->labelTotalBuf->setText(Utils::Misc::friendlyUnit(cs.totalUsedBuffers * 16 * 1024));
     // Disk overload (100%) equivalent
@@ -114,4 +144,77 @@ void StatsDialog::update()
 
     // Total connected peers
     m_ui->labelPeers->setText(QString::number(ss.peersCount));
+
+#ifdef QBT_USES_LIBTORRENT2
+    updateDiskIOStatus();
+#endif
+    updateMoveStorageStatus();
+}
+
+void StatsDialog::updateDiskIOStatus()
+{
+    const QHash<QString, BitTorrent::DiskIOStatus> deviceStatus = BitTorrent::Session::instance()->deviceDiskIOStatus();
+    QStringList devices = deviceStatus.keys();
+    devices.sort();
+
+    QTreeWidget *tree = m_ui->treeDiskIO;
+    while (tree->topLevelItemCount() > devices.size())
+        delete tree->takeTopLevelItem(tree->topLevelItemCount() - 1);
+    while (tree->topLevelItemCount() < devices.size())
+        tree->addTopLevelItem(new QTreeWidgetItem);
+
+    const auto latencyText = [](const LatencyHistogram &latency) -> QString
+    {
+        if (latency.count() == 0)
+            return u"-"_qs;
+
+        return tr("%1 / %2 ms", "median / 99th percentile, e.g. 0.25 / 12.5 ms")
+            .arg(Utils::String::fromDouble((latency.percentile(50) / 1000.), 2)
+                , Utils::String::fromDouble((latency.percentile(99) / 1000.), 2));
+    };
+
+    for (int i = 0; i < devices.size(); ++i)
+    {
+        const BitTorrent::DiskIOStatus &status = deviceStatus[devices[i]];
+
+        QTreeWidgetItem *item = tree->topLevelItem(i);
+        item->setText(DISKIO_DEVICE, devices[i]);
+        item->setText(DISKIO_READ_LATENCY, latencyText(status.read.latency));
+        item->setText(DISKIO_WRITE_LATENCY, latencyText(status.write.latency));
+        item->setText(DISKIO_HASH_LATENCY, latencyText(status.hash.latency));
+        item->setText(DISKIO_READ_BYTES, Utils::Misc::friendlyUnit(status.read.bytes));
+        item->setText(DISKIO_WRITE_BYTES, Utils::Misc::friendlyUnit(status.write.bytes));
+    }
+}
+
+void StatsDialog::updateMoveStorageStatus()
+{
+    QVector<BitTorrent::MoveStorageLaneStatus> laneStatus = BitTorrent::Session::instance()->moveStorageLaneStatus();
+    std::sort(laneStatus.begin(), laneStatus.end()
+        , [](const BitTorrent::MoveStorageLaneStatus &left, const BitTorrent::MoveStorageLaneStatus &right)
+    {
+        return std::tie(left.sourceDevice, left.destinationDevice) < std::tie(right.sourceDevice, right.destinationDevice);
+    });
+
+    QTreeWidget *tree = m_ui->treeMoveStorage;
+    while (tree->topLevelItemCount() > laneStatus.size())
+        delete tree->takeTopLevelItem(tree->topLevelItemCount() - 1);
+    while (tree->topLevelItemCount() < laneStatus.size())
+        tree->addTopLevelItem(new QTreeWidgetItem);
+
+    for (int i = 0; i < laneStatus.size(); ++i)
+    {
+        const BitTorrent::MoveStorageLaneStatus &status = laneStatus[i];
+
+        QTreeWidgetItem *item = tree->topLevelItem(i);
+        item->setText(MOVE_SOURCE, status.sourceDevice);
+        item->setText(MOVE_DESTINATION, status.destinationDevice);
+        item->setText(MOVE_ACTIVE, u"%1 / %2"_qs.arg(QString::number(status.activeCount), QString::number(status.limit)));
+        item->setText(MOVE_QUEUED, QString::number(status.queuedCount));
+        item->setText(MOVE_FINISHED, QString::number(status.finishedCount));
+        item->setText(MOVE_BYTES, Utils::Misc::friendlyUnit(status.movedBytes));
+        item->setText(MOVE_SPEED, ((status.movingTime > 0)
+            ? Utils::Misc::friendlyUnit(((status.movedBytes * 1000) / status.movingTime), true)
+            : u"-"_qs));
+    }
 }
@@ -50,6 +50,9 @@ private slots:
     void update();
 
 private:
+    void updateDiskIOStatus();
+    void updateMoveStorageStatus();
+
     Ui::StatsDialog *m_ui = nullptr;
     SettingValue<QSize> m_storeDialogSize;
 };
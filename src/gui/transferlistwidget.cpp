@@ -360,44 +360,44 @@ void TransferListWidget::setSelectedTorrentsLocation()
 
 void TransferListWidget::pauseAllTorrents()
 {
-    for (BitTorrent::Torrent *const torrent : asConst(BitTorrent::Session::instance()->torrents()))
-        torrent->pause();
+    BitTorrent::Session *const session = BitTorrent::Session::instance();
+    session->applyToTorrents(session->torrents(), [](BitTorrent::Torrent *const torrent) { torrent->pause(); });
 }
 
 void TransferListWidget::resumeAllTorrents()
 {
-    for (BitTorrent::Torrent *const torrent : asConst(BitTorrent::Session::instance()->torrents()))
-        torrent->resume();
+    BitTorrent::Session *const session = BitTorrent::Session::instance();
+    session->applyToTorrents(session->torrents(), [](BitTorrent::Torrent *const torrent) { torrent->resume(); });
 }
 
 void TransferListWidget::startSelectedTorrents()
 {
-    for (BitTorrent::Torrent *const torrent : asConst(getSelectedTorrents()))
-        torrent->resume();
+    BitTorrent::Session::instance()->applyToTorrents(getSelectedTorrents()
+            , [](BitTorrent::Torrent *const torrent) { torrent->resume(); });
 }
 
 void TransferListWidget::forceStartSelectedTorrents()
 {
-    for (BitTorrent::Torrent *const torrent : asConst(getSelectedTorrents()))
-        torrent->resume(BitTorrent::TorrentOperatingMode::Forced);
+    BitTorrent::Session::instance()->applyToTorrents(getSelectedTorrents()
+            , [](BitTorrent::Torrent *const torrent) { torrent->resume(BitTorrent::TorrentOperatingMode::Forced); });
 }
 
 void TransferListWidget::startVisibleTorrents()
 {
-    for (BitTorrent::Torrent *const torrent : asConst(getVisibleTorrents()))
-        torrent->resume();
+    BitTorrent::Session::instance()->applyToTorrents(getVisibleTorrents()
+            , [](BitTorrent::Torrent *const torrent) { torrent->resume(); });
 }
 
 void TransferListWidget::pauseSelectedTorrents()
 {
-    for (BitTorrent::Torrent *const torrent : asConst(getSelectedTorrents()))
-        torrent->pause();
+    BitTorrent::Session::instance()->applyToTorrents(getSelectedTorrents()
+            , [](BitTorrent::Torrent *const torrent) { torrent->pause(); });
 }
 
 void TransferListWidget::pauseVisibleTorrents()
 {
-    for (BitTorrent::Torrent *const torrent : asConst(getVisibleTorrents()))
-        torrent->pause();
+    BitTorrent::Session::instance()->applyToTorrents(getVisibleTorrents()
+            , [](BitTorrent::Torrent *const torrent) { torrent->pause(); });
 }
 
 void TransferListWidget::softDeleteSelectedTorrents()
@@ -613,6 +613,12 @@ void TransferListWidget::recheckSelectedTorrents()
         torrent->forceRecheck();
 }
 
+void TransferListWidget::quickRecheckSelectedTorrents()
+{
+    for (BitTorrent::Torrent *const torrent : asConst(getSelectedTorrents()))
+        torrent->quickRecheck();
+}
+
 void TransferListWidget::reannounceSelectedTorrents()
 {
     for (BitTorrent::Torrent *const torrent : asConst(getSelectedTorrents()))
@@ -935,6 +941,9 @@ void TransferListWidget::displayListMenu()
     connect(actionSetTorrentPath, &QAction::triggered, this, &TransferListWidget::setSelectedTorrentsLocation);
     auto *actionForceRecheck = new QAction(UIThemeManager::instance()->getIcon(u"force-recheck"_qs), tr("Force rec&heck"), listMenu);
     connect(actionForceRecheck, &QAction::triggered, this, &TransferListWidget::recheckSelectedTorrents);
+    auto *actionQuickRecheck = new QAction(UIThemeManager::instance()->getIcon(u"force-recheck"_qs), tr("Quick rechec&k"), listMenu);
+    actionQuickRecheck->setToolTip(tr("Check only the files which were modified since they were completed"));
+    connect(actionQuickRecheck, &QAction::triggered, this, &TransferListWidget::quickRecheckSelectedTorrents);
     auto *actionForceReannounce = new QAction(UIThemeManager::instance()->getIcon(u"reannounce"_qs), tr("Force r&eannounce"), listMenu);
     connect(actionForceReannounce, &QAction::triggered, this, &TransferListWidget::reannounceSelectedTorrents);
     auto *actionCopyMagnetLink = new QAction(UIThemeManager::instance()->getIcon(u"torrent-magnet"_qs), tr("&Magnet link"), listMenu);
@@ -1198,7 +1207,10 @@ void TransferListWidget::displayListMenu()
     if (addedPreviewAction)
         listMenu->addSeparator();
     if (oneHasMetadata)
+    {
         listMenu->addAction(actionForceRecheck);
+        listMenu->addAction(actionQuickRecheck);
+    }
     // We can not force reannounce torrents that are paused/errored/checking/missing files/queued.
     // We may already have the tracker list from magnet url. So we can force reannounce torrents without metadata anyway.
     listMenu->addAction(actionForceReannounce);
@@ -88,6 +88,7 @@ public slots:
     void copySelectedIDs() const;
     void openSelectedTorrentsFolder() const;
     void recheckSelectedTorrents();
+    void quickRecheckSelectedTorrents();
     void reannounceSelectedTorrents();
     void setTorrentOptions();
     void previewSelectedTorrents();
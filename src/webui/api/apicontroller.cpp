@@ -30,11 +30,15 @@
 
 #include <algorithm>
 
+#include <QCborValue>
 #include <QHash>
+#include <QJsonArray>
 #include <QJsonDocument>
+#include <QJsonObject>
 #include <QMetaObject>
 #include <QVector>
 
+#include "base/http/types.h"
 #include "apierror.h"
 
 APIController::APIController(IApplication *app, QObject *parent)
@@ -43,9 +47,9 @@ APIController::APIController(IApplication *app, QObject *parent)
 {
 }
 
-QVariant APIController::run(const QString &action, const StringMap &params, const DataMap &data)
+APIResult APIController::run(const QString &action, const StringMap &params, const DataMap &data)
 {
-    m_result.clear(); // clear result
+    m_result = {}; // clear result
     m_params = params;
     m_data = data;
 
@@ -56,6 +60,11 @@ QVariant APIController::run(const QString &action, const StringMap &params, cons
     return m_result;
 }
 
+void APIController::setResultEncoding(const JsonWriter::Encoding encoding)
+{
+    m_resultEncoding = encoding;
+}
+
 const StringMap &APIController::params() const
 {
     return m_params;
@@ -78,22 +87,40 @@ void APIController::requireParams(const QVector<QString> &requiredParams) const
         throw APIError(APIErrorType::BadParams);
 }
 
+JsonWriter::Encoding APIController::resultEncoding() const
+{
+    return m_resultEncoding;
+}
+
 void APIController::setResult(const QString &result)
 {
-    m_result = result;
+    m_result = {result, {}};
 }
 
 void APIController::setResult(const QJsonArray &result)
 {
-    m_result = QJsonDocument(result);
+    if (m_resultEncoding == JsonWriter::Encoding::CBOR)
+        m_result = {QCborValue::fromJsonValue(result).toCbor(), Http::CONTENT_TYPE_CBOR};
+    else
+        m_result = {QJsonDocument(result), {}};
 }
 
 void APIController::setResult(const QJsonObject &result)
 {
-    m_result = QJsonDocument(result);
+    if (m_resultEncoding == JsonWriter::Encoding::CBOR)
+        m_result = {QCborValue::fromJsonValue(result).toCbor(), Http::CONTENT_TYPE_CBOR};
+    else
+        m_result = {QJsonDocument(result), {}};
+}
+
+void APIController::setResult(const QByteArray &result, const QString &mimeType)
+{
+    m_result = {result, mimeType};
 }
 
-void APIController::setResult(const QByteArray &result)
+void APIController::setResult(const JsonWriter &result)
 {
-    m_result = result;
+    const QString mimeType = (result.encoding() == JsonWriter::Encoding::CBOR)
+        ? Http::CONTENT_TYPE_CBOR : Http::CONTENT_TYPE_JSON;
+    m_result = {result.data(), mimeType};
 }
@@ -30,15 +30,21 @@
 
 #include <QtContainerFwd>
 #include <QObject>
+#include <QString>
 #include <QVariant>
 
 #include "base/applicationcomponent.h"
-
-class QString;
+#include "jsonwriter.h"
 
 using DataMap = QHash<QString, QByteArray>;
 using StringMap = QHash<QString, QString>;
 
+struct APIResult
+{
+    QVariant data;
+    QString mimeType;
+};
+
 class APIController : public QObject, public ApplicationComponent
 {
     Q_OBJECT
@@ -47,20 +53,25 @@ class APIController : public QObject, public ApplicationComponent
 public:
     explicit APIController(IApplication *app, QObject *parent = nullptr);
 
-    QVariant run(const QString &action, const StringMap &params, const DataMap &data = {});
+    APIResult run(const QString &action, const StringMap &params, const DataMap &data = {});
+    // The encoding of JSON results, they are encoded as text by default
+    void setResultEncoding(JsonWriter::Encoding encoding);
 
 protected:
     const StringMap &params() const;
     const DataMap &data() const;
     void requireParams(const QVector<QString> &requiredParams) const;
+    JsonWriter::Encoding resultEncoding() const;
 
     void setResult(const QString &result);
     void setResult(const QJsonArray &result);
     void setResult(const QJsonObject &result);
-    void setResult(const QByteArray &result);
+    void setResult(const QByteArray &result, const QString &mimeType = {});
+    void setResult(const JsonWriter &result);
 
 private:
     StringMap m_params;
     DataMap m_data;
-    QVariant m_result;
+    APIResult m_result;
+    JsonWriter::Encoding m_resultEncoding = JsonWriter::Encoding::Text;
 };
@@ -65,6 +65,12 @@
 
 using namespace std::chrono_literals;
 
+AppController::AppController(IApplication *app, const StaticFilesStatistics *staticFilesStatistics, QObject *parent)
+    : APIController(app, parent)
+    , m_staticFilesStatistics {staticFilesStatistics}
+{
+}
+
 void AppController::webapiVersionAction()
 {
     setResult(API_VERSION.toString());
@@ -319,9 +325,22 @@ void AppController::preferencesAction()
     data[u"file_pool_size"_qs] = session->filePoolSize();
     // Checking memory usage
     data[u"checking_memory_use"_qs] = session->checkingMemUsage();
+    // Disk-aware checking
+    data[u"disk_aware_checking"_qs] = session->isDiskAwareCheckingEnabled();
+    data[u"max_active_checking_torrents_per_hdd"_qs] = session->maxActiveCheckingTorrentsPerHDD();
+    data[u"max_active_checking_torrents_per_ssd"_qs] = session->maxActiveCheckingTorrentsPerSSD();
+    // Concurrent moves
+    data[u"max_active_moves_per_lane"_qs] = session->maxActiveMovesPerLane();
+    // Content removal
+    data[u"content_removal_rate_limit"_qs] = session->contentRemovalRateLimit();
+    // Metadata cache
+    data[u"metadata_cache_size"_qs] = session->metadataCacheSize();
+    // Content reuse
+    data[u"content_reuse_enabled"_qs] = session->isContentReuseEnabled();
     // Disk write cache
     data[u"disk_cache"_qs] = session->diskCacheSize();
     data[u"disk_cache_ttl"_qs] = session->diskCacheTTL();
+    data[u"disk_read_cache"_qs] = session->diskReadCacheSize();
     // Disk queue size
     data[u"disk_queue_size"_qs] = session->diskQueueSize();
     // Disk IO Type
@@ -813,11 +832,32 @@ void AppController::setPreferencesAction()
     // Checking Memory Usage
     if (hasKey(u"checking_memory_use"_qs))
         session->setCheckingMemUsage(it.value().toInt());
+    // Disk-aware checking
+    if (hasKey(u"disk_aware_checking"_qs))
+        session->setDiskAwareCheckingEnabled(it.value().toBool());
+    if (hasKey(u"max_active_checking_torrents_per_hdd"_qs))
+        session->setMaxActiveCheckingTorrentsPerHDD(it.value().toInt());
+    if (hasKey(u"max_active_checking_torrents_per_ssd"_qs))
+        session->setMaxActiveCheckingTorrentsPerSSD(it.value().toInt());
+    // Concurrent moves
+    if (hasKey(u"max_active_moves_per_lane"_qs))
+        session->setMaxActiveMovesPerLane(it.value().toInt());
+    // Content removal
+    if (hasKey(u"content_removal_rate_limit"_qs))
+        session->setContentRemovalRateLimit(it.value().toInt());
+    // Metadata cache
+    if (hasKey(u"metadata_cache_size"_qs))
+        session->setMetadataCacheSize(it.value().toInt());
+    // Content reuse
+    if (hasKey(u"content_reuse_enabled"_qs))
+        session->setContentReuseEnabled(it.value().toBool());
     // Disk write cache
     if (hasKey(u"disk_cache"_qs))
         session->setDiskCacheSize(it.value().toInt());
     if (hasKey(u"disk_cache_ttl"_qs))
         session->setDiskCacheTTL(it.value().toInt());
+    if (hasKey(u"disk_read_cache"_qs))
+        session->setDiskReadCacheSize(it.value().toInt());
     // Disk queue size
     if (hasKey(u"disk_queue_size"_qs))
         session->setDiskQueueSize(it.value().toLongLong());
@@ -973,3 +1013,16 @@ void AppController::networkInterfaceAddressListAction()
 
     setResult(addressList);
 }
+
+// Returns the statistics of Web UI static files cache:
+//   - "compression_time": time spent compressing the files, in microseconds
+//   - "compressed_bytes_saved": bytes saved by sending the compressed files
+//   - "not_modified_bytes_saved": bytes saved by "304 Not Modified" responses
+void AppController::staticFilesStatisticsAction()
+{
+    setResult(QJsonObject {
+        {u"compression_time"_qs, m_staticFilesStatistics->compressionTime.loadRelaxed()},
+        {u"compressed_bytes_saved"_qs, m_staticFilesStatistics->compressedBytesSaved.loadRelaxed()},
+        {u"not_modified_bytes_saved"_qs, m_staticFilesStatistics->notModifiedBytesSaved.loadRelaxed()}
+    });
+}
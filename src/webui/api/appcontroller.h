@@ -32,13 +32,15 @@
 
 #include "apicontroller.h"
 
+struct StaticFilesStatistics;
+
 class AppController : public APIController
 {
     Q_OBJECT
     Q_DISABLE_COPY_MOVE(AppController)
 
 public:
-    using APIController::APIController;
+    AppController(IApplication *app, const StaticFilesStatistics *staticFilesStatistics, QObject *parent = nullptr);
 
 private slots:
     void webapiVersionAction();
@@ -51,4 +53,8 @@ private slots:
 
     void networkInterfaceListAction();
     void networkInterfaceAddressListAction();
+    void staticFilesStatisticsAction();
+
+private:
+    const StaticFilesStatistics *m_staticFilesStatistics = nullptr;
 };
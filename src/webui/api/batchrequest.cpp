@@ -0,0 +1,157 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "batchrequest.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QJsonValue>
+#include <QLocale>
+#include <QRegularExpression>
+
+#include "base/global.h"
+#include "base/http/httperror.h"
+#include "base/http/types.h"
+#include "jsonwriter.h"
+
+namespace
+{
+    StringMap parseParams(const QJsonValue &paramsValue)
+    {
+        if (!paramsValue.isUndefined() && !paramsValue.isNull() && !paramsValue.isObject())
+            throw BadRequestHTTPError(u"\"params\" must be a JSON object"_qs);
+
+        StringMap params;
+        const QJsonObject paramsObj = paramsValue.toObject();
+        for (auto iter = paramsObj.constBegin(); iter != paramsObj.constEnd(); ++iter)
+        {
+            // the values are passed to the controllers the same way as if they were sent as form fields
+            const QJsonValue value = iter.value();
+            switch (value.type())
+            {
+            case QJsonValue::String:
+                params[iter.key()] = value.toString();
+                break;
+            case QJsonValue::Bool:
+                params[iter.key()] = value.toBool() ? u"true"_qs : u"false"_qs;
+                break;
+            case QJsonValue::Double:
+                params[iter.key()] = QString::number(value.toDouble(), 'f', QLocale::FloatingPointShortest);
+                break;
+            case QJsonValue::Null:
+                params[iter.key()] = u""_qs;
+                break;
+            default:
+                throw BadRequestHTTPError(u"Parameter \"%1\" must be a string, number or boolean"_qs.arg(iter.key()));
+            }
+        }
+
+        return params;
+    }
+
+    void writeResult(const APIResult &result, JsonWriter &writer)
+    {
+        writer.writeKey(u"result");
+        switch (result.data.userType())
+        {
+        case QMetaType::QJsonDocument:
+            writer.writeRawJson(result.data.toJsonDocument().toJson(QJsonDocument::Compact));
+            break;
+        case QMetaType::QByteArray:
+            if (result.mimeType == Http::CONTENT_TYPE_JSON)
+            {
+                writer.writeRawJson(result.data.toByteArray());
+            }
+            else if (result.mimeType.isEmpty())
+            {
+                writer.writeValue(QString::fromUtf8(result.data.toByteArray()));
+            }
+            else
+            {
+                // non-JSON binary results are base64 encoded
+                writer.writeValue(QString::fromLatin1(result.data.toByteArray().toBase64()));
+                writer.writeMember(u"content_type", result.mimeType);
+            }
+            break;
+        case QMetaType::QString:
+        default:
+            writer.writeValue(result.data.toString());
+            break;
+        }
+    }
+}
+
+void runBatchRequest(const QString &requests, const QRegularExpression &apiPathPattern
+        , const BatchDispatcher &dispatch, JsonWriter &writer)
+{
+    QJsonParseError jsonError;
+    const QJsonDocument doc = QJsonDocument::fromJson(requests.toUtf8(), &jsonError);
+    if ((jsonError.error != QJsonParseError::NoError) || !doc.isArray())
+        throw BadRequestHTTPError(u"\"requests\" must be a JSON array"_qs);
+
+    const QJsonArray items = doc.array();
+    if (items.size() > MAX_BATCH_SIZE)
+        throw BadRequestHTTPError(u"Too many requests in batch. Maximum: %1"_qs.arg(MAX_BATCH_SIZE));
+
+    writer.beginArray();
+    for (const QJsonValue &item : items)
+    {
+        writer.beginObject();
+
+        try
+        {
+            if (!item.isObject())
+                throw BadRequestHTTPError();
+
+            const QJsonObject itemObj = item.toObject();
+            const QRegularExpressionMatch match = apiPathPattern.match(itemObj.value(u"path"_qs).toString());
+            if (!match.hasMatch())
+                throw NotFoundHTTPError();
+
+            const QString action = match.captured(u"action"_qs);
+            const QString scope = match.captured(u"scope"_qs);
+            if ((scope == u"auth") || ((scope == u"sync") && (action == u"events")))
+                throw BadRequestHTTPError(u"Unsupported in batch"_qs);
+
+            const StringMap params = parseParams(itemObj.value(u"params"_qs));
+            const APIResult result = dispatch(scope, action, params);
+            writer.writeMember(u"status", 200);
+            writeResult(result, writer);
+        }
+        catch (const HTTPError &error)
+        {
+            writer.writeMember(u"status", error.statusCode());
+            writer.writeMember(u"error", (!error.message().isEmpty() ? error.message() : error.statusText()));
+        }
+
+        writer.endObject();
+    }
+    writer.endArray();
+}
@@ -0,0 +1,52 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+
+#include <QString>
+
+#include "apicontroller.h"
+
+class QRegularExpression;
+
+class JsonWriter;
+
+// Runs the API action of a sub-request, it throws HTTPError if the action fails
+using BatchDispatcher = std::function<APIResult (const QString &scope, const QString &action, const StringMap &params)>;
+
+inline const int MAX_BATCH_SIZE = 100;
+
+// Runs the sub-requests of a batch (JSON array of objects having "path" and "params")
+// one by one in the given order and writes the array of their results.
+// Each item holds "status" (HTTP status code) and either "result" or "error" (message).
+// A failing sub-request doesn't stop the rest, but HTTPError is thrown before anything
+// is written if the batch itself is invalid.
+void runBatchRequest(const QString &requests, const QRegularExpression &apiPathPattern
+        , const BatchDispatcher &dispatch, JsonWriter &writer);
@@ -0,0 +1,444 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "jsonwriter.h"
+
+#include <charconv>
+#include <cmath>
+
+#include <QCborStreamWriter>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QLocale>
+#include <QStringList>
+#include <QVariant>
+
+#include "base/global.h"
+
+namespace
+{
+    const char HEX_DIGITS[] = "0123456789abcdef";
+}
+
+JsonWriter::JsonWriter(const Encoding encoding, const int reservedSize)
+{
+    m_buffer.reserve(reservedSize);
+    if (encoding == Encoding::CBOR)
+        m_cborWriter = std::make_unique<QCborStreamWriter>(&m_buffer);
+}
+
+JsonWriter::~JsonWriter() = default;
+
+JsonWriter::Encoding JsonWriter::encoding() const
+{
+    return m_cborWriter ? Encoding::CBOR : Encoding::Text;
+}
+
+void JsonWriter::beginObject()
+{
+    if (m_cborWriter)
+    {
+        m_cborWriter->startMap();
+        return;
+    }
+
+    beginValue();
+    m_buffer.append('{');
+    m_needsSeparator = false;
+}
+
+void JsonWriter::endObject()
+{
+    if (m_cborWriter)
+    {
+        m_cborWriter->endMap();
+        return;
+    }
+
+    m_buffer.append('}');
+    m_needsSeparator = true;
+}
+
+void JsonWriter::beginArray()
+{
+    if (m_cborWriter)
+    {
+        m_cborWriter->startArray();
+        return;
+    }
+
+    beginValue();
+    m_buffer.append('[');
+    m_needsSeparator = false;
+}
+
+void JsonWriter::endArray()
+{
+    if (m_cborWriter)
+    {
+        m_cborWriter->endArray();
+        return;
+    }
+
+    m_buffer.append(']');
+    m_needsSeparator = true;
+}
+
+void JsonWriter::writeKey(const QStringView key)
+{
+    if (m_cborWriter)
+    {
+        m_cborWriter->append(key);
+        return;
+    }
+
+    beginValue();
+    writeString(key);
+    m_buffer.append(':');
+    // the value follows the key without separator
+    m_needsSeparator = false;
+}
+
+void JsonWriter::writeNull()
+{
+    if (m_cborWriter)
+    {
+        m_cborWriter->appendNull();
+        return;
+    }
+
+    beginValue();
+    m_buffer.append("null", 4);
+    m_needsSeparator = true;
+}
+
+void JsonWriter::writeValue(const bool value)
+{
+    if (m_cborWriter)
+    {
+        m_cborWriter->append(value);
+        return;
+    }
+
+    beginValue();
+    if (value)
+        m_buffer.append("true", 4);
+    else
+        m_buffer.append("false", 5);
+    m_needsSeparator = true;
+}
+
+void JsonWriter::writeValue(const qint64 value)
+{
+    if (m_cborWriter)
+    {
+        m_cborWriter->append(value);
+        return;
+    }
+
+    beginValue();
+    char buf[24];
+    const std::to_chars_result result = std::to_chars(std::begin(buf), std::end(buf), value);
+    m_buffer.append(buf, (result.ptr - buf));
+    m_needsSeparator = true;
+}
+
+void JsonWriter::writeValue(const quint64 value)
+{
+    if (m_cborWriter)
+    {
+        m_cborWriter->append(value);
+        return;
+    }
+
+    beginValue();
+    char buf[24];
+    const std::to_chars_result result = std::to_chars(std::begin(buf), std::end(buf), value);
+    m_buffer.append(buf, (result.ptr - buf));
+    m_needsSeparator = true;
+}
+
+void JsonWriter::writeValue(const double value)
+{
+    // same as QJsonDocument does
+    if (!std::isfinite(value))
+    {
+        writeNull();
+        return;
+    }
+
+    if (m_cborWriter)
+    {
+        m_cborWriter->append(value);
+        return;
+    }
+
+    beginValue();
+    m_buffer.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+    m_needsSeparator = true;
+}
+
+void JsonWriter::writeValue(const QStringView value)
+{
+    if (m_cborWriter)
+    {
+        m_cborWriter->append(value);
+        return;
+    }
+
+    beginValue();
+    writeString(value);
+    m_needsSeparator = true;
+}
+
+void JsonWriter::writeValue(const QString &value)
+{
+    writeValue(QStringView(value));
+}
+
+void JsonWriter::writeValue(const QJsonValue &value)
+{
+    switch (value.type())
+    {
+    case QJsonValue::Bool:
+        writeValue(value.toBool());
+        break;
+    case QJsonValue::Double:
+        {
+            // integers are kept as doubles by QJsonValue
+            const double number = value.toDouble();
+            if ((std::trunc(number) == number) && (std::abs(number) < 9007199254740992.0))  // 2^53
+                writeValue(static_cast<qint64>(number));
+            else
+                writeValue(number);
+        }
+        break;
+    case QJsonValue::String:
+        writeValue(value.toString());
+        break;
+    case QJsonValue::Array:
+        beginArray();
+        for (const QJsonValue &item : asConst(value.toArray()))
+            writeValue(item);
+        endArray();
+        break;
+    case QJsonValue::Object:
+        {
+            const QJsonObject object = value.toObject();
+            beginObject();
+            for (auto iter = object.constBegin(); iter != object.constEnd(); ++iter)
+                writeMember(iter.key(), iter.value());
+            endObject();
+        }
+        break;
+    default:
+        writeNull();
+        break;
+    }
+}
+
+void JsonWriter::writeValue(const QVariant &value)
+{
+    switch (static_cast<QMetaType::Type>(value.userType()))
+    {
+    case QMetaType::UnknownType:
+        writeNull();
+        break;
+    case QMetaType::Bool:
+        writeValue(value.toBool());
+        break;
+    case QMetaType::Int:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+        writeValue(value.toLongLong());
+        break;
+    case QMetaType::UInt:
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+        writeValue(value.toULongLong());
+        break;
+    case QMetaType::Float:
+    case QMetaType::Double:
+        writeValue(value.toDouble());
+        break;
+    case QMetaType::QString:
+        writeValue(value.toString());
+        break;
+    case QMetaType::QStringList:
+        beginArray();
+        for (const QString &item : asConst(value.toStringList()))
+            writeValue(item);
+        endArray();
+        break;
+    case QMetaType::QVariantList:
+        beginArray();
+        for (const QVariant &item : asConst(value.toList()))
+            writeValue(item);
+        endArray();
+        break;
+    case QMetaType::QVariantMap:
+        {
+            const QVariantMap map = value.toMap();
+            beginObject();
+            for (auto iter = map.cbegin(); iter != map.cend(); ++iter)
+                writeMember(iter.key(), iter.value());
+            endObject();
+        }
+        break;
+    case QMetaType::QVariantHash:
+        {
+            const QVariantHash hash = value.toHash();
+            beginObject();
+            for (auto iter = hash.cbegin(); iter != hash.cend(); ++iter)
+                writeMember(iter.key(), iter.value());
+            endObject();
+        }
+        break;
+    default:
+        writeValue(QJsonValue::fromVariant(value));
+        break;
+    }
+}
+
+void JsonWriter::writeRawJson(const QByteArray &json)
+{
+    if (m_cborWriter)
+    {
+        const QJsonDocument doc = QJsonDocument::fromJson(json);
+        if (doc.isArray())
+            writeValue(QJsonValue(doc.array()));
+        else if (doc.isObject())
+            writeValue(QJsonValue(doc.object()));
+        else
+            writeNull();
+        return;
+    }
+
+    beginValue();
+    m_buffer.append(json);
+    m_needsSeparator = true;
+}
+
+const QByteArray &JsonWriter::data() const
+{
+    return m_buffer;
+}
+
+void JsonWriter::beginValue()
+{
+    if (m_needsSeparator)
+        m_buffer.append(',');
+}
+
+void JsonWriter::writeString(const QStringView str)
+{
+    // [rfc8259] 7. Strings
+    m_buffer.append('"');
+
+    for (int i = 0; i < str.size(); ++i)
+    {
+        const char16_t c = str[i].unicode();
+        if (c < 0x80)
+        {
+            switch (c)
+            {
+            case u'"':
+                m_buffer.append("\\\"", 2);
+                break;
+            case u'\\':
+                m_buffer.append("\\\\", 2);
+                break;
+            case u'\b':
+                m_buffer.append("\\b", 2);
+                break;
+            case u'\f':
+                m_buffer.append("\\f", 2);
+                break;
+            case u'\n':
+                m_buffer.append("\\n", 2);
+                break;
+            case u'\r':
+                m_buffer.append("\\r", 2);
+                break;
+            case u'\t':
+                m_buffer.append("\\t", 2);
+                break;
+            default:
+                if (c < 0x20)
+                {
+                    const char escaped[] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF]};
+                    m_buffer.append(escaped, sizeof(escaped));
+                }
+                else
+                {
+                    m_buffer.append(static_cast<char>(c));
+                }
+                break;
+            }
+            continue;
+        }
+
+        // encode as UTF-8
+        char32_t codePoint = c;
+        if (QChar::isHighSurrogate(c) && ((i + 1) < str.size()) && QChar::isLowSurrogate(str[i + 1].unicode()))
+        {
+            codePoint = QChar::surrogateToUcs4(c, str[i + 1].unicode());
+            ++i;
+        }
+        else if (QChar::isSurrogate(c))
+        {
+            codePoint = QChar::ReplacementCharacter;
+        }
+
+        if (codePoint < 0x800)
+        {
+            const char encoded[] = {static_cast<char>(0xC0 | (codePoint >> 6))
+                , static_cast<char>(0x80 | (codePoint & 0x3F))};
+            m_buffer.append(encoded, sizeof(encoded));
+        }
+        else if (codePoint < 0x10000)
+        {
+            const char encoded[] = {static_cast<char>(0xE0 | (codePoint >> 12))
+                , static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F))
+                , static_cast<char>(0x80 | (codePoint & 0x3F))};
+            m_buffer.append(encoded, sizeof(encoded));
+        }
+        else
+        {
+            const char encoded[] = {static_cast<char>(0xF0 | (codePoint >> 18))
+                , static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F))
+                , static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F))
+                , static_cast<char>(0x80 | (codePoint & 0x3F))};
+            m_buffer.append(encoded, sizeof(encoded));
+        }
+    }
+
+    m_buffer.append('"');
+}
@@ -0,0 +1,109 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QStringView>
+
+class QCborStreamWriter;
+class QJsonValue;
+class QVariant;
+
+// Writes JSON directly into its buffer instead of building QJsonObject/QVariantMap trees
+// and converting them to text. The commas are placed automatically, so the values are just
+// written in order between begin*()/end*() calls, each member value preceded by its key.
+// The same data can be encoded as CBOR instead of JSON text.
+class JsonWriter
+{
+    Q_DISABLE_COPY_MOVE(JsonWriter)
+
+public:
+    enum class Encoding
+    {
+        Text,
+        CBOR
+    };
+
+    explicit JsonWriter(Encoding encoding = Encoding::Text, int reservedSize = 0);
+    ~JsonWriter();
+
+    Encoding encoding() const;
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void writeKey(QStringView key);
+
+    void writeNull();
+    void writeValue(bool value);
+    void writeValue(qint64 value);
+    void writeValue(quint64 value);
+    void writeValue(double value);
+    void writeValue(QStringView value);
+    void writeValue(const QString &value);
+    void writeValue(const QJsonValue &value);
+    void writeValue(const QVariant &value);
+    // Writes the value that is already serialized as JSON object or array
+    void writeRawJson(const QByteArray &json);
+
+    template <typename T, typename std::enable_if_t<(std::is_integral_v<T> && !std::is_same_v<T, bool>), int> = 0>
+    void writeValue(const T value)
+    {
+        // the unsigned values which may not fit qint64
+        if constexpr (std::is_unsigned_v<T> && (sizeof(T) >= sizeof(quint64)))
+            writeValue(static_cast<quint64>(value));
+        else
+            writeValue(static_cast<qint64>(value));
+    }
+
+    template <typename T>
+    void writeMember(const QStringView key, const T &value)
+    {
+        writeKey(key);
+        writeValue(value);
+    }
+
+    const QByteArray &data() const;
+
+private:
+    void beginValue();
+    void writeString(QStringView str);
+
+    QByteArray m_buffer;
+    // CBOR is written by it instead
+    std::unique_ptr<QCborStreamWriter> m_cborWriter;
+    bool m_needsSeparator = false;
+};
@@ -28,13 +28,12 @@
 
 #include "logcontroller.h"
 
-#include <QJsonArray>
-#include <QJsonObject>
 #include <QVector>
 
 #include "base/global.h"
 #include "base/logger.h"
 #include "base/utils/string.h"
+#include "jsonwriter.h"
 
 const QString KEY_LOG_ID = u"id"_qs;
 const QString KEY_LOG_TIMESTAMP = u"timestamp"_qs;
@@ -72,7 +71,8 @@ void LogController::mainAction()
         lastKnownId = -1;
 
     Logger *const logger = Logger::instance();
-    QJsonArray msgList;
+    JsonWriter writer {resultEncoding()};
+    writer.beginArray();
 
     for (const Log::Msg &msg : asConst(logger->getMessages(lastKnownId)))
     {
@@ -82,16 +82,16 @@ void LogController::mainAction()
               || ((msg.type == Log::CRITICAL) && isCritical)))
             continue;
 
-        msgList.append(QJsonObject
-        {
-            {KEY_LOG_ID, msg.id},
-            {KEY_LOG_TIMESTAMP, msg.timestamp},
-            {KEY_LOG_MSG_TYPE, msg.type},
-            {KEY_LOG_MSG_MESSAGE, msg.message}
-        });
+        writer.beginObject();
+        writer.writeMember(KEY_LOG_ID, msg.id);
+        writer.writeMember(KEY_LOG_TIMESTAMP, msg.timestamp);
+        writer.writeMember(KEY_LOG_MSG_TYPE, static_cast<int>(msg.type));
+        writer.writeMember(KEY_LOG_MSG_MESSAGE, msg.message);
+        writer.endObject();
     }
+    writer.endArray();
 
-    setResult(msgList);
+    setResult(writer);
 }
 
 // Returns the peer log in JSON format.
@@ -112,19 +112,20 @@ void LogController::peersAction()
         lastKnownId = -1;
 
     Logger *const logger = Logger::instance();
-    QJsonArray peerList;
+    JsonWriter writer {resultEncoding()};
+    writer.beginArray();
 
     for (const Log::Peer &peer : asConst(logger->getPeers(lastKnownId)))
     {
-        peerList.append(QJsonObject
-        {
-            {KEY_LOG_ID, peer.id},
-            {KEY_LOG_TIMESTAMP, peer.timestamp},
-            {KEY_LOG_PEER_IP, peer.ip},
-            {KEY_LOG_PEER_BLOCKED, peer.blocked},
-            {KEY_LOG_PEER_REASON, peer.reason}
-        });
+        writer.beginObject();
+        writer.writeMember(KEY_LOG_ID, peer.id);
+        writer.writeMember(KEY_LOG_TIMESTAMP, peer.timestamp);
+        writer.writeMember(KEY_LOG_PEER_IP, peer.ip);
+        writer.writeMember(KEY_LOG_PEER_BLOCKED, peer.blocked);
+        writer.writeMember(KEY_LOG_PEER_REASON, peer.reason);
+        writer.endObject();
     }
+    writer.endArray();
 
-    setResult(peerList);
+    setResult(writer);
 }
@@ -28,7 +28,12 @@
 
 #include "serialize_torrent.h"
 
+#include <type_traits>
+
+#include <QBitArray>
 #include <QDateTime>
+#include <QJsonValue>
+#include <QStringList>
 #include <QVector>
 
 #include "base/bittorrent/infohash.h"
@@ -37,6 +42,7 @@
 #include "base/path.h"
 #include "base/tagset.h"
 #include "base/utils/fs.h"
+#include "../jsonwriter.h"
 
 namespace
 {
@@ -84,80 +90,176 @@ namespace
             return u"unknown"_qs;
         }
     }
+
+    template <typename T>
+    QJsonValue toJsonValue(const T &value)
+    {
+        if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+            return static_cast<qint64>(value);
+        else
+            return value;
+    }
+
+    // Calls the function with the key and the value getter of each torrent field
+    // so that only the values which are needed are computed.
+    // The fields are always visited in the same order.
+    // The torrent can be null if only the keys are needed.
+    template <typename Func>
+    void forEachTorrentField(const BitTorrent::Torrent *torrent, Func &&func)
+    {
+        const auto adjustQueuePosition = [](const int position) -> int
+        {
+            return (position < 0) ? 0 : (position + 1);
+        };
+
+        const auto adjustRatio = [](const qreal ratio) -> qreal
+        {
+            return (ratio > BitTorrent::Torrent::MAX_RATIO) ? -1 : ratio;
+        };
+
+        const auto getLastActivityTime = [torrent]() -> qlonglong
+        {
+            const qlonglong timeSinceActivity = torrent->timeSinceActivity();
+            return (timeSinceActivity < 0)
+                ? torrent->addedTime().toSecsSinceEpoch()
+                : (QDateTime::currentDateTime().toSecsSinceEpoch() - timeSinceActivity);
+        };
+
+        func(KEY_TORRENT_ID, [&] { return torrent->id().toString(); });
+        func(KEY_TORRENT_INFOHASHV1, [&] { return torrent->infoHash().v1().toString(); });
+        func(KEY_TORRENT_INFOHASHV2, [&] { return torrent->infoHash().v2().toString(); });
+        func(KEY_TORRENT_NAME, [&] { return torrent->name(); });
+        func(KEY_TORRENT_MAGNET_URI, [&] { return torrent->createMagnetURI(); });
+        func(KEY_TORRENT_SIZE, [&] { return torrent->wantedSize(); });
+        func(KEY_TORRENT_PROGRESS, [&] { return torrent->progress(); });
+        func(KEY_TORRENT_DLSPEED, [&] { return torrent->downloadPayloadRate(); });
+        func(KEY_TORRENT_UPSPEED, [&] { return torrent->uploadPayloadRate(); });
+        func(KEY_TORRENT_QUEUE_POSITION, [&] { return adjustQueuePosition(torrent->queuePosition()); });
+        func(KEY_TORRENT_SEEDS, [&] { return torrent->seedsCount(); });
+        func(KEY_TORRENT_NUM_COMPLETE, [&] { return torrent->totalSeedsCount(); });
+        func(KEY_TORRENT_LEECHS, [&] { return torrent->leechsCount(); });
+        func(KEY_TORRENT_NUM_INCOMPLETE, [&] { return torrent->totalLeechersCount(); });
+
+        func(KEY_TORRENT_STATE, [&] { return torrentStateToString(torrent->state()); });
+        func(KEY_TORRENT_ETA, [&] { return torrent->eta(); });
+        func(KEY_TORRENT_SEQUENTIAL_DOWNLOAD, [&] { return torrent->isSequentialDownload(); });
+        func(KEY_TORRENT_FIRST_LAST_PIECE_PRIO, [&] { return torrent->hasFirstLastPiecePriority(); });
+
+        func(KEY_TORRENT_CATEGORY, [&] { return torrent->category(); });
+        func(KEY_TORRENT_TAGS, [&] { return torrent->tags().join(u", "_qs); });
+        func(KEY_TORRENT_SUPER_SEEDING, [&] { return torrent->superSeeding(); });
+        func(KEY_TORRENT_FORCE_START, [&] { return torrent->isForced(); });
+        func(KEY_TORRENT_SAVE_PATH, [&] { return torrent->savePath().toString(); });
+        func(KEY_TORRENT_DOWNLOAD_PATH, [&] { return torrent->downloadPath().toString(); });
+        func(KEY_TORRENT_CONTENT_PATH, [&] { return torrent->contentPath().toString(); });
+        func(KEY_TORRENT_ADDED_ON, [&] { return torrent->addedTime().toSecsSinceEpoch(); });
+        func(KEY_TORRENT_COMPLETION_ON, [&] { return torrent->completedTime().toSecsSinceEpoch(); });
+        func(KEY_TORRENT_TRACKER, [&] { return torrent->currentTracker(); });
+        func(KEY_TORRENT_TRACKERS_COUNT, [&] { return torrent->trackers().size(); });
+        func(KEY_TORRENT_DL_LIMIT, [&] { return torrent->downloadLimit(); });
+        func(KEY_TORRENT_UP_LIMIT, [&] { return torrent->uploadLimit(); });
+        func(KEY_TORRENT_AMOUNT_DOWNLOADED, [&] { return torrent->totalDownload(); });
+        func(KEY_TORRENT_AMOUNT_UPLOADED, [&] { return torrent->totalUpload(); });
+        func(KEY_TORRENT_AMOUNT_DOWNLOADED_SESSION, [&] { return torrent->totalPayloadDownload(); });
+        func(KEY_TORRENT_AMOUNT_UPLOADED_SESSION, [&] { return torrent->totalPayloadUpload(); });
+        func(KEY_TORRENT_AMOUNT_LEFT, [&] { return torrent->remainingSize(); });
+        func(KEY_TORRENT_AMOUNT_COMPLETED, [&] { return torrent->completedSize(); });
+        func(KEY_TORRENT_MAX_RATIO, [&] { return torrent->maxRatio(); });
+        func(KEY_TORRENT_MAX_SEEDING_TIME, [&] { return torrent->maxSeedingTime(); });
+        func(KEY_TORRENT_RATIO, [&] { return adjustRatio(torrent->realRatio()); });
+        func(KEY_TORRENT_RATIO_LIMIT, [&] { return torrent->ratioLimit(); });
+        func(KEY_TORRENT_SEEDING_TIME_LIMIT, [&] { return torrent->seedingTimeLimit(); });
+        func(KEY_TORRENT_LAST_SEEN_COMPLETE_TIME, [&] { return torrent->lastSeenComplete().toSecsSinceEpoch(); });
+        func(KEY_TORRENT_AUTO_TORRENT_MANAGEMENT, [&] { return torrent->isAutoTMMEnabled(); });
+        func(KEY_TORRENT_TIME_ACTIVE, [&] { return torrent->activeTime(); });
+        func(KEY_TORRENT_SEEDING_TIME, [&] { return torrent->finishedTime(); });
+        func(KEY_TORRENT_LAST_ACTIVITY_TIME, [&] { return getLastActivityTime(); });
+        func(KEY_TORRENT_AVAILABILITY, [&] { return torrent->distributedCopies(); });
+
+        func(KEY_TORRENT_TOTAL_SIZE, [&] { return torrent->totalSize(); });
+    }
+}
+
+void serialize(const BitTorrent::Torrent &torrent, JsonWriter &writer, const QBitArray &fieldMask)
+{
+    writer.beginObject();
+    int fieldIndex = 0;
+    forEachTorrentField(&torrent, [&writer, &fieldMask, &fieldIndex](const QString &key, const auto &getValue)
+    {
+        if (fieldMask.isEmpty() || fieldMask.testBit(fieldIndex))
+            writer.writeMember(key, getValue());
+        ++fieldIndex;
+    });
+    writer.endObject();
+}
+
+void serialize(const BitTorrent::Torrent &torrent, QVector<QJsonValue> &values, QStringList *keys)
+{
+    values.clear();
+    if (keys)
+        keys->clear();
+
+    forEachTorrentField(&torrent, [&values, keys](const QString &key, const auto &getValue)
+    {
+        values.append(toJsonValue(getValue()));
+        if (keys)
+            keys->append(key);
+    });
+}
+
+const QStringList &torrentFieldKeys()
+{
+    static const QStringList keys = []
+    {
+        QStringList result;
+        forEachTorrentField(nullptr, [&result](const QString &key, const auto &) { result.append(key); });
+        return result;
+    }();
+    return keys;
 }
 
-QVariantMap serialize(const BitTorrent::Torrent &torrent)
+bool isTorrentTextField(const int fieldIndex)
 {
-    const auto adjustQueuePosition = [](const int position) -> int
+    static const QBitArray textFields = []
     {
-        return (position < 0) ? 0 : (position + 1);
-    };
+        QBitArray result {static_cast<int>(torrentFieldKeys().size())};
+        int index = 0;
+        forEachTorrentField(nullptr, [&result, &index](const QString &, const auto &getValue)
+        {
+            result.setBit(index, std::is_same_v<std::decay_t<decltype(getValue())>, QString>);
+            ++index;
+        });
+        return result;
+    }();
+    return textFields.testBit(fieldIndex);
+}
 
-    const auto adjustRatio = [](const qreal ratio) -> qreal
+std::optional<QBitArray> torrentFieldMask(const QStringList &fieldKeys)
+{
+    if (fieldKeys.isEmpty())
+        return QBitArray();
+
+    const QStringList &keys = torrentFieldKeys();
+    QBitArray fieldMask {static_cast<int>(keys.size())};
+    for (const QString &fieldKey : fieldKeys)
     {
-        return (ratio > BitTorrent::Torrent::MAX_RATIO) ? -1 : ratio;
-    };
+        const int fieldIndex = keys.indexOf(fieldKey);
+        if (fieldIndex < 0)
+            return std::nullopt;
+        fieldMask.setBit(fieldIndex);
+    }
+    return fieldMask;
+}
 
-    const auto getLastActivityTime = [&torrent]() -> qlonglong
+QJsonValue serializeField(const BitTorrent::Torrent &torrent, const int fieldIndex)
+{
+    QJsonValue result;
+    int index = 0;
+    forEachTorrentField(&torrent, [&result, fieldIndex, &index](const QString &, const auto &getValue)
     {
-        const qlonglong timeSinceActivity = torrent.timeSinceActivity();
-        return (timeSinceActivity < 0)
-            ? torrent.addedTime().toSecsSinceEpoch()
-            : (QDateTime::currentDateTime().toSecsSinceEpoch() - timeSinceActivity);
-    };
-
-    return {
-        {KEY_TORRENT_ID, torrent.id().toString()},
-        {KEY_TORRENT_INFOHASHV1, torrent.infoHash().v1().toString()},
-        {KEY_TORRENT_INFOHASHV2, torrent.infoHash().v2().toString()},
-        {KEY_TORRENT_NAME, torrent.name()},
-        {KEY_TORRENT_MAGNET_URI, torrent.createMagnetURI()},
-        {KEY_TORRENT_SIZE, torrent.wantedSize()},
-        {KEY_TORRENT_PROGRESS, torrent.progress()},
-        {KEY_TORRENT_DLSPEED, torrent.downloadPayloadRate()},
-        {KEY_TORRENT_UPSPEED, torrent.uploadPayloadRate()},
-        {KEY_TORRENT_QUEUE_POSITION, adjustQueuePosition(torrent.queuePosition())},
-        {KEY_TORRENT_SEEDS, torrent.seedsCount()},
-        {KEY_TORRENT_NUM_COMPLETE, torrent.totalSeedsCount()},
-        {KEY_TORRENT_LEECHS, torrent.leechsCount()},
-        {KEY_TORRENT_NUM_INCOMPLETE, torrent.totalLeechersCount()},
-
-        {KEY_TORRENT_STATE, torrentStateToString(torrent.state())},
-        {KEY_TORRENT_ETA, torrent.eta()},
-        {KEY_TORRENT_SEQUENTIAL_DOWNLOAD, torrent.isSequentialDownload()},
-        {KEY_TORRENT_FIRST_LAST_PIECE_PRIO, torrent.hasFirstLastPiecePriority()},
-
-        {KEY_TORRENT_CATEGORY, torrent.category()},
-        {KEY_TORRENT_TAGS, torrent.tags().join(u", "_qs)},
-        {KEY_TORRENT_SUPER_SEEDING, torrent.superSeeding()},
-        {KEY_TORRENT_FORCE_START, torrent.isForced()},
-        {KEY_TORRENT_SAVE_PATH, torrent.savePath().toString()},
-        {KEY_TORRENT_DOWNLOAD_PATH, torrent.downloadPath().toString()},
-        {KEY_TORRENT_CONTENT_PATH, torrent.contentPath().toString()},
-        {KEY_TORRENT_ADDED_ON, torrent.addedTime().toSecsSinceEpoch()},
-        {KEY_TORRENT_COMPLETION_ON, torrent.completedTime().toSecsSinceEpoch()},
-        {KEY_TORRENT_TRACKER, torrent.currentTracker()},
-        {KEY_TORRENT_TRACKERS_COUNT, torrent.trackers().size()},
-        {KEY_TORRENT_DL_LIMIT, torrent.downloadLimit()},
-        {KEY_TORRENT_UP_LIMIT, torrent.uploadLimit()},
-        {KEY_TORRENT_AMOUNT_DOWNLOADED, torrent.totalDownload()},
-        {KEY_TORRENT_AMOUNT_UPLOADED, torrent.totalUpload()},
-        {KEY_TORRENT_AMOUNT_DOWNLOADED_SESSION, torrent.totalPayloadDownload()},
-        {KEY_TORRENT_AMOUNT_UPLOADED_SESSION, torrent.totalPayloadUpload()},
-        {KEY_TORRENT_AMOUNT_LEFT, torrent.remainingSize()},
-        {KEY_TORRENT_AMOUNT_COMPLETED, torrent.completedSize()},
-        {KEY_TORRENT_MAX_RATIO, torrent.maxRatio()},
-        {KEY_TORRENT_MAX_SEEDING_TIME, torrent.maxSeedingTime()},
-        {KEY_TORRENT_RATIO, adjustRatio(torrent.realRatio())},
-        {KEY_TORRENT_RATIO_LIMIT, torrent.ratioLimit()},
-        {KEY_TORRENT_SEEDING_TIME_LIMIT, torrent.seedingTimeLimit()},
-        {KEY_TORRENT_LAST_SEEN_COMPLETE_TIME, torrent.lastSeenComplete().toSecsSinceEpoch()},
-        {KEY_TORRENT_AUTO_TORRENT_MANAGEMENT, torrent.isAutoTMMEnabled()},
-        {KEY_TORRENT_TIME_ACTIVE, torrent.activeTime()},
-        {KEY_TORRENT_SEEDING_TIME, torrent.finishedTime()},
-        {KEY_TORRENT_LAST_ACTIVITY_TIME, getLastActivityTime()},
-        {KEY_TORRENT_AVAILABILITY, torrent.distributedCopies()},
-
-        {KEY_TORRENT_TOTAL_SIZE, torrent.totalSize()}
-    };
+        if (index == fieldIndex)
+            result = toJsonValue(getValue());
+        ++index;
+    });
+    return result;
 }
@@ -28,10 +28,18 @@
 
 #pragma once
 
-#include <QVariant>
+#include <optional>
+
+#include <QBitArray>
+#include <QtContainerFwd>
+#include <QString>
 
 #include "base/global.h"
 
+class QJsonValue;
+
+class JsonWriter;
+
 namespace BitTorrent
 {
     class Torrent;
@@ -89,4 +97,18 @@ inline const QString KEY_TORRENT_TIME_ACTIVE = u"time_active"_qs;
 inline const QString KEY_TORRENT_SEEDING_TIME = u"seeding_time"_qs;
 inline const QString KEY_TORRENT_AVAILABILITY = u"availability"_qs;
 
-QVariantMap serialize(const BitTorrent::Torrent &torrent);
+// Serializes the torrent into the values ordered the same way for all the torrents.
+// The keys of the values are returned on request.
+void serialize(const BitTorrent::Torrent &torrent, QVector<QJsonValue> &values, QStringList *keys = nullptr);
+// Writes the torrent as JSON object. If the field mask isn't empty only the fields
+// which bits are set are written, the bits are indexed the same way as the values above.
+void serialize(const BitTorrent::Torrent &torrent, JsonWriter &writer, const QBitArray &fieldMask = {});
+// Returns the value of the single field, the index is the same as of the values above
+QJsonValue serializeField(const BitTorrent::Torrent &torrent, int fieldIndex);
+// Returns the keys of the values above, they don't depend on the torrent
+const QStringList &torrentFieldKeys();
+// Returns whether the value of the field is string, the index is the same as of the keys
+bool isTorrentTextField(int fieldIndex);
+// Returns the mask of the fields having the given keys (empty mask if there are no keys)
+// or nothing if some of the keys is unknown
+std::optional<QBitArray> torrentFieldMask(const QStringList &fieldKeys);
@@ -39,7 +39,6 @@
 #include "base/bittorrent/peerinfo.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrent.h"
-#include "base/bittorrent/trackerentry.h"
 #include "base/global.h"
 #include "base/net/geoipmanager.h"
 #include "base/preferences.h"
@@ -47,7 +46,8 @@
 #include "apierror.h"
 #include "freediskspacechecker.h"
 #include "isessionmanager.h"
-#include "serialize/serialize_torrent.h"
+#include "jsonwriter.h"
+#include "syncstate.h"
 
 namespace
 {
@@ -134,7 +134,7 @@ namespace
         map[KEY_TRANSFER_GLOBAL_RATIO] = ((atd > 0) && (atu > 0)) ? Utils::String::fromDouble(static_cast<qreal>(atu) / atd, 2) : u"-"_qs;
         map[KEY_TRANSFER_TOTAL_PEER_CONNECTIONS] = sessionStatus.peersCount;
 
-        const qreal readRatio = cacheStatus.readRatio;  // TODO: remove when LIBTORRENT_VERSION_NUM >= 20000
+        const qreal readRatio = cacheStatus.readRatio;
         map[KEY_TRANSFER_READ_CACHE_HITS] = (readRatio > 0) ? Utils::String::fromDouble(100 * readRatio, 2) : u"0"_qs;
         map[KEY_TRANSFER_TOTAL_BUFFERS_SIZE] = cacheStatus.totalUsedBuffers * 16 * 1024;
 
@@ -366,8 +366,9 @@ namespace
     }
 }
 
-SyncController::SyncController(IApplication *app, QObject *parent)
+SyncController::SyncController(IApplication *app, SyncState *syncState, QObject *parent)
     : APIController(app, parent)
+    , m_syncState {syncState}
 {
     m_freeDiskSpaceThread = new QThread(this);
     m_freeDiskSpaceChecker = new FreeDiskSpaceChecker();
@@ -387,6 +388,16 @@ SyncController::~SyncController()
     m_freeDiskSpaceThread->wait();
 }
 
+int SyncController::lastMaindataResponseID() const
+{
+    return m_lastMaindataResponse.value(KEY_RESPONSE_ID).toInt();
+}
+
+int SyncController::lastPeersResponseID() const
+{
+    return m_lastPeersResponse.value(KEY_RESPONSE_ID).toInt();
+}
+
 // The function returns the changed data from the server to synchronize with the web client.
 // Return value is map in JSON format.
 // Map contain the key:
@@ -454,46 +465,10 @@ void SyncController::maindataAction()
 {
     const auto *session = BitTorrent::Session::instance();
 
+    // Torrents and trackers are shared by all the sessions and synced by revision
+    // so only the rest of the data is compared against the last response
     QVariantMap data;
 
-    QVariantHash torrents;
-    QHash<QString, QStringList> trackers;
-    for (const BitTorrent::Torrent *torrent : asConst(session->torrents()))
-    {
-        const BitTorrent::TorrentID torrentID = torrent->id();
-
-        QVariantMap map = serialize(*torrent);
-        map.remove(KEY_TORRENT_ID);
-
-        // Calculated last activity time can differ from actual value by up to 10 seconds (this is a libtorrent issue).
-        // So we don't need unnecessary updates of last activity time in response.
-        const auto iterTorrents = m_lastMaindataResponse.find(u"torrents"_qs);
-        if (iterTorrents != m_lastMaindataResponse.end())
-        {
-            const QVariantHash lastResponseTorrents = iterTorrents->toHash();
-            const auto iterID = lastResponseTorrents.find(torrentID.toString());
-
-            if (iterID != lastResponseTorrents.end())
-            {
-                const QVariantMap torrentData = iterID->toMap();
-                const auto iterLastActivity = torrentData.find(KEY_TORRENT_LAST_ACTIVITY_TIME);
-
-                if (iterLastActivity != torrentData.end())
-                {
-                    const int lastValue = iterLastActivity->toInt();
-                    if (qAbs(lastValue - map[KEY_TORRENT_LAST_ACTIVITY_TIME].toInt()) < 15)
-                        map[KEY_TORRENT_LAST_ACTIVITY_TIME] = lastValue;
-                }
-            }
-        }
-
-        for (const BitTorrent::TrackerEntry &tracker : asConst(torrent->trackers()))
-            trackers[tracker.url] << torrentID.toString();
-
-        torrents[torrentID.toString()] = map;
-    }
-    data[u"torrents"_qs] = torrents;
-
     QVariantHash categories;
     const QStringList categoriesList = session->categories();
     for (const auto &categoryName : categoriesList)
@@ -512,13 +487,6 @@ void SyncController::maindataAction()
         tags << tag;
     data[u"tags"_qs] = tags;
 
-    QVariantHash trackersHash;
-    for (auto i = trackers.constBegin(); i != trackers.constEnd(); ++i)
-    {
-        trackersHash[i.key()] = i.value();
-    }
-    data[u"trackers"_qs] = trackersHash;
-
     QVariantMap serverState = getTransferInfo();
     serverState[KEY_TRANSFER_FREESPACEONDISK] = getFreeDiskSpace();
     serverState[KEY_SYNC_MAINDATA_QUEUEING] = session->isQueueingSystemEnabled();
@@ -526,8 +494,49 @@ void SyncController::maindataAction()
     serverState[KEY_SYNC_MAINDATA_REFRESH_INTERVAL] = session->refreshInterval();
     data[u"server_state"_qs] = serverState;
 
-    const int acceptedResponseId = params()[u"rid"_qs].toInt();
-    setResult(QJsonObject::fromVariantMap(generateSyncData(acceptedResponseId, data, m_lastAcceptedMaindataResponse, m_lastMaindataResponse)));
+    int acceptedResponseId = params()[u"rid"_qs].toInt();
+    if ((acceptedResponseId > 0) && (acceptedResponseId == m_lastMaindataResponse.value(KEY_RESPONSE_ID).toInt()))
+        m_lastAcceptedMaindataRevision = m_lastMaindataRevision;
+
+    m_syncState->update();
+    // The client is too much behind to be synced incrementally
+    if (m_syncState->torrents().isFullUpdateNeeded(m_lastAcceptedMaindataRevision)
+            || m_syncState->trackers().isFullUpdateNeeded(m_lastAcceptedMaindataRevision))
+    {
+        acceptedResponseId = 0;
+    }
+
+    const QVariantMap syncData = generateSyncData(acceptedResponseId, data, m_lastAcceptedMaindataResponse, m_lastMaindataResponse);
+
+    // Torrents are the bulk of the response so they are written directly
+    // instead of being converted to intermediate JSON objects first
+    JsonWriter writer {resultEncoding()};
+    writer.beginObject();
+    for (auto iter = syncData.cbegin(); iter != syncData.cend(); ++iter)
+        writer.writeMember(iter.key(), iter.value());
+
+    const bool isFullUpdate = syncData.contains(KEY_FULL_UPDATE);
+    const quint64 sinceRevision = isFullUpdate ? 0 : m_lastAcceptedMaindataRevision;
+    const auto writeChanges = [&writer, isFullUpdate, sinceRevision](const QString &key, const SyncStore &store)
+    {
+        if (isFullUpdate || store.hasChangedItems(sinceRevision))
+        {
+            writer.writeKey(key);
+            store.writeChangedItems(writer, sinceRevision);
+        }
+
+        if (store.hasRemovedItems(sinceRevision))
+        {
+            writer.writeKey(key + KEY_SUFFIX_REMOVED);
+            store.writeRemovedItems(writer, sinceRevision);
+        }
+    };
+    writeChanges(u"torrents"_qs, m_syncState->torrents());
+    writeChanges(u"trackers"_qs, m_syncState->trackers());
+    writer.endObject();
+    m_lastMaindataRevision = m_syncState->revision();
+
+    setResult(writer);
 }
 
 // GET param:
@@ -590,7 +599,9 @@ void SyncController::torrentPeersAction()
     data[u"peers"_qs] = peers;
 
     const int acceptedResponseId = params()[u"rid"_qs].toInt();
-    setResult(QJsonObject::fromVariantMap(generateSyncData(acceptedResponseId, data, m_lastAcceptedPeersResponse, m_lastPeersResponse)));
+    JsonWriter writer {resultEncoding()};
+    writer.writeValue(generateSyncData(acceptedResponseId, data, m_lastAcceptedPeersResponse, m_lastPeersResponse));
+    setResult(writer);
 }
 
 qint64 SyncController::getFreeDiskSpace()
@@ -36,6 +36,7 @@
 class QThread;
 
 class FreeDiskSpaceChecker;
+class SyncState;
 
 class SyncController : public APIController
 {
@@ -43,11 +44,13 @@ class SyncController : public APIController
     Q_DISABLE_COPY_MOVE(SyncController)
 
 public:
-    using APIController::APIController;
-
-    explicit SyncController(IApplication *app, QObject *parent = nullptr);
+    SyncController(IApplication *app, SyncState *syncState, QObject *parent = nullptr);
     ~SyncController() override;
 
+    // The IDs of the last responses the clients should pass back to get the changes since them
+    int lastMaindataResponseID() const;
+    int lastPeersResponseID() const;
+
 private slots:
     void maindataAction();
     void torrentPeersAction();
@@ -62,8 +65,11 @@ private:
     QThread *m_freeDiskSpaceThread = nullptr;
     QElapsedTimer m_freeDiskSpaceElapsedTimer;
 
+    SyncState *m_syncState = nullptr;
     QVariantMap m_lastMaindataResponse;
     QVariantMap m_lastAcceptedMaindataResponse;
+    quint64 m_lastMaindataRevision = 0;
+    quint64 m_lastAcceptedMaindataRevision = 0;
     QVariantMap m_lastPeersResponse;
     QVariantMap m_lastAcceptedPeersResponse;
 };
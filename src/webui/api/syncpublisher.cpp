@@ -0,0 +1,214 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "syncpublisher.h"
+
+#include <chrono>
+
+#include <QByteArray>
+#include <QStringList>
+#include <QVariant>
+
+#include "base/algorithm.h"
+#include "base/bittorrent/session.h"
+#include "base/global.h"
+#include "base/http/eventstream.h"
+#include "../webapplication.h"
+#include "apierror.h"
+#include "synccontroller.h"
+#include "syncstate.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    // The changes which come in a row are published at once
+    const std::chrono::milliseconds PUBLISH_DELAY = 100ms;
+
+    const QString EVENT_MAINDATA = u"maindata"_qs;
+    const QString EVENT_TORRENT_PEERS = u"torrentPeers"_qs;
+}
+
+SyncEventID SyncEventID::fromString(const QString &str)
+{
+    const QStringList parts = str.split(u'-');
+    if (parts.size() != 2)
+        return {};
+
+    bool isSubscriptionIDValid = false;
+    bool isResponseIDValid = false;
+    const SyncEventID eventID {parts[0].toULongLong(&isSubscriptionIDValid), parts[1].toInt(&isResponseIDValid)};
+    if (!isSubscriptionIDValid || !isResponseIDValid)
+        return {};
+
+    return eventID;
+}
+
+QString SyncEventID::toString() const
+{
+    return u"%1-%2"_qs.arg(QString::number(subscriptionID), QString::number(responseID));
+}
+
+SyncPublisher::SyncPublisher(SyncState *syncState, QObject *parent)
+    : QObject(parent)
+    , m_syncState {syncState}
+{
+    m_publishTimer.setSingleShot(true);
+    m_publishTimer.setInterval(PUBLISH_DELAY);
+    connect(&m_publishTimer, &QTimer::timeout, this, qOverload<>(&SyncPublisher::publish));
+
+    connect(syncState, &SyncState::invalidated, this, &SyncPublisher::schedulePublishing);
+    connect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated, this, &SyncPublisher::schedulePublishing);
+}
+
+void SyncPublisher::setSessionTimeout(const int seconds)
+{
+    m_sessionTimeout = seconds;
+}
+
+void SyncPublisher::subscribe(Http::EventStream *stream, WebSession *session, const QString &peersTorrentID
+    , const SyncEventID &lastEventID)
+{
+    Subscription subscription = m_endedSubscriptions.take(session->id());
+    if (subscription.controller && (subscription.id == lastEventID.subscriptionID))
+    {
+        // the client might have missed the events sent after the last one it has received
+        subscription.maindataResponseID = lastEventID.responseID;
+        subscription.peersResponseID = 0;
+        subscription.isBehind = false;
+    }
+    else
+    {
+        delete subscription.controller;
+
+        subscription = {};
+        subscription.id = ++m_lastSubscriptionID;
+        subscription.session = session;
+        subscription.controller = new SyncController(session->app(), m_syncState, session);
+    }
+    subscription.peersTorrentID = peersTorrentID;
+
+    m_subscriptions.insert(stream, subscription);
+
+    connect(stream, &QObject::destroyed, this, [this, stream]() { unsubscribe(stream); });
+    connect(subscription.controller, &QObject::destroyed, stream, &Http::EventStream::close);
+    // the initial data is sent as soon as the stream is opened
+    connect(stream, &Http::EventStream::opened, this, [this, stream]()
+    {
+        const auto iter = m_subscriptions.find(stream);
+        if (iter != m_subscriptions.end())
+            publish(stream, iter.value());
+    });
+}
+
+void SyncPublisher::schedulePublishing()
+{
+    if (!m_subscriptions.isEmpty() && !m_publishTimer.isActive())
+        m_publishTimer.start();
+}
+
+void SyncPublisher::publish()
+{
+    for (auto iter = m_subscriptions.begin(); iter != m_subscriptions.end(); ++iter)
+        publish(iter.key(), iter.value());
+}
+
+void SyncPublisher::publish(Http::EventStream *stream, Subscription &subscription) const
+{
+    if (!stream->isOpen() || !subscription.controller)
+        return;
+
+    // Only the requests of the client refresh the session
+    if (!subscription.session || subscription.session->hasExpired(m_sessionTimeout))
+    {
+        stream->close();
+        return;
+    }
+
+    // Don't queue up the changes the client can't keep up with,
+    // it gets the whole data instead once it reads what it has been sent
+    if (stream->isBackedUp())
+    {
+        subscription.isBehind = true;
+        return;
+    }
+
+    if (subscription.isBehind)
+    {
+        subscription.maindataResponseID = 0;
+        subscription.peersResponseID = 0;
+        subscription.isBehind = false;
+    }
+
+    const QByteArray maindata = subscription.controller->run(u"maindata"_qs
+        , {{u"rid"_qs, QString::number(subscription.maindataResponseID)}}).data.toByteArray();
+    subscription.maindataResponseID = subscription.controller->lastMaindataResponseID();
+    stream->send(EVENT_MAINDATA, maindata, SyncEventID {subscription.id, subscription.maindataResponseID}.toString());
+
+    if (!subscription.peersTorrentID.isEmpty())
+    {
+        try
+        {
+            const QByteArray peers = subscription.controller->run(u"torrentPeers"_qs
+                , {{u"hash"_qs, subscription.peersTorrentID}, {u"rid"_qs, QString::number(subscription.peersResponseID)}})
+                    .data.toByteArray();
+            subscription.peersResponseID = subscription.controller->lastPeersResponseID();
+            stream->send(EVENT_TORRENT_PEERS, peers);
+        }
+        catch (const APIError &)
+        {
+            // the torrent is removed
+            subscription.peersTorrentID.clear();
+        }
+    }
+}
+
+void SyncPublisher::unsubscribe(Http::EventStream *stream)
+{
+    const Subscription subscription = m_subscriptions.take(stream);
+    if (!subscription.controller)
+        return;
+
+    if (!subscription.session || subscription.session->hasExpired(m_sessionTimeout))
+    {
+        delete subscription.controller;
+        return;
+    }
+
+    // The controller keeps the data the client has so it is kept until the client
+    // reconnects or starts another subscription
+    const Subscription replaced = m_endedSubscriptions.take(subscription.session->id());
+    delete replaced.controller;
+    m_endedSubscriptions.insert(subscription.session->id(), subscription);
+
+    // the controllers are deleted along with the sessions
+    Algorithm::removeIf(m_endedSubscriptions, [](const QString &, const Subscription &ended)
+    {
+        return !ended.controller;
+    });
+}
@@ -0,0 +1,103 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+
+namespace Http
+{
+    class EventStream;
+}
+
+class SyncController;
+class SyncState;
+class WebSession;
+
+// ID of the event the client has received last so that it can resume
+// the subscription once it is reconnected
+struct SyncEventID
+{
+    quint64 subscriptionID = 0;
+    int responseID = 0;
+
+    static SyncEventID fromString(const QString &str);
+    QString toString() const;
+};
+
+// Pushes the changes of sync data to the clients subscribed to server-sent events
+// so that they don't need to poll for them. Each subscription has its own controller
+// keeping the data the client has.
+class SyncPublisher final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(SyncPublisher)
+
+public:
+    explicit SyncPublisher(SyncState *syncState, QObject *parent = nullptr);
+
+    // The streams don't keep the sessions alive, the subscriptions end once
+    // the sessions expire
+    void setSessionTimeout(int seconds);
+
+    // The subscription ends once the stream or the session is gone.
+    // Torrent peers are published as well if torrent ID isn't empty.
+    // The last ended subscription of the session is resumed if the client
+    // has received its events so that it gets only the changes since then.
+    void subscribe(Http::EventStream *stream, WebSession *session, const QString &peersTorrentID
+        , const SyncEventID &lastEventID = {});
+
+private:
+    struct Subscription
+    {
+        quint64 id = 0;
+        QPointer<WebSession> session;
+        QPointer<SyncController> controller;
+        QString peersTorrentID;
+        int maindataResponseID = 0;
+        int peersResponseID = 0;
+        bool isBehind = false;
+    };
+
+    void schedulePublishing();
+    void publish();
+    void publish(Http::EventStream *stream, Subscription &subscription) const;
+    void unsubscribe(Http::EventStream *stream);
+
+    SyncState *m_syncState = nullptr;
+    int m_sessionTimeout = 0;
+    QHash<Http::EventStream *, Subscription> m_subscriptions;
+    // Ended subscriptions which can be resumed by session ID
+    QHash<QString, Subscription> m_endedSubscriptions;
+    quint64 m_lastSubscriptionID = 0;
+    QTimer m_publishTimer;
+};
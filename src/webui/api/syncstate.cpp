@@ -0,0 +1,143 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "syncstate.h"
+
+#include <QHash>
+#include <QJsonValue>
+#include <QStringList>
+#include <QVector>
+
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/torrent.h"
+#include "base/bittorrent/trackerentry.h"
+#include "base/global.h"
+#include "serialize/serialize_torrent.h"
+
+SyncState::SyncState(QObject *parent)
+    : QObject(parent)
+{
+    const auto *session = BitTorrent::Session::instance();
+    const auto invalidateState = [this]() { invalidate(); };
+    connect(session, &BitTorrent::Session::torrentAdded, this, invalidateState);
+    connect(session, &BitTorrent::Session::torrentAboutToBeRemoved, this, invalidateState);
+    connect(session, &BitTorrent::Session::torrentsUpdated, this, invalidateState);
+    connect(session, &BitTorrent::Session::torrentMetadataReceived, this, invalidateState);
+    connect(session, &BitTorrent::Session::torrentPaused, this, invalidateState);
+    connect(session, &BitTorrent::Session::torrentResumed, this, invalidateState);
+    connect(session, &BitTorrent::Session::torrentCategoryChanged, this, invalidateState);
+    connect(session, &BitTorrent::Session::torrentTagAdded, this, invalidateState);
+    connect(session, &BitTorrent::Session::torrentTagRemoved, this, invalidateState);
+    connect(session, &BitTorrent::Session::torrentSavePathChanged, this, invalidateState);
+    connect(session, &BitTorrent::Session::trackersChanged, this, invalidateState);
+}
+
+void SyncState::update()
+{
+    // Some changes (e.g. of the limits made from GUI) aren't signaled
+    // so the data is refreshed periodically anyway
+    if (m_isValid && !m_updateTimer.hasExpired(BitTorrent::Session::instance()->refreshInterval()))
+        return;
+
+    collect();
+    m_isValid = true;
+    m_updateTimer.start();
+}
+
+void SyncState::invalidate()
+{
+    m_isValid = false;
+    emit invalidated();
+}
+
+quint64 SyncState::revision() const
+{
+    return m_revision;
+}
+
+const SyncStore &SyncState::torrents() const
+{
+    return m_torrents;
+}
+
+const SyncStore &SyncState::trackers() const
+{
+    return m_trackers;
+}
+
+void SyncState::collect()
+{
+    const auto *session = BitTorrent::Session::instance();
+    const QVector<BitTorrent::Torrent *> torrents = session->torrents();
+
+    ++m_revision;
+    m_torrents.beginUpdate(m_revision);
+
+    int idFieldIndex = -1;
+    QVector<QJsonValue> values;
+    QHash<QString, QJsonArray> trackers;
+    for (const BitTorrent::Torrent *torrent : torrents)
+    {
+        const QString torrentID = torrent->id().toString();
+
+        if (idFieldIndex < 0)
+        {
+            QStringList keys;
+            serialize(*torrent, values, &keys);
+            idFieldIndex = keys.indexOf(KEY_TORRENT_ID);
+            keys.removeAt(idFieldIndex);
+
+            if (keys != m_torrents.fieldKeys())
+            {
+                m_torrents = SyncStore(keys);
+                // Calculated last activity time can differ from actual value by up to 10 seconds (this is a libtorrent issue).
+                // So we don't need unnecessary updates of last activity time in response.
+                m_torrents.setFieldTolerance(keys.indexOf(KEY_TORRENT_LAST_ACTIVITY_TIME), 15);
+                m_torrents.beginUpdate(m_revision);
+            }
+        }
+        else
+        {
+            serialize(*torrent, values);
+        }
+
+        values.removeAt(idFieldIndex);
+        m_torrents.updateItem(torrentID, values);
+
+        for (const BitTorrent::TrackerEntry &tracker : asConst(torrent->trackers()))
+            trackers[tracker.url].append(torrentID);
+    }
+
+    m_torrents.endUpdate();
+
+    m_trackers.beginUpdate(m_revision);
+    for (auto iter = trackers.cbegin(); iter != trackers.cend(); ++iter)
+        m_trackers.updateItem(iter.key(), {iter.value()});
+    m_trackers.endUpdate();
+}
@@ -0,0 +1,65 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+
+#include "syncstore.h"
+
+// Torrents and trackers data of sync/maindata shared by all WebUI sessions.
+// The data is collected once per update no matter how many clients poll it.
+class SyncState final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(SyncState)
+
+public:
+    explicit SyncState(QObject *parent = nullptr);
+
+    // Collects the data if it might be changed since it was collected last time
+    void update();
+    void invalidate();
+
+    quint64 revision() const;
+    const SyncStore &torrents() const;
+    const SyncStore &trackers() const;
+
+signals:
+    void invalidated();
+
+private:
+    void collect();
+
+    SyncStore m_torrents;
+    SyncStore m_trackers;
+    quint64 m_revision = 0;
+    bool m_isValid = false;
+    QElapsedTimer m_updateTimer;
+};
@@ -0,0 +1,259 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "syncstore.h"
+
+#include <algorithm>
+
+#include <QtGlobal>
+
+#include "jsonwriter.h"
+
+namespace
+{
+    const int MAX_REMOVED_ITEMS = 10000;
+}
+
+SyncStore::SyncStore(const QStringList &fieldKeys)
+    : m_fieldKeys {fieldKeys}
+    , m_fieldTolerances(std::max<int>(fieldKeys.size(), 1), 0)
+{
+}
+
+QStringList SyncStore::fieldKeys() const
+{
+    return m_fieldKeys;
+}
+
+void SyncStore::setFieldTolerance(const int fieldIndex, const double tolerance)
+{
+    m_fieldTolerances[fieldIndex] = tolerance;
+}
+
+quint64 SyncStore::revision() const
+{
+    return m_revision;
+}
+
+void SyncStore::beginUpdate(const quint64 revision)
+{
+    Q_ASSERT(revision > m_revision);
+    m_revision = revision;
+}
+
+void SyncStore::updateItem(const QString &key, const QVector<QJsonValue> &values)
+{
+    Q_ASSERT(values.size() == m_fieldTolerances.size());
+
+    const auto iter = m_items.find(key);
+    if (iter == m_items.end())
+    {
+        m_items.insert(key, {values, QVector<quint64>(values.size(), m_revision), m_revision, m_revision, m_revision});
+        m_removedItems.remove(key);
+        return;
+    }
+
+    Item &item = iter.value();
+    item.updatedRevision = m_revision;
+    for (int i = 0; i < values.size(); ++i)
+    {
+        if (!isEqual(i, item.values[i], values[i]))
+        {
+            item.values[i] = values[i];
+            item.revisions[i] = m_revision;
+            item.changedRevision = m_revision;
+        }
+    }
+}
+
+void SyncStore::endUpdate()
+{
+    for (auto iter = m_items.begin(); iter != m_items.end();)
+    {
+        if (iter->updatedRevision == m_revision)
+        {
+            ++iter;
+            continue;
+        }
+
+        m_removedItems.insert(iter.key(), m_revision);
+        iter = m_items.erase(iter);
+    }
+
+    if (m_removedItems.size() > MAX_REMOVED_ITEMS)
+    {
+        // forget the oldest half of removed items
+        QVector<quint64> revisions(m_removedItems.cbegin(), m_removedItems.cend());
+        const auto middle = revisions.begin() + (revisions.size() / 2);
+        std::nth_element(revisions.begin(), middle, revisions.end());
+        m_removedItemsRevision = *middle;
+
+        for (auto iter = m_removedItems.begin(); iter != m_removedItems.end();)
+        {
+            if (iter.value() <= m_removedItemsRevision)
+                iter = m_removedItems.erase(iter);
+            else
+                ++iter;
+        }
+    }
+}
+
+bool SyncStore::isFullUpdateNeeded(const quint64 sinceRevision) const
+{
+    return (sinceRevision == 0) || (sinceRevision > m_revision) || (sinceRevision < m_removedItemsRevision);
+}
+
+QJsonObject SyncStore::changedItems(quint64 sinceRevision) const
+{
+    if (isFullUpdateNeeded(sinceRevision))
+        sinceRevision = 0;
+
+    QJsonObject result;
+    for (auto iter = m_items.cbegin(); iter != m_items.cend(); ++iter)
+    {
+        const QJsonValue data = itemData(iter.value(), sinceRevision);
+        if (!data.isUndefined())
+            result.insert(iter.key(), data);
+    }
+
+    return result;
+}
+
+QJsonArray SyncStore::removedItems(const quint64 sinceRevision) const
+{
+    if (isFullUpdateNeeded(sinceRevision))
+        return {};
+
+    QJsonArray result;
+    for (auto iter = m_removedItems.cbegin(); iter != m_removedItems.cend(); ++iter)
+    {
+        if (iter.value() > sinceRevision)
+            result.append(iter.key());
+    }
+
+    return result;
+}
+
+bool SyncStore::hasChangedItems(quint64 sinceRevision) const
+{
+    if (isFullUpdateNeeded(sinceRevision))
+        sinceRevision = 0;
+
+    return std::any_of(m_items.cbegin(), m_items.cend(), [sinceRevision](const Item &item)
+    {
+        return (item.changedRevision > sinceRevision);
+    });
+}
+
+bool SyncStore::hasRemovedItems(const quint64 sinceRevision) const
+{
+    if (isFullUpdateNeeded(sinceRevision))
+        return false;
+
+    return std::any_of(m_removedItems.cbegin(), m_removedItems.cend(), [sinceRevision](const quint64 revision)
+    {
+        return (revision > sinceRevision);
+    });
+}
+
+void SyncStore::writeChangedItems(JsonWriter &writer, quint64 sinceRevision) const
+{
+    if (isFullUpdateNeeded(sinceRevision))
+        sinceRevision = 0;
+
+    writer.beginObject();
+    for (auto iter = m_items.cbegin(); iter != m_items.cend(); ++iter)
+    {
+        const Item &item = iter.value();
+        if (item.changedRevision <= sinceRevision)
+            continue;
+
+        writer.writeKey(iter.key());
+        if (m_fieldKeys.isEmpty())
+        {
+            writer.writeValue(item.values[0]);
+            continue;
+        }
+
+        const bool isNewItem = (item.addedRevision > sinceRevision);
+        writer.beginObject();
+        for (int i = 0; i < m_fieldKeys.size(); ++i)
+        {
+            if (isNewItem || (item.revisions[i] > sinceRevision))
+                writer.writeMember(m_fieldKeys[i], item.values[i]);
+        }
+        writer.endObject();
+    }
+    writer.endObject();
+}
+
+void SyncStore::writeRemovedItems(JsonWriter &writer, const quint64 sinceRevision) const
+{
+    writer.beginArray();
+    if (!isFullUpdateNeeded(sinceRevision))
+    {
+        for (auto iter = m_removedItems.cbegin(); iter != m_removedItems.cend(); ++iter)
+        {
+            if (iter.value() > sinceRevision)
+                writer.writeValue(iter.key());
+        }
+    }
+    writer.endArray();
+}
+
+bool SyncStore::isEqual(const int fieldIndex, const QJsonValue &left, const QJsonValue &right) const
+{
+    const double tolerance = m_fieldTolerances[fieldIndex];
+    if ((tolerance > 0) && left.isDouble() && right.isDouble())
+        return (qAbs(left.toDouble() - right.toDouble()) < tolerance);
+
+    return (left == right);
+}
+
+QJsonValue SyncStore::itemData(const Item &item, const quint64 sinceRevision) const
+{
+    const bool isNewItem = (item.addedRevision > sinceRevision);
+
+    if (m_fieldKeys.isEmpty())
+    {
+        if (isNewItem || (item.revisions[0] > sinceRevision))
+            return item.values[0];
+        return QJsonValue::Undefined;
+    }
+
+    QJsonObject object;
+    for (int i = 0; i < m_fieldKeys.size(); ++i)
+    {
+        if (isNewItem || (item.revisions[i] > sinceRevision))
+            object.insert(m_fieldKeys[i], item.values[i]);
+    }
+
+    if (object.isEmpty())
+        return QJsonValue::Undefined;
+    return object;
+}
@@ -0,0 +1,95 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class JsonWriter;
+
+// Keeps the last known fields of the items (e.g. torrents) together with the revision
+// they were changed at. The changes since any revision can be computed from it so
+// the clients don't need to keep their own copies of the data to compare against.
+class SyncStore
+{
+public:
+    // If there are no field keys the items hold a single plain value
+    explicit SyncStore(const QStringList &fieldKeys = {});
+
+    QStringList fieldKeys() const;
+    // Numeric values which differ less than the tolerance aren't considered changed
+    void setFieldTolerance(int fieldIndex, double tolerance);
+
+    quint64 revision() const;
+    // All the items should be updated between beginUpdate() and endUpdate(),
+    // the ones which weren't are considered removed
+    void beginUpdate(quint64 revision);
+    void updateItem(const QString &key, const QVector<QJsonValue> &values);
+    void endUpdate();
+
+    // The client having the data of the given revision can't be updated
+    // incrementally and should drop its data
+    bool isFullUpdateNeeded(quint64 sinceRevision) const;
+    // Returns the changed fields of the items (all the items in case of full update)
+    QJsonObject changedItems(quint64 sinceRevision) const;
+    QJsonArray removedItems(quint64 sinceRevision) const;
+
+    // Same as above but the items are written directly to the response
+    bool hasChangedItems(quint64 sinceRevision) const;
+    bool hasRemovedItems(quint64 sinceRevision) const;
+    void writeChangedItems(JsonWriter &writer, quint64 sinceRevision) const;
+    void writeRemovedItems(JsonWriter &writer, quint64 sinceRevision) const;
+
+private:
+    struct Item
+    {
+        QVector<QJsonValue> values;
+        QVector<quint64> revisions;
+        quint64 addedRevision = 0;
+        quint64 updatedRevision = 0;
+        // The latest revision any of the fields was changed at
+        quint64 changedRevision = 0;
+    };
+
+    bool isEqual(int fieldIndex, const QJsonValue &left, const QJsonValue &right) const;
+    QJsonValue itemData(const Item &item, quint64 sinceRevision) const;
+
+    QStringList m_fieldKeys;
+    QVector<double> m_fieldTolerances;
+    QHash<QString, Item> m_items;
+    QHash<QString, quint64> m_removedItems;
+    // Clients older than it might have missed removed items which are forgotten already
+    quint64 m_removedItemsRevision = 0;
+    quint64 m_revision = 0;
+};
@@ -0,0 +1,174 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentpaging.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "base/utils/compare.h"
+
+namespace
+{
+    using TorrentNaturalCompare = Utils::Compare::NaturalCompare<Qt::CaseInsensitive>;
+
+    // The value of the sorted field is converted once per torrent
+    // so that the torrents are compared cheaply while sorting
+    struct TorrentSortItem
+    {
+        int index = -1;
+        BitTorrent::TorrentID id;
+        QJsonValue sortValue;
+        double number = 0;
+        std::optional<Utils::Compare::NaturalSortKey> text;
+    };
+
+    TorrentSortItem makeSortItem(const int index, const BitTorrent::TorrentID &id
+        , const QJsonValue &sortValue, const TorrentNaturalCompare &naturalCompare)
+    {
+        TorrentSortItem item {index, id, sortValue};
+        if (sortValue.isString())
+            item.text = naturalCompare.sortKey(sortValue.toString());
+        else if (sortValue.isBool())
+            item.number = sortValue.toBool() ? 1 : 0;
+        else
+            item.number = sortValue.toDouble();
+        return item;
+    }
+
+    QVector<TorrentSortItem> makeSortItems(const QVector<TorrentSortValue> &sortValues, const TorrentNaturalCompare &naturalCompare)
+    {
+        QVector<TorrentSortItem> items;
+        items.reserve(sortValues.size());
+        for (int i = 0; i < sortValues.size(); ++i)
+            items.append(makeSortItem(i, sortValues[i].id, sortValues[i].value, naturalCompare));
+        return items;
+    }
+
+    int compareSortItems(const TorrentSortItem &left, const TorrentSortItem &right)
+    {
+        if (left.text && right.text)
+            return left.text->compare(*right.text);
+        if (left.number < right.number)
+            return -1;
+        if (left.number > right.number)
+            return 1;
+        return 0;
+    }
+
+    auto sortItemsLessThan(const bool reverse)
+    {
+        return [reverse](const TorrentSortItem &left, const TorrentSortItem &right) -> bool
+        {
+            const int result = compareSortItems(left, right);
+            if (result != 0)
+                return reverse ? (result > 0) : (result < 0);
+            // keep the order stable between the requests
+            return (left.id < right.id);
+        };
+    }
+
+    // Cursor identifies the last torrent of the page by its sort value and ID
+    // so the next page can be found without knowing the position of the torrent
+    QString makeCursor(const QJsonValue &sortValue, const BitTorrent::TorrentID &id)
+    {
+        const QByteArray data = QJsonDocument(QJsonArray {sortValue, id.toString()}).toJson(QJsonDocument::Compact);
+        return QString::fromLatin1(data.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+    }
+
+    std::optional<std::pair<QJsonValue, BitTorrent::TorrentID>> parseCursor(const QString &cursor)
+    {
+        const QByteArray data = QByteArray::fromBase64(cursor.toLatin1(), QByteArray::Base64UrlEncoding);
+        const QJsonArray array = QJsonDocument::fromJson(data).array();
+        if ((array.size() != 2) || !array[1].isString())
+            return std::nullopt;
+
+        const auto id = BitTorrent::TorrentID::fromString(array[1].toString());
+        if (!id.isValid())
+            return std::nullopt;
+
+        return std::make_pair(array[0], id);
+    }
+}
+
+// Only the torrents up to the end of the requested page are sorted
+QVector<int> sortedTorrentPage(const QVector<TorrentSortValue> &sortValues, const int offset, const int count, const bool reverse)
+{
+    const TorrentNaturalCompare naturalCompare;
+    QVector<TorrentSortItem> items = makeSortItems(sortValues, naturalCompare);
+    std::partial_sort(items.begin(), (items.begin() + offset + count), items.end(), sortItemsLessThan(reverse));
+
+    QVector<int> indexes;
+    indexes.reserve(count);
+    for (int i = offset; i < (offset + count); ++i)
+        indexes.append(items[i].index);
+    return indexes;
+}
+
+std::optional<TorrentPage> torrentPageAfterCursor(const QVector<TorrentSortValue> &sortValues, const QString &cursor
+        , const int limit, const bool reverse, const bool isTextField)
+{
+    const TorrentNaturalCompare naturalCompare;
+    const auto lessThan = sortItemsLessThan(reverse);
+
+    QVector<TorrentSortItem> items = makeSortItems(sortValues, naturalCompare);
+    if (!cursor.isEmpty())
+    {
+        const auto cursorData = parseCursor(cursor);
+        // a valid cursor is accepted even if no torrent matches anymore
+        if (!cursorData || (cursorData->first.isString() != isTextField))
+            return std::nullopt;
+
+        const TorrentSortItem cursorItem = makeSortItem(-1, cursorData->second, cursorData->first, naturalCompare);
+        items.erase(std::remove_if(items.begin(), items.end(), [&lessThan, &cursorItem](const TorrentSortItem &item)
+        {
+            return !lessThan(cursorItem, item);
+        }), items.end());
+    }
+
+    const bool hasNextPage = (limit > 0) && (limit < items.size());
+    const int pageSize = hasNextPage ? limit : static_cast<int>(items.size());
+    std::partial_sort(items.begin(), (items.begin() + pageSize), items.end(), lessThan);
+
+    TorrentPage page;
+    page.indexes.reserve(pageSize);
+    for (int i = 0; i < pageSize; ++i)
+        page.indexes.append(items[i].index);
+
+    if (hasNextPage)
+    {
+        const TorrentSortItem &lastItem = items[pageSize - 1];
+        page.nextCursor = makeCursor(lastItem.sortValue, lastItem.id);
+    }
+
+    return page;
+}
@@ -0,0 +1,61 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <QJsonValue>
+#include <QString>
+#include <QVector>
+
+#include "base/bittorrent/infohash.h"
+
+// Sorting and paging of the torrent list. The torrents are represented by their IDs
+// and the values of the sorted field (null if the list isn't sorted by any field).
+// Pages are returned as the indexes of the torrents in the sorted order.
+struct TorrentSortValue
+{
+    BitTorrent::TorrentID id;
+    QJsonValue value;
+};
+
+struct TorrentPage
+{
+    QVector<int> indexes;
+    // identifies the last torrent of the page unless it's the last page
+    std::optional<QString> nextCursor;
+};
+
+// Returns the `count` torrents starting at `offset` of the sorted list
+QVector<int> sortedTorrentPage(const QVector<TorrentSortValue> &sortValues, int offset, int count, bool reverse);
+// Returns up to `limit` torrents (all if it isn't positive) which follow the torrent
+// identified by the cursor, or the first ones if the cursor is empty.
+// Nothing is returned if the cursor is invalid.
+std::optional<TorrentPage> torrentPageAfterCursor(const QVector<TorrentSortValue> &sortValues, const QString &cursor
+        , int limit, bool reverse, bool isTextField);
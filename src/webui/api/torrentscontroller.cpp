@@ -28,21 +28,27 @@
 
 #include "torrentscontroller.h"
 
+#include <algorithm>
 #include <functional>
+#include <optional>
 
 #include <QBitArray>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QJsonValue>
 #include <QList>
 #include <QNetworkCookie>
 #include <QRegularExpression>
+#include <QSet>
 #include <QUrl>
+#include <QVector>
 
 #include "base/bittorrent/categoryoptions.h"
 #include "base/bittorrent/downloadpriority.h"
 #include "base/bittorrent/infohash.h"
 #include "base/bittorrent/peeraddress.h"
 #include "base/bittorrent/peerinfo.h"
+#include "base/bittorrent/piecestates.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrent.h"
 #include "base/bittorrent/torrentinfo.h"
@@ -54,7 +60,9 @@
 #include "base/utils/fs.h"
 #include "base/utils/string.h"
 #include "apierror.h"
+#include "jsonwriter.h"
 #include "serialize/serialize_torrent.h"
+#include "torrentpaging.h"
 
 // Tracker keys
 const QString KEY_TRACKER_URL = u"url"_qs;
@@ -69,6 +77,12 @@ const QString KEY_TRACKER_DOWNLOADED_COUNT = u"num_downloaded"_qs;
 // Web seed keys
 const QString KEY_WEBSEED_URL = u"url"_qs;
 
+// Pieces keys
+const QString KEY_PIECES_NUM = u"pieces_num"_qs;
+const QString KEY_PIECES_OFFSET = u"offset"_qs;
+const QString KEY_PIECES_STATES = u"states"_qs;
+const QString KEY_PIECES_HASHES = u"hashes"_qs;
+
 // Torrent keys (Properties)
 const QString KEY_PROP_TIME_ELAPSED = u"time_elapsed"_qs;
 const QString KEY_PROP_SEEDING_TIME = u"seeding_time"_qs;
@@ -123,20 +137,29 @@ namespace
 
     void applyToTorrents(const QStringList &idList, const std::function<void (BitTorrent::Torrent *torrent)> &func)
     {
+        BitTorrent::Session *const session = BitTorrent::Session::instance();
         if ((idList.size() == 1) && (idList[0] == u"all"))
         {
-            for (BitTorrent::Torrent *const torrent : asConst(BitTorrent::Session::instance()->torrents()))
-                func(torrent);
+            session->applyToTorrents(session->torrents(), func);
         }
         else
         {
+            // the same torrent must not be passed twice since `func` may delete it
+            QVector<BitTorrent::Torrent *> torrents;
+            QSet<BitTorrent::TorrentID> torrentIDs;
+            torrents.reserve(idList.size());
             for (const QString &idString : idList)
             {
                 const auto hash = BitTorrent::TorrentID::fromString(idString);
-                BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->findTorrent(hash);
-                if (torrent)
-                    func(torrent);
+                BitTorrent::Torrent *const torrent = session->findTorrent(hash);
+                if (torrent && !torrentIDs.contains(hash))
+                {
+                    torrentIDs.insert(hash);
+                    torrents.append(torrent);
+                }
             }
+
+            session->applyToTorrents(torrents, func);
         }
     }
 
@@ -229,10 +252,25 @@ namespace
             idList << BitTorrent::TorrentID::fromString(hash);
         return idList;
     }
+
+    bool isPackedFormat(const StringMap &params)
+    {
+        return (params.value(u"format"_qs) == u"packed");
+    }
+
+    // Returns the range of the pieces requested by "offset" and "limit" params
+    BitTorrent::TorrentInfo::PieceRange requestedPieces(const StringMap &params, const int piecesCount)
+    {
+        const int offset = std::clamp(params.value(u"offset"_qs).toInt(), 0, piecesCount);
+        const int limit = params.value(u"limit"_qs).toInt();
+        const int count = ((limit > 0) && (limit < (piecesCount - offset))) ? limit : (piecesCount - offset);
+        return {offset, count};
+    }
 }
 
 // Returns all the torrents in JSON format.
-// The return value is a JSON-formatted list of dictionaries.
+// The return value is a JSON-formatted list of dictionaries,
+// or the dictionary having the list under "torrents" key if "cursor" param is presented.
 // The dictionary keys are:
 //   - "hash": Torrent hash (ID)
 //   - "name": Torrent name
@@ -257,10 +295,14 @@ namespace
 //   - category (string): torrent category for filtering by it (empty string means "uncategorized"; no "category" param presented means "any category")
 //   - tag (string): torrent tag for filtering by it (empty string means "untagged"; no "tag" param presented means "any tag")
 //   - hashes (string): filter by hashes, can contain multiple hashes separated by |
-//   - sort (string): name of column for sorting by its value
+//   - fields (string): keys of the fields to return separated by | (all the fields by default)
+//   - sort (string): name of column for sorting by its value (strings are compared naturally and case insensitively)
 //   - reverse (bool): enable reverse sorting
 //   - limit (int): set limit number of torrents returned (if greater than 0, otherwise - unlimited)
-//   - offset (int): set offset (if less than 0 - offset from end)
+//   - offset (int): set offset (if less than 0 - offset from end), it's ignored if "cursor" param is presented
+//   - cursor (string): return the page following the one this cursor was returned with (empty string means the first page).
+//                      The torrents are ordered by their hashes if "sort" param isn't presented.
+//                      The "next_cursor" key of the result holds the cursor of the next page unless it's the last one.
 void TorrentsController::infoAction()
 {
     const QString filter {params()[u"filter"_qs]};
@@ -271,6 +313,8 @@ void TorrentsController::infoAction()
     int limit {params()[u"limit"_qs].toInt()};
     int offset {params()[u"offset"_qs].toInt()};
     const QStringList hashes {params()[u"hashes"_qs].split(u'|', Qt::SkipEmptyParts)};
+    const QStringList fields {params()[u"fields"_qs].split(u'|', Qt::SkipEmptyParts)};
+    const std::optional<QString> cursor = getOptionalString(params(), u"cursor"_qs);
 
     std::optional<TorrentIDSet> idSet;
     if (!hashes.isEmpty())
@@ -281,73 +325,93 @@ void TorrentsController::infoAction()
     }
 
     const TorrentFilter torrentFilter {filter, idSet, category, tag};
-    QVariantList torrentList;
+    QVector<const BitTorrent::Torrent *> torrents;
     for (const BitTorrent::Torrent *torrent : asConst(BitTorrent::Session::instance()->torrents()))
     {
         if (torrentFilter.match(torrent))
-            torrentList.append(serialize(*torrent));
-    }
-
-    if (torrentList.isEmpty())
-    {
-        setResult(QJsonArray {});
-        return;
+            torrents.append(torrent);
     }
 
+    int sortedColumnIndex = -1;
     if (!sortedColumn.isEmpty())
     {
-        if (!torrentList[0].toMap().contains(sortedColumn))
+        sortedColumnIndex = torrentFieldKeys().indexOf(sortedColumn);
+        if (sortedColumnIndex < 0)
             throw APIError(APIErrorType::BadParams, tr("'sort' parameter is invalid"));
+    }
 
-        const auto lessThan = [](const QVariant &left, const QVariant &right) -> bool
-        {
-            Q_ASSERT(left.type() == right.type());
-
-            switch (static_cast<QMetaType::Type>(left.type()))
-            {
-            case QMetaType::Bool:
-                return left.value<bool>() < right.value<bool>();
-            case QMetaType::Double:
-                return left.value<double>() < right.value<double>();
-            case QMetaType::Float:
-                return left.value<float>() < right.value<float>();
-            case QMetaType::Int:
-                return left.value<int>() < right.value<int>();
-            case QMetaType::LongLong:
-                return left.value<qlonglong>() < right.value<qlonglong>();
-            case QMetaType::QString:
-                return left.value<QString>() < right.value<QString>();
-            default:
-                qWarning("Unhandled QVariant comparison, type: %d, name: %s", left.type()
-                    , QMetaType::typeName(left.type()));
-                break;
-            }
-            return false;
-        };
+    const std::optional<QBitArray> fieldMask = torrentFieldMask(fields);
+    if (!fieldMask)
+        throw APIError(APIErrorType::BadParams, tr("'fields' parameter is invalid"));
 
-        std::sort(torrentList.begin(), torrentList.end()
-            , [reverse, &sortedColumn, &lessThan](const QVariant &torrent1, const QVariant &torrent2)
+    // The value of the sorted column is extracted once per torrent
+    const auto sortValues = [&torrents, sortedColumnIndex]() -> QVector<TorrentSortValue>
+    {
+        QVector<TorrentSortValue> values;
+        values.reserve(torrents.size());
+        for (const BitTorrent::Torrent *torrent : asConst(torrents))
+            values.append({torrent->id(), ((sortedColumnIndex >= 0) ? serializeField(*torrent, sortedColumnIndex) : QJsonValue())});
+        return values;
+    };
+
+    QVector<const BitTorrent::Torrent *> page;
+    std::optional<QString> nextCursor;
+    if (cursor)
+    {
+        const bool isTextColumn = (sortedColumnIndex >= 0) && isTorrentTextField(sortedColumnIndex);
+        const std::optional<TorrentPage> torrentPage = torrentPageAfterCursor(sortValues(), *cursor, limit, reverse, isTextColumn);
+        if (!torrentPage)
+            throw APIError(APIErrorType::BadParams, tr("'cursor' parameter is invalid"));
+
+        page.reserve(torrentPage->indexes.size());
+        for (const int index : torrentPage->indexes)
+            page.append(torrents[index]);
+        nextCursor = torrentPage->nextCursor;
+    }
+    else
+    {
+        const int size = torrents.size();
+        // normalize offset
+        if (offset < 0)
+            offset = size + offset;
+        if ((offset >= size) || (offset < 0))
+            offset = 0;
+        // normalize limit
+        if ((limit <= 0) || (limit > (size - offset)))
+            limit = size - offset;
+
+        if (sortedColumnIndex >= 0)
         {
-            const QVariant value1 {torrent1.toMap().value(sortedColumn)};
-            const QVariant value2 {torrent2.toMap().value(sortedColumn)};
-            return reverse ? lessThan(value2, value1) : lessThan(value1, value2);
-        });
+            page.reserve(limit);
+            for (const int index : asConst(sortedTorrentPage(sortValues(), offset, limit, reverse)))
+                page.append(torrents[index]);
+        }
+        else
+        {
+            page = torrents.mid(offset, limit);
+        }
+    }
+
+    JsonWriter writer {resultEncoding()};
+    if (cursor)
+    {
+        writer.beginObject();
+        writer.writeKey(u"torrents");
     }
 
-    const int size = torrentList.size();
-    // normalize offset
-    if (offset < 0)
-        offset = size + offset;
-    if ((offset >= size) || (offset < 0))
-        offset = 0;
-    // normalize limit
-    if (limit <= 0)
-        limit = -1; // unlimited
+    writer.beginArray();
+    for (const BitTorrent::Torrent *torrent : asConst(page))
+        serialize(*torrent, writer, *fieldMask);
+    writer.endArray();
 
-    if ((limit > 0) || (offset > 0))
-        torrentList = torrentList.mid(offset, limit);
+    if (cursor)
+    {
+        if (nextCursor)
+            writer.writeMember(u"next_cursor", *nextCursor);
+        writer.endObject();
+    }
 
-    setResult(QJsonArray::fromVariantList(torrentList));
+    setResult(writer);
 }
 
 // Returns the properties for a torrent in JSON format.
@@ -561,7 +625,8 @@ void TorrentsController::filesAction()
             fileIndexes.append(i);
     }
 
-    QJsonArray fileList;
+    JsonWriter writer {resultEncoding()};
+    writer.beginArray();
     if (torrent->hasMetadata())
     {
         const QVector<BitTorrent::DownloadPriority> priorities = torrent->filePriorities();
@@ -570,31 +635,41 @@ void TorrentsController::filesAction()
         const BitTorrent::TorrentInfo info = torrent->info();
         for (const int index : asConst(fileIndexes))
         {
-            QJsonObject fileDict =
-            {
-                {KEY_FILE_INDEX, index},
-                {KEY_FILE_PROGRESS, fp[index]},
-                {KEY_FILE_PRIORITY, static_cast<int>(priorities[index])},
-                {KEY_FILE_SIZE, torrent->fileSize(index)},
-                {KEY_FILE_AVAILABILITY, fileAvailability[index]},
-                {KEY_FILE_NAME, torrent->filePath(index).toString()}
-            };
+            writer.beginObject();
+            writer.writeMember(KEY_FILE_INDEX, index);
+            writer.writeMember(KEY_FILE_PROGRESS, fp[index]);
+            writer.writeMember(KEY_FILE_PRIORITY, static_cast<int>(priorities[index]));
+            writer.writeMember(KEY_FILE_SIZE, torrent->fileSize(index));
+            writer.writeMember(KEY_FILE_AVAILABILITY, fileAvailability[index]);
+            writer.writeMember(KEY_FILE_NAME, torrent->filePath(index).toString());
 
             const BitTorrent::TorrentInfo::PieceRange idx = info.filePieces(index);
-            fileDict[KEY_FILE_PIECE_RANGE] = QJsonArray {idx.first(), idx.last()};
+            writer.writeKey(KEY_FILE_PIECE_RANGE);
+            writer.beginArray();
+            writer.writeValue(idx.first());
+            writer.writeValue(idx.last());
+            writer.endArray();
 
             if (index == 0)
-                fileDict[KEY_FILE_IS_SEED] = torrent->isSeed();
-
-            fileList.append(fileDict);
+                writer.writeMember(KEY_FILE_IS_SEED, torrent->isSeed());
+            writer.endObject();
         }
     }
+    writer.endArray();
 
-    setResult(fileList);
+    setResult(writer);
 }
 
 // Returns an array of hashes (of each pieces respectively) for a torrent in JSON format.
 // The return value is a JSON-formatted array of strings (hex strings).
+// GET params:
+//   - hash (string): torrent hash (ID)
+//   - offset (int): index of the first piece (default 0)
+//   - limit (int): number of pieces (if greater than 0, otherwise - up to the last piece)
+//   - format (string): "packed" to return the dictionary instead of the array, its keys are:
+//       - "pieces_num": number of all the pieces of the torrent
+//       - "offset": index of the first returned piece
+//       - "hashes": base64 encoded hashes of the pieces one after another (20 bytes each)
 void TorrentsController::pieceHashesAction()
 {
     requireParams({u"hash"_qs});
@@ -604,15 +679,32 @@ void TorrentsController::pieceHashesAction()
     if (!torrent)
         throw APIError(APIErrorType::NotFound);
 
-    QJsonArray pieceHashes;
-    if (torrent->hasMetadata())
+    const BitTorrent::TorrentInfo info = torrent->info();
+    const int piecesCount = torrent->hasMetadata() ? info.piecesCount() : 0;
+    const BitTorrent::TorrentInfo::PieceRange pieces = requestedPieces(params(), piecesCount);
+    const QByteArray hashesData = info.pieceHashesData(pieces);
+
+    JsonWriter writer {resultEncoding()};
+    if (isPackedFormat(params()))
     {
-        const QVector<QByteArray> hashes = torrent->info().pieceHashes();
-        for (const QByteArray &hash : hashes)
-            pieceHashes.append(QString::fromLatin1(hash.toHex()));
+        writer.beginObject();
+        writer.writeMember(KEY_PIECES_NUM, piecesCount);
+        writer.writeMember(KEY_PIECES_OFFSET, pieces.first());
+        writer.writeMember(KEY_PIECES_HASHES, QString::fromLatin1(hashesData.toBase64()));
+        writer.endObject();
+    }
+    else
+    {
+        writer.beginArray();
+        for (int offset = 0; offset < hashesData.size(); offset += SHA1Hash::length())
+        {
+            const QByteArray hash = QByteArray::fromRawData((hashesData.constData() + offset), SHA1Hash::length());
+            writer.writeValue(QString::fromLatin1(hash.toHex()));
+        }
+        writer.endArray();
     }
 
-    setResult(pieceHashes);
+    setResult(writer);
 }
 
 // Returns an array of states (of each pieces respectively) for a torrent in JSON format.
@@ -620,6 +712,15 @@ void TorrentsController::pieceHashesAction()
 // 0: piece not downloaded
 // 1: piece requested or downloading
 // 2: piece already downloaded
+// GET params:
+//   - hash (string): torrent hash (ID)
+//   - offset (int): index of the first piece (default 0)
+//   - limit (int): number of pieces (if greater than 0, otherwise - up to the last piece)
+//   - format (string): "packed" to return the dictionary instead of the array, its keys are:
+//       - "pieces_num": number of all the pieces of the torrent
+//       - "offset": index of the first returned piece
+//       - "states": base64 encoded states of the pieces packed into 2 bits each,
+//                   4 pieces per byte starting from the lowest bits
 void TorrentsController::pieceStatesAction()
 {
     requireParams({u"hash"_qs});
@@ -629,19 +730,28 @@ void TorrentsController::pieceStatesAction()
     if (!torrent)
         throw APIError(APIErrorType::NotFound);
 
-    QJsonArray pieceStates;
-    const QBitArray states = torrent->pieces();
-    for (int i = 0; i < states.size(); ++i)
-        pieceStates.append(static_cast<int>(states[i]) * 2);
+    const BitTorrent::PieceStates allStates {torrent->pieces(), torrent->downloadingPieces()};
+    const BitTorrent::TorrentInfo::PieceRange pieces = requestedPieces(params(), allStates.size());
+    const BitTorrent::PieceStates states = allStates.mid(pieces.first(), pieces.size());
 
-    const QBitArray dlstates = torrent->downloadingPieces();
-    for (int i = 0; i < states.size(); ++i)
+    JsonWriter writer {resultEncoding()};
+    if (isPackedFormat(params()))
     {
-        if (dlstates[i])
-            pieceStates[i] = 1;
+        writer.beginObject();
+        writer.writeMember(KEY_PIECES_NUM, allStates.size());
+        writer.writeMember(KEY_PIECES_OFFSET, pieces.first());
+        writer.writeMember(KEY_PIECES_STATES, QString::fromLatin1(states.packedData().toBase64()));
+        writer.endObject();
+    }
+    else
+    {
+        writer.beginArray();
+        for (int i = 0; i < states.size(); ++i)
+            writer.writeValue(static_cast<int>(states.state(i)));
+        writer.endArray();
     }
 
-    setResult(pieceStates);
+    setResult(writer);
 }
 
 void TorrentsController::addAction()
@@ -1076,6 +1186,20 @@ void TorrentsController::bottomPrioAction()
     BitTorrent::Session::instance()->bottomTorrentsQueuePos(toTorrentIDs(hashes));
 }
 
+// Reorders the given torrents within the queue positions they occupy so that
+// they follow each other in the order of "hashes", other torrents keep their positions.
+// Passing all the queued torrents sets the order of the whole queue.
+void TorrentsController::setQueueOrderAction()
+{
+    requireParams({u"hashes"_qs});
+
+    if (!BitTorrent::Session::instance()->isQueueingSystemEnabled())
+        throw APIError(APIErrorType::Conflict, tr("Torrent queueing must be enabled"));
+
+    const QStringList hashes {params()[u"hashes"_qs].split(u'|')};
+    BitTorrent::Session::instance()->setTorrentsQueueOrder(toTorrentIDs(hashes));
+}
+
 void TorrentsController::setLocationAction()
 {
     requireParams({u"hashes"_qs, u"location"_qs});
@@ -1184,12 +1308,50 @@ void TorrentsController::setAutoManagementAction()
     });
 }
 
+// Rechecks the torrents. Optional "mode" parameter:
+//   - "full" (default): All pieces are hashed
+//   - "quick": Only the pieces of the files which were modified since they were completed are hashed
 void TorrentsController::recheckAction()
 {
     requireParams({u"hashes"_qs});
 
     const QStringList hashes {params()[u"hashes"_qs].split(u'|')};
-    applyToTorrents(hashes, [](BitTorrent::Torrent *const torrent) { torrent->forceRecheck(); });
+    const QString mode = params().value(u"mode"_qs, u"full"_qs);
+    if (mode == u"quick")
+        applyToTorrents(hashes, [](BitTorrent::Torrent *const torrent) { torrent->quickRecheck(); });
+    else if (mode == u"full")
+        applyToTorrents(hashes, [](BitTorrent::Torrent *const torrent) { torrent->forceRecheck(); });
+    else
+        throw APIError(APIErrorType::BadParams, tr("Unknown recheck mode"));
+}
+
+// Rechecks only the pieces overlapping the given files
+void TorrentsController::recheckFilesAction()
+{
+    requireParams({u"hash"_qs, u"id"_qs});
+
+    const auto id = BitTorrent::TorrentID::fromString(params()[u"hash"_qs]);
+    BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->findTorrent(id);
+    if (!torrent)
+        throw APIError(APIErrorType::NotFound);
+    if (!torrent->hasMetadata())
+        throw APIError(APIErrorType::Conflict, tr("Torrent's metadata has not yet downloaded"));
+
+    const int filesCount = torrent->filesCount();
+    QVector<int> fileIndexes;
+    for (const QString &fileID : params()[u"id"_qs].split(u'|'))
+    {
+        bool ok = false;
+        const int fileIndex = fileID.toInt(&ok);
+        if (!ok)
+            throw APIError(APIErrorType::BadParams, tr("File IDs must be integers"));
+        if ((fileIndex < 0) || (fileIndex >= filesCount))
+            throw APIError(APIErrorType::Conflict, tr("File ID is not valid"));
+
+        fileIndexes.append(fileIndex);
+    }
+
+    torrent->recheckFiles(fileIndexes);
 }
 
 void TorrentsController::reannounceAction()
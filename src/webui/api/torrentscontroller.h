@@ -49,6 +49,7 @@ private slots:
     void resumeAction();
     void pauseAction();
     void recheckAction();
+    void recheckFilesAction();
     void reannounceAction();
     void renameAction();
     void setCategoryAction();
@@ -77,6 +78,7 @@ private slots:
     void decreasePrioAction();
     void topPrioAction();
     void bottomPrioAction();
+    void setQueueOrderAction();
     void setLocationAction();
     void setSavePathAction();
     void setDownloadPathAction();
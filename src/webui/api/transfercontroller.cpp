@@ -28,13 +28,22 @@
 
 #include "transfercontroller.h"
 
+#include <QHash>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QVector>
 
+#include "base/bittorrent/checkingdevicestatus.h"
+#include "base/bittorrent/contentremovalstatus.h"
+#include "base/bittorrent/diskiostatistics.h"
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/movestoragelanestatus.h"
 #include "base/bittorrent/peeraddress.h"
 #include "base/bittorrent/peerinfo.h"
+#include "base/bittorrent/piecechecker.h"
 #include "base/bittorrent/session.h"
 #include "base/global.h"
+#include "base/utils/fs.h"
 #include "apierror.h"
 
 const QString KEY_TRANSFER_DLSPEED = u"dl_info_speed"_qs;
@@ -46,6 +55,75 @@ const QString KEY_TRANSFER_UPRATELIMIT = u"up_rate_limit"_qs;
 const QString KEY_TRANSFER_DHT_NODES = u"dht_nodes"_qs;
 const QString KEY_TRANSFER_CONNECTION_STATUS = u"connection_status"_qs;
 
+const QString KEY_DISKIO_READ = u"read"_qs;
+const QString KEY_DISKIO_WRITE = u"write"_qs;
+const QString KEY_DISKIO_HASH = u"hash"_qs;
+const QString KEY_DISKIO_MOVE = u"move"_qs;
+const QString KEY_DISKIO_COUNT = u"count"_qs;
+const QString KEY_DISKIO_BYTES = u"bytes"_qs;
+const QString KEY_DISKIO_MEAN = u"mean"_qs;
+const QString KEY_DISKIO_P50 = u"p50"_qs;
+const QString KEY_DISKIO_P90 = u"p90"_qs;
+const QString KEY_DISKIO_P99 = u"p99"_qs;
+const QString KEY_DISKIO_MAX = u"max"_qs;
+
+const QString KEY_CHECKING_SSD = u"ssd"_qs;
+const QString KEY_CHECKING_LIMIT = u"limit"_qs;
+const QString KEY_CHECKING_ACTIVE = u"active"_qs;
+const QString KEY_CHECKING_QUEUED = u"queued"_qs;
+const QString KEY_CHECKING_BYTES = u"checked_bytes"_qs;
+const QString KEY_CHECKING_TIME = u"checking_time"_qs;
+const QString KEY_CHECKING_RATE = u"rate"_qs;
+
+const QString KEY_MOVE_SOURCE = u"source"_qs;
+const QString KEY_MOVE_DESTINATION = u"destination"_qs;
+const QString KEY_MOVE_LIMIT = u"limit"_qs;
+const QString KEY_MOVE_ACTIVE = u"active"_qs;
+const QString KEY_MOVE_QUEUED = u"queued"_qs;
+const QString KEY_MOVE_FINISHED = u"finished"_qs;
+const QString KEY_MOVE_BYTES = u"moved_bytes"_qs;
+const QString KEY_MOVE_TIME = u"moving_time"_qs;
+
+const QString KEY_COPY_CLONED = u"cloned"_qs;
+const QString KEY_COPY_COPY_FILE_RANGE = u"copy_file_range"_qs;
+const QString KEY_COPY_SENDFILE = u"sendfile"_qs;
+const QString KEY_COPY_READ_WRITE = u"read_write"_qs;
+
+const QString KEY_REMOVAL_QUEUED_TORRENTS = u"queued_torrents"_qs;
+const QString KEY_REMOVAL_REMAINING_FILES = u"remaining_files"_qs;
+const QString KEY_REMOVAL_REMOVED_FILES = u"removed_files"_qs;
+const QString KEY_REMOVAL_RATE_LIMIT = u"rate_limit"_qs;
+
+const QString KEY_PIECE_CHECK_PENDING = u"pending"_qs;
+const QString KEY_PIECE_CHECK_HASHED = u"hashed_bytes"_qs;
+const QString KEY_PIECE_CHECK_SKIPPED = u"skipped_bytes"_qs;
+
+namespace
+{
+    QJsonObject serialize(const BitTorrent::DiskIOOperationStatus &status)
+    {
+        return {
+            {KEY_DISKIO_COUNT, status.latency.count()},
+            {KEY_DISKIO_BYTES, status.bytes},
+            {KEY_DISKIO_MEAN, status.latency.mean()},
+            {KEY_DISKIO_P50, status.latency.percentile(50)},
+            {KEY_DISKIO_P90, status.latency.percentile(90)},
+            {KEY_DISKIO_P99, status.latency.percentile(99)},
+            {KEY_DISKIO_MAX, status.latency.max()}
+        };
+    }
+
+    QJsonObject serialize(const BitTorrent::DiskIOStatus &status)
+    {
+        return {
+            {KEY_DISKIO_READ, serialize(status.read)},
+            {KEY_DISKIO_WRITE, serialize(status.write)},
+            {KEY_DISKIO_HASH, serialize(status.hash)},
+            {KEY_DISKIO_MOVE, serialize(status.move)}
+        };
+    }
+}
+
 // Returns the global transfer information in JSON format.
 // The return value is a JSON-formatted dictionary.
 // The dictionary keys are:
@@ -141,3 +219,150 @@ void TransferController::banPeersAction()
             BitTorrent::Session::instance()->banIP(addr.ip.toString());
     }
 }
+
+// Returns disk I/O latency statistics in JSON format.
+// Without parameters the statistics are grouped by storage device,
+// otherwise the statistics of the torrent specified by "hash" are returned.
+// Every device/torrent entry contains "read", "write", "hash" and "move" dictionaries
+// with the following keys (latency values are in microseconds):
+//   - "count": Number of completed jobs
+//   - "bytes": Amount of data processed
+//   - "mean": Mean latency
+//   - "p50", "p90", "p99": Latency percentiles
+//   - "max": Maximum latency
+void TransferController::diskIOAction()
+{
+    const BitTorrent::Session *session = BitTorrent::Session::instance();
+
+    const QString hash = params()[u"hash"_qs];
+    if (!hash.isEmpty())
+    {
+        const auto id = BitTorrent::TorrentID::fromString(hash);
+        if (!session->findTorrent(id))
+            throw APIError(APIErrorType::NotFound);
+
+        setResult(serialize(session->torrentDiskIOStatus(id)));
+        return;
+    }
+
+    const QHash<QString, BitTorrent::DiskIOStatus> deviceStatus = session->deviceDiskIOStatus();
+
+    QJsonObject result;
+    for (auto it = deviceStatus.cbegin(); it != deviceStatus.cend(); ++it)
+        result[it.key()] = serialize(it.value());
+
+    setResult(result);
+}
+
+// Returns the state of disk-aware checking scheduler in JSON format.
+// The result is a dictionary of storage devices with the following keys:
+//   - "ssd": Whether the device is detected as solid state drive
+//   - "limit": Max number of torrents allowed to be checked simultaneously
+//   - "active": Number of torrents being checked
+//   - "queued": Number of torrents waiting to be checked
+//   - "checked_bytes": Total size of torrents checked so far
+//   - "checking_time": Time spent for the completed checks (milliseconds)
+//   - "rate": Current checking speed (bytes/s)
+void TransferController::checkingAction()
+{
+    const QHash<QString, BitTorrent::CheckingDeviceStatus> deviceStatus = BitTorrent::Session::instance()->checkingDeviceStatus();
+
+    QJsonObject result;
+    for (auto it = deviceStatus.cbegin(); it != deviceStatus.cend(); ++it)
+    {
+        const BitTorrent::CheckingDeviceStatus &status = it.value();
+        result[it.key()] = QJsonObject {
+            {KEY_CHECKING_SSD, status.isSolidState},
+            {KEY_CHECKING_LIMIT, status.limit},
+            {KEY_CHECKING_ACTIVE, status.activeCount},
+            {KEY_CHECKING_QUEUED, status.queuedCount},
+            {KEY_CHECKING_BYTES, status.checkedBytes},
+            {KEY_CHECKING_TIME, status.checkingTime},
+            {KEY_CHECKING_RATE, status.rate}
+        };
+    }
+
+    setResult(result);
+}
+
+// Returns the state of torrent moves in JSON format.
+// Moves between the same pair of storage devices share a lane.
+// The result is an array of lanes with the following keys:
+//   - "source": Source storage device
+//   - "destination": Destination storage device
+//   - "limit": Max number of torrents allowed to be moved simultaneously
+//   - "active": Number of torrents being moved
+//   - "queued": Number of torrents waiting to be moved
+//   - "finished": Number of torrents moved so far
+//   - "moved_bytes": Amount of data moved so far
+//   - "moving_time": Time spent for the finished moves (milliseconds)
+void TransferController::moveStorageAction()
+{
+    const QVector<BitTorrent::MoveStorageLaneStatus> laneStatus = BitTorrent::Session::instance()->moveStorageLaneStatus();
+
+    QJsonArray result;
+    for (const BitTorrent::MoveStorageLaneStatus &status : laneStatus)
+    {
+        result.append(QJsonObject {
+            {KEY_MOVE_SOURCE, status.sourceDevice},
+            {KEY_MOVE_DESTINATION, status.destinationDevice},
+            {KEY_MOVE_LIMIT, status.limit},
+            {KEY_MOVE_ACTIVE, status.activeCount},
+            {KEY_MOVE_QUEUED, status.queuedCount},
+            {KEY_MOVE_FINISHED, status.finishedCount},
+            {KEY_MOVE_BYTES, status.movedBytes},
+            {KEY_MOVE_TIME, status.movingTime}
+        });
+    }
+
+    setResult(result);
+}
+
+// Returns the amount of data copied between files in JSON format.
+// The data is grouped by the method used to copy it:
+//   - "cloned": Shared with the copy by the file system (reflink)
+//   - "copy_file_range": Copied by the kernel using copy_file_range()
+//   - "sendfile": Copied by the kernel using sendfile()
+//   - "read_write": Read and written by qBittorrent
+void TransferController::fileCopyAction()
+{
+    const Utils::Fs::CopyStatistics statistics = Utils::Fs::copyStatistics();
+    setResult(QJsonObject {
+        {KEY_COPY_CLONED, statistics.clonedBytes},
+        {KEY_COPY_COPY_FILE_RANGE, statistics.copyFileRangeBytes},
+        {KEY_COPY_SENDFILE, statistics.sendFileBytes},
+        {KEY_COPY_READ_WRITE, statistics.readWriteBytes}
+    });
+}
+
+// Returns the state of the background torrent content removal in JSON format.
+// The response contains the following fields:
+//   - "queued_torrents": Number of torrents whose content is still to be removed
+//   - "remaining_files": Number of files still to be removed
+//   - "removed_files": Number of files removed since startup
+//   - "rate_limit": Maximum number of files removed per second (0 = unlimited)
+void TransferController::contentRemovalAction()
+{
+    const BitTorrent::ContentRemovalStatus status = BitTorrent::Session::instance()->contentRemovalStatus();
+    setResult(QJsonObject {
+        {KEY_REMOVAL_QUEUED_TORRENTS, status.queuedTorrents},
+        {KEY_REMOVAL_REMAINING_FILES, status.remainingFiles},
+        {KEY_REMOVAL_REMOVED_FILES, status.removedFiles},
+        {KEY_REMOVAL_RATE_LIMIT, status.rateLimit}
+    });
+}
+
+// Returns the statistics of quick rechecks in JSON format.
+// The response contains the following fields:
+//   - "pending": Number of torrents being checked or waiting to be checked
+//   - "hashed_bytes": Amount of data hashed since startup
+//   - "skipped_bytes": Amount of data of unmodified files which wasn't hashed since startup
+void TransferController::pieceCheckAction()
+{
+    const BitTorrent::PieceCheckStatistics statistics = BitTorrent::Session::instance()->pieceCheckStatistics();
+    setResult(QJsonObject {
+        {KEY_PIECE_CHECK_PENDING, statistics.pendingCount},
+        {KEY_PIECE_CHECK_HASHED, statistics.hashedBytes},
+        {KEY_PIECE_CHECK_SKIPPED, statistics.skippedBytes}
+    });
+}
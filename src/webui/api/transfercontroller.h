@@ -48,4 +48,10 @@ private slots:
     void setUploadLimitAction();
     void setDownloadLimitAction();
     void banPeersAction();
+    void diskIOAction();
+    void checkingAction();
+    void moveStorageAction();
+    void fileCopyAction();
+    void contentRemovalAction();
+    void pieceCheckAction();
 };
@@ -0,0 +1,197 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "staticfilecache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QMimeDatabase>
+#include <QMimeType>
+#include <QMutexLocker>
+#include <QStringView>
+
+#include "base/global.h"
+#include "base/http/httperror.h"
+#include "base/http/responsebuilder.h"
+#include "base/http/responsegenerator.h"
+#include "base/http/types.h"
+#include "base/utils/fs.h"
+#include "base/utils/gzip.h"
+#include "base/utils/misc.h"
+
+namespace
+{
+    const int MAX_ALLOWED_FILESIZE = 10 * 1024 * 1024;
+
+    QString getCachingInterval(QString contentType)
+    {
+        contentType = contentType.toLower();
+
+        if (contentType.startsWith(u"image/"))
+            return u"private, max-age=604800"_qs;  // 1 week
+
+        if ((contentType == Http::CONTENT_TYPE_CSS)
+            || (contentType == Http::CONTENT_TYPE_JS))
+            {
+            // short interval in case of program update
+            return u"private, max-age=43200"_qs;  // 12 hrs
+        }
+
+        // the cached copy is validated by its ETag
+        return u"no-cache"_qs;
+    }
+
+    // [rfc7232] 3.2. If-None-Match
+    bool matchesETag(const QString &ifNoneMatch, const QString &etag)
+    {
+        if (ifNoneMatch.isEmpty())
+            return false;
+        if (ifNoneMatch.trimmed() == u"*")
+            return true;
+
+        const QList<QStringView> tags = QStringView(ifNoneMatch).split(u',', Qt::SkipEmptyParts);
+        return std::any_of(tags.cbegin(), tags.cend(), [&etag](QStringView tag)
+        {
+            tag = tag.trimmed();
+            // weak comparison
+            if (tag.startsWith(u"W/"))
+                tag = tag.mid(2);
+            return (tag == etag);
+        });
+    }
+}
+
+StaticFileCache::StaticFileCache(Translator translator)
+    : m_translator {std::move(translator)}
+{
+}
+
+void StaticFileCache::sendFile(Http::ResponseBuilder &responseBuilder, const Http::Request &request, const Path &path)
+{
+    const QDateTime lastModified = Utils::Fs::lastModified(path);
+
+    CachedFile cachedFile;
+    {
+        const QMutexLocker locker {&m_cachedFilesMutex};
+        cachedFile = m_cachedFiles.value(path);
+    }
+    if (cachedFile.data.isEmpty() || (lastModified > cachedFile.lastModified))
+    {
+        // the other threads don't wait for the file to be loaded
+        cachedFile = loadFile(path, lastModified);
+
+        const QMutexLocker locker {&m_cachedFilesMutex};
+        m_cachedFiles.insert(path, cachedFile);
+    }
+
+    const bool isCompressed = !cachedFile.compressedData.isEmpty()
+        && Http::acceptsGzipEncoding(request.headers.value(u"accept-encoding"_qs));
+    const QString etag = (isCompressed ? u"\"%1-gzip\""_qs : u"\"%1\""_qs).arg(cachedFile.etag);
+
+    responseBuilder.setHeader({Http::HEADER_CACHE_CONTROL, getCachingInterval(cachedFile.mimeType)});
+    responseBuilder.setHeader({Http::HEADER_ETAG, etag});
+    responseBuilder.setHeader({Http::HEADER_VARY, u"accept-encoding"_qs});
+
+    if (matchesETag(request.headers.value(Http::HEADER_IF_NONE_MATCH), etag))
+    {
+        responseBuilder.status(304, u"Not Modified"_qs);
+        m_statistics.notModifiedBytesSaved.fetchAndAddRelaxed(isCompressed ? cachedFile.compressedData.size() : cachedFile.data.size());
+        return;
+    }
+
+    responseBuilder.print(cachedFile.data, cachedFile.mimeType);
+    responseBuilder.setCompressedContent(cachedFile.compressedData);
+    if (isCompressed)
+        m_statistics.compressedBytesSaved.fetchAndAddRelaxed(cachedFile.data.size() - cachedFile.compressedData.size());
+}
+
+void StaticFileCache::clear()
+{
+    const QMutexLocker locker {&m_cachedFilesMutex};
+    m_cachedFiles.clear();
+}
+
+const StaticFilesStatistics &StaticFileCache::statistics() const
+{
+    return m_statistics;
+}
+
+StaticFileCache::CachedFile StaticFileCache::loadFile(const Path &path, const QDateTime &lastModified)
+{
+    QFile file {path.data()};
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qDebug("File %s was not found!", qUtf8Printable(path.toString()));
+        throw NotFoundHTTPError();
+    }
+
+    if (file.size() > MAX_ALLOWED_FILESIZE)
+    {
+        qWarning("%s: exceeded the maximum allowed file size!", qUtf8Printable(path.toString()));
+        throw InternalServerErrorHTTPError(tr("Exceeded the maximum allowed file size (%1)!")
+                                           .arg(Utils::Misc::friendlyUnit(MAX_ALLOWED_FILESIZE)));
+    }
+
+    QByteArray data {file.readAll()};
+    file.close();
+
+    const QMimeType mimeType = QMimeDatabase().mimeTypeForFileNameAndData(path.data(), data);
+    const bool isTranslatable = mimeType.inherits(u"text/plain"_qs);
+
+    // Translate the file
+    if (isTranslatable && m_translator)
+    {
+        auto dataStr = QString::fromUtf8(data);
+        m_translator(dataStr);
+        data = dataStr.toUtf8();
+    }
+
+    const QString etag = QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex().left(20));
+
+    QByteArray compressedData;
+    if (Http::isCompressible(mimeType.name(), data.size()))
+    {
+        QElapsedTimer compressionTimer;
+        compressionTimer.start();
+
+        bool ok = false;
+        compressedData = Utils::Gzip::compress(data, 9, &ok);
+        // "Content-Encoding: gzip\r\n" is 24 bytes long
+        if (!ok || ((compressedData.size() + 24) >= data.size()))
+            compressedData.clear();
+
+        m_statistics.compressionTime.fetchAndAddRelaxed(compressionTimer.nsecsElapsed() / 1000);
+    }
+
+    return {data, compressedData, mimeType.name(), etag, lastModified};
+}
@@ -0,0 +1,95 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include "base/path.h"
+
+namespace Http
+{
+    class ResponseBuilder;
+    struct Request;
+}
+
+// Static files are served in the I/O threads as well
+struct StaticFilesStatistics
+{
+    QAtomicInteger<qint64> compressionTime = 0;  // in microseconds
+    QAtomicInteger<qint64> compressedBytesSaved = 0;
+    QAtomicInteger<qint64> notModifiedBytesSaved = 0;
+};
+
+// Static files are translated and compressed once and kept until they are modified.
+// The cached copies of the clients are validated by ETag, the compressed content
+// is another representation of the file so it has its own tag.
+class StaticFileCache
+{
+    Q_DISABLE_COPY_MOVE(StaticFileCache)
+    Q_DECLARE_TR_FUNCTIONS(StaticFileCache)
+
+public:
+    // Replaces the translatable strings of the text files
+    using Translator = std::function<void (QString &data)>;
+
+    explicit StaticFileCache(Translator translator = {});
+
+    // It can be called in any thread, the response is written to the passed builder.
+    // Throws HTTPError if the file can't be served.
+    void sendFile(Http::ResponseBuilder &responseBuilder, const Http::Request &request, const Path &path);
+    // The files are loaded again, e.g. when the translation is changed
+    void clear();
+
+    const StaticFilesStatistics &statistics() const;
+
+private:
+    struct CachedFile
+    {
+        QByteArray data;
+        QByteArray compressedData;
+        QString mimeType;
+        QString etag;
+        QDateTime lastModified;
+    };
+
+    CachedFile loadFile(const Path &path, const QDateTime &lastModified);
+
+    const Translator m_translator;
+    QMutex m_cachedFilesMutex;
+    QHash<Path, CachedFile> m_cachedFiles;
+    StaticFilesStatistics m_statistics;
+};
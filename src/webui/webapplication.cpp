@@ -29,40 +29,41 @@
 #include "webapplication.h"
 
 #include <algorithm>
+#include <chrono>
 
 #include <QDateTime>
 #include <QDebug>
-#include <QFile>
 #include <QFileInfo>
 #include <QJsonDocument>
-#include <QMimeDatabase>
-#include <QMimeType>
 #include <QNetworkCookie>
 #include <QRegularExpression>
 #include <QUrl>
 
 #include "base/algorithm.h"
 #include "base/global.h"
+#include "base/http/eventstream.h"
 #include "base/http/httperror.h"
 #include "base/logger.h"
 #include "base/preferences.h"
 #include "base/types.h"
 #include "base/utils/bytearray.h"
 #include "base/utils/fs.h"
-#include "base/utils/misc.h"
 #include "base/utils/random.h"
 #include "base/utils/string.h"
 #include "api/apierror.h"
 #include "api/appcontroller.h"
 #include "api/authcontroller.h"
+#include "api/batchrequest.h"
+#include "api/jsonwriter.h"
 #include "api/logcontroller.h"
 #include "api/rsscontroller.h"
 #include "api/searchcontroller.h"
 #include "api/synccontroller.h"
+#include "api/syncpublisher.h"
+#include "api/syncstate.h"
 #include "api/torrentscontroller.h"
 #include "api/transfercontroller.h"
 
-const int MAX_ALLOWED_FILESIZE = 10 * 1024 * 1024;
 const auto C_SID = QByteArrayLiteral("SID"); // name of session id cookie
 
 const QString PATH_PREFIX_ICONS = u"/icons/"_qs;
@@ -70,6 +71,8 @@ const QString WWW_FOLDER = u":/www"_qs;
 const QString PUBLIC_FOLDER = u"/public"_qs;
 const QString PRIVATE_FOLDER = u"/private"_qs;
 
+const QString BATCH_API_PATH = u"/api/v2/batch"_qs;
+
 namespace
 {
     QStringMap parseCookie(const QStringView cookieStr)
@@ -91,6 +94,11 @@ namespace
         return ret;
     }
 
+    qint64 currentTimestamp()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
     QUrl urlFromHostHeader(const QString &hostHeader)
     {
         if (!hostHeader.contains(u"://"))
@@ -98,21 +106,39 @@ namespace
         return hostHeader;
     }
 
-    QString getCachingInterval(QString contentType)
+    // [rfc7231] 5.3.2. Accept
+    // CBOR is used only if the client prefers it to JSON
+    JsonWriter::Encoding preferredResultEncoding(const QString &accept)
     {
-        contentType = contentType.toLower();
+        double jsonQuality = 0;
+        double cborQuality = 0;
 
-        if (contentType.startsWith(u"image/"))
-            return u"private, max-age=604800"_qs;  // 1 week
+        const QList<QStringView> mediaRanges = QStringView(accept).split(u',', Qt::SkipEmptyParts);
+        for (const QStringView mediaRange : mediaRanges)
+        {
+            const QList<QStringView> params = mediaRange.split(u';');
+            const QStringView mediaType = params[0].trimmed();
 
-        if ((contentType == Http::CONTENT_TYPE_CSS)
-            || (contentType == Http::CONTENT_TYPE_JS))
+            double quality = 1;
+            for (int i = 1; i < params.size(); ++i)
             {
-            // short interval in case of program update
-            return u"private, max-age=43200"_qs;  // 12 hrs
+                const QStringView param = params[i].trimmed();
+                if (param.startsWith(u"q=", Qt::CaseInsensitive))
+                    quality = param.mid(2).toString().toDouble();
+            }
+
+            if (mediaType.compare(Http::CONTENT_TYPE_CBOR, Qt::CaseInsensitive) == 0)
+            {
+                cborQuality = std::max(cborQuality, quality);
+            }
+            else if ((mediaType.compare(Http::CONTENT_TYPE_JSON, Qt::CaseInsensitive) == 0)
+                || (mediaType == u"application/*") || (mediaType == u"*/*"))
+            {
+                jsonQuality = std::max(jsonQuality, quality);
+            }
         }
 
-        return u"no-store"_qs;
+        return (cborQuality > jsonQuality) ? JsonWriter::Encoding::CBOR : JsonWriter::Encoding::Text;
     }
 }
 
@@ -120,7 +146,10 @@ WebApplication::WebApplication(IApplication *app, QObject *parent)
     : QObject(parent)
     , ApplicationComponent(app)
     , m_cacheID {QString::number(Utils::Random::rand(), 36)}
+    , m_staticFileCache {[this](QString &data) { translateDocument(data); }}
     , m_authController {new AuthController(this, app, this)}
+    , m_syncState {new SyncState(this)}
+    , m_syncPublisher {new SyncPublisher(m_syncState, this)}
 {
     declarePublicAPI(u"auth/login"_qs);
 
@@ -134,30 +163,30 @@ WebApplication::~WebApplication()
     qDeleteAll(m_sessions);
 }
 
-void WebApplication::sendWebUIFile()
+void WebApplication::sendWebUIFile(Http::ResponseBuilder &responseBuilder, const Http::Request &request, const bool hasSession)
 {
-    const QStringList pathItems {request().path.split(u'/', Qt::SkipEmptyParts)};
+    const QStringList pathItems {request.path.split(u'/', Qt::SkipEmptyParts)};
     if (pathItems.contains(u".") || pathItems.contains(u".."))
         throw InternalServerErrorHTTPError();
 
     if (!m_isAltUIUsed)
     {
-        if (request().path.startsWith(PATH_PREFIX_ICONS))
+        if (request.path.startsWith(PATH_PREFIX_ICONS))
         {
-            const Path imageFilename {request().path.mid(PATH_PREFIX_ICONS.size())};
-            sendFile(Path(u":/icons"_qs) / imageFilename);
+            const Path imageFilename {request.path.mid(PATH_PREFIX_ICONS.size())};
+            m_staticFileCache.sendFile(responseBuilder, request, (Path(u":/icons"_qs) / imageFilename));
             return;
         }
     }
 
-    const QString path = (request().path != u"/")
-        ? request().path
+    const QString path = (request.path != u"/")
+        ? request.path
         : u"/index.html"_qs;
 
     Path localPath = m_rootFolder
-                / Path(session() ? PRIVATE_FOLDER : PUBLIC_FOLDER)
+                / Path(hasSession ? PRIVATE_FOLDER : PUBLIC_FOLDER)
                 / Path(path);
-    if (!localPath.exists() && session())
+    if (!localPath.exists() && hasSession)
     {
         // try to send public file if there is no private one
         localPath = m_rootFolder / Path(PUBLIC_FOLDER) / Path(path);
@@ -167,8 +196,8 @@ void WebApplication::sendWebUIFile()
     {
         if (!Utils::Fs::isRegularFile(localPath))
         {
-            status(500, u"Internal Server Error"_qs);
-            print(tr("Unacceptable file type, only regular file is allowed."), Http::CONTENT_TYPE_TXT);
+            responseBuilder.status(500, u"Internal Server Error"_qs);
+            responseBuilder.print(tr("Unacceptable file type, only regular file is allowed."), Http::CONTENT_TYPE_TXT);
             return;
         }
 
@@ -182,7 +211,7 @@ void WebApplication::sendWebUIFile()
         }
     }
 
-    sendFile(localPath);
+    m_staticFileCache.sendFile(responseBuilder, request, localPath);
 }
 
 void WebApplication::translateDocument(QString &data) const
@@ -241,10 +270,16 @@ const Http::Environment &WebApplication::env() const
 
 void WebApplication::doProcessRequest()
 {
+    if (request().path == BATCH_API_PATH)
+    {
+        processBatchRequest();
+        return;
+    }
+
     const QRegularExpressionMatch match = m_apiPathPattern.match(request().path);
     if (!match.hasMatch())
     {
-        sendWebUIFile();
+        sendWebUIFile(*this, request(), (session() != nullptr));
         return;
     }
 
@@ -254,6 +289,40 @@ void WebApplication::doProcessRequest()
     if (!session() && !isPublicAPI(scope, action))
         throw ForbiddenHTTPError();
 
+    // Server-sent events aren't handled by controllers since the response doesn't end
+    if (session() && (scope == u"sync") && (action == u"events"))
+    {
+        openSyncEventStream();
+        return;
+    }
+
+    DataMap data;
+    for (const Http::UploadedFile &torrent : request().files)
+        data[torrent.filename] = torrent.data;
+
+    // the same result can be encoded differently depending on what client accepts
+    const JsonWriter::Encoding resultEncoding = preferredResultEncoding(m_request.headers.value(Http::HEADER_ACCEPT));
+    setHeader({Http::HEADER_VARY, Http::HEADER_ACCEPT});
+
+    const APIResult result = runAPIAction(scope, action, m_params, data, resultEncoding);
+    switch (result.data.userType())
+    {
+    case QMetaType::QJsonDocument:
+        print(result.data.toJsonDocument().toJson(QJsonDocument::Compact), Http::CONTENT_TYPE_JSON);
+        break;
+    case QMetaType::QByteArray:
+        print(result.data.toByteArray(), (!result.mimeType.isEmpty() ? result.mimeType : Http::CONTENT_TYPE_TXT));
+        break;
+    case QMetaType::QString:
+    default:
+        print(result.data.toString(), Http::CONTENT_TYPE_TXT);
+        break;
+    }
+}
+
+APIResult WebApplication::runAPIAction(const QString &scope, const QString &action, const StringMap &params
+        , const DataMap &data, const JsonWriter::Encoding resultEncoding)
+{
     APIController *controller = nullptr;
     if (session())
         controller = session()->getAPIController(scope);
@@ -265,26 +334,15 @@ void WebApplication::doProcessRequest()
             throw NotFoundHTTPError();
     }
 
-    DataMap data;
-    for (const Http::UploadedFile &torrent : request().files)
-        data[torrent.filename] = torrent.data;
+    // the action can change the data shared by sync controllers
+    if (scope != u"sync")
+        m_syncState->invalidate();
+
+    controller->setResultEncoding(resultEncoding);
 
     try
     {
-        const QVariant result = controller->run(action, m_params, data);
-        switch (result.userType())
-        {
-        case QMetaType::QJsonDocument:
-            print(result.toJsonDocument().toJson(QJsonDocument::Compact), Http::CONTENT_TYPE_JSON);
-            break;
-        case QMetaType::QByteArray:
-            print(result.toByteArray(), Http::CONTENT_TYPE_TXT);
-            break;
-        case QMetaType::QString:
-        default:
-            print(result.toString(), Http::CONTENT_TYPE_TXT);
-            break;
-        }
+        return controller->run(action, params, data);
     }
     catch (const APIError &error)
     {
@@ -305,19 +363,72 @@ void WebApplication::doProcessRequest()
             Q_ASSERT(false);
         }
     }
+
+    return {};
+}
+
+// Runs the API requests one by one in the given order and responds with their results,
+// so a client avoids the round trip and session lookup of each request.
+// POST param:
+//   - requests (string): JSON array of sub-requests, e.g.
+//     [{"path": "/api/v2/torrents/setCategory", "params": {"hashes": "...", "category": "Linux"}}, ...]
+//     the values of "params" are strings, numbers or booleans
+// Each item of the response array holds "status" (HTTP status code) and either "result"
+// or "error" (message). Non-JSON binary results are base64 encoded and their "content_type" is given.
+// The sub-requests can't upload files, log in/out or open event streams.
+void WebApplication::processBatchRequest()
+{
+    if (!session())
+        throw ForbiddenHTTPError();
+    if (m_request.method != Http::METHOD_POST)
+        throw MethodNotAllowedHTTPError();
+
+    const JsonWriter::Encoding resultEncoding = preferredResultEncoding(m_request.headers.value(Http::HEADER_ACCEPT));
+    setHeader({Http::HEADER_VARY, Http::HEADER_ACCEPT});
+
+    JsonWriter writer {resultEncoding};
+    runBatchRequest(m_params.value(u"requests"_qs), m_apiPathPattern
+        , [this](const QString &scope, const QString &action, const StringMap &params)
+    {
+        // results are embedded into the batch response so they are always produced as JSON text
+        return runAPIAction(scope, action, params, {}, JsonWriter::Encoding::Text);
+    }, writer);
+
+    print(writer.data(), ((resultEncoding == JsonWriter::Encoding::CBOR) ? Http::CONTENT_TYPE_CBOR : Http::CONTENT_TYPE_JSON));
+}
+
+// Streams the changes of sync/maindata (event "maindata") and optionally
+// of sync/torrentPeers (event "torrentPeers") as they happen.
+// The events of maindata have IDs so that the client gets only the changes
+// it has missed once it is reconnected.
+// GET param:
+//   - hash (string): torrent hash (ID) whose peers are streamed (optional)
+//   - rid (string): ID of the last received event (optional), "Last-Event-ID" header is used if present
+void WebApplication::openSyncEventStream()
+{
+    if (m_request.method != Http::METHOD_GET)
+        throw MethodNotAllowedHTTPError();
+
+    const QString lastEventID = m_request.headers.value(Http::HEADER_LAST_EVENT_ID, m_params.value(u"rid"_qs));
+
+    auto *eventStream = new Http::EventStream;
+    m_syncPublisher->subscribe(eventStream, session(), m_params.value(u"hash"_qs), SyncEventID::fromString(lastEventID));
+    stream(eventStream);
 }
 
 void WebApplication::configure()
 {
     const auto *pref = Preferences::instance();
 
+    const QWriteLocker locker {&m_configLock};
+
     const bool isAltUIUsed = pref->isAltWebUiEnabled();
     const Path rootFolder = (!isAltUIUsed ? Path(WWW_FOLDER) : pref->getWebUiRootFolder());
     if ((isAltUIUsed != m_isAltUIUsed) || (rootFolder != m_rootFolder))
     {
         m_isAltUIUsed = isAltUIUsed;
         m_rootFolder = rootFolder;
-        m_translatedFiles.clear();
+        m_staticFileCache.clear();
         if (!m_isAltUIUsed)
             LogMsg(tr("Using built-in Web UI."));
         else
@@ -328,7 +439,7 @@ void WebApplication::configure()
     if (m_currentLocale != newLocale)
     {
         m_currentLocale = newLocale;
-        m_translatedFiles.clear();
+        m_staticFileCache.clear();
 
         m_translationFileLoaded = m_translator.load((m_rootFolder / Path(u"translations/webui_"_qs) + newLocale).data());
         if (m_translationFileLoaded)
@@ -346,6 +457,7 @@ void WebApplication::configure()
     m_isAuthSubnetWhitelistEnabled = pref->isWebUiAuthSubnetWhitelistEnabled();
     m_authSubnetWhitelist = pref->getWebUiAuthSubnetWhitelist();
     m_sessionTimeout = pref->getWebUISessionTimeout();
+    m_syncPublisher->setSessionTimeout(m_sessionTimeout);
 
     m_domainList = pref->getServerDomains().split(u';', Qt::SkipEmptyParts);
     std::for_each(m_domainList.begin(), m_domainList.end(), [](QString &entry) { entry = entry.trimmed(); });
@@ -420,53 +532,6 @@ void WebApplication::declarePublicAPI(const QString &apiPath)
     m_publicAPIs << apiPath;
 }
 
-void WebApplication::sendFile(const Path &path)
-{
-    const QDateTime lastModified = Utils::Fs::lastModified(path);
-
-    // find translated file in cache
-    const auto it = m_translatedFiles.constFind(path);
-    if ((it != m_translatedFiles.constEnd()) && (lastModified <= it->lastModified))
-    {
-        print(it->data, it->mimeType);
-        setHeader({Http::HEADER_CACHE_CONTROL, getCachingInterval(it->mimeType)});
-        return;
-    }
-
-    QFile file {path.data()};
-    if (!file.open(QIODevice::ReadOnly))
-    {
-        qDebug("File %s was not found!", qUtf8Printable(path.toString()));
-        throw NotFoundHTTPError();
-    }
-
-    if (file.size() > MAX_ALLOWED_FILESIZE)
-    {
-        qWarning("%s: exceeded the maximum allowed file size!", qUtf8Printable(path.toString()));
-        throw InternalServerErrorHTTPError(tr("Exceeded the maximum allowed file size (%1)!")
-                                           .arg(Utils::Misc::friendlyUnit(MAX_ALLOWED_FILESIZE)));
-    }
-
-    QByteArray data {file.readAll()};
-    file.close();
-
-    const QMimeType mimeType = QMimeDatabase().mimeTypeForFileNameAndData(path.data(), data);
-    const bool isTranslatable = mimeType.inherits(u"text/plain"_qs);
-
-    // Translate the file
-    if (isTranslatable)
-    {
-        auto dataStr = QString::fromUtf8(data);
-        translateDocument(dataStr);
-        data = dataStr.toUtf8();
-
-        m_translatedFiles[path] = {data, mimeType.name(), lastModified}; // caching translated file
-    }
-
-    print(data, mimeType.name());
-    setHeader({Http::HEADER_CACHE_CONTROL, getCachingInterval(mimeType.name())});
-}
-
 Http::Response WebApplication::processRequest(const Http::Request &request, const Http::Environment &env)
 {
     m_currentSession = nullptr;
@@ -489,12 +554,8 @@ Http::Response WebApplication::processRequest(const Http::Request &request, cons
 
     try
     {
-        // block suspicious requests
-        if ((m_isCSRFProtectionEnabled && isCrossSiteRequest(m_request))
-            || (m_isHostHeaderValidationEnabled && !validateHostHeader(m_domainList)))
-            {
+        if (isSuspiciousRequest(m_request, m_env))
             throw UnauthorizedHTTPError();
-        }
 
         // reverse proxy resolve client address
         m_clientAddress = resolveClientAddress();
@@ -511,9 +572,45 @@ Http::Response WebApplication::processRequest(const Http::Request &request, cons
     for (const Http::Header &prebuiltHeader : asConst(m_prebuiltHeaders))
         setHeader(prebuiltHeader);
 
+    // the uploaded files can be large, don't keep them until the next request
+    m_request.files.clear();
+    m_request.bodyFile.reset();
+
     return response();
 }
 
+// Only the static files requested within a session are served in the I/O threads.
+// The rest of requests (including the ones starting sessions) need the state owned by the main thread.
+std::optional<Http::Response> WebApplication::processRequestConcurrently(const Http::Request &request, const Http::Environment &env)
+{
+    if ((request.method != Http::METHOD_GET) || request.path.startsWith(u"/api/"))
+        return std::nullopt;
+
+    const QReadLocker configLocker {&m_configLock};
+
+    Http::ResponseBuilder responseBuilder;
+    try
+    {
+        if (isSuspiciousRequest(request, env))
+            throw UnauthorizedHTTPError();
+
+        if (!refreshSession(request))
+            return std::nullopt;
+
+        sendWebUIFile(responseBuilder, request, true);
+    }
+    catch (const HTTPError &error)
+    {
+        responseBuilder.status(error.statusCode(), error.statusText());
+        responseBuilder.print((!error.message().isEmpty() ? error.message() : error.statusText()), Http::CONTENT_TYPE_TXT);
+    }
+
+    for (const Http::Header &prebuiltHeader : asConst(m_prebuiltHeaders))
+        responseBuilder.setHeader(prebuiltHeader);
+
+    return responseBuilder.response();
+}
+
 QString WebApplication::clientId() const
 {
     return m_clientAddress.toString();
@@ -535,6 +632,7 @@ void WebApplication::sessionInitialize()
             if (m_currentSession->hasExpired(m_sessionTimeout))
             {
                 // session is outdated - removing it
+                const QWriteLocker locker {&m_sessionsLock};
                 delete m_sessions.take(sessionId);
                 m_currentSession = nullptr;
             }
@@ -583,10 +681,28 @@ bool WebApplication::isPublicAPI(const QString &scope, const QString &action) co
     return m_publicAPIs.contains(u"%1/%2"_qs.arg(scope, action));
 }
 
+bool WebApplication::refreshSession(const Http::Request &request)
+{
+    const QString sessionId {parseCookie(request.headers.value(u"cookie"_qs)).value(QString::fromLatin1(C_SID))};
+    if (sessionId.isEmpty())
+        return false;
+
+    // the outdated sessions are removed by the main thread
+    const QReadLocker locker {&m_sessionsLock};
+    WebSession *session = m_sessions.value(sessionId);
+    if (!session || session->hasExpired(m_sessionTimeout))
+        return false;
+
+    session->updateTimestamp();
+    return true;
+}
+
 void WebApplication::sessionStart()
 {
     Q_ASSERT(!m_currentSession);
 
+    const QWriteLocker locker {&m_sessionsLock};
+
     // remove outdated sessions
     Algorithm::removeIf(m_sessions, [this](const QString &, const WebSession *session)
     {
@@ -600,11 +716,11 @@ void WebApplication::sessionStart()
     });
 
     m_currentSession = new WebSession(generateSid(), app());
-    m_currentSession->registerAPIController<AppController>(u"app"_qs);
+    m_currentSession->registerAPIController<AppController>(u"app"_qs, &m_staticFileCache.statistics());
     m_currentSession->registerAPIController<LogController>(u"log"_qs);
     m_currentSession->registerAPIController<RSSController>(u"rss"_qs);
     m_currentSession->registerAPIController<SearchController>(u"search"_qs);
-    m_currentSession->registerAPIController<SyncController>(u"sync"_qs);
+    m_currentSession->registerAPIController<SyncController>(u"sync"_qs, m_syncState);
     m_currentSession->registerAPIController<TorrentsController>(u"torrents"_qs);
     m_currentSession->registerAPIController<TransferController>(u"transfer"_qs);
     m_sessions[m_currentSession->id()] = m_currentSession;
@@ -627,13 +743,22 @@ void WebApplication::sessionEnd()
     cookie.setPath(u"/"_qs);
     cookie.setExpirationDate(QDateTime::currentDateTime().addDays(-1));
 
-    delete m_sessions.take(m_currentSession->id());
+    {
+        const QWriteLocker locker {&m_sessionsLock};
+        delete m_sessions.take(m_currentSession->id());
+    }
     m_currentSession = nullptr;
 
     setHeader({Http::HEADER_SET_COOKIE, QString::fromLatin1(cookie.toRawForm())});
 }
 
-bool WebApplication::isCrossSiteRequest(const Http::Request &request) const
+bool WebApplication::isSuspiciousRequest(const Http::Request &request, const Http::Environment &env) const
+{
+    return (m_isCSRFProtectionEnabled && isCrossSiteRequest(request, env))
+        || (m_isHostHeaderValidationEnabled && !validateHostHeader(request, env));
+}
+
+bool WebApplication::isCrossSiteRequest(const Http::Request &request, const Http::Environment &env) const
 {
     // https://www.owasp.org/index.php/Cross-Site_Request_Forgery_(CSRF)_Prevention_Cheat_Sheet#Verifying_Same_Origin_with_Standard_Headers
 
@@ -662,7 +787,7 @@ bool WebApplication::isCrossSiteRequest(const Http::Request &request) const
         const bool isInvalid = !isSameOrigin(urlFromHostHeader(targetOrigin), originValue);
         if (isInvalid)
             LogMsg(tr("WebUI: Origin header & Target origin mismatch! Source IP: '%1'. Origin header: '%2'. Target origin: '%3'")
-                   .arg(m_env.clientAddress.toString(), originValue, targetOrigin)
+                   .arg(env.clientAddress.toString(), originValue, targetOrigin)
                    , Log::WARNING);
         return isInvalid;
     }
@@ -672,7 +797,7 @@ bool WebApplication::isCrossSiteRequest(const Http::Request &request) const
         const bool isInvalid = !isSameOrigin(urlFromHostHeader(targetOrigin), refererValue);
         if (isInvalid)
             LogMsg(tr("WebUI: Referer header & Target origin mismatch! Source IP: '%1'. Referer header: '%2'. Target origin: '%3'")
-                   .arg(m_env.clientAddress.toString(), refererValue, targetOrigin)
+                   .arg(env.clientAddress.toString(), refererValue, targetOrigin)
                    , Log::WARNING);
         return isInvalid;
     }
@@ -680,30 +805,30 @@ bool WebApplication::isCrossSiteRequest(const Http::Request &request) const
     return true;
 }
 
-bool WebApplication::validateHostHeader(const QStringList &domains) const
+bool WebApplication::validateHostHeader(const Http::Request &request, const Http::Environment &env) const
 {
-    const QUrl hostHeader = urlFromHostHeader(m_request.headers[Http::HEADER_HOST]);
+    const QUrl hostHeader = urlFromHostHeader(request.headers[Http::HEADER_HOST]);
     const QString requestHost = hostHeader.host();
 
     // (if present) try matching host header's port with local port
     const int requestPort = hostHeader.port();
-    if ((requestPort != -1) && (m_env.localPort != requestPort))
+    if ((requestPort != -1) && (env.localPort != requestPort))
     {
         LogMsg(tr("WebUI: Invalid Host header, port mismatch. Request source IP: '%1'. Server port: '%2'. Received Host header: '%3'")
-               .arg(m_env.clientAddress.toString()).arg(m_env.localPort)
-               .arg(m_request.headers[Http::HEADER_HOST])
+               .arg(env.clientAddress.toString()).arg(env.localPort)
+               .arg(request.headers[Http::HEADER_HOST])
                 , Log::WARNING);
         return false;
     }
 
     // try matching host header with local address
-    const bool sameAddr = m_env.localAddress.isEqual(QHostAddress(requestHost));
+    const bool sameAddr = env.localAddress.isEqual(QHostAddress(requestHost));
 
     if (sameAddr)
         return true;
 
     // try matching host header with domain list
-    for (const auto &domain : domains)
+    for (const auto &domain : asConst(m_domainList))
     {
         const QRegularExpression domainRegex {Utils::String::wildcardToRegexPattern(domain), QRegularExpression::CaseInsensitiveOption};
         if (requestHost.contains(domainRegex))
@@ -711,7 +836,7 @@ bool WebApplication::validateHostHeader(const QStringList &domains) const
     }
 
     LogMsg(tr("WebUI: Invalid Host header. Request source IP: '%1'. Received Host header: '%2'")
-           .arg(m_env.clientAddress.toString(), m_request.headers[Http::HEADER_HOST])
+           .arg(env.clientAddress.toString(), request.headers[Http::HEADER_HOST])
             , Log::WARNING);
     return false;
 }
@@ -768,12 +893,12 @@ bool WebSession::hasExpired(const qint64 seconds) const
 {
     if (seconds <= 0)
         return false;
-    return m_timer.hasExpired(seconds * 1000);
+    return ((currentTimestamp() - m_timestamp.loadRelaxed()) > (seconds * 1000));
 }
 
 void WebSession::updateTimestamp()
 {
-    m_timer.start();
+    m_timestamp.storeRelaxed(currentTimestamp());
 }
 
 APIController *WebSession::getAPIController(const QString &scope) const
@@ -28,13 +28,15 @@
 
 #pragma once
 
+#include <optional>
 #include <type_traits>
+#include <utility>
 
-#include <QDateTime>
-#include <QElapsedTimer>
+#include <QAtomicInteger>
 #include <QHash>
 #include <QMap>
 #include <QObject>
+#include <QReadWriteLock>
 #include <QRegularExpression>
 #include <QSet>
 #include <QTranslator>
@@ -47,12 +49,15 @@
 #include "base/path.h"
 #include "base/utils/net.h"
 #include "base/utils/version.h"
+#include "api/apicontroller.h"
 #include "api/isessionmanager.h"
+#include "staticfilecache.h"
 
-inline const Utils::Version<int, 3, 2> API_VERSION {2, 8, 14};
+inline const Utils::Version<int, 3, 2> API_VERSION {2, 8, 28};
 
-class APIController;
 class AuthController;
+class SyncPublisher;
+class SyncState;
 class WebApplication;
 
 class WebSession final : public QObject, public ApplicationComponent, public ISession
@@ -65,18 +70,19 @@ public:
     bool hasExpired(qint64 seconds) const;
     void updateTimestamp();
 
-    template <typename T>
-    void registerAPIController(const QString &scope)
+    template <typename T, typename ...Args>
+    void registerAPIController(const QString &scope, Args &&...args)
     {
         static_assert(std::is_base_of_v<APIController, T>, "Class should be derived from APIController.");
-        m_apiControllers[scope] = new T(app(), this);
+        m_apiControllers[scope] = new T(app(), std::forward<Args>(args)..., this);
     }
 
     APIController *getAPIController(const QString &scope) const;
 
 private:
     const QString m_sid;
-    QElapsedTimer m_timer;  // timestamp
+    // in milliseconds of the monotonic clock, it is updated by the requests served in the I/O threads as well
+    QAtomicInteger<qint64> m_timestamp = 0;
     QMap<QString, APIController *> m_apiControllers;
 };
 
@@ -93,6 +99,7 @@ public:
     ~WebApplication() override;
 
     Http::Response processRequest(const Http::Request &request, const Http::Environment &env) override;
+    std::optional<Http::Response> processRequestConcurrently(const Http::Request &request, const Http::Environment &env) override;
 
     QString clientId() const override;
     WebSession *session() override;
@@ -104,12 +111,16 @@ public:
 
 private:
     void doProcessRequest();
+    APIResult runAPIAction(const QString &scope, const QString &action, const StringMap &params
+            , const DataMap &data, JsonWriter::Encoding resultEncoding);
+    void processBatchRequest();
+    void openSyncEventStream();
     void configure();
 
     void declarePublicAPI(const QString &apiPath);
 
-    void sendFile(const Path &path);
-    void sendWebUIFile();
+    // Static files can be served in any thread, they use the passed response builder
+    void sendWebUIFile(Http::ResponseBuilder &responseBuilder, const Http::Request &request, bool hasSession);
 
     void translateDocument(QString &data) const;
 
@@ -118,13 +129,18 @@ private:
     void sessionInitialize();
     bool isAuthNeeded();
     bool isPublicAPI(const QString &scope, const QString &action) const;
+    // Refreshes the valid session of the request, it is used by the I/O threads
+    bool refreshSession(const Http::Request &request);
 
-    bool isCrossSiteRequest(const Http::Request &request) const;
-    bool validateHostHeader(const QStringList &domains) const;
+    bool isSuspiciousRequest(const Http::Request &request, const Http::Environment &env) const;
+    bool isCrossSiteRequest(const Http::Request &request, const Http::Environment &env) const;
+    bool validateHostHeader(const Http::Request &request, const Http::Environment &env) const;
 
     QHostAddress resolveClientAddress() const;
 
     // Persistent data
+    // The sessions are changed only by the main thread which locks them for writing then
+    mutable QReadWriteLock m_sessionsLock;
     QHash<QString, WebSession *> m_sessions;
 
     // Current data
@@ -137,21 +153,20 @@ private:
     const QRegularExpression m_apiPathPattern {u"^/api/v2/(?<scope>[A-Za-z_][A-Za-z_0-9]*)/(?<action>[A-Za-z_][A-Za-z_0-9]*)$"_qs};
 
     QSet<QString> m_publicAPIs;
+
+    // The settings below are changed only by the main thread which locks them for writing then
+    mutable QReadWriteLock m_configLock;
     bool m_isAltUIUsed = false;
     Path m_rootFolder;
 
-    struct TranslatedFile
-    {
-        QByteArray data;
-        QString mimeType;
-        QDateTime lastModified;
-    };
-    QHash<Path, TranslatedFile> m_translatedFiles;
+    StaticFileCache m_staticFileCache;
     QString m_currentLocale;
     QTranslator m_translator;
     bool m_translationFileLoaded = false;
 
     AuthController *m_authController = nullptr;
+    SyncState *m_syncState = nullptr;
+    SyncPublisher *m_syncPublisher = nullptr;
     bool m_isLocalAuthEnabled;
     bool m_isAuthSubnetWhitelistEnabled;
     QVector<Utils::Net::Subnet> m_authSubnetWhitelist;
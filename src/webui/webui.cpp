@@ -46,6 +46,12 @@ WebUI::WebUI(IApplication *app)
     connect(Preferences::instance(), &Preferences::changed, this, &WebUI::configure);
 }
 
+WebUI::~WebUI()
+{
+    // the server may still pass the requests to the web application from its I/O threads
+    delete m_httpServer;
+}
+
 void WebUI::configure()
 {
     m_isErrored = false; // clear previous error state
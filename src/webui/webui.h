@@ -52,6 +52,7 @@ class WebUI : public QObject, public ApplicationComponent
 
 public:
     explicit WebUI(IApplication *app);
+    ~WebUI() override;
 
     bool isErrored() const;
 
@@ -3,15 +3,22 @@ HEADERS += \
     $$PWD/api/apierror.h \
     $$PWD/api/appcontroller.h \
     $$PWD/api/authcontroller.h \
+    $$PWD/api/batchrequest.h \
     $$PWD/api/freediskspacechecker.h \
     $$PWD/api/isessionmanager.h \
+    $$PWD/api/jsonwriter.h \
     $$PWD/api/logcontroller.h \
     $$PWD/api/rsscontroller.h \
     $$PWD/api/searchcontroller.h \
     $$PWD/api/synccontroller.h \
+    $$PWD/api/syncpublisher.h \
+    $$PWD/api/syncstate.h \
+    $$PWD/api/syncstore.h \
+    $$PWD/api/torrentpaging.h \
     $$PWD/api/torrentscontroller.h \
     $$PWD/api/transfercontroller.h \
     $$PWD/api/serialize/serialize_torrent.h \
+    $$PWD/staticfilecache.h \
     $$PWD/webapplication.h \
     $$PWD/webui.h
 
@@ -20,14 +27,21 @@ SOURCES += \
     $$PWD/api/apierror.cpp \
     $$PWD/api/appcontroller.cpp \
     $$PWD/api/authcontroller.cpp \
+    $$PWD/api/batchrequest.cpp \
     $$PWD/api/freediskspacechecker.cpp \
+    $$PWD/api/jsonwriter.cpp \
     $$PWD/api/logcontroller.cpp \
     $$PWD/api/rsscontroller.cpp \
     $$PWD/api/searchcontroller.cpp \
     $$PWD/api/synccontroller.cpp \
+    $$PWD/api/syncpublisher.cpp \
+    $$PWD/api/syncstate.cpp \
+    $$PWD/api/syncstore.cpp \
+    $$PWD/api/torrentpaging.cpp \
     $$PWD/api/torrentscontroller.cpp \
     $$PWD/api/transfercontroller.cpp \
     $$PWD/api/serialize/serialize_torrent.cpp \
+    $$PWD/staticfilecache.cpp \
     $$PWD/webapplication.cpp \
     $$PWD/webui.cpp
 
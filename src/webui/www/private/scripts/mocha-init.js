@@ -59,6 +59,7 @@ let pauseFN = function() {};
 let startFN = function() {};
 let autoTorrentManagementFN = function() {};
 let recheckFN = function() {};
+let quickRecheckFN = function() {};
 let reannounceFN = function() {};
 let setLocationFN = function() {};
 let renameFN = function() {};
@@ -464,6 +465,21 @@ const initializeWindows = function() {
         }
     };
 
+    quickRecheckFN = function() {
+        const hashes = torrentsTable.selectedRowsIds();
+        if (hashes.length) {
+            new Request({
+                url: 'api/v2/torrents/recheck',
+                method: 'post',
+                data: {
+                    hashes: hashes.join("|"),
+                    mode: 'quick'
+                }
+            }).send();
+            updateMainData();
+        }
+    };
+
     reannounceFN = function() {
         const hashes = torrentsTable.selectedRowsIds();
         if (hashes.length) {
@@ -512,10 +512,9 @@ window.qBittorrent.PropFiles = (function() {
         }
     };
 
-    const filesPriorityMenuClicked = function(priority) {
+    // returns the selected rows and files including the children of the selected folders
+    const getSelectedRows = function() {
         const selectedRows = torrentFilesTable.selectedRowsIds();
-        if (selectedRows.length === 0)
-            return;
 
         const rowIds = [];
         const fileIds = [];
@@ -537,7 +536,36 @@ window.qBittorrent.PropFiles = (function() {
             });
         }
 
-        setFilePriority(Object.keys(uniqueRowIds), Object.keys(uniqueFileIds), priority);
+        return {
+            rowIds: Object.keys(uniqueRowIds),
+            fileIds: Object.keys(uniqueFileIds)
+        };
+    };
+
+    const filesPriorityMenuClicked = function(priority) {
+        const rows = getSelectedRows();
+        if (rows.rowIds.length === 0)
+            return;
+
+        setFilePriority(rows.rowIds, rows.fileIds, priority);
+    };
+
+    const filesRecheckMenuClicked = function() {
+        if (current_hash === "")
+            return;
+
+        const rows = getSelectedRows();
+        if (rows.fileIds.length === 0)
+            return;
+
+        new Request({
+            url: 'api/v2/torrents/recheckFiles',
+            method: 'post',
+            data: {
+                'hash': current_hash,
+                'id': rows.fileIds.join('|')
+            }
+        }).send();
     };
 
     const torrentFilesContextMenu = new window.qBittorrent.ContextMenu.ContextMenu({
@@ -574,6 +602,10 @@ window.qBittorrent.PropFiles = (function() {
                 });
             },
 
+            Recheck: function(element, ref) {
+                filesRecheckMenuClicked();
+            },
+
             FilePrioIgnore: function(element, ref) {
                 filesPriorityMenuClicked(FilePriority.Ignored);
             },
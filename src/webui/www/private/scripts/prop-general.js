@@ -217,7 +217,7 @@ window.qBittorrent.PropGeneral = (function() {
             }
         }).send();
 
-        const piecesUrl = new URI('api/v2/torrents/pieceStates?hash=' + current_id);
+        const piecesUrl = new URI('api/v2/torrents/pieceStates?format=packed&hash=' + current_id);
         new Request.JSON({
             url: piecesUrl,
             noCache: true,
@@ -231,8 +231,12 @@ window.qBittorrent.PropGeneral = (function() {
                 $('error_div').set('html', '');
 
                 if (data) {
+                    // 4 pieces per byte, 2 bits each starting from the lowest bits
+                    const states = window.atob(data.states);
+                    const piecesCount = data.pieces_num;
+
                     const canvas = $('progress').getFirst('canvas');
-                    canvas.width = data.length;
+                    canvas.width = piecesCount;
                     const ctx = canvas.getContext('2d');
                     ctx.clearRect(0, 0, canvas.width, canvas.height);
 
@@ -240,8 +244,8 @@ window.qBittorrent.PropGeneral = (function() {
                     let color = '';
                     let rectWidth = 1;
 
-                    for (let i = 0; i < data.length; ++i) {
-                        const status = data[i];
+                    for (let i = 0; i < piecesCount; ++i) {
+                        const status = (states.charCodeAt(i >> 2) >> ((i & 3) * 2)) & 3;
                         let newColor = '';
 
                         if (status === 1)
@@ -266,7 +270,7 @@ window.qBittorrent.PropGeneral = (function() {
                     // Fill a rect at the end of the canvas if one is needed
                     if (color !== '') {
                         ctx.fillStyle = color;
-                        ctx.fillRect((data.length - rectWidth), 0, rectWidth, canvas.height);
+                        ctx.fillRect((piecesCount - rectWidth), 0, rectWidth, canvas.height);
                     }
                 }
                 else {
@@ -0,0 +1,121 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/addtorrentpipeline.h"
+#include "base/bittorrent/torrentcontentlayout.h"
+#include "base/global.h"
+#include "base/path.h"
+#include "torrentfactory.h"
+
+namespace
+{
+    const int PIECE_SIZE = 16 * 1024;
+    const int TORRENTS_COUNT = 1000;
+
+    QRegularExpression excludedFileName(const QString &wildcard)
+    {
+        const QString pattern = QRegularExpression::anchoredPattern(QRegularExpression::wildcardToRegularExpression(wildcard));
+        return QRegularExpression {pattern, QRegularExpression::CaseInsensitiveOption};
+    }
+
+    int prepareAll(BitTorrent::AddTorrentPipeline &pipeline, const int expectedCount)
+    {
+        int preparedCount = 0;
+        const QMetaObject::Connection connection = QObject::connect(&pipeline, &BitTorrent::AddTorrentPipeline::torrentsPrepared
+                , [&preparedCount](const QVector<BitTorrent::PreparedTorrent> &torrents) { preparedCount += torrents.size(); });
+
+        QElapsedTimer timer;
+        timer.start();
+        while ((preparedCount < expectedCount) && (timer.elapsed() < 60000))
+            QTest::qWait(1);
+
+        QObject::disconnect(connection);
+        return preparedCount;
+    }
+}
+
+// Preparing of the torrents which are added at once, e.g. from a watched folder.
+// It isn't a part of the test suite, see Readme.md.
+class BenchmarkAddTorrentPipeline final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchmarkAddTorrentPipeline)
+
+public:
+    BenchmarkAddTorrentPipeline() = default;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_tmpDir.isValid());
+
+        TorrentFactory::FileList files;
+        for (int i = 0; i < 50; ++i)
+            files.append({u"dir%1/file%2.dat"_qs.arg(i % 5).arg(i), PIECE_SIZE});
+
+        for (int i = 0; i < TORRENTS_COUNT; ++i)
+        {
+            TorrentFactory::FileList torrentFiles = files;
+            for (auto &file : torrentFiles)
+                file.first.prepend(u"torrent%1/"_qs.arg(i));
+
+            const Path torrentPath = Path(m_tmpDir.path()) / Path(u"%1.torrent"_qs.arg(i));
+            TorrentFactory::writeFile(torrentPath, TorrentFactory::createTorrentData(torrentFiles, PIECE_SIZE));
+            m_torrentPaths.append(torrentPath);
+        }
+    }
+
+    void benchmarkAddTorrents() const
+    {
+        const QVector<QRegularExpression> excludedFileNames {excludedFileName(u"*.nfo"_qs), excludedFileName(u"sample*"_qs)};
+
+        QBENCHMARK
+        {
+            BitTorrent::AddTorrentPipeline pipeline;
+            for (const Path &torrentPath : asConst(m_torrentPaths))
+            {
+                BitTorrent::AddTorrentParams params;
+                params.contentLayout = BitTorrent::TorrentContentLayout::NoSubfolder;
+                pipeline.add(torrentPath, params, excludedFileNames);
+            }
+            QCOMPARE(prepareAll(pipeline, TORRENTS_COUNT), TORRENTS_COUNT);
+        }
+    }
+
+private:
+    QTemporaryDir m_tmpDir;
+    PathList m_torrentPaths;
+};
+
+QTEST_GUILESS_MAIN(BenchmarkAddTorrentPipeline)
+#include "benchmarkaddtorrentpipeline.moc"
@@ -0,0 +1,99 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <random>
+#include <vector>
+
+#include <QByteArray>
+#include <QTest>
+
+#include "base/bittorrent/diskreadcache.h"
+#include "base/global.h"
+
+namespace
+{
+    const int BLOCK_SIZE = 16 * 1024;
+    const int BLOCKS_PER_PIECE = 16;
+}
+
+// Blocks of a seeded torrent requested by many peers with Zipf distributed popularity.
+// It isn't a part of the test suite, see Readme.md.
+class BenchmarkDiskReadCache final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchmarkDiskReadCache)
+
+public:
+    BenchmarkDiskReadCache() = default;
+
+private slots:
+    void benchmarkZipfRequests_data() const
+    {
+        QTest::addColumn<int>("cachedBlockCount");
+
+        QTest::newRow("256 of 4096 blocks cached") << 256;
+        QTest::newRow("1024 of 4096 blocks cached") << 1024;
+    }
+
+    void benchmarkZipfRequests() const
+    {
+        QFETCH(int, cachedBlockCount);
+
+        const int blockCount = 4096;
+        const int requestCount = 100000;
+
+        std::vector<double> weights(blockCount);
+        for (int i = 0; i < blockCount; ++i)
+            weights[i] = 1.0 / (i + 1);
+
+        std::mt19937 generator {42};
+        std::discrete_distribution<int> distribution {weights.cbegin(), weights.cend()};
+        std::vector<int> requests(requestCount);
+        for (int &request : requests)
+            request = distribution(generator);
+
+        const QByteArray block(BLOCK_SIZE, 'a');
+
+        QBENCHMARK
+        {
+            BitTorrent::DiskReadCache cache;
+            cache.setCapacity(static_cast<qint64>(cachedBlockCount) * BLOCK_SIZE);
+
+            for (const int request : requests)
+            {
+                const int piece = request / BLOCKS_PER_PIECE;
+                const int offset = (request % BLOCKS_PER_PIECE) * BLOCK_SIZE;
+                if (cache.read(0, piece, offset, BLOCK_SIZE).isNull())
+                    cache.insert(0, piece, offset, block.constData(), block.size());
+            }
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(BenchmarkDiskReadCache)
+#include "benchmarkdiskreadcache.moc"
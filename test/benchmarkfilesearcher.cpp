@@ -0,0 +1,105 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/filesearcher.h"
+#include "base/bittorrent/infohash.h"
+#include "base/global.h"
+#include "base/path.h"
+
+// Search of the files of a torrent having a deep directory tree,
+// the half of the files exists.
+// It isn't a part of the test suite, see Readme.md.
+class BenchmarkFileSearcher final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchmarkFileSearcher)
+
+public:
+    BenchmarkFileSearcher() = default;
+
+private slots:
+    void initTestCase()
+    {
+        qRegisterMetaType<BitTorrent::TorrentID>();
+        qRegisterMetaType<Path>();
+        qRegisterMetaType<PathList>();
+
+        QVERIFY(m_tmpDir.isValid());
+
+        // 10 levels with 2 subdirectories and 20 files in each directory
+        QVector<Path> dirs {Path(u"root"_qs)};
+        for (int level = 0; level < 10; ++level)
+        {
+            QVector<Path> nextDirs;
+            for (const Path &dir : asConst(dirs))
+            {
+                for (int i = 0; i < 20; ++i)
+                    m_fileNames.append(dir / Path(u"file%1.dat"_qs.arg(i)));
+                nextDirs.append(dir / Path(u"a"_qs));
+                nextDirs.append(dir / Path(u"b"_qs));
+            }
+            dirs = nextDirs;
+        }
+
+        for (int i = 0; i < m_fileNames.size(); i += 2)
+        {
+            const Path filePath = Path(m_tmpDir.path()) / m_fileNames[i];
+            QVERIFY(QDir().mkpath(filePath.parentPath().data()));
+            QFile file {filePath.data()};
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+    }
+
+    void benchmarkDeepTree() const
+    {
+        const auto id = BitTorrent::TorrentID::fromString(u"0000000000000000000000000000000000000001"_qs);
+
+        FileSearcher searcher;
+        QSignalSpy spy {&searcher, &FileSearcher::searchFinished};
+
+        QBENCHMARK
+        {
+            spy.clear();
+            searcher.search(id, m_fileNames, Path(m_tmpDir.path()), {});
+            QVERIFY(spy.wait());
+        }
+    }
+
+private:
+    QTemporaryDir m_tmpDir;
+    PathList m_fileNames;
+};
+
+QTEST_GUILESS_MAIN(BenchmarkFileSearcher)
+#include "benchmarkfilesearcher.moc"
@@ -0,0 +1,194 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+#include <optional>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QTcpSocket>
+#include <QTest>
+#include <QVector>
+
+#include "base/global.h"
+#include "base/http/irequesthandler.h"
+#include "base/http/server.h"
+#include "base/http/types.h"
+#include "base/latencyhistogram.h"
+
+namespace
+{
+    class EchoRequestHandler final : public Http::IRequestHandler
+    {
+    public:
+        explicit EchoRequestHandler(const bool isConcurrent)
+            : m_isConcurrent {isConcurrent}
+        {
+        }
+
+        Http::Response processRequest(const Http::Request &request, const Http::Environment &) override
+        {
+            Http::Response response;
+            response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_TXT;
+            response.content = request.path.toUtf8();
+            return response;
+        }
+
+        std::optional<Http::Response> processRequestConcurrently(const Http::Request &request, const Http::Environment &env) override
+        {
+            if (!m_isConcurrent)
+                return std::nullopt;
+
+            return processRequest(request, env);
+        }
+
+    private:
+        const bool m_isConcurrent;
+    };
+
+    QByteArray makeRequest(const QString &path)
+    {
+        return u"GET %1 HTTP/1.1\r\nHost: localhost\r\n\r\n"_qs.arg(path).toLatin1();
+    }
+
+    // Takes the content of the first complete response from the buffer
+    bool takeResponse(QByteArray &buffer, QByteArray &content)
+    {
+        const int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0)
+            return false;
+
+        const QByteArray lengthHeader = "content-length: ";
+        const int lengthPos = buffer.indexOf(lengthHeader);
+        if ((lengthPos < 0) || (lengthPos > headerEnd))
+            return false;
+
+        const int lengthEnd = buffer.indexOf("\r\n", lengthPos);
+        const int contentLength = buffer.mid((lengthPos + lengthHeader.size()), (lengthEnd - lengthPos - lengthHeader.size())).toInt();
+        const int frameSize = headerEnd + 4 + contentLength;
+        if (buffer.size() < frameSize)
+            return false;
+
+        content = buffer.mid((headerEnd + 4), contentLength);
+        buffer.remove(0, frameSize);
+        return true;
+    }
+}
+
+// Loopback load test of the HTTP server which reports requests/s and latency percentiles.
+// It isn't a part of the test suite, see Readme.md.
+class BenchmarkHttpServer final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchmarkHttpServer)
+
+public:
+    BenchmarkHttpServer() = default;
+
+private slots:
+    void benchmarkLoopback_data() const
+    {
+        QTest::addColumn<bool>("isConcurrent");
+
+        QTest::newRow("Processed in the thread of the server") << false;
+        QTest::newRow("Processed in the I/O threads") << true;
+    }
+
+    // Each client sends its requests one after another over a persistent connection
+    void benchmarkLoopback() const
+    {
+        QFETCH(bool, isConcurrent);
+
+        const int clientsCount = 16;
+        const int requestsPerClient = 500;
+
+        EchoRequestHandler handler {isConcurrent};
+        Http::Server server {&handler};
+        QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+
+        struct Client
+        {
+            QTcpSocket socket;
+            QByteArray buffer;
+            QElapsedTimer requestTimer;
+            int responsesCount = 0;
+        };
+
+        QVector<Client *> clients;
+        LatencyHistogram latencies;  // in microseconds
+        int finishedCount = 0;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < clientsCount; ++i)
+        {
+            auto *client = new Client;
+            clients.append(client);
+
+            connect(&client->socket, &QTcpSocket::connected, &client->socket, [client]()
+            {
+                client->requestTimer.start();
+                client->socket.write(makeRequest(u"/"_qs));
+            });
+            connect(&client->socket, &QTcpSocket::readyRead, &client->socket, [client, &latencies, &finishedCount]()
+            {
+                client->buffer.append(client->socket.readAll());
+
+                QByteArray content;
+                while (takeResponse(client->buffer, content))
+                {
+                    latencies.record(client->requestTimer.nsecsElapsed() / 1000);
+                    if (++client->responsesCount == requestsPerClient)
+                    {
+                        ++finishedCount;
+                        return;
+                    }
+
+                    client->requestTimer.start();
+                    client->socket.write(makeRequest(u"/"_qs));
+                }
+            });
+
+            client->socket.connectToHost(QHostAddress::LocalHost, server.serverPort());
+        }
+
+        QTRY_COMPARE_WITH_TIMEOUT(finishedCount, clientsCount, 60000);
+        const qint64 elapsed = timer.elapsed();
+        qDeleteAll(clients);
+
+        QCOMPARE(latencies.count(), qint64 {clientsCount * requestsPerClient});
+        qInfo("Requests: %.1f/s, latency p50: %lld us, p99: %lld us"
+            , (static_cast<qreal>(latencies.count()) * 1000 / std::max<qint64>(1, elapsed))
+            , latencies.percentile(50), latencies.percentile(99));
+    }
+};
+
+QTEST_GUILESS_MAIN(BenchmarkHttpServer)
+#include "benchmarkhttpserver.moc"
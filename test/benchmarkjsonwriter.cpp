@@ -0,0 +1,155 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTest>
+#include <QVariant>
+
+#include "base/global.h"
+#include "webui/api/jsonwriter.h"
+
+namespace
+{
+    const QString KEY_ID = u"hash"_qs;
+    const QString KEY_NAME = u"name"_qs;
+    const QString KEY_SAVE_PATH = u"save_path"_qs;
+    const QString KEY_STATE = u"state"_qs;
+    const QString KEY_TAGS = u"tags"_qs;
+    const QString KEY_SIZE = u"size"_qs;
+    const QString KEY_DOWNLOADED = u"downloaded"_qs;
+    const QString KEY_UPLOADED = u"uploaded"_qs;
+    const QString KEY_ADDED_ON = u"added_on"_qs;
+    const QString KEY_PROGRESS = u"progress"_qs;
+    const QString KEY_RATIO = u"ratio"_qs;
+    const QString KEY_AVAILABILITY = u"availability"_qs;
+    const QString KEY_DLSPEED = u"dlspeed"_qs;
+    const QString KEY_UPSPEED = u"upspeed"_qs;
+    const QString KEY_PRIORITY = u"priority"_qs;
+    const QString KEY_ETA = u"eta"_qs;
+    const QString KEY_SEQ_DL = u"seq_dl"_qs;
+    const QString KEY_FORCE_START = u"force_start"_qs;
+
+    // Mimics the fields of the torrents returned by WebAPI
+    template <typename Func>
+    void forEachTorrentField(const int index, Func &&func)
+    {
+        func(KEY_ID, u"%1"_qs.arg(index, 40, 16, u'0'));
+        func(KEY_NAME, u"Some.Torrent.Name.%1 [\"quoted\"] \u00E9\u20AC"_qs.arg(index));
+        func(KEY_SAVE_PATH, u"C:\\Downloads\\Torrents"_qs);
+        func(KEY_STATE, u"stalledUP"_qs);
+        func(KEY_TAGS, u"linux, iso"_qs);
+        func(KEY_SIZE, (qint64 {index} * 1048576));
+        func(KEY_DOWNLOADED, (qint64 {index} * 524288));
+        func(KEY_UPLOADED, (qint64 {index} * 262144));
+        func(KEY_ADDED_ON, (qint64 {1650000000} + index));
+        func(KEY_PROGRESS, (index % 100) / 100.0);
+        func(KEY_RATIO, index / 7.0);
+        func(KEY_AVAILABILITY, 1.25);
+        func(KEY_DLSPEED, (index % 1000));
+        func(KEY_UPSPEED, (index % 500));
+        func(KEY_PRIORITY, index);
+        func(KEY_ETA, 8640000);
+        func(KEY_SEQ_DL, ((index % 2) == 0));
+        func(KEY_FORCE_START, false);
+    }
+
+    // The way the responses were built before JsonWriter
+    QByteArray serializeVariant(const int torrentsCount)
+    {
+        QVariantList torrentList;
+        for (int i = 0; i < torrentsCount; ++i)
+        {
+            QVariantMap map;
+            forEachTorrentField(i, [&map](const QString &key, const auto &value) { map.insert(key, value); });
+            torrentList.append(map);
+        }
+
+        return QJsonDocument(QJsonArray::fromVariantList(torrentList)).toJson(QJsonDocument::Compact);
+    }
+
+    QByteArray serializeWriter(const int torrentsCount, const JsonWriter::Encoding encoding)
+    {
+        JsonWriter writer {encoding};
+        writer.beginArray();
+        for (int i = 0; i < torrentsCount; ++i)
+        {
+            writer.beginObject();
+            forEachTorrentField(i, [&writer](const QString &key, const auto &value) { writer.writeMember(key, value); });
+            writer.endObject();
+        }
+        writer.endArray();
+
+        return writer.data();
+    }
+}
+
+// Serialization of the torrent list as WebAPI returns it.
+// It isn't a part of the test suite, see Readme.md.
+class BenchmarkJsonWriter final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchmarkJsonWriter)
+
+public:
+    BenchmarkJsonWriter() = default;
+
+private slots:
+    void benchmarkTorrents_data() const
+    {
+        QTest::addColumn<int>("torrentsCount");
+        QTest::addColumn<bool>("useWriter");
+        QTest::addColumn<bool>("useCBOR");
+
+        QTest::newRow("10k torrents, QVariant -> QJsonDocument") << 10000 << false << false;
+        QTest::newRow("10k torrents, JsonWriter") << 10000 << true << false;
+        QTest::newRow("50k torrents, JsonWriter") << 50000 << true << false;
+        QTest::newRow("50k torrents, JsonWriter CBOR") << 50000 << true << true;
+    }
+
+    // The writer allocates nothing but the output while the former way
+    // builds the whole QVariant tree and its QJsonArray copy first.
+    // CBOR output is smaller since numbers and booleans are stored in binary form
+    // and strings need no escaping.
+    void benchmarkTorrents() const
+    {
+        QFETCH(int, torrentsCount);
+        QFETCH(bool, useWriter);
+        QFETCH(bool, useCBOR);
+
+        const JsonWriter::Encoding encoding = useCBOR ? JsonWriter::Encoding::CBOR : JsonWriter::Encoding::Text;
+        QBENCHMARK
+        {
+            const QByteArray output = useWriter ? serializeWriter(torrentsCount, encoding) : serializeVariant(torrentsCount);
+            QVERIFY(!output.isEmpty());
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(BenchmarkJsonWriter)
+#include "benchmarkjsonwriter.moc"
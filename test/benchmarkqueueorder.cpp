@@ -0,0 +1,91 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+#include <random>
+
+#include <QTest>
+#include <QVector>
+
+#include "base/bittorrent/queueorder.h"
+#include "base/global.h"
+
+Q_DECLARE_METATYPE(QVector<int>)
+
+namespace
+{
+    QVector<int> identity(const int size)
+    {
+        QVector<int> result;
+        result.reserve(size);
+        for (int i = 0; i < size; ++i)
+            result.append(i);
+        return result;
+    }
+}
+
+// Reordering of a large queue.
+// It isn't a part of the test suite, see Readme.md.
+class BenchmarkQueueOrder final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchmarkQueueOrder)
+
+public:
+    BenchmarkQueueOrder() = default;
+
+private slots:
+    void benchmarkComputeQueueMoves_data() const
+    {
+        QTest::addColumn<QVector<int>>("order");
+
+        const int size = 50000;
+        std::mt19937 generator {42};
+
+        QVector<int> blockMoved = identity(size);
+        std::rotate((blockMoved.begin() + 1000), (blockMoved.begin() + 40000), (blockMoved.begin() + 45000));
+        QTest::newRow("50k queue, 5k torrents moved up") << blockMoved;
+
+        QVector<int> shuffled = identity(size);
+        std::shuffle(shuffled.begin(), shuffled.end(), generator);
+        QTest::newRow("50k queue, shuffled") << shuffled;
+    }
+
+    void benchmarkComputeQueueMoves() const
+    {
+        QFETCH(QVector<int>, order);
+
+        QBENCHMARK
+        {
+            BitTorrent::computeQueueMoves(order);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(BenchmarkQueueOrder)
+#include "benchmarkqueueorder.moc"
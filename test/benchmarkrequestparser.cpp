@@ -0,0 +1,106 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QTest>
+#include <QVector>
+
+#include "base/global.h"
+#include "base/http/requestparser.h"
+#include "base/http/types.h"
+
+using Http::RequestParser;
+
+namespace
+{
+    // Passes the data to the parser in chunks, as if they were received from the socket
+    int parseInChunks(const QByteArray &data, const int chunkSize)
+    {
+        RequestParser parser;
+        int requestsCount = 0;
+        for (int pos = 0; pos < data.size(); pos += chunkSize)
+        {
+            parser.append(data.mid(pos, chunkSize));
+            while (parser.parse() == RequestParser::ParseStatus::OK)
+            {
+                parser.takeRequest();
+                ++requestsCount;
+            }
+        }
+        return requestsCount;
+    }
+}
+
+// Parsing of the requests received over a connection.
+// It isn't a part of the test suite, see Readme.md.
+class BenchmarkRequestParser final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchmarkRequestParser)
+
+public:
+    BenchmarkRequestParser() = default;
+
+private slots:
+    void benchmarkPipelinedRequests() const
+    {
+        const int requestsCount = 1000;
+
+        QByteArray data;
+        for (int i = 0; i < requestsCount; ++i)
+            data += "GET /api/v2/sync/maindata?rid=" + QByteArray::number(i) + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+        QBENCHMARK
+        {
+            QCOMPARE(parseInChunks(data, (16 * 1024)), requestsCount);
+        }
+    }
+
+    void benchmarkLargeUpload() const
+    {
+        const QByteArray boundary = "----boundary";
+        const QByteArray body = "--" + boundary + "\r\n"
+            + "Content-Disposition: form-data; name=\"torrents\"; filename=\"file.torrent\"\r\n"
+            + "Content-Type: application/x-bittorrent\r\n\r\n"
+            + QByteArray((32 * 1024 * 1024), 'x') + "\r\n"
+            + "--" + boundary + "--\r\n";
+        const QByteArray data = "POST /api/v2/torrents/add HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "Content-Type: multipart/form-data; boundary=" + boundary + "\r\n"
+            "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n"
+            + body;
+
+        QBENCHMARK
+        {
+            QCOMPARE(parseInChunks(data, (64 * 1024)), 1);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(BenchmarkRequestParser)
+#include "benchmarkrequestparser.moc"
@@ -0,0 +1,119 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QStringList>
+#include <QTest>
+#include <QVector>
+
+#include "base/global.h"
+#include "webui/api/syncstore.h"
+
+namespace
+{
+    const int FIELDS_COUNT = 40;
+
+    QStringList fieldKeys()
+    {
+        QStringList keys;
+        for (int i = 0; i < FIELDS_COUNT; ++i)
+            keys.append(u"field%1"_qs.arg(i));
+        return keys;
+    }
+
+    // Every "changeInterval"-th item gets its first field changed in each update
+    void updateItems(SyncStore &store, const quint64 revision, const int itemsCount, const int changeInterval)
+    {
+        store.beginUpdate(revision);
+
+        QVector<QJsonValue> values(FIELDS_COUNT);
+        for (int i = 0; i < itemsCount; ++i)
+        {
+            values[0] = ((i % changeInterval) == 0) ? static_cast<qint64>(revision) : 0;
+            for (int field = 1; field < FIELDS_COUNT; ++field)
+                values[field] = u"value%1"_qs.arg(i);
+            store.updateItem(QString::number(i), values);
+        }
+
+        store.endUpdate();
+    }
+}
+
+// Sync data of many torrents shared by several clients.
+// It isn't a part of the test suite, see Readme.md.
+class BenchmarkSyncStore final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchmarkSyncStore)
+
+public:
+    BenchmarkSyncStore() = default;
+
+private slots:
+    void benchmarkChanges_data() const
+    {
+        QTest::addColumn<int>("itemsCount");
+        QTest::addColumn<int>("clientsCount");
+
+        QTest::newRow("10k torrents, 1 client") << 10000 << 1;
+        QTest::newRow("10k torrents, 5 clients") << 10000 << 5;
+        QTest::newRow("50k torrents, 5 clients") << 50000 << 5;
+    }
+
+    // Each round the data is collected once and each client gets its changes
+    void benchmarkChanges() const
+    {
+        QFETCH(int, itemsCount);
+        QFETCH(int, clientsCount);
+
+        SyncStore store {fieldKeys()};
+        quint64 revision = 1;
+        updateItems(store, revision, itemsCount, 100);
+        QVector<quint64> clientRevisions(clientsCount, revision);
+
+        QBENCHMARK
+        {
+            ++revision;
+            updateItems(store, revision, itemsCount, 100);
+
+            for (quint64 &clientRevision : clientRevisions)
+            {
+                const QJsonObject changedItems = store.changedItems(clientRevision);
+                const QJsonArray removedItems = store.removedItems(clientRevision);
+                QCOMPARE(static_cast<int>(changedItems.size()), (itemsCount / 100));
+                QVERIFY(removedItems.isEmpty());
+                clientRevision = store.revision();
+            }
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(BenchmarkSyncStore)
+#include "benchmarksyncstore.moc"
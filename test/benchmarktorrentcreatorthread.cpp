@@ -0,0 +1,130 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <random>
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/torrentcreatorthread.h"
+#include "base/global.h"
+#include "base/path.h"
+
+#ifdef QBT_USES_LIBTORRENT2
+Q_DECLARE_METATYPE(BitTorrent::TorrentFormat)
+#endif
+
+namespace
+{
+    const int PIECE_SIZE = 256 * 1024;
+    const int FILE_SIZE = 16 * 1024 * 1024;
+    const int FILES_COUNT = 4;
+
+    void generateContent(const Path &rootPath)
+    {
+        QVERIFY(QDir().mkpath(rootPath.data()));
+
+        std::mt19937 generator {42};
+        QByteArray data {FILE_SIZE, Qt::Uninitialized};
+        for (int i = 0; i < FILES_COUNT; ++i)
+        {
+            for (char &c : data)
+                c = static_cast<char>(generator());
+
+            QFile file {(rootPath / Path(u"file%1"_qs.arg(i))).data()};
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            QCOMPARE(file.write(data), qint64 {FILE_SIZE});
+        }
+    }
+}
+
+// Creation of the torrent of 64 MiB content which is likely to be cached by the OS
+// so it's the hashing itself which is measured mostly.
+// It isn't a part of the test suite, see Readme.md.
+class BenchmarkTorrentCreatorThread final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchmarkTorrentCreatorThread)
+
+public:
+    BenchmarkTorrentCreatorThread() = default;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_tmpDir.isValid());
+        generateContent(Path(m_tmpDir.path()) / Path(u"content"_qs));
+    }
+
+    void benchmarkCreation_data() const
+    {
+#ifdef QBT_USES_LIBTORRENT2
+        QTest::addColumn<BitTorrent::TorrentFormat>("format");
+        QTest::newRow("v1") << BitTorrent::TorrentFormat::V1;
+        QTest::newRow("v2") << BitTorrent::TorrentFormat::V2;
+        QTest::newRow("hybrid") << BitTorrent::TorrentFormat::Hybrid;
+#else
+        QTest::addColumn<int>("format");
+        QTest::newRow("v1") << 0;
+#endif
+    }
+
+    void benchmarkCreation() const
+    {
+        BitTorrent::TorrentCreatorParams params;
+        params.isPrivate = false;
+#ifdef QBT_USES_LIBTORRENT2
+        QFETCH(BitTorrent::TorrentFormat, format);
+        params.torrentFormat = format;
+#else
+        params.isAlignmentOptimized = false;
+        params.paddedFileSizeLimit = -1;
+#endif
+        params.pieceSize = PIECE_SIZE;
+        params.inputPath = Path(m_tmpDir.path()) / Path(u"content"_qs);
+        params.savePath = Path(m_tmpDir.path()) / Path(u"test.torrent"_qs);
+
+        QBENCHMARK
+        {
+            BitTorrent::TorrentCreatorThread creator;
+            QSignalSpy successSpy {&creator, &BitTorrent::TorrentCreatorThread::creationSuccess};
+            creator.create(params);
+            creator.wait();
+            QCOMPARE(successSpy.count(), 1);
+        }
+    }
+
+private:
+    QTemporaryDir m_tmpDir;
+};
+
+QTEST_GUILESS_MAIN(BenchmarkTorrentCreatorThread)
+#include "benchmarktorrentcreatorthread.moc"
@@ -0,0 +1,93 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/path.h"
+#include "base/utils/fs.h"
+
+// Copying of files by Utils::Fs::copyFile().
+// It isn't a part of the test suite, see Readme.md.
+class BenchmarkUtilsFs final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchmarkUtilsFs)
+
+public:
+    BenchmarkUtilsFs() = default;
+
+private slots:
+    // Copies into `QBT_BENCHMARK_COPY_DIR` when it is set, e.g. to a loopback mounted
+    // btrfs or xfs image to measure the copying between different file systems
+    void benchmarkCopyFile_data() const
+    {
+        QTest::addColumn<int>("size");
+
+        QTest::newRow("1 MiB") << (1024 * 1024);
+        QTest::newRow("64 MiB") << (64 * 1024 * 1024);
+    }
+
+    void benchmarkCopyFile() const
+    {
+        QFETCH(int, size);
+
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const QByteArray destinationDir = qgetenv("QBT_BENCHMARK_COPY_DIR");
+        const QTemporaryDir destinationTmpDir {destinationDir.isEmpty()
+                ? (tmpDir.path() + u"/destination-XXXXXX"_qs)
+                : (QString::fromLocal8Bit(destinationDir) + u"/qbt-XXXXXX"_qs)};
+        QVERIFY(destinationTmpDir.isValid());
+
+        const Path source = Path(tmpDir.path()) / Path(u"source"_qs);
+        const Path destination = Path(destinationTmpDir.path()) / Path(u"destination"_qs);
+        {
+            // not sparse so that all the data is copied indeed
+            QByteArray data {size, Qt::Uninitialized};
+            for (int i = 0; i < size; ++i)
+                data[i] = static_cast<char>((i * 7) ^ (i >> 8));
+
+            QFile file {source.data()};
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            QCOMPARE(file.write(data), qint64 {size});
+        }
+
+        QBENCHMARK
+        {
+            Utils::Fs::removeFile(destination);
+            QVERIFY(Utils::Fs::copyFile(source, destination));
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(BenchmarkUtilsFs)
+#include "benchmarkutilsfs.moc"
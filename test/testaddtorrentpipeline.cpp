@@ -0,0 +1,167 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/addtorrentpipeline.h"
+#include "base/bittorrent/downloadpriority.h"
+#include "base/bittorrent/torrentcontentlayout.h"
+#include "base/global.h"
+#include "base/path.h"
+#include "torrentfactory.h"
+
+namespace
+{
+    const int PIECE_SIZE = 16 * 1024;
+
+    // Only the metadata matters, so the torrent doesn't need any content
+    void createTorrentFile(const Path &path, const QString &name, const QStringList &fileNames)
+    {
+        TorrentFactory::FileList files;
+        for (const QString &fileName : fileNames)
+            files.append({(name + u'/' + fileName), PIECE_SIZE});
+
+        TorrentFactory::writeFile(path, TorrentFactory::createTorrentData(files, PIECE_SIZE));
+    }
+
+    QRegularExpression excludedFileName(const QString &wildcard)
+    {
+        const QString pattern = QRegularExpression::anchoredPattern(QRegularExpression::wildcardToRegularExpression(wildcard));
+        return QRegularExpression {pattern, QRegularExpression::CaseInsensitiveOption};
+    }
+
+    QVector<BitTorrent::PreparedTorrent> prepareAll(BitTorrent::AddTorrentPipeline &pipeline, const int expectedCount)
+    {
+        QVector<BitTorrent::PreparedTorrent> result;
+        const QMetaObject::Connection connection = QObject::connect(&pipeline, &BitTorrent::AddTorrentPipeline::torrentsPrepared
+                , [&result](const QVector<BitTorrent::PreparedTorrent> &torrents) { result.append(torrents); });
+
+        QElapsedTimer timer;
+        timer.start();
+        while ((result.size() < expectedCount) && (timer.elapsed() < 60000))
+            QTest::qWait(1);
+
+        QObject::disconnect(connection);
+        return result;
+    }
+}
+
+class TestAddTorrentPipeline final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestAddTorrentPipeline)
+
+public:
+    TestAddTorrentPipeline() = default;
+
+private slots:
+    void testPrepareParams() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path torrentPath = Path(tmpDir.path()) / Path(u"test.torrent"_qs);
+        createTorrentFile(torrentPath, u"root"_qs, {u"a.txt"_qs, u"b.nfo"_qs, u"sub/c.txt"_qs});
+        const nonstd::expected<BitTorrent::TorrentInfo, QString> loadResult = BitTorrent::TorrentInfo::loadFromFile(torrentPath);
+        QVERIFY(loadResult);
+
+        BitTorrent::AddTorrentParams params;
+        params.contentLayout = BitTorrent::TorrentContentLayout::NoSubfolder;
+        const auto prepareResult = BitTorrent::prepareAddTorrentParams(loadResult.value(), params, {excludedFileName(u"*.NFO"_qs)});
+        QVERIFY(prepareResult);
+
+        const PathList expectedPaths {Path(u"a.txt"_qs), Path(u"b.nfo"_qs), Path(u"sub/c.txt"_qs)};
+        QCOMPARE(prepareResult.value().filePaths, expectedPaths);
+        const QVector<BitTorrent::DownloadPriority> expectedPriorities {BitTorrent::DownloadPriority::Normal
+                , BitTorrent::DownloadPriority::Ignored, BitTorrent::DownloadPriority::Normal};
+        QVERIFY(prepareResult.value().filePriorities == expectedPriorities);
+
+        // explicitly set priorities aren't overridden
+        params.filePriorities = {BitTorrent::DownloadPriority::High, BitTorrent::DownloadPriority::Normal
+                , BitTorrent::DownloadPriority::Normal};
+        const auto explicitResult = BitTorrent::prepareAddTorrentParams(loadResult.value(), params, {excludedFileName(u"*.nfo"_qs)});
+        QVERIFY(explicitResult);
+        QVERIFY(explicitResult.value().filePriorities == params.filePriorities);
+
+        params.filePaths = {Path(u"a.txt"_qs)};
+        QVERIFY(!BitTorrent::prepareAddTorrentParams(loadResult.value(), params, {}));
+    }
+
+    void testOrder() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const int count = 200;
+        const int brokenIndex = 57;
+        BitTorrent::AddTorrentPipeline pipeline;
+        for (int i = 0; i < count; ++i)
+        {
+            const Path torrentPath = Path(tmpDir.path()) / Path(u"%1.torrent"_qs.arg(i));
+            if (i == brokenIndex)
+            {
+                QFile file {torrentPath.data()};
+                QVERIFY(file.open(QIODevice::WriteOnly));
+                file.write("d4:infoi1ee");
+            }
+            else
+            {
+                createTorrentFile(torrentPath, u"torrent%1"_qs.arg(i), {u"file.dat"_qs});
+            }
+
+            pipeline.add(torrentPath, {});
+        }
+
+        const QVector<BitTorrent::PreparedTorrent> torrents = prepareAll(pipeline, count);
+        QCOMPARE(torrents.size(), count);
+        QCOMPARE(pipeline.pendingCount(), 0);
+
+        // torrents are handed over in the order they were added
+        for (int i = 0; i < count; ++i)
+        {
+            const BitTorrent::PreparedTorrent &torrent = torrents.at(i);
+            QCOMPARE(torrent.sourcePath, (Path(tmpDir.path()) / Path(u"%1.torrent"_qs.arg(i))));
+            if (i == brokenIndex)
+            {
+                QVERIFY(!torrent.error.isEmpty());
+            }
+            else
+            {
+                QVERIFY(torrent.error.isEmpty());
+                QCOMPARE(torrent.torrentInfo.name(), u"torrent%1"_qs.arg(i));
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(TestAddTorrentPipeline)
+#include "testaddtorrentpipeline.moc"
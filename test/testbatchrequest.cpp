@@ -0,0 +1,207 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/http/httperror.h"
+#include "webui/api/batchrequest.h"
+#include "webui/api/jsonwriter.h"
+
+namespace
+{
+    const QRegularExpression API_PATH_PATTERN {u"^/api/v2/(?<scope>[A-Za-z_][A-Za-z_0-9]*)/(?<action>[A-Za-z_][A-Za-z_0-9]*)$"_qs};
+
+    // Records the dispatched sub-requests, the "torrents" scope is the only existing one
+    class Dispatcher
+    {
+    public:
+        APIResult operator()(const QString &scope, const QString &action, const StringMap &params)
+        {
+            calls.append(scope + u'/' + action);
+            lastParams = params;
+
+            if (scope != u"torrents")
+                throw NotFoundHTTPError();
+            if (action == u"fail")
+                throw ConflictHTTPError(u"failed"_qs);
+            if (action == u"info")
+                return {QJsonDocument(QJsonArray {QJsonObject {{u"hash"_qs, u"abc"_qs}}}), {}};
+            return {action, {}};
+        }
+
+        QStringList calls;
+        StringMap lastParams;
+    };
+
+    QJsonArray run(const QJsonArray &requests, Dispatcher &dispatcher)
+    {
+        JsonWriter writer;
+        runBatchRequest(QString::fromUtf8(QJsonDocument(requests).toJson())
+            , API_PATH_PATTERN, std::ref(dispatcher), writer);
+        return QJsonDocument::fromJson(writer.data()).array();
+    }
+
+    // The batch is rejected as a whole before anything is written
+    bool isRejected(const QString &requests, Dispatcher &dispatcher)
+    {
+        JsonWriter writer;
+        try
+        {
+            runBatchRequest(requests, API_PATH_PATTERN, std::ref(dispatcher), writer);
+        }
+        catch (const BadRequestHTTPError &)
+        {
+            return writer.data().isEmpty() && dispatcher.calls.isEmpty();
+        }
+        return false;
+    }
+
+    QJsonObject makeRequest(const QString &path, const QJsonObject &params = {})
+    {
+        return {{u"path"_qs, path}, {u"params"_qs, params}};
+    }
+}
+
+class TestBatchRequest final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBatchRequest)
+
+public:
+    TestBatchRequest() = default;
+
+private slots:
+    void testOrder() const
+    {
+        Dispatcher dispatcher;
+        const QJsonArray results = run({makeRequest(u"/api/v2/torrents/pause"_qs)
+            , makeRequest(u"/api/v2/torrents/info"_qs), makeRequest(u"/api/v2/torrents/resume"_qs)}, dispatcher);
+
+        QCOMPARE(dispatcher.calls, QStringList({u"torrents/pause"_qs, u"torrents/info"_qs, u"torrents/resume"_qs}));
+        QCOMPARE(static_cast<int>(results.size()), 3);
+        QCOMPARE(results[0].toObject(), QJsonObject({{u"status"_qs, 200}, {u"result"_qs, u"pause"_qs}}));
+        QCOMPARE(results[1].toObject().value(u"result"_qs), QJsonValue(QJsonArray {QJsonObject {{u"hash"_qs, u"abc"_qs}}}));
+        QCOMPARE(results[2].toObject().value(u"result"_qs), QJsonValue(u"resume"_qs));
+    }
+
+    void testItemErrors() const
+    {
+        Dispatcher dispatcher;
+        const QJsonArray results = run({makeRequest(u"/api/v2/torrents/fail"_qs), makeRequest(u"/api/v2/unknown/info"_qs)
+            , makeRequest(u"/not/api"_qs), u"not an object"_qs, makeRequest(u"/api/v2/torrents/info"_qs)}, dispatcher);
+
+        // the failing items don't stop the rest
+        QCOMPARE(static_cast<int>(results.size()), 5);
+        QCOMPARE(results[0].toObject(), QJsonObject({{u"status"_qs, 409}, {u"error"_qs, u"failed"_qs}}));
+        QCOMPARE(results[1].toObject().value(u"status"_qs), QJsonValue(404));
+        QCOMPARE(results[2].toObject().value(u"status"_qs), QJsonValue(404));
+        QCOMPARE(results[3].toObject().value(u"status"_qs), QJsonValue(400));
+        QCOMPARE(results[4].toObject().value(u"status"_qs), QJsonValue(200));
+        QCOMPARE(dispatcher.calls, QStringList({u"torrents/fail"_qs, u"unknown/info"_qs, u"torrents/info"_qs}));
+    }
+
+    void testUnsupported() const
+    {
+        Dispatcher dispatcher;
+        const QJsonArray results = run({makeRequest(u"/api/v2/auth/login"_qs), makeRequest(u"/api/v2/auth/logout"_qs)
+            , makeRequest(u"/api/v2/sync/events"_qs)}, dispatcher);
+
+        QCOMPARE(static_cast<int>(results.size()), 3);
+        for (const QJsonValue &result : results)
+            QCOMPARE(result.toObject().value(u"status"_qs), QJsonValue(400));
+        QVERIFY(dispatcher.calls.isEmpty());
+    }
+
+    void testParams() const
+    {
+        Dispatcher dispatcher;
+        const QJsonObject params
+        {
+            {u"string"_qs, u"a b"_qs},
+            {u"bool"_qs, true},
+            {u"int"_qs, 42},
+            {u"big"_qs, 1e20},
+            {u"fraction"_qs, 0.25},
+            {u"null"_qs, QJsonValue()}
+        };
+        QCOMPARE(run({makeRequest(u"/api/v2/torrents/add"_qs, params)}, dispatcher)[0].toObject().value(u"status"_qs), QJsonValue(200));
+
+        const StringMap expected
+        {
+            {u"string"_qs, u"a b"_qs},
+            {u"bool"_qs, u"true"_qs},
+            {u"int"_qs, u"42"_qs},
+            {u"big"_qs, u"100000000000000000000"_qs},
+            {u"fraction"_qs, u"0.25"_qs},
+            {u"null"_qs, u""_qs}
+        };
+        QCOMPARE(dispatcher.lastParams, expected);
+    }
+
+    void testNonScalarParams() const
+    {
+        Dispatcher dispatcher;
+        const QJsonArray results = run({makeRequest(u"/api/v2/torrents/add"_qs, {{u"urls"_qs, QJsonArray {u"a"_qs}}})
+            , makeRequest(u"/api/v2/torrents/add"_qs, {{u"tags"_qs, QJsonObject {{u"a"_qs, 1}}}})
+            , QJsonObject {{u"path"_qs, u"/api/v2/torrents/add"_qs}, {u"params"_qs, QJsonArray {}}}}, dispatcher);
+
+        QCOMPARE(static_cast<int>(results.size()), 3);
+        for (const QJsonValue &result : results)
+            QCOMPARE(result.toObject().value(u"status"_qs), QJsonValue(400));
+        QVERIFY(dispatcher.calls.isEmpty());
+    }
+
+    void testSizeLimit() const
+    {
+        Dispatcher dispatcher;
+        QJsonArray requests;
+        for (int i = 0; i < MAX_BATCH_SIZE; ++i)
+            requests.append(makeRequest(u"/api/v2/torrents/info"_qs));
+        QCOMPARE(static_cast<int>(run(requests, dispatcher).size()), MAX_BATCH_SIZE);
+
+        dispatcher.calls.clear();
+        requests.append(makeRequest(u"/api/v2/torrents/info"_qs));
+        QVERIFY(isRejected(QString::fromUtf8(QJsonDocument(requests).toJson()), dispatcher));
+    }
+
+    void testInvalidBatch() const
+    {
+        Dispatcher dispatcher;
+        QVERIFY(isRejected(u"{}"_qs, dispatcher));
+        QVERIFY(isRejected(u"[1,"_qs, dispatcher));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBatchRequest)
+#include "testbatchrequest.moc"
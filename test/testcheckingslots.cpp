@@ -0,0 +1,128 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QHash>
+#include <QString>
+#include <QTest>
+
+#include "base/bittorrent/checkingslots.h"
+#include "base/global.h"
+
+using BitTorrent::CheckingDeviceQueue;
+
+class TestCheckingSlots final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestCheckingSlots)
+
+public:
+    TestCheckingSlots() = default;
+
+private slots:
+    void testDeviceLimits() const
+    {
+        const QHash<QString, CheckingDeviceQueue> queues
+        {
+            {u"sda"_qs, {0, 5, 2}},
+            {u"sdb"_qs, {1, 3, 2}},
+            {u"sdc"_qs, {1, 0, 4}}
+        };
+
+        const QHash<QString, int> grantedSlots = BitTorrent::distributeCheckingSlots(queues, -1, 2);
+        QCOMPARE(grantedSlots.value(u"sda"_qs), 2);
+        QCOMPARE(grantedSlots.value(u"sdb"_qs), 1);
+        QVERIFY(!grantedSlots.contains(u"sdc"_qs));
+    }
+
+    void testGlobalLimit() const
+    {
+        const QHash<QString, CheckingDeviceQueue> queues
+        {
+            {u"sda"_qs, {0, 5, 4}},
+            {u"sdb"_qs, {0, 5, 4}}
+        };
+
+        // free slots are shared by devices
+        const QHash<QString, int> grantedSlots = BitTorrent::distributeCheckingSlots(queues, 5, 1);
+        QCOMPARE(grantedSlots.value(u"sda"_qs), 2);
+        QCOMPARE(grantedSlots.value(u"sdb"_qs), 2);
+
+        QVERIFY(BitTorrent::distributeCheckingSlots(queues, 5, 5).isEmpty());
+    }
+
+    // More torrents are waiting than there are slots, they should be started as the active ones finish
+    void testQueueDrain() const
+    {
+        const int globalLimit = 3;
+        QHash<QString, CheckingDeviceQueue> queues
+        {
+            {u"sda"_qs, {0, 7, 2}},
+            {u"sdb"_qs, {0, 2, 1}}
+        };
+
+        int startedCount = 0;
+        int rounds = 0;
+        while ((queues[u"sda"_qs].waitingCount > 0) || (queues[u"sdb"_qs].waitingCount > 0))
+        {
+            QVERIFY(rounds < 10);
+            ++rounds;
+
+            int totalActiveCount = 0;
+            for (const CheckingDeviceQueue &queue : asConst(queues))
+                totalActiveCount += queue.activeCount;
+
+            const QHash<QString, int> grantedSlots = BitTorrent::distributeCheckingSlots(queues, globalLimit, totalActiveCount);
+            QVERIFY(!grantedSlots.isEmpty());
+
+            int grantedCount = 0;
+            for (auto iter = grantedSlots.cbegin(); iter != grantedSlots.cend(); ++iter)
+            {
+                CheckingDeviceQueue &queue = queues[iter.key()];
+                queue.waitingCount -= iter.value();
+                queue.activeCount += iter.value();
+                QVERIFY(queue.waitingCount >= 0);
+                QVERIFY(queue.activeCount <= queue.limit);
+                grantedCount += iter.value();
+            }
+            QVERIFY((totalActiveCount + grantedCount) <= globalLimit);
+            startedCount += grantedCount;
+
+            // one check of each device is finished
+            for (CheckingDeviceQueue &queue : queues)
+            {
+                if (queue.activeCount > 0)
+                    --queue.activeCount;
+            }
+        }
+
+        QCOMPARE(startedCount, 9);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestCheckingSlots)
+#include "testcheckingslots.moc"
@@ -0,0 +1,157 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/contentreuse.h"
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/torrentinfo.h"
+#include "base/global.h"
+#include "base/path.h"
+#include "torrentfactory.h"
+
+using TorrentFactory::fileContent;
+using TorrentFactory::writeFile;
+
+namespace
+{
+    const int PIECE_SIZE = 16 * 1024;
+    const qint64 FIRST_FILE_SIZE = (PIECE_SIZE * 5) / 2;
+    const qint64 SECOND_FILE_SIZE = PIECE_SIZE * 3;
+
+    // "root/a.bin" ends in the middle of the third piece so "root/b.bin" starts at half a piece offset
+    BitTorrent::TorrentInfo createTorrent(const Path &dirPath)
+    {
+        writeFile((dirPath / Path(u"root/a.bin"_qs)), fileContent(FIRST_FILE_SIZE, 1));
+        writeFile((dirPath / Path(u"root/b.bin"_qs)), fileContent(SECOND_FILE_SIZE, 2));
+
+        return TorrentFactory::createTorrentInfo({{u"root/a.bin"_qs, FIRST_FILE_SIZE}, {u"root/b.bin"_qs, SECOND_FILE_SIZE}}
+                , PIECE_SIZE, dirPath);
+    }
+}
+
+class TestContentReuse final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestContentReuse)
+
+public:
+    TestContentReuse() = default;
+
+private slots:
+    void testCandidate() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const BitTorrent::TorrentInfo torrentInfo = createTorrent(Path(tmpDir.path()));
+        const QVector<QByteArray> pieceHashes = torrentInfo.pieceHashes();
+        QCOMPARE(pieceHashes.size(), 6);
+
+        const auto first = BitTorrent::makeContentReuseCandidate(torrentInfo, pieceHashes, 0);
+        QVERIFY(first);
+        QCOMPARE(first->fileSize, FIRST_FILE_SIZE);
+        QCOMPARE(first->firstPieceOffset, qint64 {0});
+        QCOMPARE(first->pieceHashes, pieceHashes.mid(0, 2));
+
+        // the last piece of the torrent is shorter than the others
+        const auto second = BitTorrent::makeContentReuseCandidate(torrentInfo, pieceHashes, 1);
+        QVERIFY(second);
+        QCOMPARE(second->firstPieceOffset, qint64 {PIECE_SIZE / 2});
+        QCOMPARE(second->pieceHashes, pieceHashes.mid(3, 3));
+
+        QVERIFY(BitTorrent::verifyFileContent((Path(tmpDir.path()) / Path(u"root/a.bin"_qs)), *first));
+        QVERIFY(BitTorrent::verifyFileContent((Path(tmpDir.path()) / Path(u"root/b.bin"_qs)), *second));
+        QVERIFY(!BitTorrent::verifyFileContent((Path(tmpDir.path()) / Path(u"root/a.bin"_qs)), *second));
+    }
+
+    void testReuse() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path dirPath {tmpDir.path()};
+        const BitTorrent::TorrentInfo torrentInfo = createTorrent(dirPath);
+        auto candidate = BitTorrent::makeContentReuseCandidate(torrentInfo, torrentInfo.pieceHashes(), 1);
+        QVERIFY(candidate);
+
+        QByteArray corrupted = fileContent(SECOND_FILE_SIZE, 2);
+        corrupted[PIECE_SIZE] = static_cast<char>(corrupted[PIECE_SIZE] + 1);
+        const Path corruptedPath = dirPath / Path(u"other/corrupted.bin"_qs);
+        writeFile(corruptedPath, corrupted);
+
+        candidate->existingFilePaths = {corruptedPath};
+        const Path targetPath = dirPath / Path(u"new/root/b.bin"_qs);
+        QCOMPARE(BitTorrent::reuseFileContent(*candidate, targetPath), qint64 {0});
+        QVERIFY(!targetPath.exists());
+
+        candidate->existingFilePaths = {corruptedPath, (dirPath / Path(u"root/b.bin"_qs))};
+        QCOMPARE(BitTorrent::reuseFileContent(*candidate, targetPath), SECOND_FILE_SIZE);
+
+        QFile file {targetPath.data()};
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QCOMPARE(file.readAll(), fileContent(SECOND_FILE_SIZE, 2));
+
+        // the data of the existing file must not change when the new torrent rewrites its copy
+        QVERIFY(file.seek(0));
+        QCOMPARE(file.write("x", 1), qint64 {1});
+        file.close();
+
+        QFile existingFile {(dirPath / Path(u"root/b.bin"_qs)).data()};
+        QVERIFY(existingFile.open(QIODevice::ReadOnly));
+        QCOMPARE(existingFile.readAll(), fileContent(SECOND_FILE_SIZE, 2));
+    }
+
+    void testIndex() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const BitTorrent::TorrentInfo torrentInfo = createTorrent(Path(tmpDir.path()));
+        const auto id = BitTorrent::TorrentID::fromInfoHash(torrentInfo.infoHash());
+
+        BitTorrent::ContentReuseIndex index;
+        index.addTorrent(id, torrentInfo);
+
+        const QVector<BitTorrent::ContentReuseIndex::FileRef> refs = index.find(SECOND_FILE_SIZE);
+        QCOMPARE(refs.size(), 1);
+        QCOMPARE(refs[0].torrentID, id);
+        QCOMPARE(refs[0].fileIndex, 1);
+        QVERIFY(index.find(PIECE_SIZE).isEmpty());
+
+        index.removeTorrent(id, torrentInfo);
+        QVERIFY(index.find(FIRST_FILE_SIZE).isEmpty());
+        QVERIFY(index.find(SECOND_FILE_SIZE).isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(TestContentReuse)
+#include "testcontentreuse.moc"
@@ -0,0 +1,205 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <random>
+#include <vector>
+
+#include <QByteArray>
+#include <QTest>
+
+#include "base/bittorrent/diskreadcache.h"
+#include "base/global.h"
+
+namespace
+{
+    const int BLOCK_SIZE = 16 * 1024;
+
+    QByteArray makeBlock(const char fill)
+    {
+        return QByteArray(BLOCK_SIZE, fill);
+    }
+}
+
+class TestDiskReadCache final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestDiskReadCache)
+
+public:
+    TestDiskReadCache() = default;
+
+private slots:
+    void testDisabled() const
+    {
+        BitTorrent::DiskReadCache cache;
+        const QByteArray block = makeBlock('a');
+        cache.insert(0, 0, 0, block.constData(), block.size());
+
+        QVERIFY(cache.read(0, 0, 0, BLOCK_SIZE).isNull());
+        QCOMPARE(cache.status().size, qint64 {0});
+        QCOMPARE(cache.status().misses, qint64 {0});
+    }
+
+    void testReadInsert() const
+    {
+        BitTorrent::DiskReadCache cache;
+        cache.setCapacity(4 * BLOCK_SIZE);
+
+        QVERIFY(cache.read(0, 1, 0, BLOCK_SIZE).isNull());
+
+        const QByteArray block = makeBlock('a');
+        cache.insert(0, 1, 0, block.constData(), block.size());
+        QCOMPARE(cache.read(0, 1, 0, BLOCK_SIZE), block);
+        QVERIFY(cache.read(0, 1, BLOCK_SIZE, BLOCK_SIZE).isNull());
+        QVERIFY(cache.read(1, 1, 0, BLOCK_SIZE).isNull());
+        // cached block is too short
+        QVERIFY(cache.read(0, 1, 0, (BLOCK_SIZE + 1)).isNull());
+
+        const BitTorrent::DiskReadCacheStatus status = cache.status();
+        QCOMPARE(status.hits, qint64 {1});
+        QCOMPARE(status.misses, qint64 {4});
+        QCOMPARE(status.size, qint64 {BLOCK_SIZE});
+    }
+
+    void testInvalidation() const
+    {
+        BitTorrent::DiskReadCache cache;
+        cache.setCapacity(8 * BLOCK_SIZE);
+
+        const QByteArray block = makeBlock('a');
+        for (int storage = 0; storage < 2; ++storage)
+        {
+            for (int piece = 0; piece < 2; ++piece)
+            {
+                cache.insert(storage, piece, 0, block.constData(), block.size());
+                cache.insert(storage, piece, BLOCK_SIZE, block.constData(), block.size());
+            }
+        }
+        QCOMPARE(cache.status().size, qint64 {8 * BLOCK_SIZE});
+
+        cache.removePiece(0, 1);
+        QVERIFY(cache.read(0, 1, 0, BLOCK_SIZE).isNull());
+        QVERIFY(cache.read(0, 1, BLOCK_SIZE, BLOCK_SIZE).isNull());
+        QVERIFY(!cache.read(0, 0, 0, BLOCK_SIZE).isNull());
+        QCOMPARE(cache.status().size, qint64 {6 * BLOCK_SIZE});
+
+        cache.removeStorage(1);
+        QVERIFY(cache.read(1, 0, 0, BLOCK_SIZE).isNull());
+        QVERIFY(cache.read(1, 1, BLOCK_SIZE, BLOCK_SIZE).isNull());
+        QVERIFY(!cache.read(0, 0, BLOCK_SIZE, BLOCK_SIZE).isNull());
+        QCOMPARE(cache.status().size, qint64 {2 * BLOCK_SIZE});
+
+        cache.clear();
+        QCOMPARE(cache.status().size, qint64 {0});
+    }
+
+    void testStaleInsert() const
+    {
+        BitTorrent::DiskReadCache cache;
+        cache.setCapacity(4 * BLOCK_SIZE);
+
+        const QByteArray block = makeBlock('a');
+
+        // the piece is written while it is read
+        const quint64 generation = cache.generation(0);
+        cache.removePiece(0, 1);
+        cache.insert(0, 1, 0, block.constData(), block.size(), generation);
+        QVERIFY(cache.read(0, 1, 0, BLOCK_SIZE).isNull());
+
+        // other storages aren't affected
+        cache.insert(1, 1, 0, block.constData(), block.size(), cache.generation(1));
+        QVERIFY(!cache.read(1, 1, 0, BLOCK_SIZE).isNull());
+
+        const quint64 clearedGeneration = cache.generation(2);
+        cache.clear();
+        cache.insert(2, 1, 0, block.constData(), block.size(), clearedGeneration);
+        QVERIFY(cache.read(2, 1, 0, BLOCK_SIZE).isNull());
+
+        cache.insert(0, 1, 0, block.constData(), block.size(), cache.generation(0));
+        QCOMPARE(cache.read(0, 1, 0, BLOCK_SIZE), block);
+    }
+
+    void testEviction() const
+    {
+        BitTorrent::DiskReadCache cache;
+        cache.setCapacity(4 * BLOCK_SIZE);
+
+        const QByteArray block = makeBlock('a');
+        cache.insert(0, 0, 0, block.constData(), block.size());
+        // requested again, so it should survive a scan of the blocks requested only once
+        QVERIFY(!cache.read(0, 0, 0, BLOCK_SIZE).isNull());
+
+        for (int piece = 1; piece <= 8; ++piece)
+            cache.insert(0, piece, 0, block.constData(), block.size());
+
+        QCOMPARE(cache.status().size, qint64 {4 * BLOCK_SIZE});
+        QVERIFY(!cache.read(0, 0, 0, BLOCK_SIZE).isNull());
+        QVERIFY(!cache.read(0, 8, 0, BLOCK_SIZE).isNull());
+        QVERIFY(cache.read(0, 1, 0, BLOCK_SIZE).isNull());
+
+        cache.setCapacity(BLOCK_SIZE);
+        QCOMPARE(cache.status().size, qint64 {BLOCK_SIZE});
+        cache.setCapacity(0);
+        QCOMPARE(cache.status().size, qint64 {0});
+    }
+
+    // Many peers requesting blocks of a seeded torrent with Zipf distributed popularity
+    void testZipfRequests() const
+    {
+        const int blockCount = 4096;
+        const int cachedBlockCount = 256;
+        const int requestCount = 100000;
+
+        std::vector<double> weights(blockCount);
+        for (int i = 0; i < blockCount; ++i)
+            weights[i] = 1.0 / (i + 1);
+
+        std::mt19937 generator {42};
+        std::discrete_distribution<int> distribution {weights.cbegin(), weights.cend()};
+
+        const QByteArray block = makeBlock('a');
+        BitTorrent::DiskReadCache cache;
+        cache.setCapacity(static_cast<qint64>(cachedBlockCount) * BLOCK_SIZE);
+
+        for (int i = 0; i < requestCount; ++i)
+        {
+            const int request = distribution(generator);
+            const int piece = request / 16;
+            const int offset = (request % 16) * BLOCK_SIZE;
+            if (cache.read(0, piece, offset, BLOCK_SIZE).isNull())
+                cache.insert(0, piece, offset, block.constData(), block.size());
+        }
+
+        const BitTorrent::DiskReadCacheStatus status = cache.status();
+        const qreal hitRatio = static_cast<qreal>(status.hits) / (status.hits + status.misses);
+        QVERIFY(hitRatio > 0.5);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestDiskReadCache)
+#include "testdiskreadcache.moc"
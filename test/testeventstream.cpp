@@ -0,0 +1,96 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/http/eventstream.h"
+
+class TestEventStream final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestEventStream)
+
+public:
+    TestEventStream() = default;
+
+private slots:
+    void testFraming() const
+    {
+        Http::EventStream stream;
+        QByteArray output;
+        connect(&stream, &Http::EventStream::dataAvailable, &stream, [&output](const QByteArray &data) { output.append(data); });
+
+        stream.open();
+        stream.send(u"maindata"_qs, R"({"rid":1})");
+        stream.send(u"maindata"_qs, "first\nsecond", u"3-2"_qs);
+        stream.send(u"torrentPeers"_qs, "");
+
+        QCOMPARE(output, QByteArray(
+            "event: maindata\ndata: {\"rid\":1}\n\n"
+            "event: maindata\nid: 3-2\ndata: first\ndata: second\n\n"
+            "event: torrentPeers\ndata: \n\n"));
+    }
+
+    void testClosed() const
+    {
+        Http::EventStream stream;
+        QSignalSpy dataSpy {&stream, &Http::EventStream::dataAvailable};
+        QSignalSpy closeSpy {&stream, &Http::EventStream::closeRequested};
+
+        // nothing is sent until the connection opens the stream
+        stream.send(u"maindata"_qs, "{}");
+        QCOMPARE(dataSpy.count(), 0);
+
+        stream.open();
+        QVERIFY(stream.isOpen());
+        stream.close();
+        QVERIFY(!stream.isOpen());
+        QCOMPARE(closeSpy.count(), 1);
+
+        stream.send(u"maindata"_qs, "{}");
+        stream.close();
+        QCOMPARE(dataSpy.count(), 0);
+        QCOMPARE(closeSpy.count(), 1);
+    }
+
+    void testBackedUp() const
+    {
+        Http::EventStream stream;
+        QVERIFY(!stream.isBackedUp());
+        stream.setPendingSize(64 * 1024 * 1024);
+        QVERIFY(stream.isBackedUp());
+        stream.setPendingSize(0);
+        QVERIFY(!stream.isBackedUp());
+    }
+};
+
+QTEST_GUILESS_MAIN(TestEventStream)
+#include "testeventstream.moc"
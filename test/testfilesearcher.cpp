@@ -0,0 +1,151 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/common.h"
+#include "base/bittorrent/contentreuse.h"
+#include "base/bittorrent/filesearcher.h"
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/torrentinfo.h"
+#include "base/global.h"
+#include "base/path.h"
+#include "torrentfactory.h"
+
+namespace
+{
+    void createFile(const Path &path)
+    {
+        QVERIFY(QDir().mkpath(path.parentPath().data()));
+        QFile file {path.data()};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    BitTorrent::TorrentID makeID(const int value)
+    {
+        return BitTorrent::TorrentID::fromString(u"%1"_qs.arg(value, 40, 16, QChar(u'0')));
+    }
+}
+
+class TestFileSearcher final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestFileSearcher)
+
+public:
+    TestFileSearcher() = default;
+
+private slots:
+    void initTestCase() const
+    {
+        qRegisterMetaType<BitTorrent::TorrentID>();
+        qRegisterMetaType<Path>();
+        qRegisterMetaType<PathList>();
+    }
+
+    void testSearch() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path savePath = Path(tmpDir.path()) / Path(u"save"_qs);
+        const Path downloadPath = Path(tmpDir.path()) / Path(u"download"_qs);
+        createFile(savePath / Path(u"first/a.txt"_qs));
+        createFile(savePath / Path(u"first/dir/b.txt"_qs + QB_EXT));
+        createFile(downloadPath / Path(u"second/c.txt"_qs + QB_EXT));
+
+        FileSearcher searcher;
+        QSignalSpy spy {&searcher, &FileSearcher::searchFinished};
+
+        const PathList firstFiles {Path(u"first/a.txt"_qs), Path(u"first/dir/b.txt"_qs), Path(u"first/missing.txt"_qs)};
+        const PathList secondFiles {Path(u"second/c.txt"_qs)};
+        searcher.search(makeID(1), firstFiles, savePath, downloadPath);
+        searcher.search(makeID(2), secondFiles, savePath, downloadPath);
+        QVERIFY(spy.wait());
+        QCOMPARE(spy.count(), 2);
+
+        QCOMPARE(spy[0][0].value<BitTorrent::TorrentID>(), makeID(1));
+        QCOMPARE(spy[0][1].value<Path>(), savePath);
+        const PathList expectedFirstFiles {Path(u"first/a.txt"_qs), Path(u"first/dir/b.txt"_qs + QB_EXT), Path(u"first/missing.txt"_qs)};
+        QCOMPARE(spy[0][2].value<PathList>(), expectedFirstFiles);
+
+        QCOMPARE(spy[1][0].value<BitTorrent::TorrentID>(), makeID(2));
+        QCOMPARE(spy[1][1].value<Path>(), downloadPath);
+        const PathList expectedSecondFiles {Path(u"second/c.txt"_qs + QB_EXT)};
+        QCOMPARE(spy[1][2].value<PathList>(), expectedSecondFiles);
+    }
+
+    void testReuse() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const int pieceSize = 16 * 1024;
+        const qint64 fileSize = pieceSize * 4;
+        const Path existingPath = Path(tmpDir.path()) / Path(u"existing"_qs);
+        const Path savePath = Path(tmpDir.path()) / Path(u"save"_qs);
+        TorrentFactory::writeFile((existingPath / Path(u"root/a.bin"_qs)), TorrentFactory::fileContent(fileSize, 1));
+        const BitTorrent::TorrentInfo torrentInfo = TorrentFactory::createTorrentInfo({{u"root/a.bin"_qs, fileSize}}
+                , pieceSize, existingPath);
+
+        auto candidate = BitTorrent::makeContentReuseCandidate(torrentInfo, torrentInfo.pieceHashes(), 0);
+        QVERIFY(candidate);
+        candidate->existingFilePaths = {(existingPath / Path(u"root/a.bin"_qs))};
+
+        FileSearcher searcher;
+        QSignalSpy finishedSpy {&searcher, &FileSearcher::searchFinished};
+        QSignalSpy reusedSpy {&searcher, &FileSearcher::contentReused};
+
+        const PathList fileNames {Path(u"root/a.bin"_qs)};
+        searcher.search(makeID(1), fileNames, savePath, {}, {*candidate});
+        searcher.search(makeID(2), {Path(u"other/b.bin"_qs)}, savePath, {});
+
+        // the torrent which has nothing to reuse doesn't wait for the copying
+        QVERIFY(finishedSpy.wait());
+        QCOMPARE(finishedSpy[0][0].value<BitTorrent::TorrentID>(), makeID(2));
+        if (finishedSpy.count() < 2)
+            QVERIFY(finishedSpy.wait());
+        QCOMPARE(finishedSpy.count(), 2);
+
+        QCOMPARE(finishedSpy[1][0].value<BitTorrent::TorrentID>(), makeID(1));
+        QCOMPARE(finishedSpy[1][1].value<Path>(), savePath);
+        QCOMPARE(finishedSpy[1][2].value<PathList>(), fileNames);
+
+        QCOMPARE(reusedSpy.count(), 1);
+        QCOMPARE(reusedSpy[0][0].value<BitTorrent::TorrentID>(), makeID(1));
+        QCOMPARE(reusedSpy[0][1].toLongLong(), fileSize);
+        QVERIFY((savePath / Path(u"root/a.bin"_qs)).exists());
+    }
+};
+
+QTEST_GUILESS_MAIN(TestFileSearcher)
+#include "testfilesearcher.moc"
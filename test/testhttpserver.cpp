@@ -0,0 +1,231 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <optional>
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QHostAddress>
+#include <QPointer>
+#include <QTcpSocket>
+#include <QTest>
+#include <QThread>
+#include <QVector>
+
+#include "base/global.h"
+#include "base/http/eventstream.h"
+#include "base/http/irequesthandler.h"
+#include "base/http/server.h"
+#include "base/http/types.h"
+
+namespace
+{
+    class EchoRequestHandler final : public Http::IRequestHandler
+    {
+    public:
+        Http::Response processRequest(const Http::Request &request, const Http::Environment &) override
+        {
+            Http::Response response;
+            response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_TXT;
+            response.content = request.path.toUtf8();
+            return response;
+        }
+    };
+
+    // Serves "/static/..." requests in the I/O threads
+    class ConcurrentRequestHandler final : public Http::IRequestHandler
+    {
+    public:
+        Http::Response processRequest(const Http::Request &request, const Http::Environment &) override
+        {
+            Http::Response response;
+            response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_TXT;
+            response.content = "main:" + request.path.toUtf8();
+            return response;
+        }
+
+        std::optional<Http::Response> processRequestConcurrently(const Http::Request &request, const Http::Environment &) override
+        {
+            if (!request.path.startsWith(u"/static/"))
+                return std::nullopt;
+
+            if (QThread::currentThread() == m_mainThread)
+                m_isMainThreadUsed.storeRelaxed(1);
+
+            Http::Response response;
+            response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_TXT;
+            response.content = "io:" + request.path.toUtf8();
+            return response;
+        }
+
+        QThread *m_mainThread = QThread::currentThread();
+        QAtomicInteger<int> m_isMainThreadUsed = 0;
+    };
+
+    class EventStreamRequestHandler final : public Http::IRequestHandler
+    {
+    public:
+        Http::Response processRequest(const Http::Request &, const Http::Environment &) override
+        {
+            auto *eventStream = new Http::EventStream;
+            QObject::connect(eventStream, &Http::EventStream::opened, eventStream, [eventStream]()
+            {
+                eventStream->send(u"test"_qs, "data", u"1"_qs);
+            });
+            m_eventStream = eventStream;
+
+            Http::Response response;
+            response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_EVENT_STREAM;
+            response.eventStream = eventStream;
+            return response;
+        }
+
+        QPointer<Http::EventStream> m_eventStream;
+    };
+
+    QByteArray makeRequest(const QString &path)
+    {
+        return u"GET %1 HTTP/1.1\r\nHost: localhost\r\n\r\n"_qs.arg(path).toLatin1();
+    }
+
+    // Takes the content of the first complete response from the buffer
+    bool takeResponse(QByteArray &buffer, QByteArray &content)
+    {
+        const int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0)
+            return false;
+
+        const QByteArray lengthHeader = "content-length: ";
+        const int lengthPos = buffer.indexOf(lengthHeader);
+        if ((lengthPos < 0) || (lengthPos > headerEnd))
+            return false;
+
+        const int lengthEnd = buffer.indexOf("\r\n", lengthPos);
+        const int contentLength = buffer.mid((lengthPos + lengthHeader.size()), (lengthEnd - lengthPos - lengthHeader.size())).toInt();
+        const int frameSize = headerEnd + 4 + contentLength;
+        if (buffer.size() < frameSize)
+            return false;
+
+        content = buffer.mid((headerEnd + 4), contentLength);
+        buffer.remove(0, frameSize);
+        return true;
+    }
+}
+
+class TestHttpServer final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestHttpServer)
+
+public:
+    TestHttpServer() = default;
+
+private slots:
+    void testPipelinedRequests() const
+    {
+        EchoRequestHandler handler;
+        Http::Server server {&handler};
+        QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+
+        QTcpSocket socket;
+        socket.connectToHost(QHostAddress::LocalHost, server.serverPort());
+        QVERIFY(socket.waitForConnected());
+        socket.write(makeRequest(u"/a"_qs) + makeRequest(u"/b"_qs) + makeRequest(u"/c"_qs));
+
+        QByteArray buffer;
+        QVector<QByteArray> contents;
+        const auto receiveResponses = [&socket, &buffer, &contents]()
+        {
+            buffer.append(socket.readAll());
+            QByteArray content;
+            while (takeResponse(buffer, content))
+                contents.append(content);
+            return static_cast<int>(contents.size());
+        };
+        QTRY_COMPARE_WITH_TIMEOUT(receiveResponses(), 3, 5000);
+
+        QCOMPARE(contents, (QVector<QByteArray> {"/a", "/b", "/c"}));
+    }
+
+    void testConcurrentRequests() const
+    {
+        ConcurrentRequestHandler handler;
+        Http::Server server {&handler};
+        QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+
+        QTcpSocket socket;
+        socket.connectToHost(QHostAddress::LocalHost, server.serverPort());
+        QVERIFY(socket.waitForConnected());
+        // the responses keep the order of the requests no matter where they are processed
+        socket.write(makeRequest(u"/static/a"_qs) + makeRequest(u"/api"_qs) + makeRequest(u"/static/b"_qs));
+
+        QByteArray buffer;
+        QVector<QByteArray> contents;
+        const auto receiveResponses = [&socket, &buffer, &contents]()
+        {
+            buffer.append(socket.readAll());
+            QByteArray content;
+            while (takeResponse(buffer, content))
+                contents.append(content);
+            return static_cast<int>(contents.size());
+        };
+        QTRY_COMPARE_WITH_TIMEOUT(receiveResponses(), 3, 5000);
+
+        QCOMPARE(contents, (QVector<QByteArray> {"io:/static/a", "main:/api", "io:/static/b"}));
+        QCOMPARE(handler.m_isMainThreadUsed.loadRelaxed(), 0);
+    }
+
+    void testEventStreamTeardown() const
+    {
+        EventStreamRequestHandler handler;
+        Http::Server server {&handler};
+        QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+
+        QTcpSocket socket;
+        socket.connectToHost(QHostAddress::LocalHost, server.serverPort());
+        QVERIFY(socket.waitForConnected());
+        socket.write(makeRequest(u"/events"_qs));
+
+        QByteArray buffer;
+        const auto receive = [&socket, &buffer]()
+        {
+            buffer.append(socket.readAll());
+            return buffer.endsWith("event: test\nid: 1\ndata: data\n\n");
+        };
+        QTRY_VERIFY_WITH_TIMEOUT(receive(), 5000);
+        QVERIFY(buffer.startsWith("HTTP/1.1 200 OK\r\n"));
+        QVERIFY(handler.m_eventStream);
+
+        // the stream is destroyed once the client is gone
+        socket.disconnectFromHost();
+        QTRY_VERIFY_WITH_TIMEOUT(!handler.m_eventStream, 5000);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestHttpServer)
+#include "testhttpserver.moc"
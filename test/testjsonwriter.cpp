@@ -0,0 +1,251 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <limits>
+
+#include <QCborValue>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+#include <QVariant>
+
+#include "base/global.h"
+#include "webui/api/jsonwriter.h"
+
+namespace
+{
+    const QString KEY_ID = u"hash"_qs;
+    const QString KEY_NAME = u"name"_qs;
+    const QString KEY_SAVE_PATH = u"save_path"_qs;
+    const QString KEY_STATE = u"state"_qs;
+    const QString KEY_TAGS = u"tags"_qs;
+    const QString KEY_SIZE = u"size"_qs;
+    const QString KEY_DOWNLOADED = u"downloaded"_qs;
+    const QString KEY_UPLOADED = u"uploaded"_qs;
+    const QString KEY_ADDED_ON = u"added_on"_qs;
+    const QString KEY_PROGRESS = u"progress"_qs;
+    const QString KEY_RATIO = u"ratio"_qs;
+    const QString KEY_AVAILABILITY = u"availability"_qs;
+    const QString KEY_DLSPEED = u"dlspeed"_qs;
+    const QString KEY_UPSPEED = u"upspeed"_qs;
+    const QString KEY_PRIORITY = u"priority"_qs;
+    const QString KEY_ETA = u"eta"_qs;
+    const QString KEY_SEQ_DL = u"seq_dl"_qs;
+    const QString KEY_FORCE_START = u"force_start"_qs;
+
+    // Mimics the fields of the torrents returned by WebAPI
+    template <typename Func>
+    void forEachTorrentField(const int index, Func &&func)
+    {
+        func(KEY_ID, u"%1"_qs.arg(index, 40, 16, u'0'));
+        func(KEY_NAME, u"Some.Torrent.Name.%1 [\"quoted\"] \u00E9\u20AC"_qs.arg(index));
+        func(KEY_SAVE_PATH, u"C:\\Downloads\\Torrents"_qs);
+        func(KEY_STATE, u"stalledUP"_qs);
+        func(KEY_TAGS, u"linux, iso"_qs);
+        func(KEY_SIZE, (qint64 {index} * 1048576));
+        func(KEY_DOWNLOADED, (qint64 {index} * 524288));
+        func(KEY_UPLOADED, (qint64 {index} * 262144));
+        func(KEY_ADDED_ON, (qint64 {1650000000} + index));
+        func(KEY_PROGRESS, (index % 100) / 100.0);
+        func(KEY_RATIO, index / 7.0);
+        func(KEY_AVAILABILITY, 1.25);
+        func(KEY_DLSPEED, (index % 1000));
+        func(KEY_UPSPEED, (index % 500));
+        func(KEY_PRIORITY, index);
+        func(KEY_ETA, 8640000);
+        func(KEY_SEQ_DL, ((index % 2) == 0));
+        func(KEY_FORCE_START, false);
+    }
+
+    // The way the responses were built before JsonWriter
+    QByteArray serializeVariant(const int torrentsCount)
+    {
+        QVariantList torrentList;
+        for (int i = 0; i < torrentsCount; ++i)
+        {
+            QVariantMap map;
+            forEachTorrentField(i, [&map](const QString &key, const auto &value) { map.insert(key, value); });
+            torrentList.append(map);
+        }
+
+        return QJsonDocument(QJsonArray::fromVariantList(torrentList)).toJson(QJsonDocument::Compact);
+    }
+
+    QByteArray serializeWriter(const int torrentsCount, const JsonWriter::Encoding encoding = JsonWriter::Encoding::Text)
+    {
+        JsonWriter writer {encoding};
+        writer.beginArray();
+        for (int i = 0; i < torrentsCount; ++i)
+        {
+            writer.beginObject();
+            forEachTorrentField(i, [&writer](const QString &key, const auto &value) { writer.writeMember(key, value); });
+            writer.endObject();
+        }
+        writer.endArray();
+
+        return writer.data();
+    }
+
+    QByteArray toJson(const QString &value)
+    {
+        JsonWriter writer;
+        writer.writeValue(value);
+        return writer.data();
+    }
+}
+
+class TestJsonWriter final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestJsonWriter)
+
+public:
+    TestJsonWriter() = default;
+
+private slots:
+    void testStructure() const
+    {
+        JsonWriter writer;
+        writer.beginObject();
+        writer.writeMember(u"a", 1);
+        writer.writeKey(u"b");
+        writer.beginArray();
+        writer.writeValue(true);
+        writer.writeNull();
+        writer.beginObject();
+        writer.endObject();
+        writer.beginArray();
+        writer.endArray();
+        writer.endArray();
+        writer.writeMember(u"c", u"x"_qs);
+        writer.endObject();
+
+        QCOMPARE(writer.data(), QByteArray(R"({"a":1,"b":[true,null,{},[]],"c":"x"})"));
+    }
+
+    void testNumbers() const
+    {
+        JsonWriter writer;
+        writer.beginArray();
+        writer.writeValue(std::numeric_limits<qint64>::min());
+        writer.writeValue(std::numeric_limits<qint64>::max());
+        writer.writeValue(std::numeric_limits<quint64>::max());
+        writer.writeValue(QVariant::fromValue(std::numeric_limits<quint64>::max()));
+        writer.writeValue(QVariant::fromValue(std::numeric_limits<uint>::max()));
+        writer.writeValue(0.1);
+        writer.writeValue(-2.5);
+        writer.writeValue(1e300);
+        writer.writeValue(std::numeric_limits<double>::quiet_NaN());
+        writer.writeValue(std::numeric_limits<double>::infinity());
+        writer.endArray();
+
+        QCOMPARE(writer.data(), QByteArray("[-9223372036854775808,9223372036854775807,18446744073709551615,18446744073709551615,4294967295,0.1,-2.5,1e+300,null,null]"));
+    }
+
+    void testStrings() const
+    {
+        QCOMPARE(toJson(u"plain"_qs), QByteArray(R"("plain")"));
+        QCOMPARE(toJson(u"\"\\/"_qs), QByteArray(R"("\"\\/")"));
+        QCOMPARE(toJson(u"\b\f\n\r\t"_qs), QByteArray(R"("\b\f\n\r\t")"));
+        QCOMPARE(toJson(QString(QChar(0x01)) + QChar(0x1F)), QByteArray(R"("\u0001\u001f")"));
+        // 2, 3 and 4 byte UTF-8 sequences
+        QCOMPARE(toJson(u"\u00E9\u20AC\U0001F600"_qs), QByteArray("\"\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\""));
+        // lone surrogate is replaced
+        QCOMPARE(toJson(QString(QChar(0xD800))), QByteArray("\"\xEF\xBF\xBD\""));
+    }
+
+    void testVariant() const
+    {
+        const QVariantMap map
+        {
+            {u"int"_qs, 42},
+            {u"double"_qs, 0.5},
+            {u"bool"_qs, false},
+            {u"string"_qs, u"str"_qs},
+            {u"list"_qs, QVariantList {1, u"a"_qs}},
+            {u"stringList"_qs, QStringList {u"b"_qs, u"c"_qs}},
+            {u"hash"_qs, QVariantHash {{u"x"_qs, QVariantMap {{u"y"_qs, 1}}}}},
+            {u"null"_qs, QVariant()}
+        };
+
+        JsonWriter writer;
+        writer.writeValue(map);
+        QCOMPARE(QJsonDocument::fromJson(writer.data()).object(), QJsonObject::fromVariantMap(map));
+    }
+
+    void testRawJson() const
+    {
+        const QByteArray json = R"({"x":[1,"y"]})";
+
+        JsonWriter writer;
+        writer.beginArray();
+        writer.writeRawJson(json);
+        writer.writeRawJson(json);
+        writer.endArray();
+        QCOMPARE(writer.data(), QByteArray(R"([{"x":[1,"y"]},{"x":[1,"y"]}])"));
+
+        JsonWriter cborWriter {JsonWriter::Encoding::CBOR};
+        cborWriter.writeRawJson(json);
+        QCOMPARE(QCborValue::fromCbor(cborWriter.data()).toJsonValue(), QJsonValue(QJsonDocument::fromJson(json).object()));
+    }
+
+    void testSameAsJsonDocument() const
+    {
+        QCOMPARE(QJsonDocument::fromJson(serializeWriter(100)), QJsonDocument::fromJson(serializeVariant(100)));
+    }
+
+    void testCBOR() const
+    {
+        JsonWriter writer {JsonWriter::Encoding::CBOR};
+        writer.beginObject();
+        writer.writeMember(u"a", std::numeric_limits<qint64>::min());
+        writer.writeKey(u"b");
+        writer.beginArray();
+        writer.writeValue(true);
+        writer.writeNull();
+        writer.writeValue(-2.5);
+        writer.writeValue(std::numeric_limits<double>::quiet_NaN());
+        writer.writeValue(u"\u00E9\U0001F600"_qs);
+        writer.endArray();
+        writer.endObject();
+
+        const QJsonObject expected
+        {
+            {u"a"_qs, std::numeric_limits<qint64>::min()},
+            {u"b"_qs, QJsonArray {true, QJsonValue(), -2.5, QJsonValue(), u"\u00E9\U0001F600"_qs}}
+        };
+        QCOMPARE(QCborValue::fromCbor(writer.data()).toJsonValue(), QJsonValue(expected));
+
+        const QJsonDocument torrents = QJsonDocument::fromJson(serializeVariant(100));
+        QCOMPARE(QCborValue::fromCbor(serializeWriter(100, JsonWriter::Encoding::CBOR)).toJsonValue(), QJsonValue(torrents.array()));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestJsonWriter)
+#include "testjsonwriter.moc"
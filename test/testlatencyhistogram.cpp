@@ -0,0 +1,121 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QTest>
+
+#include "base/global.h"
+#include "base/latencyhistogram.h"
+
+class TestLatencyHistogram final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestLatencyHistogram)
+
+public:
+    TestLatencyHistogram() = default;
+
+private slots:
+    void testEmpty() const
+    {
+        const LatencyHistogram histogram;
+        QCOMPARE(histogram.count(), qint64 {0});
+        QCOMPARE(histogram.total(), qint64 {0});
+        QCOMPARE(histogram.max(), qint64 {0});
+        QCOMPARE(histogram.mean(), qint64 {0});
+        QCOMPARE(histogram.percentile(50), qint64 {0});
+    }
+
+    void testSmallValues() const
+    {
+        LatencyHistogram histogram;
+        for (int i = 0; i < 8; ++i)
+            histogram.record(i);
+
+        QCOMPARE(histogram.count(), qint64 {8});
+        QCOMPARE(histogram.total(), qint64 {28});
+        QCOMPARE(histogram.max(), qint64 {7});
+        QCOMPARE(histogram.percentile(0), qint64 {0});
+        QCOMPARE(histogram.percentile(50), qint64 {3});
+        QCOMPARE(histogram.percentile(100), qint64 {7});
+    }
+
+    void testPrecision() const
+    {
+        LatencyHistogram histogram;
+        for (int i = 1; i <= 10000; ++i)
+            histogram.record(i);
+
+        QCOMPARE(histogram.count(), qint64 {10000});
+        QCOMPARE(histogram.max(), qint64 {10000});
+        QCOMPARE(histogram.mean(), qint64 {5000});
+
+        const qint64 median = histogram.percentile(50);
+        QVERIFY(median >= 5000);
+        QVERIFY(median <= 6250);
+
+        const qint64 p99 = histogram.percentile(99);
+        QVERIFY(p99 >= 9900);
+        QVERIFY(p99 <= 10000);
+    }
+
+    void testOutOfRange() const
+    {
+        LatencyHistogram histogram;
+        histogram.record(-10);
+        QCOMPARE(histogram.max(), qint64 {0});
+        QCOMPARE(histogram.percentile(100), qint64 {0});
+
+        const qint64 hugeValue = (qint64(1) << 50);
+        histogram.record(hugeValue);
+        QCOMPARE(histogram.max(), hugeValue);
+        QVERIFY(histogram.percentile(100) > 0);
+    }
+
+    void testMerge() const
+    {
+        LatencyHistogram histogram1;
+        histogram1.record(10);
+        histogram1.record(20);
+
+        LatencyHistogram histogram2;
+        histogram2.record(1000);
+
+        histogram1.merge(histogram2);
+        QCOMPARE(histogram1.count(), qint64 {3});
+        QCOMPARE(histogram1.total(), qint64 {1030});
+        QCOMPARE(histogram1.max(), qint64 {1000});
+        QCOMPARE(histogram1.percentile(100), qint64 {1000});
+
+        histogram1.reset();
+        QCOMPARE(histogram1.count(), qint64 {0});
+        QCOMPARE(histogram1.max(), qint64 {0});
+    }
+};
+
+QTEST_APPLESS_MAIN(TestLatencyHistogram)
+#include "testlatencyhistogram.moc"
@@ -0,0 +1,155 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/metadatacache.h"
+#include "base/bittorrent/torrentinfo.h"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/path.h"
+#include "torrentfactory.h"
+
+namespace
+{
+    const int PIECE_SIZE = 16 * 1024;
+
+    BitTorrent::TorrentInfo makeTorrentInfo(const QString &name)
+    {
+        return TorrentFactory::createTorrentInfo({{(name + u"/file.dat"_qs), (4 * PIECE_SIZE)}}, PIECE_SIZE
+                , {}, {u"http://tracker.example.com/announce"_qs});
+    }
+
+    Path cacheFilePath(const Path &dirPath, const BitTorrent::TorrentInfo &torrentInfo)
+    {
+        return dirPath / Path(torrentInfo.infoHash().v1().toString() + u".torrent"_qs);
+    }
+}
+
+class TestMetadataCache final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestMetadataCache)
+
+public:
+    TestMetadataCache() = default;
+
+private slots:
+    void initTestCase() const
+    {
+        Logger::initInstance();
+    }
+
+    void cleanupTestCase() const
+    {
+        Logger::freeInstance();
+    }
+
+    void testStoreAndFind() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const Path dirPath {tmpDir.path()};
+
+        const BitTorrent::TorrentInfo torrentInfo = makeTorrentInfo(u"torrent1"_qs);
+        {
+            BitTorrent::MetadataCache cache {dirPath, (1024 * 1024)};
+            QVERIFY(!cache.find(torrentInfo.infoHash()));
+            cache.store(torrentInfo);
+            QVERIFY(cache.size() > 0);
+        }
+
+        // the cache is loaded from disk and contains only the info dictionary
+        BitTorrent::MetadataCache cache {dirPath, (1024 * 1024)};
+        const std::optional<BitTorrent::TorrentInfo> cached = cache.find(torrentInfo.infoHash());
+        QVERIFY(cached);
+        QVERIFY(cached->infoHash() == torrentInfo.infoHash());
+        QCOMPARE(cached->filePaths(), torrentInfo.filePaths());
+        QVERIFY(cached->trackers().isEmpty());
+    }
+
+    void testInvalidFile() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const Path dirPath {tmpDir.path()};
+
+        const BitTorrent::TorrentInfo torrentInfo = makeTorrentInfo(u"torrent1"_qs);
+        const BitTorrent::TorrentInfo otherTorrentInfo = makeTorrentInfo(u"torrent2"_qs);
+        BitTorrent::MetadataCache cache {dirPath, (1024 * 1024)};
+        cache.store(torrentInfo);
+        cache.store(otherTorrentInfo);
+
+        // metadata of another torrent must not be used
+        const Path filePath = cacheFilePath(dirPath, torrentInfo);
+        QVERIFY(QFile::remove(filePath.data()));
+        QVERIFY(QFile::copy(cacheFilePath(dirPath, otherTorrentInfo).data(), filePath.data()));
+
+        QVERIFY(!cache.find(torrentInfo.infoHash()));
+        QVERIFY(!filePath.exists());
+        QVERIFY(cache.find(otherTorrentInfo.infoHash()));
+    }
+
+    void testEviction() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const Path dirPath {tmpDir.path()};
+
+        const BitTorrent::TorrentInfo first = makeTorrentInfo(u"torrent1"_qs);
+        const BitTorrent::TorrentInfo second = makeTorrentInfo(u"torrent2"_qs);
+        const BitTorrent::TorrentInfo third = makeTorrentInfo(u"torrent3"_qs);
+
+        BitTorrent::MetadataCache cache {dirPath, (1024 * 1024)};
+        cache.store(first);
+        const qint64 entrySize = cache.size();
+        cache.setMaxSize((entrySize * 5) / 2);
+
+        QTest::qSleep(10);
+        cache.store(second);
+        QTest::qSleep(10);
+        QVERIFY(cache.find(first.infoHash()));
+        QTest::qSleep(10);
+
+        // the least recently used one is removed
+        cache.store(third);
+        QVERIFY(cache.size() <= cache.maxSize());
+        QVERIFY(!cacheFilePath(dirPath, second).exists());
+        QVERIFY(cache.find(first.infoHash()));
+        QVERIFY(cache.find(third.infoHash()));
+
+        cache.setMaxSize(0);
+        QCOMPARE(cache.size(), qint64 {0});
+        QVERIFY(!cacheFilePath(dirPath, first).exists());
+    }
+};
+
+QTEST_GUILESS_MAIN(TestMetadataCache)
+#include "testmetadatacache.moc"
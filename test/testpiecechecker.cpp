@@ -0,0 +1,188 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QBitArray>
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/filefingerprint.h"
+#include "base/bittorrent/piecechecker.h"
+#include "base/bittorrent/torrentinfo.h"
+#include "base/global.h"
+#include "base/path.h"
+#include "torrentfactory.h"
+
+using TorrentFactory::fileContent;
+using TorrentFactory::writeFile;
+
+namespace
+{
+    const int PIECE_SIZE = 16 * 1024;
+    const qint64 FIRST_FILE_SIZE = (PIECE_SIZE * 5) / 2;
+    const qint64 SECOND_FILE_SIZE = PIECE_SIZE * 3;
+    const qint64 TOTAL_SIZE = FIRST_FILE_SIZE + SECOND_FILE_SIZE;
+
+    // "root/a.bin" covers pieces 0-2 and "root/b.bin" covers pieces 2-5
+    BitTorrent::TorrentInfo createTorrent(const Path &dirPath)
+    {
+        writeFile((dirPath / Path(u"root/a.bin"_qs)), fileContent(FIRST_FILE_SIZE, 1));
+        writeFile((dirPath / Path(u"root/b.bin"_qs)), fileContent(SECOND_FILE_SIZE, 2));
+
+        return TorrentFactory::createTorrentInfo({{u"root/a.bin"_qs, FIRST_FILE_SIZE}, {u"root/b.bin"_qs, SECOND_FILE_SIZE}}
+                , PIECE_SIZE, dirPath);
+    }
+
+    BitTorrent::PieceCheckParams completeTorrentParams(const Path &dirPath, const BitTorrent::TorrentInfo &torrentInfo)
+    {
+        BitTorrent::PieceCheckParams params;
+        params.torrentInfo = torrentInfo;
+        params.filePaths = {(dirPath / Path(u"root/a.bin"_qs)), (dirPath / Path(u"root/b.bin"_qs))};
+        params.havePieces = QBitArray(torrentInfo.piecesCount(), true);
+        params.piecesToCheck = QBitArray(torrentInfo.piecesCount());
+        params.checkModifiedFiles = true;
+        for (const Path &filePath : asConst(params.filePaths))
+            params.fileFingerprints.append(BitTorrent::FileFingerprint::fromFile(filePath));
+        return params;
+    }
+}
+
+class TestPieceChecker final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestPieceChecker)
+
+public:
+    TestPieceChecker() = default;
+
+private slots:
+    void testUnmodifiedFiles() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path dirPath {tmpDir.path()};
+        const BitTorrent::TorrentInfo torrentInfo = createTorrent(dirPath);
+        const BitTorrent::PieceCheckParams params = completeTorrentParams(dirPath, torrentInfo);
+
+        const BitTorrent::PieceCheckResult result = BitTorrent::checkPieces(params);
+        QCOMPARE(result.hashedBytes, qint64 {0});
+        QCOMPARE(result.skippedBytes, TOTAL_SIZE);
+        QCOMPARE(result.havePieces, params.havePieces);
+        QCOMPARE(result.fileFingerprints, params.fileFingerprints);
+    }
+
+    void testModifiedFile() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path dirPath {tmpDir.path()};
+        const BitTorrent::TorrentInfo torrentInfo = createTorrent(dirPath);
+        const BitTorrent::PieceCheckParams params = completeTorrentParams(dirPath, torrentInfo);
+
+        // corrupt piece 3 keeping the file size
+        QByteArray content = fileContent(SECOND_FILE_SIZE, 2);
+        content[PIECE_SIZE] = static_cast<char>(content[PIECE_SIZE] + 1);
+        const Path modifiedPath = dirPath / Path(u"root/b.bin"_qs);
+        writeFile(modifiedPath, content);
+        {
+            QFile file {modifiedPath.data()};
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+        }
+
+        const BitTorrent::PieceCheckResult result = BitTorrent::checkPieces(params);
+        QCOMPARE(result.hashedBytes, (TOTAL_SIZE - (PIECE_SIZE * 2)));
+        QCOMPARE(result.skippedBytes, qint64 {PIECE_SIZE * 2});
+
+        QBitArray expectedPieces {torrentInfo.piecesCount(), true};
+        expectedPieces.clearBit(3);
+        QCOMPARE(result.havePieces, expectedPieces);
+
+        QVERIFY(result.fileFingerprints[0].isValid());
+        QVERIFY(!result.fileFingerprints[1].isValid());
+    }
+
+    void testRequestedPieces() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path dirPath {tmpDir.path()};
+        const BitTorrent::TorrentInfo torrentInfo = createTorrent(dirPath);
+        BitTorrent::PieceCheckParams params = completeTorrentParams(dirPath, torrentInfo);
+        params.checkModifiedFiles = false;
+        params.fileFingerprints = QVector<BitTorrent::FileFingerprint>(torrentInfo.filesCount());
+        params.havePieces = QBitArray(torrentInfo.piecesCount());
+        params.piecesToCheck = BitTorrent::piecesOverlappingFiles(torrentInfo, {0});
+
+        const BitTorrent::PieceCheckResult result = BitTorrent::checkPieces(params);
+        QCOMPARE(result.hashedBytes, qint64 {PIECE_SIZE * 3});
+        QCOMPARE(result.skippedBytes, qint64 {0});
+        QCOMPARE(result.havePieces, params.piecesToCheck);
+        QVERIFY(result.fileFingerprints[0].isValid());
+        QVERIFY(!result.fileFingerprints[1].isValid());
+    }
+
+    void testUnwantedFile() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path dirPath {tmpDir.path()};
+        const BitTorrent::TorrentInfo torrentInfo = createTorrent(dirPath);
+        BitTorrent::PieceCheckParams params = completeTorrentParams(dirPath, torrentInfo);
+
+        // the data of unwanted "root/a.bin" is in the part file, piece 2 is shared with "root/b.bin"
+        QVERIFY(QFile::remove((dirPath / Path(u"root/a.bin"_qs)).data()));
+        params.fileFingerprints[0] = {};
+        params.unwantedFiles = QBitArray(torrentInfo.filesCount());
+        params.unwantedFiles.setBit(0);
+
+        const BitTorrent::PieceCheckResult result = BitTorrent::checkPieces(params);
+        QCOMPARE(result.hashedBytes, qint64 {0});
+        QCOMPARE(result.havePieces, params.havePieces);
+        QVERIFY(!result.fileFingerprints[0].isValid());
+        QCOMPARE(result.fileFingerprints[1], params.fileFingerprints[1]);
+
+        // the shared piece is kept when the wanted file is rechecked
+        params.checkModifiedFiles = false;
+        params.piecesToCheck = BitTorrent::piecesOverlappingFiles(torrentInfo, {1});
+        const BitTorrent::PieceCheckResult recheckResult = BitTorrent::checkPieces(params);
+        QCOMPARE(recheckResult.hashedBytes, (TOTAL_SIZE - (PIECE_SIZE * 3)));
+        QCOMPARE(recheckResult.havePieces, params.havePieces);
+        QVERIFY(!recheckResult.checkedPieces.testBit(2));
+        QVERIFY(recheckResult.fileFingerprints[1].isValid());
+    }
+};
+
+QTEST_GUILESS_MAIN(TestPieceChecker)
+#include "testpiecechecker.moc"
@@ -0,0 +1,122 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+
+#include <QBitArray>
+#include <QByteArray>
+#include <QTest>
+
+#include "base/bittorrent/piecestates.h"
+#include "base/global.h"
+
+using BitTorrent::PieceState;
+using BitTorrent::PieceStates;
+
+namespace
+{
+    // Every 3rd piece is downloaded and every 5th one is being downloaded
+    PieceStates makeStates(const int size)
+    {
+        QBitArray pieces {size};
+        QBitArray downloadingPieces {size};
+        for (int i = 0; i < size; ++i)
+        {
+            pieces.setBit(i, ((i % 3) == 0));
+            downloadingPieces.setBit(i, ((i % 5) == 0));
+        }
+        return {pieces, downloadingPieces};
+    }
+
+    PieceState expectedState(const int index)
+    {
+        if ((index % 5) == 0)
+            return PieceState::Downloading;
+        if ((index % 3) == 0)
+            return PieceState::Downloaded;
+        return PieceState::NotDownloaded;
+    }
+}
+
+class TestPieceStates final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestPieceStates)
+
+public:
+    TestPieceStates() = default;
+
+private slots:
+    void testStates() const
+    {
+        const PieceStates states = makeStates(103);
+        QCOMPARE(states.size(), 103);
+        QCOMPARE(static_cast<int>(states.packedData().size()), 26);
+        for (int i = 0; i < states.size(); ++i)
+            QCOMPARE(states.state(i), expectedState(i));
+    }
+
+    void testPackedData() const
+    {
+        PieceStates states {5};
+        states.setState(0, PieceState::Downloaded);
+        states.setState(1, PieceState::Downloading);
+        states.setState(3, PieceState::Downloaded);
+        states.setState(4, PieceState::Downloading);
+        QCOMPARE(states.packedData(), QByteArray("\x86\x01", 2));
+
+        states.setState(3, PieceState::NotDownloaded);
+        QCOMPARE(states.packedData(), QByteArray("\x06\x01", 2));
+
+        const PieceStates restored = PieceStates::fromPackedData(states.packedData(), states.size());
+        QCOMPARE(restored.size(), 5);
+        QCOMPARE(restored.packedData(), states.packedData());
+        QVERIFY(PieceStates::fromPackedData(states.packedData(), 9).isEmpty());
+    }
+
+    void testMid() const
+    {
+        const PieceStates states = makeStates(103);
+        for (const int first : {0, 1, 4, 7, 100})
+        {
+            const int count = std::min(13, (states.size() - first));
+            const PieceStates window = states.mid(first, count);
+            QCOMPARE(window.size(), count);
+            for (int i = 0; i < count; ++i)
+                QCOMPARE(window.state(i), expectedState(first + i));
+
+            PieceStates expected {count};
+            for (int i = 0; i < count; ++i)
+                expected.setState(i, expectedState(first + i));
+            QCOMPARE(window.packedData(), expected.packedData());
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestPieceStates)
+#include "testpiecestates.moc"
@@ -0,0 +1,111 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+#include <random>
+
+#include <QTest>
+#include <QVector>
+
+#include "base/bittorrent/queueorder.h"
+#include "base/global.h"
+
+Q_DECLARE_METATYPE(QVector<int>)
+
+namespace
+{
+    QVector<int> identity(const int size)
+    {
+        QVector<int> result;
+        result.reserve(size);
+        for (int i = 0; i < size; ++i)
+            result.append(i);
+        return result;
+    }
+
+    // Applies the moves the way libtorrent applies `queue_position_set()`
+    QVector<int> applyMoves(const int size, const QVector<BitTorrent::QueueMove> &moves)
+    {
+        QVector<int> queue = identity(size);
+        for (const BitTorrent::QueueMove &move : moves)
+        {
+            queue.removeOne(move.item);
+            queue.insert(move.position, move.item);
+        }
+        return queue;
+    }
+}
+
+class TestQueueOrder final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestQueueOrder)
+
+public:
+    TestQueueOrder() = default;
+
+private slots:
+    void testComputeQueueMoves_data() const
+    {
+        QTest::addColumn<QVector<int>>("order");
+        QTest::addColumn<int>("expectedMoveCount");
+
+        QTest::newRow("empty") << QVector<int> {} << 0;
+        QTest::newRow("unchanged") << QVector<int> {0, 1, 2, 3} << 0;
+        QTest::newRow("last to top") << QVector<int> {4, 0, 1, 2, 3} << 1;
+        QTest::newRow("first to bottom") << QVector<int> {1, 2, 3, 4, 0} << 1;
+        QTest::newRow("swap") << QVector<int> {0, 3, 2, 1, 4} << 2;
+        QTest::newRow("block") << QVector<int> {0, 4, 5, 1, 2, 3, 6} << 2;
+        QTest::newRow("reversed") << QVector<int> {4, 3, 2, 1, 0} << 4;
+        QTest::newRow("interleaved") << QVector<int> {3, 0, 4, 1, 5, 2} << 3;
+    }
+
+    void testComputeQueueMoves() const
+    {
+        QFETCH(QVector<int>, order);
+        QFETCH(int, expectedMoveCount);
+
+        const QVector<BitTorrent::QueueMove> moves = BitTorrent::computeQueueMoves(order);
+        QCOMPARE(static_cast<int>(moves.size()), expectedMoveCount);
+        QCOMPARE(applyMoves(static_cast<int>(order.size()), moves), order);
+    }
+
+    void testComputeQueueMovesRandom() const
+    {
+        std::mt19937 generator {42};
+        for (int i = 0; i < 1000; ++i)
+        {
+            QVector<int> order = identity(1 + (i % 20));
+            std::shuffle(order.begin(), order.end(), generator);
+            QCOMPARE(applyMoves(static_cast<int>(order.size()), BitTorrent::computeQueueMoves(order)), order);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestQueueOrder)
+#include "testqueueorder.moc"
@@ -0,0 +1,168 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/http/requestparser.h"
+#include "base/http/types.h"
+
+using Http::RequestParser;
+
+namespace
+{
+    const QByteArray BOUNDARY = "----boundary";
+
+    QByteArray makeGetRequest(const QByteArray &path)
+    {
+        return "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nAccept-Encoding: gzip\r\n\r\n";
+    }
+
+    QByteArray makeUploadRequest(const QByteArray &fileData)
+    {
+        const QByteArray body = "--" + BOUNDARY + "\r\n"
+            + "Content-Disposition: form-data; name=\"savepath\"\r\n\r\n"
+            + "/downloads\r\n"
+            + "--" + BOUNDARY + "\r\n"
+            + "Content-Disposition: form-data; name=\"torrents\"; filename=\"file.torrent\"\r\n"
+            + "Content-Type: application/x-bittorrent\r\n\r\n"
+            + fileData + "\r\n"
+            + "--" + BOUNDARY + "--\r\n";
+
+        return "POST /api/v2/torrents/add HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "Content-Type: multipart/form-data; boundary=" + BOUNDARY + "\r\n"
+            "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n"
+            + body;
+    }
+
+    // Passes the data to the parser in chunks, as if they were received from the socket
+    QVector<Http::Request> parseInChunks(RequestParser &parser, const QByteArray &data, const int chunkSize)
+    {
+        QVector<Http::Request> requests;
+        for (int pos = 0; pos < data.size(); pos += chunkSize)
+        {
+            parser.append(data.mid(pos, chunkSize));
+            while (parser.parse() == RequestParser::ParseStatus::OK)
+                requests.append(parser.takeRequest());
+        }
+        return requests;
+    }
+}
+
+class TestRequestParser final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestRequestParser)
+
+public:
+    TestRequestParser() = default;
+
+private slots:
+    void testPipelinedRequests() const
+    {
+        RequestParser parser;
+        parser.append(makeGetRequest("/a?x=1") + makeGetRequest("/b") + "GET /c HT");
+
+        QCOMPARE(parser.parse(), RequestParser::ParseStatus::OK);
+        const Http::Request first = parser.takeRequest();
+        QCOMPARE(first.path, u"/a"_qs);
+        QCOMPARE(first.query.value(u"x"_qs), QByteArray("1"));
+        QCOMPARE(first.headers.value(u"accept-encoding"_qs), u"gzip"_qs);
+
+        QCOMPARE(parser.parse(), RequestParser::ParseStatus::OK);
+        QCOMPARE(parser.takeRequest().path, u"/b"_qs);
+
+        QCOMPARE(parser.parse(), RequestParser::ParseStatus::Incomplete);
+        parser.append("TP/1.1\r\n\r\n");
+        QCOMPARE(parser.parse(), RequestParser::ParseStatus::OK);
+        QCOMPARE(parser.takeRequest().path, u"/c"_qs);
+
+        QCOMPARE(parser.parse(), RequestParser::ParseStatus::Incomplete);
+        QCOMPARE(parser.bufferedSize(), qint64 {0});
+    }
+
+    void testSplitRequest() const
+    {
+        // the end of header and the body are received in pieces
+        const QByteArray data = "POST /api/v2/auth/login HTTP/1.1\r\n"
+            "Content-Type: application/x-www-form-urlencoded\r\n"
+            "Content-Length: 30\r\n\r\n"
+            "username=admin&password=a+b%21";
+
+        RequestParser parser;
+        const QVector<Http::Request> requests = parseInChunks(parser, data, 1);
+        QCOMPARE(static_cast<int>(requests.size()), 1);
+        QCOMPARE(requests[0].posts.value(u"username"_qs), u"admin"_qs);
+        QCOMPARE(requests[0].posts.value(u"password"_qs), u"a b!"_qs);
+    }
+
+    void testBadRequest() const
+    {
+        RequestParser parser;
+        parser.append("PUT / HTTP/1.1\r\n\r\n");
+        QCOMPARE(parser.parse(), RequestParser::ParseStatus::BadRequest);
+    }
+
+    void testUpload_data() const
+    {
+        QTest::addColumn<int>("fileSize");
+        QTest::addColumn<bool>("isWrittenToFile");
+
+        QTest::newRow("kept in memory") << (64 * 1024) << false;
+        QTest::newRow("written to file") << (3 * 1024 * 1024) << true;
+    }
+
+    void testUpload() const
+    {
+        QFETCH(int, fileSize);
+        QFETCH(bool, isWrittenToFile);
+
+        QByteArray fileData(fileSize, Qt::Uninitialized);
+        for (int i = 0; i < fileSize; ++i)
+            fileData[i] = static_cast<char>(i % 251);
+
+        QVector<Http::Request> requests;
+        {
+            // the uploaded files must stay valid after the parser is gone
+            RequestParser parser;
+            requests = parseInChunks(parser, (makeUploadRequest(fileData) + makeGetRequest("/")), (64 * 1024));
+        }
+        QCOMPARE(static_cast<int>(requests.size()), 2);
+        QCOMPARE(static_cast<bool>(requests[0].bodyFile), isWrittenToFile);
+        QCOMPARE(requests[0].posts.value(u"savepath"_qs), u"/downloads"_qs);
+        QCOMPARE(static_cast<int>(requests[0].files.size()), 1);
+        QCOMPARE(requests[0].files[0].filename, u"file.torrent"_qs);
+        QVERIFY(requests[0].files[0].data == fileData);
+        QCOMPARE(requests[1].path, u"/"_qs);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestRequestParser)
+#include "testrequestparser.moc"
@@ -0,0 +1,200 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/http/httperror.h"
+#include "base/http/responsebuilder.h"
+#include "base/http/types.h"
+#include "base/path.h"
+#include "webui/staticfilecache.h"
+
+namespace
+{
+    // Large enough to be compressed
+    QByteArray pageContent(const QByteArray &title)
+    {
+        QByteArray content = "<!DOCTYPE html>\n<html><head><title>" + title + "</title></head><body>\n";
+        for (int i = 0; i < 100; ++i)
+            content += "<p>QBT_TR(Some text)QBT_TR[CONTEXT=Page]</p>\n";
+        return content + "</body></html>\n";
+    }
+
+    void writeFile(const Path &path, const QByteArray &content, const QDateTime &lastModified)
+    {
+        QFile file {path.data()};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(content), static_cast<qint64>(content.size()));
+        // the buffered data would change the time when written
+        QVERIFY(file.flush());
+        QVERIFY(file.setFileTime(lastModified, QFileDevice::FileModificationTime));
+    }
+
+    Http::Response sendFile(StaticFileCache &cache, const Path &path, const QString &ifNoneMatch = {}, const bool acceptsGzip = false)
+    {
+        Http::Request request;
+        request.method = Http::METHOD_GET;
+        if (!ifNoneMatch.isEmpty())
+            request.headers[Http::HEADER_IF_NONE_MATCH] = ifNoneMatch;
+        if (acceptsGzip)
+            request.headers[u"accept-encoding"_qs] = u"gzip, deflate"_qs;
+
+        Http::ResponseBuilder responseBuilder;
+        cache.sendFile(responseBuilder, request, path);
+        return responseBuilder.response();
+    }
+}
+
+class TestStaticFileCache final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestStaticFileCache)
+
+public:
+    TestStaticFileCache() = default;
+
+private slots:
+    void testNotModified() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path filePath = Path(tmpDir.path()) / Path(u"index.html"_qs);
+        writeFile(filePath, pageContent("Index"), QDateTime::currentDateTime().addSecs(-60));
+
+        StaticFileCache cache;
+        const Http::Response response = sendFile(cache, filePath);
+        QCOMPARE(response.status.code, 200U);
+        QCOMPARE(response.content, pageContent("Index"));
+        QCOMPARE(response.headers.value(Http::HEADER_CACHE_CONTROL), u"no-cache"_qs);
+        const QString etag = response.headers.value(Http::HEADER_ETAG);
+        QVERIFY(etag.startsWith(u'"') && etag.endsWith(u'"'));
+        QVERIFY(!etag.endsWith(u"-gzip\""));
+
+        const Http::Response notModified = sendFile(cache, filePath, etag);
+        QCOMPARE(notModified.status.code, 304U);
+        QVERIFY(notModified.content.isEmpty());
+        QCOMPARE(notModified.headers.value(Http::HEADER_ETAG), etag);
+        QCOMPARE(cache.statistics().notModifiedBytesSaved.loadRelaxed(), static_cast<qint64>(pageContent("Index").size()));
+
+        QCOMPARE(sendFile(cache, filePath, (u"\"other\", W/"_qs + etag)).status.code, 304U);
+        QCOMPARE(sendFile(cache, filePath, u"*"_qs).status.code, 304U);
+        QCOMPARE(sendFile(cache, filePath, u"\"other\""_qs).status.code, 200U);
+    }
+
+    void testCompressedTag() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path filePath = Path(tmpDir.path()) / Path(u"index.html"_qs);
+        writeFile(filePath, pageContent("Index"), QDateTime::currentDateTime().addSecs(-60));
+
+        StaticFileCache cache;
+        const Http::Response plain = sendFile(cache, filePath);
+        const Http::Response compressed = sendFile(cache, filePath, {}, true);
+        QCOMPARE(compressed.status.code, 200U);
+        QVERIFY(!compressed.compressedContent.isEmpty());
+        QCOMPARE(compressed.headers.value(Http::HEADER_VARY), u"accept-encoding"_qs);
+
+        // the compressed content has its own tag
+        const QString plainTag = plain.headers.value(Http::HEADER_ETAG);
+        const QString compressedTag = compressed.headers.value(Http::HEADER_ETAG);
+        QCOMPARE(compressedTag, (plainTag.chopped(1) + u"-gzip\""_qs));
+        QCOMPARE(cache.statistics().compressedBytesSaved.loadRelaxed()
+            , static_cast<qint64>(compressed.content.size() - compressed.compressedContent.size()));
+
+        QCOMPARE(sendFile(cache, filePath, compressedTag, true).status.code, 304U);
+        QCOMPARE(sendFile(cache, filePath, plainTag, true).status.code, 200U);
+        QCOMPARE(sendFile(cache, filePath, compressedTag, false).status.code, 200U);
+        QCOMPARE(sendFile(cache, filePath, plainTag, false).status.code, 304U);
+    }
+
+    void testModifiedFile() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path filePath = Path(tmpDir.path()) / Path(u"index.html"_qs);
+        const QDateTime lastModified = QDateTime::currentDateTime().addSecs(-60);
+        writeFile(filePath, pageContent("Index"), lastModified);
+
+        int translationsCount = 0;
+        StaticFileCache cache {[&translationsCount](QString &data)
+        {
+            data.replace(u"QBT_TR(Some text)QBT_TR[CONTEXT=Page]"_qs, u"Translated"_qs);
+            ++translationsCount;
+        }};
+
+        const Http::Response first = sendFile(cache, filePath);
+        QVERIFY(first.content.contains("<p>Translated</p>"));
+        QCOMPARE(translationsCount, 1);
+
+        // the file is loaded once while it isn't modified
+        const QString etag = first.headers.value(Http::HEADER_ETAG);
+        QCOMPARE(sendFile(cache, filePath, etag).status.code, 304U);
+        QCOMPARE(translationsCount, 1);
+
+        writeFile(filePath, pageContent("Changed"), lastModified.addSecs(30));
+        const Http::Response changed = sendFile(cache, filePath, etag);
+        QCOMPARE(changed.status.code, 200U);
+        QVERIFY(changed.content.contains("<title>Changed</title>"));
+        QVERIFY(changed.headers.value(Http::HEADER_ETAG) != etag);
+        QCOMPARE(translationsCount, 2);
+
+        cache.clear();
+        QCOMPARE(sendFile(cache, filePath).headers.value(Http::HEADER_ETAG), changed.headers.value(Http::HEADER_ETAG));
+        QCOMPARE(translationsCount, 3);
+    }
+
+    void testMissingFile() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        StaticFileCache cache;
+        bool isNotFound = false;
+        try
+        {
+            sendFile(cache, (Path(tmpDir.path()) / Path(u"missing.html"_qs)));
+        }
+        catch (const NotFoundHTTPError &)
+        {
+            isNotFound = true;
+        }
+        QVERIFY(isNotFound);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestStaticFileCache)
+#include "teststaticfilecache.moc"
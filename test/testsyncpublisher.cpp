@@ -0,0 +1,67 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QTest>
+
+#include "base/global.h"
+#include "webui/api/syncpublisher.h"
+
+class TestSyncPublisher final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestSyncPublisher)
+
+public:
+    TestSyncPublisher() = default;
+
+private slots:
+    void testEventID() const
+    {
+        const SyncEventID eventID {12, 345};
+        QCOMPARE(eventID.toString(), u"12-345"_qs);
+
+        const SyncEventID parsedID = SyncEventID::fromString(eventID.toString());
+        QCOMPARE(parsedID.subscriptionID, quint64 {12});
+        QCOMPARE(parsedID.responseID, 345);
+    }
+
+    void testInvalidEventID() const
+    {
+        // the subscription isn't resumed, the client gets the whole data
+        const QString invalidIDs[] = {u""_qs, u"345"_qs, u"12-"_qs, u"-345"_qs, u"a-345"_qs, u"12-345-6"_qs};
+        for (const QString &id : invalidIDs)
+        {
+            const SyncEventID parsedID = SyncEventID::fromString(id);
+            QCOMPARE(parsedID.subscriptionID, quint64 {0});
+            QCOMPARE(parsedID.responseID, 0);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestSyncPublisher)
+#include "testsyncpublisher.moc"
@@ -0,0 +1,147 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QStringList>
+#include <QTest>
+#include <QVector>
+
+#include "base/global.h"
+#include "webui/api/jsonwriter.h"
+#include "webui/api/syncstore.h"
+
+class TestSyncStore final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestSyncStore)
+
+public:
+    TestSyncStore() = default;
+
+private slots:
+    void testChanges() const
+    {
+        SyncStore store {{u"name"_qs, u"progress"_qs}};
+
+        store.beginUpdate(1);
+        store.updateItem(u"a"_qs, {u"A"_qs, 0.5});
+        store.updateItem(u"b"_qs, {u"B"_qs, 0.0});
+        store.endUpdate();
+
+        QVERIFY(store.isFullUpdateNeeded(0));
+        QVERIFY(!store.isFullUpdateNeeded(1));
+        QCOMPARE(static_cast<int>(store.changedItems(0).size()), 2);
+        QVERIFY(store.changedItems(1).isEmpty());
+
+        store.beginUpdate(2);
+        store.updateItem(u"a"_qs, {u"A"_qs, 1.0});
+        store.updateItem(u"c"_qs, {u"C"_qs, 0.0});
+        store.endUpdate();
+
+        const QJsonObject changedItems = store.changedItems(1);
+        QCOMPARE(static_cast<int>(changedItems.size()), 2);
+        QCOMPARE(changedItems[u"a"_qs].toObject(), (QJsonObject {{u"progress"_qs, 1.0}}));
+        QCOMPARE(changedItems[u"c"_qs].toObject(), (QJsonObject {{u"name"_qs, u"C"_qs}, {u"progress"_qs, 0.0}}));
+        QCOMPARE(store.removedItems(1), QJsonArray {u"b"_qs});
+
+        QVERIFY(store.changedItems(2).isEmpty());
+        QVERIFY(store.removedItems(2).isEmpty());
+    }
+
+    void testWriteItems() const
+    {
+        SyncStore store {{u"name"_qs, u"progress"_qs}};
+
+        store.beginUpdate(1);
+        store.updateItem(u"a"_qs, {u"A"_qs, 0.5});
+        store.updateItem(u"b"_qs, {u"B"_qs, 0.0});
+        store.endUpdate();
+
+        store.beginUpdate(2);
+        store.updateItem(u"a"_qs, {u"A"_qs, 1.0});
+        store.endUpdate();
+
+        for (const quint64 sinceRevision : {0, 1, 2})
+        {
+            JsonWriter writer;
+            writer.beginObject();
+            writer.writeKey(u"changed");
+            store.writeChangedItems(writer, sinceRevision);
+            writer.writeKey(u"removed");
+            store.writeRemovedItems(writer, sinceRevision);
+            writer.endObject();
+
+            const QJsonObject result = QJsonDocument::fromJson(writer.data()).object();
+            QCOMPARE(result[u"changed"_qs].toObject(), store.changedItems(sinceRevision));
+            QCOMPARE(result[u"removed"_qs].toArray(), store.removedItems(sinceRevision));
+            QCOMPARE(store.hasChangedItems(sinceRevision), !store.changedItems(sinceRevision).isEmpty());
+            QCOMPARE(store.hasRemovedItems(sinceRevision), !store.removedItems(sinceRevision).isEmpty());
+        }
+    }
+
+    void testTolerance() const
+    {
+        SyncStore store {{u"last_activity"_qs}};
+        store.setFieldTolerance(0, 15);
+
+        store.beginUpdate(1);
+        store.updateItem(u"a"_qs, {qint64 {100}});
+        store.endUpdate();
+
+        store.beginUpdate(2);
+        store.updateItem(u"a"_qs, {qint64 {110}});
+        store.endUpdate();
+        QVERIFY(store.changedItems(1).isEmpty());
+
+        store.beginUpdate(3);
+        store.updateItem(u"a"_qs, {qint64 {120}});
+        store.endUpdate();
+        QCOMPARE(store.changedItems(1)[u"a"_qs].toObject()[u"last_activity"_qs].toDouble(), 120.0);
+    }
+
+    void testPlainValues() const
+    {
+        SyncStore store;
+
+        store.beginUpdate(1);
+        store.updateItem(u"tracker"_qs, {QJsonArray {u"a"_qs}});
+        store.endUpdate();
+
+        store.beginUpdate(2);
+        store.updateItem(u"tracker"_qs, {QJsonArray {u"a"_qs, u"b"_qs}});
+        store.endUpdate();
+
+        QCOMPARE(store.changedItems(1)[u"tracker"_qs].toArray(), (QJsonArray {u"a"_qs, u"b"_qs}));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestSyncStore)
+#include "testsyncstore.moc"
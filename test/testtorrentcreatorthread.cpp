@@ -0,0 +1,166 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/torrent_info.hpp>
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/torrentcreatorthread.h"
+#include "base/global.h"
+#include "base/path.h"
+
+#ifdef QBT_USES_LIBTORRENT2
+Q_DECLARE_METATYPE(BitTorrent::TorrentFormat)
+#endif
+
+namespace
+{
+    const int PIECE_SIZE = 64 * 1024;
+
+    void writeFile(const Path &path, const qint64 size, std::mt19937 &generator)
+    {
+        QFile file {path.data()};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+
+        QByteArray data {static_cast<int>(size), Qt::Uninitialized};
+        for (char &c : data)
+            c = static_cast<char>(generator());
+        QCOMPARE(file.write(data), size);
+    }
+
+    // File sizes are chosen to cover empty, sub-block, sub-piece and unaligned multi-piece files
+    void generateContent(const Path &rootPath, const qint64 scale)
+    {
+        std::mt19937 generator {42};
+
+        QVERIFY(QDir().mkpath((rootPath / Path(u"dir/subdir"_qs)).data()));
+        writeFile((rootPath / Path(u"empty"_qs)), 0, generator);
+        writeFile((rootPath / Path(u"tiny"_qs)), 100, generator);
+        writeFile((rootPath / Path(u"dir/small"_qs)), (PIECE_SIZE / 2) + 123, generator);
+        writeFile((rootPath / Path(u"dir/piece"_qs)), PIECE_SIZE, generator);
+        writeFile((rootPath / Path(u"dir/subdir/large"_qs)), (scale * PIECE_SIZE) + 16385, generator);
+        writeFile((rootPath / Path(u"dir/subdir/large2"_qs)), (scale * PIECE_SIZE * 3) + 7, generator);
+    }
+
+    BitTorrent::TorrentCreatorParams makeParams(const Path &inputPath, const Path &savePath)
+    {
+        BitTorrent::TorrentCreatorParams params;
+        params.isPrivate = false;
+#ifndef QBT_USES_LIBTORRENT2
+        params.isAlignmentOptimized = false;
+        params.paddedFileSizeLimit = -1;
+#endif
+        params.pieceSize = PIECE_SIZE;
+        params.inputPath = inputPath;
+        params.savePath = savePath;
+        return params;
+    }
+
+    bool createTorrent(const BitTorrent::TorrentCreatorParams &params)
+    {
+        BitTorrent::TorrentCreatorThread creator;
+        QSignalSpy successSpy {&creator, &BitTorrent::TorrentCreatorThread::creationSuccess};
+        QSignalSpy failureSpy {&creator, &BitTorrent::TorrentCreatorThread::creationFailure};
+        creator.create(params);
+        creator.wait();
+        return (successSpy.count() == 1) && failureSpy.isEmpty();
+    }
+}
+
+class TestTorrentCreatorThread final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestTorrentCreatorThread)
+
+public:
+    TestTorrentCreatorThread() = default;
+
+private slots:
+    void testPieceHashes_data() const
+    {
+        addFormatColumn();
+    }
+
+    // Hashes must be the same as the ones calculated by libtorrent itself
+    void testPieceHashes() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path rootPath = Path(tmpDir.path()) / Path(u"content"_qs);
+        generateContent(rootPath, 4);
+
+        BitTorrent::TorrentCreatorParams params = makeParams(rootPath, (Path(tmpDir.path()) / Path(u"test.torrent"_qs)));
+#ifdef QBT_USES_LIBTORRENT2
+        QFETCH(BitTorrent::TorrentFormat, format);
+        params.torrentFormat = format;
+#endif
+        QVERIFY(createTorrent(params));
+
+        const lt::torrent_info createdInfo {params.savePath.toString().toStdString()};
+
+        lt::create_torrent referenceTorrent {createdInfo};
+        lt::set_piece_hashes(referenceTorrent, rootPath.parentPath().toString().toStdString());
+        std::vector<char> referenceData;
+        lt::bencode(std::back_inserter(referenceData), referenceTorrent.generate());
+        const lt::torrent_info referenceInfo {referenceData, lt::from_span};
+
+#ifdef QBT_USES_LIBTORRENT2
+        QVERIFY(createdInfo.info_hashes() == referenceInfo.info_hashes());
+#else
+        QVERIFY(createdInfo.info_hash() == referenceInfo.info_hash());
+#endif
+    }
+
+private:
+    void addFormatColumn() const
+    {
+#ifdef QBT_USES_LIBTORRENT2
+        QTest::addColumn<BitTorrent::TorrentFormat>("format");
+        QTest::newRow("v1") << BitTorrent::TorrentFormat::V1;
+        QTest::newRow("v2") << BitTorrent::TorrentFormat::V2;
+        QTest::newRow("hybrid") << BitTorrent::TorrentFormat::Hybrid;
+#else
+        QTest::addColumn<int>("format");
+        QTest::newRow("v1") << 0;
+#endif
+    }
+};
+
+QTEST_GUILESS_MAIN(TestTorrentCreatorThread)
+#include "testtorrentcreatorthread.moc"
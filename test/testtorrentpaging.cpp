@@ -0,0 +1,181 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QBitArray>
+#include <QJsonValue>
+#include <QStringList>
+#include <QTest>
+#include <QVector>
+
+#include "base/bittorrent/infohash.h"
+#include "base/global.h"
+#include "webui/api/serialize/serialize_torrent.h"
+#include "webui/api/torrentpaging.h"
+
+namespace
+{
+    BitTorrent::TorrentID makeID(const int value)
+    {
+        return BitTorrent::TorrentID::fromString(u"%1"_qs.arg(value, 40, 16, QChar(u'0')));
+    }
+
+    // Torrents 1-6 named so that the natural order differs from the order of their IDs
+    QVector<TorrentSortValue> namedTorrents()
+    {
+        return {
+            {makeID(1), u"file10"_qs},
+            {makeID(2), u"File4"_qs},
+            {makeID(3), u"file1"_qs},
+            {makeID(4), u"file2"_qs},
+            {makeID(5), u"file3"_qs},
+            {makeID(6), u"file20"_qs}
+        };
+    }
+
+    // Follows the cursors until the last page and returns the indexes of all the pages
+    QVector<int> allPages(const QVector<TorrentSortValue> &sortValues, const int limit, const bool reverse)
+    {
+        QVector<int> result;
+        QString cursor = u""_qs;
+        for (int pageCount = 0; pageCount <= sortValues.size(); ++pageCount)
+        {
+            const std::optional<TorrentPage> page = torrentPageAfterCursor(sortValues, cursor, limit, reverse, true);
+            if (!page)
+                return {};
+
+            result += page->indexes;
+            if (!page->nextCursor)
+                return result;
+            cursor = *page->nextCursor;
+        }
+        return {};
+    }
+}
+
+class TestTorrentPaging final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestTorrentPaging)
+
+public:
+    TestTorrentPaging() = default;
+
+private slots:
+    void testFieldMask() const
+    {
+        const std::optional<QBitArray> emptyMask = torrentFieldMask({});
+        QVERIFY(emptyMask);
+        QVERIFY(emptyMask->isEmpty());
+
+        const std::optional<QBitArray> mask = torrentFieldMask({KEY_TORRENT_NAME, KEY_TORRENT_ID});
+        QVERIFY(mask);
+        QCOMPARE(static_cast<int>(mask->size()), static_cast<int>(torrentFieldKeys().size()));
+        QCOMPARE(static_cast<int>(mask->count(true)), 2);
+        QVERIFY(mask->testBit(torrentFieldKeys().indexOf(KEY_TORRENT_ID)));
+        QVERIFY(mask->testBit(torrentFieldKeys().indexOf(KEY_TORRENT_NAME)));
+
+        QVERIFY(!torrentFieldMask({KEY_TORRENT_NAME, u"unknown"_qs}));
+    }
+
+    void testSortedPage() const
+    {
+        const QVector<TorrentSortValue> sortValues = namedTorrents();
+        QCOMPARE(sortedTorrentPage(sortValues, 0, 6, false), (QVector<int> {2, 3, 4, 1, 0, 5}));
+        QCOMPARE(sortedTorrentPage(sortValues, 1, 3, false), (QVector<int> {3, 4, 1}));
+        QCOMPARE(sortedTorrentPage(sortValues, 4, 2, true), (QVector<int> {3, 2}));
+    }
+
+    void testCursorPaging() const
+    {
+        const QVector<TorrentSortValue> sortValues = namedTorrents();
+        const QVector<int> sortedIndexes {2, 3, 4, 1, 0, 5};
+        QCOMPARE(allPages(sortValues, 0, false), sortedIndexes);
+        QCOMPARE(allPages(sortValues, 6, false), sortedIndexes);
+        QCOMPARE(allPages(sortValues, 4, false), sortedIndexes);
+        QCOMPARE(allPages(sortValues, 1, false), sortedIndexes);
+        QCOMPARE(allPages(sortValues, 2, true), (QVector<int> {5, 0, 1, 4, 3, 2}));
+
+        const std::optional<TorrentPage> lastPage = torrentPageAfterCursor(sortValues, u""_qs, 6, false, true);
+        QVERIFY(lastPage);
+        QVERIFY(!lastPage->nextCursor);
+    }
+
+    void testCursorKeepsPosition() const
+    {
+        QVector<TorrentSortValue> sortValues = namedTorrents();
+        const std::optional<TorrentPage> firstPage = torrentPageAfterCursor(sortValues, u""_qs, 2, false, true);
+        QVERIFY(firstPage);
+        QCOMPARE(firstPage->indexes, (QVector<int> {2, 3}));
+        QVERIFY(firstPage->nextCursor);
+
+        // the cursor holds the value the page was sorted by, so the following page
+        // starts at the same place even if the last torrent of the page has changed
+        sortValues[3].value = u"file99"_qs;
+        const std::optional<TorrentPage> secondPage = torrentPageAfterCursor(sortValues, *firstPage->nextCursor, 2, false, true);
+        QVERIFY(secondPage);
+        QCOMPARE(secondPage->indexes, (QVector<int> {4, 1}));
+
+        // the torrent of the cursor may not exist anymore
+        sortValues.removeAt(3);
+        const std::optional<TorrentPage> pageAfterRemoved = torrentPageAfterCursor(sortValues, *firstPage->nextCursor, 2, false, true);
+        QVERIFY(pageAfterRemoved);
+        QCOMPARE(pageAfterRemoved->indexes, (QVector<int> {3, 1}));
+    }
+
+    void testNumericCursor() const
+    {
+        const QVector<TorrentSortValue> sortValues {
+            {makeID(1), 3.5},
+            {makeID(2), 1},
+            {makeID(3), true},
+            {makeID(4), 1}
+        };
+        const std::optional<TorrentPage> firstPage = torrentPageAfterCursor(sortValues, u""_qs, 2, false, false);
+        QVERIFY(firstPage);
+        QCOMPARE(firstPage->indexes, (QVector<int> {1, 2}));
+        QVERIFY(firstPage->nextCursor);
+
+        const std::optional<TorrentPage> secondPage = torrentPageAfterCursor(sortValues, *firstPage->nextCursor, 2, false, false);
+        QVERIFY(secondPage);
+        QCOMPARE(secondPage->indexes, (QVector<int> {3, 0}));
+        QVERIFY(!secondPage->nextCursor);
+
+        // the cursor of the numeric column doesn't fit the text one
+        QVERIFY(!torrentPageAfterCursor(namedTorrents(), *firstPage->nextCursor, 2, false, true));
+    }
+
+    void testInvalidCursor() const
+    {
+        const QVector<TorrentSortValue> sortValues = namedTorrents();
+        QVERIFY(!torrentPageAfterCursor(sortValues, u"invalid"_qs, 2, false, true));
+        QVERIFY(!torrentPageAfterCursor(sortValues, u"WyJhIiwiYiJd"_qs, 2, false, true)); // ["a","b"]
+    }
+};
+
+QTEST_APPLESS_MAIN(TestTorrentPaging)
+#include "testtorrentpaging.moc"
@@ -177,6 +177,18 @@ private slots:
         for (const TestData &data : testData)
             testLessThan(data, cmp(data.lhs, data.rhs), data.caseSensitiveResult);
     }
+
+    void testNaturalSortKey() const
+    {
+        const Utils::Compare::NaturalCompare<Qt::CaseInsensitive> cmpInsensitive;
+        const Utils::Compare::NaturalCompare<Qt::CaseSensitive> cmpSensitive;
+
+        for (const TestData &data : testData)
+        {
+            testCompare(data, cmpInsensitive.sortKey(data.lhs).compare(cmpInsensitive.sortKey(data.rhs)), data.caseInsensitiveResult);
+            testCompare(data, cmpSensitive.sortKey(data.lhs).compare(cmpSensitive.sortKey(data.rhs)), data.caseSensitiveResult);
+        }
+    }
 #endif
 };
 
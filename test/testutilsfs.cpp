@@ -0,0 +1,138 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/path.h"
+#include "base/utils/fs.h"
+
+namespace
+{
+    QByteArray makeData(const int size)
+    {
+        QByteArray data {size, Qt::Uninitialized};
+        for (int i = 0; i < size; ++i)
+            data[i] = static_cast<char>((i * 7) ^ (i >> 8));
+        return data;
+    }
+
+    void writeFile(const Path &path, const QByteArray &data)
+    {
+        QFile file {path.data()};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(data), static_cast<qint64>(data.size()));
+    }
+
+    QByteArray readFile(const Path &path)
+    {
+        QFile file {path.data()};
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return file.readAll();
+    }
+
+    qint64 totalCopiedBytes(const Utils::Fs::CopyStatistics &statistics)
+    {
+        return statistics.clonedBytes + statistics.copyFileRangeBytes
+                + statistics.sendFileBytes + statistics.readWriteBytes;
+    }
+}
+
+class TestUtilsFs final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestUtilsFs)
+
+public:
+    TestUtilsFs() = default;
+
+private slots:
+    void testCopyFile() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path source = Path(tmpDir.path()) / Path(u"source"_qs);
+        const Path destination = Path(tmpDir.path()) / Path(u"destination"_qs);
+        const QByteArray data = makeData((3 * 1024 * 1024) + 123);
+        writeFile(source, data);
+        QVERIFY(QFile::setPermissions(source.data(), (QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner)));
+
+        const qint64 copiedBefore = totalCopiedBytes(Utils::Fs::copyStatistics());
+        QVERIFY(Utils::Fs::copyFile(source, destination));
+        QCOMPARE(readFile(destination), data);
+        QCOMPARE(QFile::permissions(destination.data()), QFile::permissions(source.data()));
+        QCOMPARE((totalCopiedBytes(Utils::Fs::copyStatistics()) - copiedBefore), static_cast<qint64>(data.size()));
+
+        // existing files are never overwritten
+        writeFile(source, makeData(10));
+        QVERIFY(!Utils::Fs::copyFile(source, destination));
+        QCOMPARE(readFile(destination), data);
+    }
+
+    void testCopyEmptyFile() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path source = Path(tmpDir.path()) / Path(u"source"_qs);
+        const Path destination = Path(tmpDir.path()) / Path(u"destination"_qs);
+        writeFile(source, {});
+
+        QVERIFY(Utils::Fs::copyFile(source, destination));
+        QVERIFY(destination.exists());
+        QCOMPARE(QFile(destination.data()).size(), static_cast<qint64>(0));
+    }
+
+    void testMoveFile() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path source = Path(tmpDir.path()) / Path(u"source"_qs);
+        const Path destination = Path(tmpDir.path()) / Path(u"destination"_qs);
+        const QByteArray data = makeData(1000);
+        writeFile(source, data);
+
+        QVERIFY(Utils::Fs::moveFile(source, destination));
+        QVERIFY(!source.exists());
+        QCOMPARE(readFile(destination), data);
+
+        writeFile(source, makeData(10));
+        QVERIFY(!Utils::Fs::moveFile(source, destination));
+        QVERIFY(source.exists());
+        QCOMPARE(readFile(destination), data);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestUtilsFs)
+#include "testutilsfs.moc"
@@ -0,0 +1,111 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2022  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QTest>
+#include <QVector>
+
+#include "base/bittorrent/torrentinfo.h"
+#include "base/path.h"
+
+// Helpers shared by the tests which need torrents and their content
+namespace TorrentFactory
+{
+    // Relative path and size of each file of the torrent
+    using FileList = QVector<std::pair<QString, qint64>>;
+
+    // Deterministic content which differs between the seeds
+    inline QByteArray fileContent(const qint64 size, const int seed)
+    {
+        QByteArray content {static_cast<int>(size), Qt::Uninitialized};
+        for (int i = 0; i < content.size(); ++i)
+            content[i] = static_cast<char>((i * 7 + seed) % 251);
+        return content;
+    }
+
+    inline void writeFile(const Path &path, const QByteArray &content)
+    {
+        QVERIFY(QDir().mkpath(path.parentPath().data()));
+        QFile file {path.data()};
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(content), static_cast<qint64>(content.size()));
+    }
+
+    // Returns the bencoded metadata of a v1 torrent.
+    // The pieces are hashed from the files in `contentDirPath`. If it is empty, the hashes
+    // are zeroed so the torrent doesn't need any content when only the metadata matters.
+    inline QByteArray createTorrentData(const FileList &files, const int pieceSize
+            , const Path &contentDirPath = {}, const QStringList &trackerURLs = {})
+    {
+        lt::file_storage fs;
+        for (const auto &[filePath, fileSize] : files)
+            fs.add_file(filePath.toStdString(), fileSize);
+
+#ifdef QBT_USES_LIBTORRENT2
+        lt::create_torrent creator {fs, pieceSize, lt::create_torrent::v1_only};
+#else
+        lt::create_torrent creator {fs, pieceSize, -1, {}};
+#endif
+        if (contentDirPath.isEmpty())
+        {
+            for (int i = 0; i < creator.num_pieces(); ++i)
+                creator.set_hash(lt::piece_index_t {i}, lt::sha1_hash {});
+        }
+        else
+        {
+            lt::set_piece_hashes(creator, contentDirPath.toString().toStdString());
+        }
+
+        for (const QString &trackerURL : trackerURLs)
+            creator.add_tracker(trackerURL.toStdString());
+
+        std::vector<char> data;
+        lt::bencode(std::back_inserter(data), creator.generate());
+        return QByteArray(data.data(), static_cast<int>(data.size()));
+    }
+
+    inline BitTorrent::TorrentInfo createTorrentInfo(const FileList &files, const int pieceSize
+            , const Path &contentDirPath = {}, const QStringList &trackerURLs = {})
+    {
+        return BitTorrent::TorrentInfo::load(createTorrentData(files, pieceSize, contentDirPath, trackerURLs)).value();
+    }
+}